@@ -26,10 +26,12 @@ int pickAdaptiveBandwidthHz(AdaptiveBandwidthMode mode, double snrDb);
 // Applies hysteresis: only allows changes every minIntervalMs ms, and only
 // when the target differs from the previous target by at least minStepHz.
 // Returns the bandwidth to apply (or 0 if no change should be made).
-// Updates `state` if a change is committed.
+// Updates `state` if a change is committed. A change is a short channel-FIR
+// crossfade in the demod (no reset, no mute), so the interval only has to
+// keep the SNR estimate from flapping between bands.
 int applyAdaptiveBandwidthHysteresis(
     AdaptiveBandwidthState &state, int proposedHz, int currentAppliedHz,
-    std::chrono::steady_clock::time_point now, int minIntervalMs = 2000,
+    std::chrono::steady_clock::time_point now, int minIntervalMs = 500,
     int minStepHz = 20000);
 
 } // namespace fm_tuner
@@ -1,11 +1,20 @@
 #ifndef AF_POST_PROCESSOR_H
 #define AF_POST_PROCESSOR_H
 
-#include "dsp/liquid_primitives.h"
+#include "dsp/first_order_iir.h"
+#include "dsp/polyphase_resampler.h"
 #include <array>
 #include <stddef.h>
 #include <stdint.h>
+#include <vector>
 
+// Audio back end after the stereo matrix: band-limiting resampler to the
+// output rate, de-emphasis (optionally crossfaded toward a narrower HiCut
+// de-emphasis on weak signals) and a DC blocker. Both channels run as one
+// stream: a single polyphase phase walk feeds interleaved L/R frames, and the
+// first-order filters are stepped per frame as 2- or 4-lane banks, so the
+// interleaved output goes to AudioOutput without a re-interleave and L/R can
+// never end up a sample apart.
 class AFPostProcessor {
 public:
   enum class HicutMode { Off = 0, Gentle = 1, Strong = 2 };
@@ -20,11 +29,26 @@ public:
   // residual hiss from the discriminator is suppressed.
   void setSignalQuality(float quality);
 
+  // Interleaved output (L0 R0 L1 R1 ...); outFrames holds outCapacity frames.
+  // Returns the number of frames written.
+  size_t processInterleaved(const float *inLeft, const float *inRight,
+                            size_t inSamples, float *outFrames,
+                            size_t outCapacity);
+  // Mono input (StereoDecoder's mono fast path): one dot product per output
+  // sample, duplicated into both lanes.
+  size_t processMonoInterleaved(const float *in, size_t inSamples,
+                                float *outFrames, size_t outCapacity);
+  // Planar wrappers around the interleaved paths.
   size_t process(const float *inLeft, const float *inRight, size_t inSamples,
                  float *outLeft, float *outRight, size_t outCapacity);
+  size_t processMono(const float *in, size_t inSamples, float *outLeft,
+                     float *outRight, size_t outCapacity);
 
 private:
   void rebuildDeemphasis();
+  // De-emphasis (+ HiCut) and DC block, in place on interleaved frames.
+  void filterFrames(float *frames, size_t count);
+  size_t deinterleave(size_t frames, float *outLeft, float *outRight) const;
 
   int m_inputRate;
   int m_outputRate;
@@ -43,18 +67,15 @@ private:
   // ([tuner].deemphasis = 1 → 75 µs) or runtime XDR command.
   static constexpr int kDefaultDeemphasisUs = 50;
   static constexpr float kMicrosecondsToSeconds = 1e-6f;
-  fm_tuner::dsp::liquid::IIRFilterReal m_liquidLeftDeemphasis;
-  fm_tuner::dsp::liquid::IIRFilterReal m_liquidRightDeemphasis;
-  fm_tuner::dsp::liquid::IIRFilterReal m_liquidLeftDeemphasisNarrow;
-  fm_tuner::dsp::liquid::IIRFilterReal m_liquidRightDeemphasisNarrow;
-  fm_tuner::dsp::liquid::IIRFilterReal m_liquidLeftDcBlock;
-  fm_tuner::dsp::liquid::IIRFilterReal m_liquidRightDcBlock;
-  fm_tuner::dsp::liquid::Resampler m_liquidLeftResampler;
-  fm_tuner::dsp::liquid::Resampler m_liquidRightResampler;
-  std::array<float, fm_tuner::dsp::liquid::Resampler::kMaxOutput>
-      m_liquidLeftTmp{};
-  std::array<float, fm_tuner::dsp::liquid::Resampler::kMaxOutput>
-      m_liquidRightTmp{};
+  // Lanes: L, R of the configured de-emphasis.
+  fm_tuner::dsp::FirstOrderIirBank<2> m_deemphasis;
+  // Lanes: L, R normal, then L, R narrow (HiCut). Used instead of
+  // m_deemphasis while HiCut is on.
+  fm_tuner::dsp::FirstOrderIirBank<4> m_deemphasisHicut;
+  fm_tuner::dsp::FirstOrderIirBank<2> m_dcBlock;
+  fm_tuner::dsp::PolyphaseResampler m_resampler;
+  // Interleaved scratch for the planar wrappers.
+  std::vector<float> m_frameScratch;
 };
 
 #endif
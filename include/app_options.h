@@ -36,6 +36,16 @@ struct AppOptions {
   bool mpxAudioEnabled = false;
   std::string mpxAudioDevice;
   std::string iqFile;
+  // IQ capture file format: auto (by extension of iqFile) | u8 | cf32 | cs16.
+  std::string iqFormat = "auto";
+  // Split the IQ capture every N MiB and/or N seconds of IQ (0 = never).
+  uint32_t iqRotateMb = 0;
+  uint32_t iqRotateSeconds = 0;
+  // --source file: IQ recording to replay (see Config::ReplaySection).
+  std::string replayFile;
+  std::string replayFormat = "auto";
+  bool replayRealtime = true;
+  bool replayLoop = false;
   bool enableSpeaker = false;
   std::string audioDevice;
   std::string xdrPassword;
@@ -44,6 +54,8 @@ struct AppOptions {
   bool autoReconnect = true;
   bool autoStart = false;
   bool lowLatencyIq = false;
+  // [audio] target_latency_ms / --latency: 0 = off.
+  int targetLatencyMs = 0;
   bool verboseLogging = true;
   std::string stereoBlendOverride; // empty = use config; else "soft"|"normal"|"aggressive"
   // One-shot band-sweep / calibration mode. When true, main() opens the
@@ -9,9 +9,11 @@
 #include <functional>
 
 #include "app_options.h"
+#include "tuner_controller.h"
 
 class AudioOutput;
 class CPUFeatures;
+class IqCaptureWriter;
 class MpxAudioOutput;
 class TunerSession;
 class WavWriter;
@@ -27,18 +29,18 @@ private:
   void logStartup(const CPUFeatures &cpu) const;
   bool initAudioOutput(AudioOutput &audioOut, TunerSession &tunerSession,
                        std::atomic<int> &requestedVolume) const;
-  FILE *openIqCapture(AudioOutput &audioOut, TunerSession &tunerSession) const;
+  bool openIqCapture(IqCaptureWriter &iqCapture, uint32_t sampleRate,
+                     TunerController::IqFormat sourceFormat,
+                     AudioOutput &audioOut, TunerSession &tunerSession) const;
   bool initMpxCapture(WavWriter &mpxWavOut, TunerSession &tunerSession,
                       uint32_t sampleRate) const;
   bool initMpxAudio(MpxAudioOutput &mpxAudioOut, TunerSession &tunerSession,
                     uint32_t sourceSampleRate) const;
-  bool readIqSamples(
-      const std::function<size_t(uint8_t *, size_t)> &tunerReadIQ,
-      const std::function<void(const uint8_t *, size_t)> &writeIqCapture,
-      uint8_t *iqBuffer, size_t sdrBufSamples,
-      const std::chrono::milliseconds &noDataSleep, TunerSession &tunerSession,
-      bool verboseLogging, size_t &samples) const;
-  void shutdownResources(AudioOutput &audioOut, FILE *&iqHandle,
+  bool leaseIqSamples(TunerController &tuner, size_t sdrBufSamples,
+                      const std::chrono::milliseconds &noDataSleep,
+                      TunerSession &tunerSession, bool verboseLogging,
+                      TunerController::IqLease &lease) const;
+  void shutdownResources(AudioOutput &audioOut, IqCaptureWriter &iqCapture,
                          WavWriter &mpxWavOut, XDRServer &xdrServer,
                          TunerSession &tunerSession) const;
 
@@ -46,19 +46,39 @@ public:
   static constexpr size_t kWavQueueSamples =
       static_cast<size_t>(SAMPLE_RATE) * CHANNELS * 2;
   static constexpr float kVolumeEpsilon = 1e-6f;
+  // Adaptive ring depth with a latency target: the ring's low-water mark is
+  // checked every 0.5 s of playback, the allowance for it shrinks by half a
+  // device period after 20 clean windows, and audio above it is skipped
+  // across a short crossfade.
+  static constexpr size_t kRingWindowSamples =
+      static_cast<size_t>(SAMPLE_RATE) * CHANNELS / 2;
+  static constexpr uint32_t kRingCalmWindows = 20;
+  static constexpr size_t kRingTrimFadeFrames = 64;
 
   AudioOutput();
   ~AudioOutput();
 
+  // [audio] target_latency_ms (0 = off). Call before init(): it sizes the
+  // ALSA buffer and turns on the adaptive speaker-ring depth.
+  void setTargetLatencyMs(int targetLatencyMs);
+
   bool init(bool enableSpeaker, const std::string &wavFile,
             const std::string &deviceSelector = "", bool verboseLogging = true);
   void shutdown();
   void setVolumePercent(int volumePercent);
   static bool listDevices();
 
+  // Interleaved L/R frames (L0 R0 L1 R1 ...), the format both the speaker
+  // ring and the WAV encoder use internally.
+  bool writeInterleaved(const float *frames, size_t numFrames);
   bool write(const float *left, const float *right, size_t numSamples);
   void clearRealtimeQueue();
   bool isRunning() const { return m_running; }
+  // Audio written but not yet played: what waits in the speaker ring, and
+  // what the device reports still queued ahead of the DAC (ALSA only; 0
+  // elsewhere).
+  double speakerRingSeconds();
+  double deviceDelaySeconds() const;
 
 private:
   bool initWAV(const std::string &filename);
@@ -69,10 +89,12 @@ private:
   void runAlsaOutputThread();
   void clearSpeakerQueueLocked();
   void logSpeakerOverflow(const char *backendLabel, uint32_t count) const;
-  void pushSpeakerSamples(const float *left, const float *right, size_t numSamples,
-                         const char *backendLabel);
+  void pushSpeakerSamples(const float *frames, size_t numFrames,
+                          const char *backendLabel);
   size_t popSpeakerSamplesLocked(float *dest, size_t maxSamples);
-  bool enqueueWavSamples(const float *left, const float *right, size_t numSamples);
+  void trackSpeakerDepthLocked(size_t popSamples);
+  void trimSpeakerRingLocked(size_t dropSamples);
+  bool enqueueWavSamples(const float *frames, size_t numFrames);
   static bool listAlsaDevices();
 #if defined(__APPLE__) && defined(FM_TUNER_HAS_COREAUDIO)
   static bool listCoreAudioDevices();
@@ -100,8 +122,8 @@ private:
   bool m_verboseLogging;
   std::atomic<int> m_requestedVolumePercent;
   float m_currentVolumeScale;
-  std::vector<float> m_scaledLeftScratch;
-  std::vector<float> m_scaledRightScratch;
+  std::vector<float> m_interleaveScratch;
+  std::vector<float> m_scaledScratch;
   std::vector<float> m_speakerScratch;
   std::vector<int16_t> m_wavEncodeScratch;
   std::mutex m_speakerMutex;
@@ -110,6 +132,16 @@ private:
   size_t m_speakerReadPos;
   size_t m_speakerWritePos;
   size_t m_speakerSize;
+  // Adaptive depth state (see trackSpeakerDepthLocked), in samples; guarded
+  // by m_speakerMutex like the ring itself.
+  int m_targetLatencyMs;
+  bool m_speakerPrimed;
+  size_t m_ringAllowance;
+  size_t m_ringWindowMin;
+  size_t m_ringWindowPopped;
+  bool m_ringWindowStarved;
+  uint32_t m_ringCalmWindows;
+  std::atomic<long> m_deviceDelayFrames;
   std::mutex m_wavMutex;
   std::condition_variable m_wavCv;
   std::vector<int16_t> m_wavRing;
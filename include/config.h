@@ -8,13 +8,23 @@ struct Config {
   struct RTLTCPSection {
     std::string host = "localhost";
     uint16_t port = 1234;
+    // IQ rate asked of the RTL source. The demod runs at 256 kHz; any rate in
+    // [kMinSampleRate, kMaxSampleRate] is decimated / resampled down to it.
     uint32_t sample_rate = 256000;
+    static constexpr uint32_t kMinSampleRate = 256000;
+    static constexpr uint32_t kMaxSampleRate = 10000000;
   } rtl_tcp;
 
   struct AudioSection {
     std::string device;
     bool enable_audio = true;
     int startup_volume = 100;
+    // End-to-end (IQ to DAC) latency to aim for, in ms; 0 keeps the default
+    // large blocks and buffers. Otherwise clamped to the range below, and
+    // the DSP block size, speaker ring and device buffer are sized for it.
+    int target_latency_ms = 0;
+    static constexpr int kMinTargetLatencyMs = 20;
+    static constexpr int kMaxTargetLatencyMs = 500;
   } audio;
 
   struct SDRSection {
@@ -37,7 +47,7 @@ struct Config {
   } sdr;
 
   struct TunerSection {
-    std::string source = "rtl_sdr"; // rtl_sdr|rtl_tcp|sdrplay
+    std::string source = "rtl_sdr"; // rtl_sdr|rtl_tcp|sdrplay|file
     uint32_t rtl_device = 0;
     uint32_t default_freq = 87500;
     int deemphasis = 0;
@@ -56,6 +66,18 @@ struct Config {
     bool bias_tee = false;
   } sdrplay;
 
+  struct ReplaySection {
+    // IQ recording played back by the "file" source: raw u8 IQ as written by
+    // --iq, normalized CF32 or CS16.
+    // format: auto (by extension) | u8 | cf32 | cs16.
+    std::string file;
+    std::string format = "auto";
+    // true = pace at the IQ sample rate like a live tuner; false = as fast as
+    // the run loop can consume (benchmarks, batch reprocessing).
+    bool realtime = true;
+    bool loop = false;
+  } replay;
+
   struct RestSection {
     // Anonymous HTTP control API (for an fm-dx-webserver plugin). Disabled
     // unless a non-zero port is set. No authentication by design — bind to
@@ -75,11 +97,19 @@ struct Config {
     int agc_mode = 2;
     bool client_gain_allowed = true;
     int dsp_block_samples = 8192;
+    // 1 runs the whole DSP chain on the run loop thread. 2 moves it to a
+    // worker so it overlaps the sinks; 3 splits it again, IQ front end +
+    // demod on one worker and stereo / AF / squelch on another. Each worker
+    // stage delays the audio by one block.
+    int dsp_pipeline_stages = 1;
     int w0_bandwidth_hz = 194000;
     std::string dsp_agc = "off"; // off|fast|slow
     std::string stereo_blend = "aggressive";
     bool stereo = true;
     bool pilot_canceller = true;
+    // Run the stereo decoder and AF chain on a half-band decimated MPX (e.g.
+    // 128 kHz from 256 kHz). RDS, WAV and MPX outputs keep the full rate.
+    bool half_rate_mpx = false;
     std::string hicut = "off"; // off|gentle|strong
     std::string adaptive_bandwidth = "off"; // off|conservative|aggressive
     std::string multipath_eq = "off"; // off|light|aggressive
@@ -88,6 +118,14 @@ struct Config {
     // signal drops out (deep fade / dropout) and fades back in on recovery.
     // off (default) | gentle (only deep fades) | strong (mutes more readily).
     std::string fade_mute = "off";
+    // Telemetry-only meters (RDS deviation, demod hiss SNR). auto: run them
+    // only as often as their consumers need (REST polling, fade-mute, the
+    // signal meter); always: every block, for reference measurements.
+    std::string metering = "auto";
+    // SIMD kernel selection: "auto" (best the CPU supports), or a comma list
+    // of "<isa>" / "<kernel>:<isa>" ceilings, e.g. "scalar" or
+    // "channel_fir:avx2,resampler:scalar". See dsp/kernel_registry.h.
+    std::string kernels = "auto";
     // When true, the IQ channel FIR is L1-normalized at design time so that
     // |y[n]| ≤ max|x[n]| for every output sample. Defaults to false to
     // preserve existing meter calibration; enable when ADC-rail clipping is
@@ -98,6 +136,11 @@ struct Config {
     // where silence on empty channels is preferable to hiss. Hysteresis is
     // a fixed 3 dB above the open threshold.
     double squelch_dbfs = -120.0;
+    // While the squelch_dbfs gate is closed and faded out, skip the stereo
+    // decoder, AF chain and RDS and emit silence of the usual length; only
+    // the channel FIR and power estimate keep running to catch reopening.
+    // Not used with fade_mute, whose closes are short dropouts.
+    bool squelch_idle = false;
   } processing;
 
   struct DebugSection {
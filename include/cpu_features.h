@@ -12,6 +12,7 @@ struct CPUFeatures {
   bool avx = false;
   bool avx2 = false;
   bool fma = false;
+  bool avx512f = false;
 
   std::string summary() const;
 };
@@ -0,0 +1,55 @@
+#ifndef FM_TUNER_DSP_BLOCK_QUEUE_H
+#define FM_TUNER_DSP_BLOCK_QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+#include "spsc_ring.h"
+
+namespace fm_tuner::dsp {
+
+// Hands block slot indices from one pipeline stage to the next.
+//
+// The indices travel through a lock-free SpscRing; the mutex and condition
+// variable are only there so an empty consumer can sleep instead of spin, and
+// never guard the data. Sized for every slot in the pool, so push() always
+// fits.
+//
+// Thread roles:
+//   producer: push()
+//   consumer: pop(), tryPop(), waitForSize()
+//   either: size(), close()
+class BlockQueue {
+public:
+  BlockQueue() = default;
+  explicit BlockQueue(size_t slots) { reset(slots); }
+
+  BlockQueue(const BlockQueue &) = delete;
+  BlockQueue &operator=(const BlockQueue &) = delete;
+
+  // Empties the queue and reopens it; neither side may be using it.
+  void reset(size_t slots);
+
+  void push(size_t slot);
+  // Waits for a slot; false once close() has been called.
+  bool pop(size_t &slot);
+  bool tryPop(size_t &slot);
+  // Waits until at least count slots are queued (or the queue is closed).
+  void waitForSize(size_t count);
+  size_t size() const { return m_ring.readAvailable(); }
+
+  // Wakes every waiter and makes pop() fail from then on.
+  void close();
+
+private:
+  SpscRing<size_t> m_ring;
+  std::atomic<bool> m_closed{false};
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+};
+
+} // namespace fm_tuner::dsp
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef FM_TUNER_DSP_FIRST_ORDER_IIR_H
+#define FM_TUNER_DSP_FIRST_ORDER_IIR_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace fm_tuner::dsp {
+
+// Lanes independent first-order IIR sections stepped together, one input per
+// lane per call: the L/R (or L/R normal + L/R narrow) audio filters run as a
+// single short vector recursion instead of one liquid iirfilt per channel.
+// Lanes is 2 or 4, so the lane loops map onto one SSE / NEON register once the
+// compiler unrolls them.
+//
+// Each section is y = b0*x + s, s = b1*x - a1*y (transposed direct form II,
+// the form liquid's iirfilt uses for a two-tap b/a), with a0 normalized to 1.
+template <std::size_t Lanes> class FirstOrderIirBank {
+public:
+  void setLane(std::size_t lane, float b0, float b1, float a1) {
+    m_b0[lane] = b0;
+    m_b1[lane] = b1;
+    m_a1[lane] = a1;
+    m_state[lane] = 0.0f;
+  }
+  // Same parameterization as liquid's iirfilt_rrrf_create_dc_blocker().
+  void setDcBlockerLane(std::size_t lane, float alpha) {
+    const float g = std::sqrt(1.0f - alpha);
+    setLane(lane, g, -g, alpha - 1.0f);
+  }
+  void reset() { m_state.fill(0.0f); }
+
+  void step(const float *x, float *y) {
+    for (std::size_t k = 0; k < Lanes; k++) {
+      const float out = m_b0[k] * x[k] + m_state[k];
+      m_state[k] = m_b1[k] * x[k] - m_a1[k] * out;
+      y[k] = out;
+    }
+  }
+
+private:
+  alignas(16) std::array<float, Lanes> m_b0{};
+  alignas(16) std::array<float, Lanes> m_b1{};
+  alignas(16) std::array<float, Lanes> m_a1{};
+  alignas(16) std::array<float, Lanes> m_state{};
+};
+
+} // namespace fm_tuner::dsp
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef FM_TUNER_DSP_FM_FRONT_END_H
+#define FM_TUNER_DSP_FM_FRONT_END_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fm_tuner::dsp {
+
+// Block front-end of the FM demodulator: IQ -> float, I/Q DC blockers, the
+// channel FIR and the frequency discriminator, each run over a whole block
+// instead of one liquid call per stage per sample. Numerically it is the same
+// chain FMDemod used to build from liquid objects (iirfilt dc_blocker,
+// firfilt_crcf with the FIRFilter lowpass design, freqdem).
+//
+// The conversion/clip scan ("iq_convert") is AVX2 / NEON and the FIR
+// ("channel_fir") AVX2 / AVX-512 / NEON, with scalar fallbacks picked by the
+// kernel registry (kernel_registry.h). The DC blockers are a
+// first-order recursion and stay scalar (I and Q interleaved for ILP); the
+// discriminator is discriminateBlock() (polynomial atan2, see
+// phase_discriminator.h), within kFastAtan2MaxErrorRad of liquid's freqdem.
+class FmFrontEnd {
+public:
+  struct BlockStats {
+    size_t clipCount = 0; // samples with I or Q at the ADC rail
+    double powerSum = 0.0; // sum of |y|^2 after the channel FIR
+  };
+
+  // A channel FIR in the layout the kernel reads: time-reversed, pre-scaled,
+  // each tap duplicated for the I and Q lanes and zero padded to a multiple
+  // of kTapBlock. Immutable once built, so a designed set can be cached and
+  // shared, and switching filters is a pointer swap.
+  //
+  // `delay` is the group delay, in samples, the filter runs at: at least its
+  // own (length - 1) / 2, more by reading older input. Filters prepared with
+  // one common delay can be swapped without a step in time.
+  struct ChannelTaps {
+    size_t length = 0;
+    size_t delay = 0;
+    std::vector<float> interleaved;
+
+    // Input samples before the current one the filter reads.
+    size_t history() const { return length - 1 + delay - (length - 1) / 2; }
+  };
+
+  FmFrontEnd();
+
+  // Designed with liquid::designLowpassTaps(). delay 0 (or anything below
+  // the filter's own) is the filter's own.
+  static std::shared_ptr<const ChannelTaps>
+  designChannelTaps(std::uint32_t length, float cutoff, float stopBandAtten,
+                    bool l1Normalize, size_t delay = 0);
+  static std::shared_ptr<const ChannelTaps>
+  prepareChannelTaps(const std::vector<float> &taps, float scale,
+                     size_t delay = 0);
+
+  // Same parameterization as liquid's iirfilt_rrrf_create_dc_blocker().
+  void setDcBlocker(float alpha);
+  // Channel FIR, designed on the spot; see designChannelTaps().
+  void setChannelFilter(std::uint32_t length, float cutoff, float stopBandAtten,
+                        bool l1Normalize);
+  // Channel FIR from a prepared set; clears the FIR history.
+  void setChannelTaps(std::shared_ptr<const ChannelTaps> taps);
+  // Hot swap for a running filter: keeps the FIR history (the new filter
+  // sees the same past input, so there is no start-up transient) and
+  // crossfades linearly from the old filter's output to the new one's over
+  // crossfadeSamples, so the change in passband doesn't step. The fade is on
+  // the complex output: both filters need the same delay, or the two
+  // signals partly cancel on FM phase.
+  void swapChannelTaps(std::shared_ptr<const ChannelTaps> taps,
+                       size_t crossfadeSamples);
+  bool crossfading() const { return m_fadeRemaining > 0; }
+  // kf = deviation / sample rate, as liquid freqdem_create().
+  void setModulationFactor(float kf);
+  void reset();
+
+  size_t channelFilterLength() const { return m_channel->length; }
+
+  // u8 (RTL) or normalized CF32 in, channel-filtered baseband out.
+  BlockStats filter(const uint8_t *iq, size_t samples,
+                    std::complex<float> *out);
+  BlockStats filter(const std::complex<float> *iq, size_t samples,
+                    std::complex<float> *out);
+  // FM discriminator: out[i] = arg(conj(x[i-1]) * x[i]) / (2*pi*kf).
+  void discriminate(const std::complex<float> *in, size_t samples, float *out);
+
+private:
+  BlockStats dcBlockAndFilter(const float *in, size_t clipCount,
+                              size_t samples, std::complex<float> *out);
+  // `channel` over the block in m_history; returns sum |out|^2.
+  double runChannelFilter(const ChannelTaps &channel, size_t samples,
+                          std::complex<float> *out);
+  // Blends the fading-out filter into the head of `out`; returns the change
+  // in sum |out|^2.
+  double crossfade(size_t samples, std::complex<float> *out);
+
+  float m_dcAlpha = 0.0f;
+  float m_dcGain = 1.0f;
+  float m_dcPole = 1.0f;
+  float m_dcPrevInI = 0.0f;
+  float m_dcPrevInQ = 0.0f;
+  float m_dcPrevOutI = 0.0f;
+  float m_dcPrevOutQ = 0.0f;
+
+  std::shared_ptr<const ChannelTaps> m_channel;
+  // DC-blocked input: the last m_historyKeep samples of the previous block,
+  // then the current block, then zero padding for the padded taps.
+  // m_historyKeep is at least the filter's history(); after a swap it is the
+  // largest one seen, until the next reset.
+  std::vector<std::complex<float>> m_history;
+  size_t m_historyKeep = 0;
+  // Filter being faded out after swapChannelTaps(), and its output.
+  std::shared_ptr<const ChannelTaps> m_fadeFrom;
+  size_t m_fadeLength = 0;
+  size_t m_fadeRemaining = 0;
+  std::vector<std::complex<float>> m_fadeScratch;
+  // Converted, not yet DC-blocked input.
+  std::vector<float> m_raw;
+
+  float m_discriminatorGain = 1.0f;
+  std::complex<float> m_discriminatorPrev{0.0f, 0.0f};
+};
+
+} // namespace fm_tuner::dsp
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef FM_TUNER_DSP_HALF_BAND_DECIMATOR_H
+#define FM_TUNER_DSP_HALF_BAND_DECIMATOR_H
+
+#include <cstddef>
+#include <vector>
+
+namespace fm_tuner::dsp {
+
+// Side taps h[mid -/+ (2k + 1)], k = 0 .. K-1, of a Kaiser half-band lowpass
+// flat to passbandEdge (relative to its input rate, in (0, 0.25)) that
+// reaches stopBandAtten at 0.5 - passbandEdge. They sum to 1/2, so with a
+// centre tap of exactly 1/2 the DC gain is 1. The filter is 4K - 1 taps long.
+// Throws std::runtime_error for an edge outside (0, 0.25).
+std::vector<float> designHalfBandSideTaps(float passbandEdge,
+                                          float stopBandAtten);
+
+// Real decimate-by-2 half-band FIR for the MPX.
+//
+// Every other tap of a half-band lowpass is zero and the centre tap is 1/2,
+// so each output costs one multiply per pair of non-zero side taps (folded)
+// plus the centre. The same sums give the complementary high-pass for free:
+// low = c + s and high = c - s, where c is the centre-tap term and s is the
+// folded side-tap sum. At 256k -> 128k the high band is everything above
+// ~64 kHz (the noise triangle above the RDS subcarrier), which is exactly
+// what the stereo decoder's hiss meter measures. Power is preserved when that
+// band aliases down, so the meter can run on it at the lower rate.
+class HalfBandDecimator {
+public:
+  HalfBandDecimator() = default;
+
+  // passbandEdge is relative to the input rate and must be below 0.25; the
+  // filter is flat to it and reaches stopBandAtten at 0.5 - passbandEdge.
+  // Throws std::runtime_error for an edge outside (0, 0.25).
+  void init(float passbandEdge, float stopBandAtten = 70.0f);
+  void reset();
+  bool ready() const { return !m_sideTaps.empty(); }
+
+  size_t length() const {
+    return m_sideTaps.empty() ? 0 : 4 * m_sideTaps.size() - 1;
+  }
+  // Upper bound on what execute() produces for inSamples inputs.
+  static size_t maxOutput(size_t inSamples) { return inSamples / 2 + 1; }
+
+  // Keeps every second filtered sample, phase continuous across calls of any
+  // size. highBand may be null. Returns the number of samples written.
+  size_t execute(const float *in, size_t inSamples, float *out,
+                 float *highBand);
+
+private:
+  // h[mid -/+ (2k + 1)] for k = 0 .. K-1; the centre tap is 0.5.
+  std::vector<float> m_sideTaps;
+  // The last (length - 1) inputs, then the current block.
+  std::vector<float> m_history;
+  // True when the next input sample completes an output.
+  bool m_emitNext = false;
+};
+
+} // namespace fm_tuner::dsp
+
+#endif
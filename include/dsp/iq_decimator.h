@@ -0,0 +1,89 @@
+#ifndef FM_TUNER_DSP_IQ_DECIMATOR_H
+#define FM_TUNER_DSP_IQ_DECIMATOR_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fm_tuner::dsp {
+
+// Power-of-two IQ decimator for the high-rate front end (1.024 / 2.048 MS/s
+// down to the demod rate).
+//
+// A cascade of complex half-band stages, each decimating by two. Every stage
+// is flat to the same passband and only has to reject what would alias into
+// it, so the stages at the highest rates are short (15 and 19 taps at 80 dB
+// for 2.048 MS/s) and the final stage into the demod rate carries the sharp
+// transition. A stage splits its input into even and odd phases: the folded
+// side taps then read contiguous even-phase samples, so the kernel computes
+// several complex outputs per register ("half_band" in kernel_registry.h),
+// and the centre tap reads the odd phase.
+//
+// The uint8 path feeds the raw RTL bytes into the first stage, whose gain
+// and output offset fold in the (x - 127.5) / 127.5 normalization, so there
+// is no separate conversion pass.
+class IqDecimator {
+public:
+  IqDecimator() = default;
+
+  // factor is a power of two; 1 passes samples through. passbandEdge is
+  // relative to the output rate and must be in (0, 0.5): the response is flat
+  // to it and nothing that aliases below it is attenuated by less than
+  // stopBandAtten. Throws std::runtime_error otherwise.
+  void init(std::uint32_t factor, float passbandEdge,
+            float stopBandAtten = 80.0f);
+  void reset();
+  bool ready() const { return m_factor > 0; }
+  std::uint32_t factor() const { return m_factor; }
+  size_t stageCount() const { return m_stages.size(); }
+  // Taps of stage `stage` (0 = first, highest rate), zeros included.
+  size_t stageLength(size_t stage) const;
+  // Real multiplies the cascade spends per complex input sample.
+  double multipliesPerInputSample() const;
+
+  // Phase continuous across calls of any size. Writes at most outCapacity
+  // samples (inSamples / factor when the inputs so far are whole multiples of
+  // factor) and returns how many. Don't mix the two input types without a
+  // reset() in between.
+  size_t execute(const uint8_t *iq, size_t inSamples,
+                 std::complex<float> *out, size_t outCapacity);
+  size_t execute(const std::complex<float> *iq, size_t inSamples,
+                 std::complex<float> *out, size_t outCapacity);
+
+private:
+  struct Stage {
+    // h[mid -/+ (2k + 1)] for k = 0 .. K-1; the centre tap is 0.5.
+    std::vector<float> sideTaps;
+    // Even and odd input phases, interleaved I/Q: the last (2K - 1) samples
+    // of each, then the current block.
+    std::vector<float> even;
+    std::vector<float> odd;
+    // An input sample still waiting for its odd partner.
+    float pending[2] = {0.0f, 0.0f};
+    bool hasPending = false;
+
+    size_t keep() const { return 2 * sideTaps.size() - 1; }
+  };
+
+  // Appends interleaved I/Q samples to a stage's phases; returns the number
+  // of complete even/odd pairs (= outputs) now queued.
+  static size_t split(Stage &stage, const float *iq, size_t samples);
+  static size_t splitU8(Stage &stage, const uint8_t *iq, size_t samples);
+  // Runs the pairs queued in the first stage, then every later stage, and
+  // writes the final outputs.
+  size_t runCascade(size_t pairs, float firstGain, float firstOffset,
+                    std::complex<float> *out, size_t outCapacity);
+
+  std::uint32_t m_factor = 0;
+  std::vector<Stage> m_stages;
+  // The first stage's history holds raw bytes (primed to the 127.5 bias, so
+  // a fresh decimator starts from silence on either input type).
+  bool m_rawHistory = false;
+  // Ping-pong buffers for the interleaved output of the inner stages.
+  std::vector<float> m_scratch[2];
+};
+
+} // namespace fm_tuner::dsp
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef FM_TUNER_DSP_IQ_RATE_CONVERTER_H
+#define FM_TUNER_DSP_IQ_RATE_CONVERTER_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dsp/iq_decimator.h"
+#include "dsp/polyphase_resampler.h"
+
+namespace fm_tuner::dsp {
+
+// IQ front end from any source rate at or above the demod rate down to it.
+//
+// Half-band stages (IqDecimator) take the rate down by the largest power of
+// two that stays at or above the output rate; when that doesn't land exactly
+// on it (2.4 MS/s / 8 = 300 kHz, 1.92 MS/s / 4 = 480 kHz), a polyphase
+// resampler covers the remaining ratio, below 2:1, with I and Q on one phase
+// walk. Its filter only has to keep the passband and reject what folds into
+// it, so the cheapest setup is the one that leaves the resampler the lowest
+// rate. A ratio that needs more than PolyphaseResampler::kMaxInterpolation
+// branches uses the closest one that doesn't: the output rate is then off
+// by a fraction of a ppm, well inside any tuner's crystal error.
+class IqRateConverter {
+public:
+  IqRateConverter() = default;
+
+  // passbandHz must be below outputRate / 2. Throws std::runtime_error for an
+  // inputRate below outputRate or an impossible passband.
+  void init(std::uint32_t inputRate, std::uint32_t outputRate,
+            float passbandHz, float stopBandAtten = 80.0f);
+  void reset();
+  bool ready() const { return m_decimator.ready(); }
+
+  std::uint32_t halfBandFactor() const { return m_decimator.factor(); }
+  bool fractional() const { return m_fractional; }
+  // The rate the output really has: outputRate unless the ratio had to be
+  // approximated.
+  double actualOutputRate() const;
+  // Inputs per block such that no block yields more than outputBlock
+  // samples. The average yield is just below outputBlock when fractional.
+  size_t inputBlockFor(size_t outputBlock) const;
+  // Real multiplies per complex input sample, half-bands plus resampler.
+  double multipliesPerInputSample() const;
+  // "2400000 -> 300000 (3 half-band stages) -> 256000 (resampler 64/75,
+  // 48 taps/branch), 17.3 mult/sample" for the startup log.
+  std::string summary() const;
+
+  // Phase continuous across calls of any size. Writes at most outCapacity
+  // samples and returns how many. Don't mix the two input types without a
+  // reset() in between.
+  size_t execute(const uint8_t *iq, size_t inSamples,
+                 std::complex<float> *out, size_t outCapacity);
+  size_t execute(const std::complex<float> *iq, size_t inSamples,
+                 std::complex<float> *out, size_t outCapacity);
+
+private:
+  size_t resample(size_t samples, std::complex<float> *out,
+                  size_t outCapacity);
+
+  std::uint32_t m_inputRate = 0;
+  std::uint32_t m_outputRate = 0;
+  bool m_fractional = false;
+  IqDecimator m_decimator;
+  PolyphaseResampler m_resampler;
+  // Half-band output, then split into I and Q for the resampler, and its
+  // interleaved (= complex) output frames.
+  std::vector<std::complex<float>> m_decimated;
+  std::vector<float> m_inI;
+  std::vector<float> m_inQ;
+  std::vector<float> m_frames;
+};
+
+} // namespace fm_tuner::dsp
+
+#endif
@@ -18,6 +18,17 @@ inline constexpr bool isRtlSdrIqByteSaturated(std::uint8_t b) {
   return b <= kRtlSdrIqLowSaturated || b >= kRtlSdrIqHighSaturated;
 }
 
+// "Near clip" band for the meter: within ~6% of full scale.
+inline constexpr std::uint8_t kRtlSdrIqLowNearClip = 8;
+inline constexpr std::uint8_t kRtlSdrIqHighNearClip = 247;
+
+// Normalized CF32 sources (SDRplay: int16 / 32768). The same rule as above —
+// the last two codes below full scale count as saturated — and a near-clip
+// magnitude matching the u8 band, so both paths meter alike.
+inline constexpr float kCf32IqSaturated = 32766.0f / 32768.0f;
+inline constexpr float kCf32IqNearClip =
+    (static_cast<float>(kRtlSdrIqHighNearClip) - 127.5f) / 127.5f;
+
 } // namespace fm_tuner::dsp
 
 #endif
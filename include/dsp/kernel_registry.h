@@ -0,0 +1,66 @@
+#ifndef FM_TUNER_DSP_KERNEL_REGISTRY_H
+#define FM_TUNER_DSP_KERNEL_REGISTRY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fm_tuner::dsp {
+
+// Instruction-set variants of a kernel, in ascending order: an override names
+// a ceiling, and the kernel runs the best variant at or below it that the
+// build compiled and the CPU supports.
+enum class KernelIsa : std::uint8_t { Scalar = 0, Neon = 1, Avx2 = 2, Avx512 = 3 };
+constexpr std::size_t kKernelIsaCount = 4;
+
+// Every runtime-dispatched hot loop, by the name used in overrides and logs.
+enum class KernelId : std::uint8_t {
+  IqConvert = 0,     // "iq_convert": u8 -> float + clip count, CF32 clip scan
+  ChannelFir = 1,    // "channel_fir": complex channel FIR (FmFrontEnd)
+  Discriminator = 2, // "discriminator": block FM discriminator
+  Resampler = 3,     // "resampler": polyphase branch dot products
+  RealFir = 4,       // "real_fir": pilot / RDS band-pass FIRs
+  MultipathEq = 5,   // "multipath_eq": CMA convolution + update
+  PowerSum = 6,      // "power_sum": CF32 IQ power / moment sums (meter)
+  HalfBand = 7,      // "half_band": complex half-band IQ decimator stages
+};
+constexpr std::size_t kKernelCount = 8;
+
+const char *kernelIdName(KernelId id);
+const char *kernelIsaName(KernelIsa isa);
+
+// The variant `id` runs right now. The first call detects the CPU and picks
+// the best supported variant for every kernel.
+KernelIsa kernelIsa(KernelId id);
+
+// Apply an override spec: "auto", or a comma list of "<isa>" (all kernels)
+// and "<kernel>:<isa>" entries, applied left to right, where isa is
+// auto|scalar|neon|avx2|avx512. Kernels not named run the best variant.
+// Returns false (selection unchanged) and fills `error` for an unknown
+// kernel or ISA. Takes effect on the next block each kernel runs.
+bool setKernelOverrides(const std::string &spec, std::string &error);
+
+// "iq_convert=avx2 channel_fir=avx512 ..." for the startup log.
+std::string kernelSelectionSummary();
+
+// Per-kernel function-pointer table indexed by ISA. Start from the scalar
+// variant, set() the ones this build compiled; select() returns the one the
+// registry picked.
+template <typename T> class KernelTable {
+public:
+  explicit KernelTable(T scalar) { m_variants.fill(scalar); }
+  void set(KernelIsa isa, T variant) {
+    m_variants[static_cast<std::size_t>(isa)] = variant;
+  }
+  const T &select(KernelId id) const {
+    return m_variants[static_cast<std::size_t>(kernelIsa(id))];
+  }
+
+private:
+  std::array<T, kKernelIsaCount> m_variants;
+};
+
+} // namespace fm_tuner::dsp
+
+#endif
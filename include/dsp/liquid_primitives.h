@@ -17,6 +17,22 @@ extern "C" {
 
 namespace fm_tuner::dsp::liquid {
 
+// Every per-sample execute() below has an executeBlock() twin that hands a
+// whole buffer to liquid's *_execute_block function (one call and one state
+// load per block instead of per sample). Same results sample for sample; in
+// may equal out unless noted.
+
+// Kaiser lowpass taps exactly as FIRFilter::init(length, cutoff, atten, 0,
+// l1Normalize) designs them, for block kernels that run their own FIR.
+// Returns the output scale FIRFilter would apply (see its l1Normalize note).
+float designLowpassTaps(std::uint32_t length, float cutoff, float stopBandAtten,
+                        bool l1Normalize, std::vector<float> &taps);
+// Real band-pass taps exactly as FIRFilter::init(length, cutoff, atten,
+// center) designs them: the Kaiser lowpass shifted to +/-center and
+// L1-normalized (unit scale). Symmetric for odd lengths.
+void designBandpassTaps(std::uint32_t length, float cutoff, float stopBandAtten,
+                        float center, std::vector<float> &taps);
+
 class AGC {
 public:
   AGC() = default;
@@ -29,6 +45,8 @@ public:
   void init(float bandwidth, float initialGain);
   void reset();
   std::complex<float> execute(std::complex<float> sample) const;
+  void executeBlock(const std::complex<float> *input, std::size_t count,
+                    std::complex<float> *output) const;
   bool ready() const { return m_object != nullptr; }
 
 private:
@@ -61,6 +79,9 @@ public:
   void reset();
   void push(std::complex<float> sample) const;
   std::complex<float> execute() const;
+  // push() + execute() for each input sample.
+  void executeBlock(const std::complex<float> *input, std::size_t count,
+                    std::complex<float> *output) const;
   std::size_t length() const;
   bool ready() const { return m_object != nullptr; }
 
@@ -91,6 +112,9 @@ public:
   void setPLLBandwidth(float bandwidth) const;
   void stepPLL(float phaseError) const;
   float phase() const;
+  // output[i] = input[i] * exp(-j*phase), stepping the oscillator per sample.
+  void mixBlockDown(const std::complex<float> *input, std::size_t count,
+                    std::complex<float> *output) const;
   bool ready() const { return m_object != nullptr; }
 
 private:
@@ -111,6 +135,8 @@ public:
   void init(float modulationFactor);
   void reset();
   float execute(std::complex<float> sample) const;
+  void executeBlock(const std::complex<float> *input, std::size_t count,
+                    float *output) const;
   bool ready() const { return m_object != nullptr; }
 
 private:
@@ -136,6 +162,7 @@ public:
                     float stopBandAtten = 60.0f);
   void reset();
   float execute(float input) const;
+  void executeBlock(const float *input, std::size_t count, float *output) const;
   bool ready() const { return m_object != nullptr; }
 
 private:
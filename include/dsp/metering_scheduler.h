@@ -0,0 +1,60 @@
+#ifndef FM_TUNER_DSP_METERING_SCHEDULER_H
+#define FM_TUNER_DSP_METERING_SCHEDULER_H
+
+#include <cstddef>
+
+namespace fm_tuner::dsp {
+
+// Block-level duty cycle for estimators that only feed telemetry (RDS
+// deviation, hiss SNR): they do not touch the audio, so nothing is lost by
+// running them on a subset of blocks and holding the value in between.
+//
+//   Always     every block (the original behaviour);
+//   DutyCycled one block, then skip until intervalSamples have gone by, so a
+//              fresh reading lands at least every interval;
+//   Off        never; the reading is frozen until the mode changes.
+//
+// The first block after reset() or a mode change is always metered, so a
+// consumer that switches the meter on gets a fresh value on the next block.
+class MeteringScheduler {
+public:
+  enum class Mode { Off, DutyCycled, Always };
+
+  void configure(Mode mode, size_t intervalSamples) {
+    m_intervalSamples = intervalSamples;
+    if (mode != m_mode) {
+      m_mode = mode;
+      reset();
+    }
+  }
+  void reset() { m_idleSamples = m_intervalSamples; }
+
+  Mode mode() const { return m_mode; }
+
+  // Decide for the next block of `samples`: true = run the estimator on it.
+  bool beginBlock(size_t samples) {
+    switch (m_mode) {
+    case Mode::Always:
+      return true;
+    case Mode::Off:
+      return false;
+    case Mode::DutyCycled:
+      break;
+    }
+    if (m_idleSamples >= m_intervalSamples) {
+      m_idleSamples = 0;
+      return true;
+    }
+    m_idleSamples += samples;
+    return false;
+  }
+
+private:
+  Mode m_mode = Mode::Always;
+  size_t m_intervalSamples = 0;
+  size_t m_idleSamples = 0;
+};
+
+} // namespace fm_tuner::dsp
+
+#endif
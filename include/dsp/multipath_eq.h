@@ -21,6 +21,14 @@ enum class MultipathEqMode : std::uint8_t { Off = 0, Light = 1, Aggressive = 2 }
 //  - Step size is small to stay stable in the presence of FM signal dynamics.
 //  - 16-tap default keeps latency low (~62 µs at 256 kHz) and preserves group
 //    delay relative to the rest of the chain.
+//
+// The recursion is inherently per sample (each output trains the taps for the
+// next one), but both halves of a step are contiguous: the history is a
+// linear buffer (last N-1 inputs, then the current block, split into I and Q
+// arrays) and the taps are stored time reversed, so the convolution is one
+// dot product and the update one axpy over the same span. Both are AVX2 /
+// NEON kernels with a scalar fallback, picked by the kernel registry
+// ("multipath_eq", see kernel_registry.h).
 class MultipathEqualizer {
 public:
   MultipathEqualizer();
@@ -32,6 +40,9 @@ public:
 
   // Returns the equalized sample. If mode is Off, returns input unchanged.
   std::complex<float> execute(std::complex<float> input);
+  // Equalize a block; in == out is allowed. If mode is Off, copies.
+  void executeBlock(const std::complex<float> *in, std::complex<float> *out,
+                    size_t samples);
 
   // Diagnostics — exposed so tests and the signal-level logger can see how the
   // equalizer is behaving. Average over the most recent ~kEnvFilterTaps samples.
@@ -49,9 +60,13 @@ private:
   bool m_adaptEnabled = false;
   bool m_targetPrimed = false;
 
-  std::vector<std::complex<float>> m_taps;
-  std::vector<std::complex<float>> m_history;
-  std::uint32_t m_writePos = 0;
+  // Taps time reversed: m_tapsRe/Im[N-1-k] multiplies x[n-k], so the centre
+  // tap sits at index N/2 either way.
+  std::vector<float> m_tapsRe;
+  std::vector<float> m_tapsIm;
+  // The last (N - 1) inputs, then the current block.
+  std::vector<float> m_historyRe;
+  std::vector<float> m_historyIm;
   // Running EMA of |x|². The CMA target tracks this so the equalizer is
   // dispersion-form (minimizes envelope variance) rather than absolute-level.
   // On a clean FM signal (already constant envelope) the error stays near
@@ -0,0 +1,63 @@
+#ifndef FM_TUNER_DSP_PILOT_PLL_H
+#define FM_TUNER_DSP_PILOT_PLL_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fm_tuner::dsp {
+
+// 19 kHz pilot PLL on a uint32_t phase accumulator.
+//
+// Same loop as the liquid nco_crcf PLL it replaces (frequency += alpha*err,
+// phase += beta*err, then one oscillator step; alpha = bandwidth, beta =
+// sqrt(bandwidth)), but the phase is a plain modulo-2^32 integer: no float
+// wrap/constrain per sample, and the top bits index the 1024-entry sin/cos
+// table directly. Harmonic references are exact too: 2*phase and 3*phase wrap
+// for free, so the 38 kHz and 57 kHz carriers need no extra accumulator.
+//
+// The loop only sees the band-passed pilot, so a whole block is run up front
+// and the per-sample results land in caller-owned vectors.
+class PilotPll {
+public:
+  // Per-sample outputs, each `samples` long. Any pointer except mixedI /
+  // mixedQ may be null when the caller does not need it.
+  struct Block {
+    // pilot * conj(vco) at the phase before the step (phase detector input).
+    float *mixedI = nullptr;
+    float *mixedQ = nullptr;
+    // Phase advance of this sample in rad/sample (loop frequency + the
+    // proportional correction).
+    float *freq = nullptr;
+    // Carriers at the phase after the step.
+    float *cos19 = nullptr;
+    float *sin19 = nullptr;
+    float *cos38 = nullptr;
+    float *sin38 = nullptr;
+    float *cos57 = nullptr;
+    float *sin57 = nullptr;
+  };
+
+  PilotPll() = default;
+
+  // Nominal frequency in rad/sample; reset() returns to it.
+  void init(float angularFrequency);
+  void reset();
+  // Loop bandwidth in liquid's normalized units (kept for the gear shift).
+  void setBandwidth(float bandwidth);
+
+  void process(const float *pilot, size_t samples, const Block &out);
+
+  float phase() const;
+  float frequency() const;
+
+private:
+  std::uint32_t m_nominalFreq = 0;
+  std::uint32_t m_phase = 0;
+  std::uint32_t m_freq = 0;
+  float m_alpha = 0.0f;
+  float m_beta = 0.0f;
+};
+
+} // namespace fm_tuner::dsp
+
+#endif
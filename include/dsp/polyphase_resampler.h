@@ -0,0 +1,113 @@
+#ifndef FM_TUNER_DSP_POLYPHASE_RESAMPLER_H
+#define FM_TUNER_DSP_POLYPHASE_RESAMPLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fm_tuner::dsp {
+
+// Exact rational L/M polyphase resampler for real audio / MPX streams.
+//
+// Replaces liquid's resamp_rrrf, which runs one call per input sample and
+// tracks an arbitrary (float) ratio with a 32/64-branch filterbank. Here the
+// rates are reduced to L/M once, the prototype lowpass is split into exactly
+// L branches, and execute() walks a whole block. The phase walk is
+// instantiated at compile time for the ratios the tuner runs all the time
+// (256k -> 48k = 3/16 audio, 128k -> 48k = 3/8 half-rate audio, 256k -> 192k
+// = 3/4 MPX, and 1/1 as a plain copy); anything else uses the same loop with
+// a runtime L/M. The branch dot products are AVX2 / AVX-512 / NEON with a
+// scalar fallback ("resampler" in kernel_registry.h).
+//
+// Filter parameterization follows liquid's resampler: 2 * halfLength taps per
+// branch (the span in input samples), Kaiser window, cutoff relative to the
+// input rate. The default cutoff band-limits to 0.47 of the lower of the two
+// Nyquist rates, so decimation never folds.
+class PolyphaseResampler {
+public:
+  // Denominator limit for the reduced ratio; 44.1k-family conversions from
+  // 256k need L = 441.
+  static constexpr std::uint32_t kMaxInterpolation = 1024;
+
+  PolyphaseResampler() = default;
+
+  // Throws std::runtime_error for a zero rate or a ratio whose reduced L
+  // exceeds kMaxInterpolation. cutoff <= 0 picks the default.
+  void init(std::uint32_t inputRate, std::uint32_t outputRate,
+            std::uint32_t halfLength = 12, float cutoff = 0.0f,
+            float stopBandAtten = 60.0f);
+  void reset();
+  bool ready() const { return m_interp != 0; }
+
+  std::uint32_t interpolation() const { return m_interp; }
+  std::uint32_t decimation() const { return m_decim; }
+  // Taps per branch (zero padded); each output is one dot product this long.
+  size_t branchTaps() const { return m_branchTaps; }
+
+  // Upper bound on what execute() produces for inSamples inputs.
+  size_t maxOutput(size_t inSamples) const;
+  // Resample a block; out must hold maxOutput(inSamples). Returns the number
+  // of samples written.
+  size_t execute(const float *in, size_t inSamples, float *out);
+  // Two channels on one phase walk: each branch is loaded once for both dot
+  // products and L/R can never drift apart. outFrames is interleaved
+  // (L0 R0 L1 R1 ...) and must hold 2 * maxOutput(inSamples). Returns frames.
+  size_t executeStereo(const float *inLeft, const float *inRight,
+                       size_t inSamples, float *outFrames);
+  // Mono input to interleaved frames (both lanes equal), one dot product per
+  // output. The right history is caught up on the next executeStereo().
+  size_t executeMonoToStereo(const float *in, size_t inSamples,
+                             float *outFrames);
+
+  // Delay of the linear-phase prototype, exact (not rounded): an input
+  // impulse at input time t emerges centred at output time
+  // (t + groupDelayInputSamples()) * L / M.
+  double groupDelayInputSamples() const;
+  double groupDelayOutputSamples() const {
+    return groupDelayInputSamples() * static_cast<double>(m_interp) /
+           static_cast<double>(m_decim == 0 ? 1 : m_decim);
+  }
+
+private:
+  // Phase walk over the current history: emit(branch, inputIndex, n) for
+  // every output n. Instantiated per ratio so the divisions are constant.
+  template <std::uint32_t L, std::uint32_t M, typename Emit>
+  size_t walk(size_t inSamples, Emit &&emit);
+  template <typename Emit> size_t dispatchWalk(size_t inSamples, Emit &&emit);
+  static void appendHistory(std::vector<float> &history, size_t keep,
+                            const float *in, size_t inSamples);
+  static void trimHistory(std::vector<float> &history, size_t keep,
+                          size_t inSamples);
+
+  enum class Kind {
+    Passthrough,
+    Ratio3Over16,
+    Ratio3Over8,
+    Ratio3Over4,
+    Generic
+  };
+
+  Kind m_kind = Kind::Passthrough;
+  std::uint32_t m_interp = 0;
+  std::uint32_t m_decim = 1;
+  // Taps per branch, zero padded to the SIMD width.
+  size_t m_branchTaps = 0;
+  size_t m_prototypeLength = 0;
+  // Branch p holds h[p + k*L] for k = branchTaps-1 .. 0 (time reversed), so
+  // each output is one contiguous dot product over the history.
+  std::vector<float> m_branches;
+  // The last (branchTaps - 1) inputs, then the current block. The right
+  // history is only used by executeStereo().
+  std::vector<float> m_history;
+  std::vector<float> m_historyRight;
+  // executeMonoToStereo() ran since the last stereo block: m_historyRight is
+  // stale and the left one holds what both channels saw.
+  bool m_rightFollowsLeft = false;
+  // Position of the next output on the L-times-oversampled time axis,
+  // relative to the first sample of the next block.
+  std::uint64_t m_nextTime = 0;
+};
+
+} // namespace fm_tuner::dsp
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef FM_TUNER_DSP_REAL_FIR_FILTER_H
+#define FM_TUNER_DSP_REAL_FIR_FILTER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace fm_tuner::dsp {
+
+// Block FIR with real taps on a real stream.
+//
+// liquid only offers firfilt_crcf/cccf for the shifted band-pass designs, so a
+// real MPX run through FIRFilter pays for a complex input (zero imaginary part)
+// and a complex output whose imaginary part is always zero: two MACs per tap
+// where one does. This keeps the taps and the stream real and runs the block
+// as contiguous dot products (AVX2 / AVX-512 / NEON with a scalar fallback,
+// "real_fir" in kernel_registry.h).
+//
+// setTaps() takes the taps in natural order, with the same scale semantics as
+// firfilt_crcf_set_scale(): y[n] = scale * sum_k h[k] x[n-k].
+class RealFirFilter {
+public:
+  RealFirFilter() = default;
+
+  void setTaps(const std::vector<float> &taps, float scale = 1.0f);
+  void reset();
+
+  size_t length() const { return m_length; }
+  // (length - 1) / 2: exact for the odd, symmetric designs used here.
+  size_t groupDelay() const { return m_length > 0 ? (m_length - 1) / 2 : 0; }
+
+  // out may alias in.
+  void executeBlock(const float *in, size_t samples, float *out);
+
+private:
+  size_t m_length = 0;
+  // Time-reversed, pre-scaled taps, zero padded at the front to a multiple of
+  // the SIMD width, so each output is one dot product over the history.
+  std::vector<float> m_taps;
+  // The last (padded taps - 1) inputs, then the current block.
+  std::vector<float> m_history;
+};
+
+} // namespace fm_tuner::dsp
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef FM_TUNER_DSP_SIMD_DOT_H
+#define FM_TUNER_DSP_SIMD_DOT_H
+
+#include "dsp/kernel_registry.h"
+#include "dsp/simd_target.h"
+
+#include <cstddef>
+
+namespace fm_tuner::dsp {
+
+// Real dot product shared by RealFirFilter (one per output sample) and the
+// polyphase resampler (one per output, against the branch the phase picks).
+//
+// count must be a multiple of kDotTapBlock (one AVX2 vector, two NEON
+// vectors); both callers zero-pad their taps to it.
+constexpr std::size_t kDotTapBlock = 8;
+
+using DotFn = float (*)(const float *taps, const float *x, std::size_t count);
+
+// Scalar / AVX2 / AVX-512 / NEON variants, registered once. Callers select()
+// with their own KernelId, so "real_fir" and "resampler" overrides stay
+// independent.
+const KernelTable<DotFn> &dotKernels();
+
+// Horizontal reductions for the FIR-style kernels (dot products, the channel
+// FIR, the multipath EQ convolution).
+#if FM_TUNER_SIMD_AVX2
+// 8 -> 4 lanes: lane k + lane k + 4.
+FM_TUNER_AVX2_TARGET inline __m128 foldAvx2(__m256 v) {
+  return _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+}
+
+FM_TUNER_AVX2_TARGET inline float hsumAvx2(__m256 v) {
+  __m128 sum = foldAvx2(v);
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+  return _mm_cvtss_f32(sum);
+}
+#endif
+
+#if FM_TUNER_SIMD_AVX512
+// Lower half of a zmm: taps padded to an odd number of 8-float blocks end in
+// a masked half-width load.
+constexpr __mmask16 kHalfTail = 0x00FF;
+
+// 16 -> 8 lanes: lane k + lane k + 8. The zero-masked extracts compile to the
+// plain vextractf64x4; the unmasked forms (and _mm512_reduce_add_ps, built
+// on them) merge into an undefined register that GCC flags as uninitialized.
+FM_TUNER_AVX512_TARGET inline __m256 foldAvx512(__m512 v) {
+  const __m512d d = _mm512_castps_pd(v);
+  return _mm256_add_ps(
+      _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, d, 0)),
+      _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, d, 1)));
+}
+
+FM_TUNER_AVX512_TARGET inline float hsumAvx512(__m512 v) {
+  return hsumAvx2(foldAvx512(v));
+}
+#endif
+
+#if FM_TUNER_SIMD_NEON
+inline float hsumNeon(float32x4_t v) {
+  const float32x2_t pair = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+  return vget_lane_f32(vpadd_f32(pair, pair), 0);
+}
+#endif
+
+} // namespace fm_tuner::dsp
+
+#endif
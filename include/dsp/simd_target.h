@@ -0,0 +1,55 @@
+#ifndef FM_TUNER_DSP_SIMD_TARGET_H
+#define FM_TUNER_DSP_SIMD_TARGET_H
+
+// Which SIMD kernel variants this build compiles, and the per-function target
+// attributes they need. The binary itself is built for the baseline ISA (SSE2
+// on x86-64, NEON on aarch64); AVX2 / AVX-512 code is compiled function by
+// function and only called after the kernel registry picked it for the CPU
+// at hand (see kernel_registry.h), so one package runs on any host.
+//
+//   FM_TUNER_SIMD_NEON    NEON variants (ARM)
+//   FM_TUNER_SIMD_AVX2    AVX2 + FMA variants, FM_TUNER_AVX2_TARGET
+//   FM_TUNER_SIMD_AVX512  AVX-512F variants, FM_TUNER_AVX512_TARGET
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||             \
+    defined(_M_IX86)
+#include <immintrin.h>
+#if defined(__has_attribute)
+#if __has_attribute(target)
+#define FM_TUNER_SIMD_AVX2 1
+#define FM_TUNER_AVX2_TARGET __attribute__((target("avx2,fma")))
+#define FM_TUNER_SIMD_AVX512 1
+#define FM_TUNER_AVX512_TARGET __attribute__((target("avx512f,avx2,fma")))
+#endif
+#elif defined(__GNUC__)
+#define FM_TUNER_SIMD_AVX2 1
+#define FM_TUNER_AVX2_TARGET __attribute__((target("avx2,fma")))
+#define FM_TUNER_SIMD_AVX512 1
+#define FM_TUNER_AVX512_TARGET __attribute__((target("avx512f,avx2,fma")))
+#endif
+// MSVC emits any intrinsic regardless of /arch, so no attribute is needed.
+#if !defined(FM_TUNER_SIMD_AVX2) && defined(_MSC_VER)
+#define FM_TUNER_SIMD_AVX2 1
+#define FM_TUNER_AVX2_TARGET
+#define FM_TUNER_SIMD_AVX512 1
+#define FM_TUNER_AVX512_TARGET
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(__arm__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define FM_TUNER_SIMD_NEON 1
+#else
+#define FM_TUNER_SIMD_NEON 0
+#endif
+
+#ifndef FM_TUNER_SIMD_AVX2
+#define FM_TUNER_SIMD_AVX2 0
+#define FM_TUNER_AVX2_TARGET
+#endif
+#ifndef FM_TUNER_SIMD_AVX512
+#define FM_TUNER_SIMD_AVX512 0
+#define FM_TUNER_AVX512_TARGET
+#endif
+
+#endif
@@ -173,10 +173,32 @@ public:
     }
   }
 
+  // Same gate on interleaved L/R frames; one gain step per frame.
+  void processInterleaved(float *frames, std::size_t numFrames) {
+    if (!frames || numFrames == 0) {
+      return;
+    }
+    if (!m_adaptive && m_openDbfs <= -119.0f) {
+      return;
+    }
+    const float target = m_isOpen ? 1.0f : 0.0f;
+    for (std::size_t i = 0; i < numFrames; ++i) {
+      m_gain += m_rampAlpha * (target - m_gain);
+      frames[2 * i] *= m_gain;
+      frames[2 * i + 1] *= m_gain;
+    }
+  }
+
   bool isOpen() const { return m_isOpen; }
   float currentGain() const { return m_gain; }
+  // Closed and faded all the way out: the output is silence, so a caller may
+  // skip producing the audio it would only multiply by zero.
+  bool isSilent() const { return !m_isOpen && m_gain < kSilentGain; }
 
 private:
+  // -80 dB: below one LSB of 16-bit output at full scale.
+  static constexpr float kSilentGain = 1e-4f;
+
   float m_openDbfs = -120.0f; // disabled sentinel
   float m_closeDbfs = -120.0f;
   float m_hysteresisDb = 3.0f;
@@ -1,25 +1,33 @@
 #ifndef DSP_PIPELINE_H
 #define DSP_PIPELINE_H
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "af_post_processor.h"
 #include "config.h"
+#include "dsp/block_queue.h"
 #include "dsp/liquid_primitives.h"
+#include "dsp/half_band_decimator.h"
+#include "dsp/iq_rate_converter.h"
 #include "dsp/squelch.h"
 #include "fm_demod.h"
+#include "signal_level.h"
 #include "stereo_decoder.h"
 
 class DspPipeline {
 public:
   struct Result {
-    float *left = nullptr;
-    float *right = nullptr;
+    // Interleaved L/R output frames (L0 R0 L1 R1 ...), outSamples frames.
+    float *audio = nullptr;
     size_t outSamples = 0;
     size_t demodSamples = 0;
     bool stereoDetected = false;
@@ -37,47 +45,161 @@ public:
     // Demod-domain SNR/quality in dB (noise-triangle hiss band). Always finite;
     // a reception-quality figure, not a calibrated absolute.
     float demodSnrDb = 0.0f;
+    // processing.squelch_idle with the gate closed: audio is silence and only
+    // channelPowerDbfs was measured; the stereo, MPX and SNR figures read 0.
+    bool idle = false;
+    // The arrival time and signal level passed to process() with this
+    // block's IQ, so a caller can time and meter it in step with the audio
+    // across the pipelined mode's delay.
+    std::chrono::steady_clock::time_point arrival{};
+    SignalLevelResult signal;
   };
 
+  // One worker stage of the pipelined mode, over the window since the
+  // previous takePipelineStats().
+  struct StageStats {
+    const char *name = "";
+    uint64_t blocks = 0;
+    // Share of the window spent processing: near 1.0 is the bottleneck.
+    double busyRatio = 0.0;
+    // Blocks still queued behind the one the stage picked up; 0 means it
+    // keeps up with its input.
+    double meanQueueDepth = 0.0;
+    size_t maxQueueDepth = 0;
+  };
+  struct PipelineStats {
+    double seconds = 0.0;
+    std::vector<StageStats> stages;
+    // Share of the window process() spent blocked on the oldest block.
+    double waitRatio = 0.0;
+  };
+
+  // iqSampleRate is the source rate, inputRate or above; anything else is
+  // decimated / resampled to inputRate before the demod.
   DspPipeline(int inputRate, int outputRate,
               const Config::ProcessingSection &processing, bool verboseLogging,
-              size_t blockSamples, size_t iqDecimation);
+              size_t blockSamples, uint32_t iqSampleRate);
+  ~DspPipeline();
+
+  DspPipeline(const DspPipeline &) = delete;
+  DspPipeline &operator=(const DspPipeline &) = delete;
 
+  // reset() and the setters are called from the thread that calls
+  // process(). In pipelined mode they first wait for the blocks in flight,
+  // so a change lands on the same block boundary as in the serial chain.
   void reset();
   void setBandwidthHz(int bandwidthHz);
   void setDeemphasisMode(int deemphasisMode);
   void setForceMono(bool forceMono);
-  void setBlendMode(StereoDecoder::BlendMode mode) { m_stereo.setBlendMode(mode); }
+  void setBlendMode(StereoDecoder::BlendMode mode);
+  // Whether a REST client is polling /api/status, the only reader of the RDS
+  // deviation meter. With processing.metering = auto this switches that meter
+  // between off and duty-cycled; the hiss SNR meter is always kept running.
+  void setRestTelemetryActive(bool active);
   size_t blockSize() const { return m_blockSamples; }
-  size_t sdrBlockSamples() const { return m_blockSamples * m_iqDecimation; }
+  // Source samples per block. With a fractional IQ front end a block then
+  // demodulates slightly fewer than blockSize() samples.
+  size_t sdrBlockSamples() const { return m_sdrBlockSamples; }
+  // The IQ front end's stages and cost per source sample, for the startup
+  // log ("256000 (direct)" when the source already runs at inputRate).
+  std::string iqFrontEndSummary() const;
+  // processing.dsp_pipeline_stages: 1 = serial. Above that, process()
+  // returns each block's result pipelineStages() - 1 calls later (false
+  // until the pipeline has filled; flush() collects the rest at end of
+  // stream), and Result::audio stays valid until the next process() or
+  // flush() call.
+  size_t pipelineStages() const { return m_stages.size() + 1; }
+  PipelineStats takePipelineStats();
 
+  // arrival: when the IQ reached the source (default: now), handed back in
+  // Result::arrival; signal likewise comes back in Result::signal.
   bool process(const uint8_t *iq, size_t samples,
                const std::function<void(const float *, size_t)> &rdsSink,
-               Result &out);
+               Result &out,
+               std::chrono::steady_clock::time_point arrival = {},
+               const SignalLevelResult &signal = {});
 
   // Normalized-complex<float> input path (SDRplay and other 16-bit sources).
   // Same processing as the uint8 overload; only the front-end input conversion
   // differs (the samples already arrive at ±1.0 full scale).
   bool process(const std::complex<float> *iq, size_t samples,
                const std::function<void(const float *, size_t)> &rdsSink,
-               Result &out);
+               Result &out,
+               std::chrono::steady_clock::time_point arrival = {},
+               const SignalLevelResult &signal = {});
+
+  // End of stream: hands out the oldest block still in flight in pipelined
+  // mode, as process() would have on the next call. False once none are
+  // left, and always in the serial chain.
+  bool flush(const std::function<void(const float *, size_t)> &rdsSink,
+             Result &out);
 
   static constexpr float kSoftLimitThreshold = 0.85f;
   static float softLimitSample(float x, uint32_t &softCount);
 
 private:
+  // One block on its way through the chain. The serial chain uses a single
+  // one and points source at the caller's (or the staging) memory; the
+  // pipelined mode keeps a pool, copies the IQ in and passes slot indices
+  // between the stages.
+  struct Block {
+    const uint8_t *sourceU8 = nullptr;
+    const std::complex<float> *sourceComplex = nullptr;
+    size_t sourceSamples = 0;
+    std::chrono::steady_clock::time_point arrival{};
+    SignalLevelResult signal;
+    std::vector<uint8_t> iqU8;
+    std::vector<std::complex<float>> iqComplex;
+    // Front stage: rate-converted IQ, demod output (MPX) and, without
+    // stereo, the demod's own mono audio.
+    std::vector<std::complex<float>> decimated;
+    std::vector<float> mpx;
+    std::vector<float> mono;
+    size_t demodSamples = 0;
+    size_t monoSamples = 0;
+    // false: squelch idle, only the channel power was measured.
+    bool demodulated = false;
+    bool ok = false;
+    double channelPowerDbfs = 0.0;
+    float envelopeError = 0.0f;
+    // Back stage: interleaved output frames and the Result pointing at them.
+    std::vector<float> frames;
+    Result result;
+  };
+
+  // A worker thread running the front stage, the back stage or both.
+  struct Stage {
+    const char *name = "";
+    bool front = false;
+    bool back = false;
+    fm_tuner::dsp::BlockQueue input;
+    fm_tuner::dsp::BlockQueue *output = nullptr;
+    std::thread thread;
+    std::atomic<uint64_t> busyNs{0};
+    std::atomic<uint64_t> blocks{0};
+    std::atomic<uint64_t> queuedSum{0};
+    std::atomic<size_t> queuedMax{0};
+  };
+
   int m_inputRate;
   int m_outputRate;
   bool m_stereoEnabled;
   bool m_verboseLogging;
   size_t m_blockSamples;
-  size_t m_iqDecimation;
+  uint32_t m_iqSampleRate;
+  size_t m_sdrBlockSamples;
+  // Rate the stereo decoder and AF chain run at: m_inputRate, or half of it
+  // with processing.half_rate_mpx.
+  int m_stereoRate;
+  // processing.metering = always: run the telemetry meters on every block.
+  bool m_meteringAlways = false;
 
   FMDemod m_demod;
   StereoDecoder m_stereo;
   AFPostProcessor m_afPost;
-  fm_tuner::dsp::liquid::ComplexDecimator m_iqDecimator;
+  fm_tuner::dsp::IqRateConverter m_iqConverter;
   fm_tuner::dsp::Squelch m_squelch;
+  fm_tuner::dsp::HalfBandDecimator m_mpxDecimator;
 
   std::vector<uint8_t> m_iqStagingRing;
   std::vector<uint8_t> m_iqLinearizedBlock;
@@ -92,18 +214,41 @@ private:
   size_t m_iqStagingReadPosC = 0;
   size_t m_iqStagingWritePosC = 0;
   size_t m_iqStagingSizeC = 0;
-  // Deferred-reset gate. setBandwidthHz / setDeemphasisMode previously called
+  // Deferred-reset gate. setDeemphasisMode previously called
   // m_stereo.reset() + m_afPost.reset() inline, so two back-to-back retune
   // setters (common on fast XDR retunes) would zero the audio-chain IIR state
-  // twice mid-block and produce audible thumps. Now those setters mark this
-  // flag; process() consumes it once at the next block boundary.
+  // twice mid-block and produce audible thumps. Now it marks this flag;
+  // runBack() consumes it once at the next block boundary. (A bandwidth
+  // change needs no reset at all: the demod crossfades the channel FIR.)
   bool m_pendingAudioReset = false;
-  std::vector<std::complex<float>> m_iqDecimatedComplex;
-  std::vector<float> m_demodBuffer;
+  // processing.squelch_idle: while the squelch is closed and faded out, only
+  // the channel FIR and power estimate run (runIdle()).
+  bool m_squelchIdleEnabled = false;
+  bool m_idle = false;
+  // Output frames owed to the audio rate across idle blocks, in units of
+  // 1 / m_inputRate.
+  uint64_t m_idleOutCarry = 0;
+  // Half-rate MPX and its complementary >64 kHz band (hiss meter input).
+  std::vector<float> m_mpxHalf;
+  std::vector<float> m_mpxHiss;
   std::vector<float> m_stereoLeft;
   std::vector<float> m_stereoRight;
-  std::vector<float> m_audioLeft;
-  std::vector<float> m_audioRight;
+  // Back-stage state the front stage reads before its next block: stereo
+  // lock (multipath adaptation) and a faded-out squelch (squelch_idle). In
+  // the three-stage mode they can be a block behind.
+  std::atomic<bool> m_stereoLocked{false};
+  std::atomic<bool> m_audioSilent{false};
+
+  std::vector<Block> m_blocks;
+  std::vector<std::unique_ptr<Stage>> m_stages;
+  fm_tuner::dsp::BlockQueue m_done;
+  std::vector<size_t> m_freeSlots;
+  // The slot the last Result points into, released by the next process().
+  static constexpr size_t kNoSlot = static_cast<size_t>(-1);
+  size_t m_heldSlot = kNoSlot;
+  size_t m_inFlight = 0;
+  uint64_t m_waitNs = 0;
+  std::chrono::steady_clock::time_point m_statsStart;
 
   void clearIqStaging();
   void appendIqToStaging(const uint8_t *iq, size_t sampleCount);
@@ -113,15 +258,48 @@ private:
   void appendIqToStagingC(const std::complex<float> *iq, size_t sampleCount);
   bool linearizeDecimatorBlockC(size_t sampleCount);
 
-  // Shared back half of process(): demod -> stereo -> AF post -> squelch ->
-  // soft-limit -> fill Result. iqForDemodComplex is non-null for the CF32 path
-  // and for the decimated uint8 path; iqForDemod (uint8) is used only for the
-  // undecimated uint8 path.
-  bool runDemodChain(const uint8_t *iqForDemod,
-                     const std::complex<float> *iqForDemodComplex,
-                     size_t demodSamples,
-                     const std::function<void(const float *, size_t)> &rdsSink,
+  // The next whole source block out of the caller's span and the staging
+  // ring, or nullptr while a block is still incomplete.
+  const uint8_t *nextSourceBlock(const uint8_t *iq, size_t samples,
+                                 size_t &blockSamples);
+  const std::complex<float> *
+  nextSourceBlock(const std::complex<float> *iq, size_t samples,
+                  size_t &blockSamples);
+
+  // Runs one source block through the chain: inline, or submitted to the
+  // workers while the result of an earlier block is collected.
+  bool runBlock(const uint8_t *iqU8, const std::complex<float> *iqComplex,
+                size_t samples, std::chrono::steady_clock::time_point arrival,
+                const SignalLevelResult &signal,
+                const std::function<void(const float *, size_t)> &rdsSink,
+                Result &out);
+  bool runPipelined(const uint8_t *iqU8, const std::complex<float> *iqComplex,
+                    size_t samples,
+                    std::chrono::steady_clock::time_point arrival,
+                    const SignalLevelResult &signal,
+                    const std::function<void(const float *, size_t)> &rdsSink,
+                    Result &out);
+  // Waits for the oldest block in flight and hands out its result; the slot
+  // stays held until the next process() / flush().
+  bool collectOldest(const std::function<void(const float *, size_t)> &rdsSink,
                      Result &out);
+  void releaseHeldSlot();
+  void runStage(Stage &stage);
+  // Waits until every block in flight has come out of the last stage, which
+  // leaves the workers idle and all DSP state to the calling thread.
+  void drainPipeline();
+  void logPipelineStats();
+
+  // Front stage: IQ rate conversion and demod (or, squelch idle, only the
+  // channel measurement). False when the converter produced no samples.
+  bool runFront(Block &block);
+  // Back stage: stereo -> AF post -> squelch -> soft-limit -> fill Result.
+  void runBack(Block &block);
+  void runAudioChain(Block &block);
+  // Squelched stand-in for runAudioChain(): feeds the measured channel power
+  // to the gate and returns the silence the audio chain would have produced.
+  void runIdle(Block &block);
+  void publishAudioState();
 };
 
 #endif
@@ -0,0 +1,130 @@
+#ifndef FILE_SOURCE_H
+#define FILE_SOURCE_H
+
+#include <chrono>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// IQ recording played back as a tuner. The file is memory-mapped and leased
+// to the DSP straight from the mapping, so replay costs no copies. Recordings
+// too large for the address space (2 GB and up on 32-bit builds) are mapped
+// through a window that slides along with playback instead. Accepts the
+// raw interleaved u8 IQ that --iq captures, normalized CF32 (e.g. GNU Radio
+// .cfile / .cf32) and interleaved signed 16-bit CS16 (--iq-format cs16), which
+// is converted to CF32 block by block.
+//
+// Playback is either paced at the configured sample rate (behaves like a live
+// dongle, including for audio sinks) or unthrottled, for benchmarking the whole
+// run loop and reprocessing recordings faster than real time.
+//
+// Multi-frequency recordings: a "<file>.tunes" sidecar (written by --iq
+// capture on every retune) lists "<sample offset> <frequency Hz>" lines. When
+// present, setFrequency() seeks to the segment recorded at that frequency and
+// playback stays inside it; frequencies not in the index continue linearly
+// through the whole file.
+class FileSource {
+public:
+  enum class Format { U8, CF32, CS16 };
+
+  FileSource() = default;
+  ~FileSource();
+  FileSource(const FileSource &) = delete;
+  FileSource &operator=(const FileSource &) = delete;
+
+  // Applied at the next connect(). "auto" picks CF32 for .cf32/.fc32/.cfile,
+  // CS16 for .cs16/.sc16 extensions and u8 otherwise.
+  void configure(const std::string &path, const std::string &format, bool paced,
+                 bool loop);
+
+  bool connect();
+  void disconnect();
+  bool isConnected() const { return m_base != nullptr; }
+
+  bool setFrequency(uint32_t freqHz);
+  bool setSampleRate(uint32_t rate);
+
+  Format format() const { return m_format; }
+  const std::string &path() const { return m_path; }
+
+  // Same contract as the device sources: up to maxSamples per call, 0 when
+  // nothing is available. Paced playback blocks until the block is "due".
+  size_t readIQ(uint8_t *buffer, size_t maxSamples);
+  size_t readIQ(std::complex<float> *buffer, size_t maxSamples);
+  // Zero-copy reads straight from the mapping; use the overload matching
+  // format() (the CF32 one for CS16, leased from a conversion buffer that
+  // stays valid until the next lease). Release with the returned count.
+  size_t leaseIQ(size_t maxSamples, const uint8_t *&data);
+  size_t leaseIQ(size_t maxSamples, const std::complex<float> *&data);
+  void releaseIQ(size_t samples);
+
+  // True once playback ran off the end of the file (or segment) without
+  // looping; the next connect() starts over.
+  bool endOfStream() const { return m_endOfStream; }
+  uint64_t totalSamples() const { return m_totalSamples; }
+  uint64_t positionSamples() const { return m_position; }
+
+private:
+  struct Segment {
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    uint32_t freqHz = 0;
+  };
+
+  bool mapFile();
+  void unmapFile();
+  bool mapView(uint64_t offset, size_t bytes);
+  void unmapView();
+  // Pointer to `samples` samples at m_position, sliding the window over them
+  // first when the file is not mapped whole. Null if the remap fails.
+  const uint8_t *viewAt(size_t samples);
+  void loadIndex();
+  void seekTo(uint64_t begin, uint64_t end);
+  size_t acquire(size_t maxSamples);
+  void pace(size_t samples);
+  void noteEndOfStream();
+
+  std::string m_path;
+  std::string m_formatName = "auto";
+  bool m_paced = true;
+  bool m_loop = false;
+  Format m_format = Format::U8;
+
+  // The mapped view covers file bytes [m_viewOffset, m_viewOffset +
+  // m_viewBytes): the whole file when it fits, else a window of m_windowBytes.
+  const uint8_t *m_base = nullptr;
+  uint64_t m_fileBytes = 0;
+  uint64_t m_viewOffset = 0;
+  size_t m_viewBytes = 0;
+  bool m_windowed = false;
+  // Files above this are windowed without trying a whole-file mapping.
+  uint64_t m_wholeMapLimit = SIZE_MAX;
+  size_t m_windowBytes = size_t{64} << 20;
+  size_t m_viewGranularity = 4096;
+#if defined(_WIN32)
+  void *m_fileHandle = nullptr;
+  void *m_mappingHandle = nullptr;
+#else
+  int m_fd = -1;
+#endif
+
+  uint64_t m_totalSamples = 0;
+  uint64_t m_position = 0;
+  uint64_t m_playBegin = 0;
+  uint64_t m_playEnd = 0;
+  std::vector<Segment> m_segments;
+  uint32_t m_frequency = 0;
+  uint32_t m_sampleRate = 256000;
+  bool m_endOfStream = false;
+
+  std::chrono::steady_clock::time_point m_paceAnchor;
+  uint64_t m_pacedSamples = 0;
+  std::chrono::steady_clock::time_point m_connectTime;
+  uint64_t m_samplesDelivered = 0;
+
+  std::vector<std::complex<float>> m_convert;
+};
+
+#endif
@@ -1,10 +1,13 @@
 #ifndef FM_DEMOD_H
 #define FM_DEMOD_H
 
+#include "dsp/fm_front_end.h"
 #include "dsp/liquid_primitives.h"
 #include "dsp/multipath_eq.h"
+#include "dsp/polyphase_resampler.h"
 #include <array>
 #include <complex>
+#include <memory>
 #include <stddef.h>
 #include <stdint.h>
 #include <vector>
@@ -25,6 +28,10 @@ public:
   size_t processSplitComplex(const std::complex<float> *iq, float *mpxOut,
                              float *monoOut, size_t numSamples);
   size_t downsampleAudio(const float *demod, float *audio, size_t numSamples);
+  // Channel FIR and the power / clipping figures only, no demodulation: keeps
+  // the squelch estimate going while the audio chain idles.
+  void measureChannel(const uint8_t *iq, size_t numSamples);
+  void measureChannelComplex(const std::complex<float> *iq, size_t numSamples);
   void reset();
 
   void setDeemphasis(int tau_us);
@@ -50,6 +57,13 @@ private:
   void demodulate(const uint8_t *iq, float *audio, size_t len);
   void demodulateComplex(const std::complex<float> *iq, float *audio,
                          size_t len);
+  // AGC / multipath EQ (only when enabled), discriminator and
+  // block statistics, after the front-end filtered len samples into
+  // m_iqScratch.
+  void finishDemodulate(const fm_tuner::dsp::FmFrontEnd::BlockStats &stats,
+                        float *audio, size_t len);
+  void updateBlockStats(const fm_tuner::dsp::FmFrontEnd::BlockStats &stats,
+                        size_t len);
 
   int m_inputRate;
   int m_outputRate;
@@ -63,21 +77,24 @@ private:
   bool m_iqFirL1Normalize = false;
 
   std::vector<float> m_demodScratch;
+  std::vector<std::complex<float>> m_iqScratch;
 
   bool m_clipping;
   float m_clippingRatio;
   double m_filteredChannelPowerDbfs;
-  fm_tuner::dsp::liquid::FIRFilter m_liquidIqFilter;
-  fm_tuner::dsp::liquid::FreqDemod m_liquidFreqDemod;
-  fm_tuner::dsp::liquid::IIRFilterReal m_liquidIqDcBlockI;
-  fm_tuner::dsp::liquid::IIRFilterReal m_liquidIqDcBlockQ;
+  // u8/CF32 -> DC block -> channel FIR, and the discriminator.
+  fm_tuner::dsp::FmFrontEnd m_frontEnd;
+  // Channel FIR for every XDR bandwidth step, without and with L1
+  // normalization, designed once in the constructor: a bandwidth change
+  // (XDR W commands, adaptive bandwidth) only swaps the pointer.
+  std::vector<std::shared_ptr<const fm_tuner::dsp::FmFrontEnd::ChannelTaps>>
+      m_channelTaps[2];
   fm_tuner::dsp::liquid::IIRFilterReal m_liquidMonoDeemphasis;
   fm_tuner::dsp::liquid::IIRFilterReal m_liquidMonoDcBlock;
-  fm_tuner::dsp::liquid::Resampler m_liquidMonoResampler;
+  fm_tuner::dsp::PolyphaseResampler m_monoResampler;
   fm_tuner::dsp::liquid::AGC m_liquidIqAgc;
   fm_tuner::dsp::MultipathEqualizer m_liquidMultipathEq;
-  std::array<float, fm_tuner::dsp::liquid::Resampler::kMaxOutput>
-      m_liquidResampleTmp{};
+  std::vector<float> m_resampleScratch;
 };
 
 #endif
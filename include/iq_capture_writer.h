@@ -0,0 +1,139 @@
+#ifndef IQ_CAPTURE_WRITER_H
+#define IQ_CAPTURE_WRITER_H
+
+#include <atomic>
+#include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+
+// Raw IQ capture (-i) off the DSP thread. enqueue() only copies the block, in
+// the source's native format, into a lock-free ring; a writer thread converts
+// it to the file format if needed and drains it in large batched write()s,
+// preallocating the file ahead of the data where the platform allows, so a
+// slow SD card or network mount back-pressures the ring instead of the demod.
+// When the ring is full the block is dropped and counted, never waited on.
+//
+// Rotation: with a size and/or duration limit, the capture is split into
+// <stem>_0000<ext>, <stem>_0001<ext>, ... at sample boundaries. Every file
+// gets its own "<file>.tunes" index ("<sample offset> <frequency Hz>" per
+// retune, starting at 0) that FileSource uses to seek on replay.
+//
+// File formats: u8 (RTL interleaved unsigned bytes), cf32 (normalized
+// complex<float>) and cs16 (interleaved int16, full scale 32768, lossless for
+// SDRplay). Rotation sizes are in file bytes, offsets always in samples.
+class IqCaptureWriter {
+public:
+  enum class Format { U8, CF32, CS16 };
+
+  struct Options {
+    uint32_t sampleRate = 256000;
+    // What enqueue() mostly receives (U8 or CF32); the other overload is
+    // converted on the caller's thread, so keep it to the rare path.
+    Format inputFormat = Format::U8;
+    Format fileFormat = Format::U8;
+    uint64_t rotateBytes = 0;   // 0 = no size-based rotation
+    uint32_t rotateSeconds = 0; // 0 = no time-based rotation
+    bool verboseLogging = true;
+  };
+
+  IqCaptureWriter();
+  ~IqCaptureWriter();
+  IqCaptureWriter(const IqCaptureWriter &) = delete;
+  IqCaptureWriter &operator=(const IqCaptureWriter &) = delete;
+
+  bool init(const std::string &path, const Options &options);
+  // Drains everything queued, closes the current file and logs a summary.
+  void shutdown();
+  bool isOpen() const { return m_threadRunning.load(); }
+
+  // "u8" / "cf32" / "cs16", or "auto": by the extension of path (.cf32, .fc32,
+  // .cfile -> cf32; .cs16, .sc16 -> cs16; anything else u8), matching what
+  // FileSource picks on replay. Returns false for an unknown name.
+  static bool parseFormat(const std::string &name, const std::string &path,
+                          Format &format);
+  static const char *formatName(Format format);
+  static size_t bytesPerSample(Format format);
+
+  // DSP thread: queue sampleCount IQ samples tuned at freqHz. Never blocks;
+  // returns false if (part of) the block was dropped.
+  bool enqueue(const uint8_t *data, size_t sampleCount, uint32_t freqHz);
+  bool enqueue(const std::complex<float> *data, size_t sampleCount,
+               uint32_t freqHz);
+
+  // In the file format.
+  uint64_t bytesWritten() const {
+    return m_bytesWritten.load(std::memory_order_relaxed);
+  }
+  uint64_t droppedSamples() const {
+    return m_droppedBytes.load(std::memory_order_relaxed) /
+           bytesPerSample(m_options.inputFormat);
+  }
+  uint32_t dropEvents() const {
+    return m_dropEvents.load(std::memory_order_relaxed);
+  }
+  uint32_t filesOpened() const { return m_fileIndex; }
+
+private:
+  struct TuneEvent {
+    uint64_t streamSample = 0;
+    uint32_t freqHz = 0;
+  };
+
+  bool push(const uint8_t *data, size_t sampleCount, uint32_t freqHz);
+  bool openFile();
+  void closeFile();
+  bool writeSamples(const uint8_t *data, size_t bytes);
+  bool writeChunk(const uint8_t *data, size_t bytes);
+  bool writeAll(const uint8_t *data, size_t bytes);
+  void writeTuneEvents(uint64_t streamEnd);
+  void drain(size_t minBytes);
+  void runWriterThread();
+  void reportDrops();
+
+  std::string m_path;
+  Options m_options;
+
+  fm_tuner::SpscRing<uint8_t> m_ring;
+  std::thread m_thread;
+  std::atomic<bool> m_threadRunning;
+  std::atomic<bool> m_fatalError;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+
+  // Retunes, producer -> writer. Rare, so a mutex-protected vector is fine.
+  std::mutex m_eventMutex;
+  std::vector<TuneEvent> m_pendingEvents;
+  std::vector<TuneEvent> m_writerEvents;
+  // Producer side.
+  uint64_t m_streamSamplesQueued;
+  uint32_t m_lastQueuedFreqHz;
+  std::vector<uint8_t> m_inputConvert;
+
+  // Writer side.
+  std::vector<uint8_t> m_fileConvert;
+  int m_fd;
+  FILE *m_indexHandle;
+  uint32_t m_fileIndex;
+  uint64_t m_fileBytes;
+  uint64_t m_filePreallocated;
+  uint64_t m_fileStartSample;
+  uint64_t m_streamSamplesWritten;
+  uint32_t m_currentFreqHz;
+  // The current file's index still needs its "0 <frequency>" first line.
+  bool m_indexNeedsHeader;
+  uint32_t m_dropEventsReported;
+
+  std::atomic<uint64_t> m_bytesWritten;
+  std::atomic<uint64_t> m_droppedBytes;
+  std::atomic<uint32_t> m_dropEvents;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef LATENCY_METER_H
+#define LATENCY_METER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Measured IQ-to-DAC latency, summed per played block and logged as
+// [LATENCY] every few seconds.
+//
+// Each block contributes the time from its IQ arriving at the source to its
+// audio reaching AudioOutput (source backlog, block assembly and DSP,
+// including the pipelined mode's delay), plus what is still queued ahead of
+// it at that moment: the speaker ring and the device buffer. The channel and
+// de-emphasis filters' group delay (well under a millisecond) is not
+// included.
+class LatencyMeter {
+public:
+  struct Report {
+    size_t blocks = 0;
+    double avgMs = 0.0;
+    double maxMs = 0.0;
+    // Averages of the three parts of avgMs.
+    double iqToOutputMs = 0.0;
+    double speakerRingMs = 0.0;
+    double deviceMs = 0.0;
+  };
+
+  static constexpr std::chrono::seconds kLogInterval{5};
+
+  // targetLatencyMs is only echoed in the log line (0 = no target).
+  explicit LatencyMeter(int targetLatencyMs);
+
+  void addBlock(std::chrono::steady_clock::time_point arrival,
+                std::chrono::steady_clock::time_point written,
+                double speakerRingSeconds, double deviceSeconds);
+  // Logs and starts a new window once kLogInterval has passed since the
+  // last one.
+  void maybeLog(std::chrono::steady_clock::time_point now);
+  Report take();
+  std::string format(const Report &report) const;
+
+private:
+  int m_targetLatencyMs;
+  std::chrono::steady_clock::time_point m_windowStart;
+  size_t m_blocks = 0;
+  double m_totalSum = 0.0;
+  double m_totalMax = 0.0;
+  double m_iqSum = 0.0;
+  double m_ringSum = 0.0;
+  double m_deviceSum = 0.0;
+};
+
+#endif
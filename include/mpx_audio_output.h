@@ -11,7 +11,7 @@
 #include <thread>
 #include <vector>
 
-#include "dsp/liquid_primitives.h"
+#include "dsp/polyphase_resampler.h"
 
 #if defined(__APPLE__) && defined(FM_TUNER_HAS_COREAUDIO)
 #include <AudioUnit/AudioUnit.h>
@@ -28,7 +28,7 @@
 // Live PCM sink for the multiplex (MPX) baseband signal coming out of the FM
 // discriminator. Mono, runs at a user-selectable sample rate (typically
 // 192 kHz so the 19/38/57 kHz subcarriers are preserved). Resamples from the
-// post-decimation IQ rate on the producer side via liquid_dsp.
+// post-decimation IQ rate on the producer side (dsp::PolyphaseResampler).
 //
 // Primarily intended to feed a virtual loopback device (BlackHole / snd-aloop
 // / VB-CABLE) so downstream tools — RDS decoders, spectrum analyzers, FM
@@ -80,9 +80,7 @@ private:
 
   // Producer-side resampler (source → target rate) and scratch buffer.
   bool m_resampleEnabled;
-  fm_tuner::dsp::liquid::Resampler m_resampler;
-  std::array<float, fm_tuner::dsp::liquid::Resampler::kMaxOutput>
-      m_resampleTmp{};
+  fm_tuner::dsp::PolyphaseResampler m_resampler;
 
   // Ring buffer of float mono samples at target rate.
   std::mutex m_mutex;
@@ -1,6 +1,7 @@
 #ifndef PROCESSING_RUNNER_H
 #define PROCESSING_RUNNER_H
 
+#include <chrono>
 #include <complex>
 #include <cstddef>
 #include <cstdint>
@@ -9,6 +10,7 @@
 #include "audio_output.h"
 #include "config.h"
 #include "dsp_pipeline.h"
+#include "latency_meter.h"
 #include "mpx_audio_output.h"
 #include "rds_worker.h"
 #include "signal_level.h"
@@ -17,6 +19,9 @@
 
 namespace processing_runner {
 
+// Meters, demodulates and plays one IQ lease. With samples == 0 (end of
+// stream) it plays the next block the pipelined DSP still holds instead;
+// false once none are left.
 bool processAudioBlock(
     const uint8_t *iqBuffer, size_t samples, int outputRate,
     uint32_t iqSampleRate, int channelBandwidthHz,
@@ -34,7 +39,9 @@ bool processAudioBlock(
     const std::function<void(float pilotDeviationKHz, bool stereo, float quality,
                              float mpxMagnitude, float mpxPeak,
                              float rdsDeviationKHz, float demodSnrDb)>
-        &dspTelemetryHook = {});
+        &dspTelemetryHook = {},
+    LatencyMeter *latencyMeter = nullptr,
+    std::chrono::steady_clock::time_point iqArrival = {});
 
 } // namespace processing_runner
 
@@ -33,6 +33,9 @@ private:
   std::mutex m_mutex;
   std::condition_variable m_cv;
   std::vector<std::vector<float>> m_queue;
+  // Buffers the worker is done with, reused by enqueue() so steady state
+  // doesn't allocate per block.
+  std::vector<std::vector<float>> m_spare;
   std::thread m_thread;
 };
 
@@ -163,6 +163,8 @@ class Resampler {
   void setRatio(float ratio);
 
   std::uint32_t execute(float in, std::array<float, kOutputArraySize>& out);
+  // Whole chunk in one liquid call; out needs room for ceil(ratio * n) + 1.
+  std::uint32_t executeBlock(const float* in, std::uint32_t n, float* out);
 
  private:
   resamp_rrrf object_;
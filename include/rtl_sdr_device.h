@@ -9,6 +9,8 @@
 #include <thread>
 #include <vector>
 
+#include "spsc_ring.h"
+
 class RTLSDRDevice {
 public:
   explicit RTLSDRDevice(uint32_t deviceIndex);
@@ -25,16 +27,35 @@ public:
   bool setAGC(bool enable);
   void setLowLatencyMode(bool enable);
   size_t readIQ(uint8_t *buffer, size_t maxSamples);
+  // Zero-copy variant of readIQ: same wait/low-latency policy, but points data
+  // at the samples inside the IQ ring instead of copying them out. The span
+  // stays valid (the USB callback cannot overwrite it) until releaseIQ() is
+  // called with the returned count. One lease at a time; no readIQ() or
+  // flushBuffers() while it is held.
+  size_t leaseIQ(size_t maxSamples, const uint8_t *&data);
+  void releaseIQ(size_t samples);
+  // IQ received but not yet released, in samples.
+  size_t queuedSamples() const { return m_iqRing.readAvailable() / 2; }
   // Drop all currently buffered IQ so the next readIQ returns only samples
   // captured after this call. Used after a scan retune to discard the stale
   // pre-retune ring contents (which otherwise mis-bin the FFT by one sweep
   // step). Cheap: just advances the read cursor to the write cursor.
   void flushBuffers();
+  // USB transfers that did not fully fit in the IQ ring because the reader
+  // fell behind; the bytes that did not fit are dropped.
+  uint32_t overflowEvents() const {
+    return m_overflowEvents.load(std::memory_order_relaxed);
+  }
+  uint64_t overflowBytes() const {
+    return m_overflowBytes.load(std::memory_order_relaxed);
+  }
 
 private:
   static void asyncCallback(unsigned char *buf, uint32_t len, void *ctx);
   void asyncReadLoop();
-  size_t availableBytesLocked() const;
+  size_t waitForIq(size_t requestedBytes);
+  void noteShortRead(size_t bytesRead, size_t requestedBytes);
+  void reportOverflows();
 
   uint32_t m_deviceIndex;
   std::atomic<bool> m_connected;
@@ -43,12 +64,17 @@ private:
   std::thread m_asyncThread;
   std::atomic<bool> m_asyncRunning;
   std::atomic<bool> m_asyncFailed;
+  // The USB callback is the only writer and readIQ()/flushBuffers() the only
+  // reader, so the ring itself needs no lock. The mutex/CV pair only parks
+  // readIQ() while it waits for data; the callback touches it solely when
+  // m_readerWaiting says someone is actually asleep.
+  fm_tuner::SpscRing<uint8_t> m_iqRing;
   std::mutex m_bufferMutex;
   std::condition_variable m_bufferCv;
-  std::vector<uint8_t> m_iqRing;
-  size_t m_ringReadPos;
-  size_t m_ringWritePos;
-  bool m_ringFull;
+  std::atomic<bool> m_readerWaiting;
+  std::atomic<uint32_t> m_overflowEvents;
+  std::atomic<uint64_t> m_overflowBytes;
+  uint32_t m_overflowEventsReported;
   std::atomic<bool> m_lowLatencyMode;
   std::atomic<uint32_t> m_lowLatencyDropEvents;
   std::atomic<uint32_t> m_lowLatencyDeadlineEvents;
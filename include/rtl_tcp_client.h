@@ -2,13 +2,43 @@
 #define RTL_TCP_CLIENT_H
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <stddef.h>
 #include <stdint.h>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "spsc_ring.h"
+
+// rtl_tcp network source. A dedicated receive thread drains the socket into
+// an SPSC IQ ring with large reads and a deep SO_RCVBUF, so network jitter is
+// absorbed there instead of stalling the DSP thread in recv(). readIQ(),
+// leaseIQ() and flushBuffers() behave like RTLSDRDevice's.
 class RTLTCPClient {
 public:
+  // Receive-side health. With verbose logging on, formatReceiveStats() of it
+  // is printed every kStatsLogInterval from the reading thread.
+  struct ReceiveStats {
+    uint64_t bytesReceived = 0;
+    uint32_t overflowEvents = 0; // recv chunks that did not fully fit the ring
+    uint64_t overflowBytes = 0;
+    uint32_t underrunReads = 0; // reads that hit the deadline with the ring dry
+    // Arrival jitter (RFC 3550 style smoothed |actual - expected| gap, where
+    // the expected gap is the chunk's duration at the sample rate) and the
+    // largest gap between two socket reads since connect.
+    double jitterMs = 0.0;
+    double maxGapMs = 0.0;
+    size_t occupancyBytes = 0;
+    size_t peakOccupancyBytes = 0;
+    size_t capacityBytes = 0;
+  };
+
+  static constexpr std::chrono::seconds kStatsLogInterval{10};
+
   RTLTCPClient(const std::string &host, uint16_t port);
   ~RTLTCPClient();
 
@@ -16,8 +46,20 @@ public:
   void disconnect();
 
   bool isConnected() const { return m_connected; }
+  // True once the receive thread saw EOF or a hard socket error.
+  bool failed() const { return m_rxFailed.load(std::memory_order_relaxed); }
 
   size_t readIQ(uint8_t *buffer, size_t maxSamples);
+  // Lease/release counterpart of readIQ (see RTLSDRDevice::leaseIQ).
+  size_t leaseIQ(size_t maxSamples, const uint8_t *&data);
+  void releaseIQ(size_t samples);
+  size_t queuedSamples() const { return m_iqRing.readAvailable() / 2; }
+  // Drop everything buffered so the next read only sees post-call samples.
+  void flushBuffers();
+  ReceiveStats receiveStats() const;
+  // "[RTL_TCP] ring 512/4096 KB (peak 1024 KB), jitter 1.2 ms, ..."
+  static std::string formatReceiveStats(const ReceiveStats &stats);
+  void setVerboseLogging(bool enable) { m_verboseLogging = enable; }
 
   bool setFrequency(uint32_t freqHz);
   bool setSampleRate(uint32_t rate);
@@ -33,6 +75,9 @@ private:
   bool sendCommand(uint8_t cmd, uint32_t param);
   bool sendAll(const uint8_t *data, size_t len);
   bool readResponse(uint8_t *buffer, size_t len);
+  void receiveLoop();
+  size_t waitForIq(size_t requestedBytes);
+  void reportReceiveEvents();
 
   std::string m_host;
   uint16_t m_port;
@@ -40,8 +85,26 @@ private:
   std::atomic<bool> m_connected;
   std::atomic<uint32_t> m_frequency;
   std::atomic<uint32_t> m_sampleRate;
-  bool m_havePendingIqByte;
-  uint8_t m_pendingIqByte;
+
+  // Receive thread -> reader. Same single-producer/single-consumer layout as
+  // RTLSDRDevice; the mutex/CV only park a waiting reader.
+  fm_tuner::SpscRing<uint8_t> m_iqRing;
+  std::thread m_rxThread;
+  std::atomic<bool> m_rxRunning;
+  std::atomic<bool> m_rxFailed;
+  std::mutex m_bufferMutex;
+  std::condition_variable m_bufferCv;
+  std::atomic<bool> m_readerWaiting;
+  std::atomic<uint64_t> m_bytesReceived;
+  std::atomic<uint32_t> m_overflowEvents;
+  std::atomic<uint64_t> m_overflowBytes;
+  std::atomic<uint32_t> m_underrunReads;
+  std::atomic<uint32_t> m_jitterUs;
+  std::atomic<uint32_t> m_maxGapUs;
+  std::atomic<size_t> m_peakOccupancy;
+  uint32_t m_overflowEventsReported;
+  bool m_verboseLogging;
+  std::chrono::steady_clock::time_point m_lastStatsLog;
 };
 
 #endif
@@ -9,6 +9,8 @@
 #include <mutex>
 #include <vector>
 
+#include "spsc_ring.h"
+
 // SDRplay RSP backend. The SDRplay API (sdrplay_api) is a proprietary library
 // the user installs separately; we dlopen it at runtime (no build-time link, no
 // bundling) so the app stays GPL-clean and falls back to RTL-SDR when SDRplay
@@ -66,24 +68,35 @@ public:
   /// Drain up to maxSamples IQ samples as interleaved uint8 (RTL format, same
   /// full-scale reference). Used by the signal meter / scan engine.
   size_t readIQ(uint8_t *out, size_t maxSamples);
+  /// Zero-copy variant of the complex readIQ: same wait policy, but points
+  /// data at the samples inside the ring. Valid until releaseIQ(count).
+  size_t leaseIQ(size_t maxSamples, const std::complex<float> *&data);
+  void releaseIQ(size_t samples);
+  /// IQ received but not yet released, in samples.
+  size_t queuedSamples() const { return m_ring.readAvailable(); }
 
   // Called from the SDRplay stream callback (file-local in the .cpp).
   void ingest(const short *xi, const short *xq, unsigned int n, bool reset = false);
   void markFailed() { m_failed.store(true, std::memory_order_relaxed); }
 
 private:
-  size_t drainLocked(std::complex<float> *out, size_t maxSamples);
+  size_t waitForSamples(size_t wanted);
+  void applyPendingFlush();
 
   int m_inputRate = 256000;
   int m_hwVer = 0;
   std::atomic<bool> m_connected{false};
   std::atomic<bool> m_failed{false};
 
+  // The stream callback is the single producer and the DSP thread the single
+  // consumer. The mutex/CV only park a waiting reader. A retune `reset` from
+  // the API can't move the read cursor from the producer side, so it records
+  // the write position in m_flushMark and the reader drops up to it.
+  fm_tuner::SpscRing<std::complex<float>> m_ring;
   std::mutex m_mutex;
   std::condition_variable m_cv;
-  std::vector<std::complex<float>> m_ring;
-  size_t m_readPos = 0, m_writePos = 0;
-  bool m_full = false;
+  std::atomic<bool> m_readerWaiting{false};
+  std::atomic<size_t> m_flushMark{0};
 
   void *m_handle = nullptr;
 };
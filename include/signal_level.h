@@ -1,6 +1,7 @@
 #ifndef SIGNAL_LEVEL_H
 #define SIGNAL_LEVEL_H
 
+#include <complex>
 #include <cstddef>
 #include <cstdint>
 
@@ -26,6 +27,15 @@ SignalLevelResult computeSignalLevel(const uint8_t *iq, size_t samples,
                                      uint32_t sampleRateHz = 0,
                                      int channelBandwidthHz = 0);
 
+// Same meter for normalized CF32 sources (SDRplay, CF32 replay), fed straight
+// from the IQ lease; clip ratios use the CF32 thresholds in iq_saturation.h.
+SignalLevelResult computeSignalLevel(const std::complex<float> *iq,
+                                     size_t samples, int appliedGainDb,
+                                     double gainCompFactor, double signalBiasDb,
+                                     double floorDbfs, double ceilDbfs,
+                                     uint32_t sampleRateHz = 0,
+                                     int channelBandwidthHz = 0);
+
 float computeDisplaySignalLevel120(double channelDbfs, double noiseFloorDbfs,
                                    int appliedGainDb, double gainCompFactor,
                                    double signalBiasDb, double floorDbfs,
@@ -0,0 +1,193 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Lock-free single-producer / single-consumer ring for trivially copyable
+// elements (IQ bytes, complex samples, audio frames).
+//
+// Capacity is rounded up to a power of two and the read/write indices are
+// free-running counters, so "full" and "empty" need no extra flag and every
+// transfer is at most two memcpy calls (up to the end of storage, then the
+// wrapped remainder). The producer only ever advances the write index and the
+// consumer only the read index; overflow handling is the producer's choice
+// (write() returns how much actually fit), so neither side ever has to touch
+// the other's cursor.
+//
+// Zero-copy consumers can reserve "contiguous slack" past the end of storage:
+// peekContiguous() then returns the readable data as one span even when it
+// wraps, by copying only the wrapped head into the slack (once per trip round
+// the ring, not once per block). The producer never writes into the slack.
+//
+// Thread roles:
+//   producer: write(), writeAvailable(), totalWritten()
+//   consumer: read(), peek(), peekContiguous(), discard(), discardAll(),
+//             readAvailable(), totalRead()
+//   either, while the other side is idle: reset(), clear()
+namespace fm_tuner {
+
+template <typename T> class SpscRing {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SpscRing elements are moved with memcpy");
+
+public:
+  // Up to two contiguous runs of readable elements, oldest first.
+  struct ReadSpans {
+    const T *first = nullptr;
+    size_t firstCount = 0;
+    const T *second = nullptr;
+    size_t secondCount = 0;
+    size_t size() const { return firstCount + secondCount; }
+  };
+
+  SpscRing() = default;
+  explicit SpscRing(size_t minCapacity, size_t contiguousSlack = 0) {
+    reset(minCapacity, contiguousSlack);
+  }
+
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  // Reallocate storage for at least minCapacity elements (plus the optional
+  // contiguous slack) and empty the ring.
+  void reset(size_t minCapacity, size_t contiguousSlack = 0) {
+    size_t capacity = 1;
+    while (capacity < minCapacity) {
+      capacity <<= 1;
+    }
+    m_capacity = (minCapacity == 0) ? 0 : capacity;
+    m_slack = (m_capacity == 0) ? 0 : std::min(contiguousSlack, m_capacity);
+    m_storage.assign(m_capacity + m_slack, T{});
+    m_mask = (m_capacity == 0) ? 0 : (m_capacity - 1);
+    clear();
+  }
+
+  void clear() {
+    m_writeIndex.store(0, std::memory_order_relaxed);
+    m_readIndex.store(0, std::memory_order_relaxed);
+  }
+
+  size_t capacity() const { return m_capacity; }
+  size_t contiguousSlack() const { return m_slack; }
+
+  // Free-running element counts. Lets a producer mark a position (e.g. "drop
+  // everything written before this retune") that the consumer later honours
+  // with discard(mark - totalRead()).
+  size_t totalWritten() const {
+    return m_writeIndex.load(std::memory_order_acquire);
+  }
+  size_t totalRead() const { return m_readIndex.load(std::memory_order_relaxed); }
+
+  size_t readAvailable() const {
+    const size_t write = m_writeIndex.load(std::memory_order_acquire);
+    const size_t read = m_readIndex.load(std::memory_order_relaxed);
+    return write - read;
+  }
+
+  size_t writeAvailable() const {
+    const size_t read = m_readIndex.load(std::memory_order_acquire);
+    const size_t write = m_writeIndex.load(std::memory_order_relaxed);
+    return m_capacity - (write - read);
+  }
+
+  // Producer: copy up to count elements in, returning how many fit.
+  size_t write(const T *src, size_t count) {
+    const size_t write = m_writeIndex.load(std::memory_order_relaxed);
+    const size_t read = m_readIndex.load(std::memory_order_acquire);
+    const size_t n = std::min(count, m_capacity - (write - read));
+    if (n == 0) {
+      return 0;
+    }
+    const size_t pos = write & m_mask;
+    const size_t head = std::min(n, m_capacity - pos);
+    std::memcpy(m_storage.data() + pos, src, head * sizeof(T));
+    if (n > head) {
+      std::memcpy(m_storage.data(), src + head, (n - head) * sizeof(T));
+    }
+    m_writeIndex.store(write + n, std::memory_order_release);
+    return n;
+  }
+
+  // Consumer: copy up to count elements out, returning how many were read.
+  size_t read(T *dst, size_t count) {
+    const ReadSpans spans = peek(count);
+    if (spans.firstCount > 0) {
+      std::memcpy(dst, spans.first, spans.firstCount * sizeof(T));
+    }
+    if (spans.secondCount > 0) {
+      std::memcpy(dst + spans.firstCount, spans.second,
+                  spans.secondCount * sizeof(T));
+    }
+    return discard(spans.size());
+  }
+
+  // Consumer: expose up to count readable elements in place. The spans stay
+  // valid until the matching discard(); the producer cannot overwrite them.
+  ReadSpans peek(size_t count) const {
+    ReadSpans spans;
+    const size_t read = m_readIndex.load(std::memory_order_relaxed);
+    const size_t write = m_writeIndex.load(std::memory_order_acquire);
+    const size_t n = std::min(count, write - read);
+    if (n == 0) {
+      return spans;
+    }
+    const size_t pos = read & m_mask;
+    spans.first = m_storage.data() + pos;
+    spans.firstCount = std::min(n, m_capacity - pos);
+    if (n > spans.firstCount) {
+      spans.second = m_storage.data();
+      spans.secondCount = n - spans.firstCount;
+    }
+    return spans;
+  }
+
+  // Consumer: expose up to count readable elements as a single span, returning
+  // its start and setting available to its length. Wrapped data is made
+  // contiguous through the slack area; without enough slack the span stops at
+  // the end of storage (a short lease). Release with discard(available).
+  const T *peekContiguous(size_t count, size_t &available) {
+    const ReadSpans spans = peek(count);
+    available = spans.firstCount;
+    if (spans.firstCount == 0) {
+      return nullptr;
+    }
+    if (spans.secondCount > 0) {
+      const size_t extra = std::min(spans.secondCount, m_slack);
+      if (extra > 0) {
+        std::memcpy(m_storage.data() + m_capacity, spans.second,
+                    extra * sizeof(T));
+        available += extra;
+      }
+    }
+    return spans.first;
+  }
+
+  // Consumer: release up to count elements without copying them.
+  size_t discard(size_t count) {
+    const size_t read = m_readIndex.load(std::memory_order_relaxed);
+    const size_t write = m_writeIndex.load(std::memory_order_acquire);
+    const size_t n = std::min(count, write - read);
+    m_readIndex.store(read + n, std::memory_order_release);
+    return n;
+  }
+
+  // Consumer: drop everything currently buffered.
+  size_t discardAll() { return discard(static_cast<size_t>(-1)); }
+
+private:
+  std::vector<T> m_storage;
+  size_t m_capacity = 0;
+  size_t m_slack = 0;
+  size_t m_mask = 0;
+  alignas(64) std::atomic<size_t> m_writeIndex{0};
+  alignas(64) std::atomic<size_t> m_readIndex{0};
+};
+
+} // namespace fm_tuner
+
+#endif
@@ -2,6 +2,9 @@
 #define STEREO_DECODER_H
 
 #include "dsp/liquid_primitives.h"
+#include "dsp/metering_scheduler.h"
+#include "dsp/pilot_pll.h"
+#include "dsp/real_fir_filter.h"
 #include <algorithm>
 #include <cmath>
 #include <complex>
@@ -16,8 +19,13 @@ public:
   StereoDecoder(int inputRate, int outputRate);
   ~StereoDecoder();
 
+  // hissBand, when given, replaces the built-in >65 kHz hiss high-pass for the
+  // demod SNR meter: same rate and length as mono. Needed when the MPX has
+  // been decimated below what the high-pass can represent. It must be the
+  // complement of mono (mono + hissBand = the undecimated MPX), as the MPX
+  // level behind the pilot-ratio and blend thresholds is taken from the sum.
   size_t processAudio(const float *mono, float *left, float *right,
-                      size_t numSamples);
+                      size_t numSamples, const float *hissBand = nullptr);
   void reset();
   void setForceStereo(bool force);
   void setForceMono(bool force);
@@ -25,6 +33,12 @@ public:
   void setPilotCancellerEnabled(bool enabled) {
     m_pilotCancellerEnabled = enabled;
   }
+  // Duty cycle of the two telemetry-only meters: the RDS deviation (57 kHz
+  // band-pass FIR) and the demod SNR (hiss high-pass). Both start as Always;
+  // DutyCycled refreshes them about every kMeterIntervalSec.
+  void setMetering(fm_tuner::dsp::MeteringScheduler::Mode rdsDeviation,
+                   fm_tuner::dsp::MeteringScheduler::Mode demodSnr);
+  static constexpr float kMeterIntervalSec = 0.1f;
   int getPilotLevelTenthsKHz() const { return m_pilotLevelTenthsKHz; }
   float getStereoBlend() const { return m_stereoBlend; }
   float getStereoQuality() const { return m_stereoQuality; }
@@ -60,8 +74,9 @@ public:
 
   // Demod-domain SNR/quality in dB, from the ratio of the in-band composite
   // power to the noise-triangle hiss power (a signal-free MPX band above the
-  // subcarriers). Always available (time-domain, per block), unlike the
-  // FFT-based signal-meter SNR which is NaN when no channel-FFT estimate runs.
+  // subcarriers). Always available (time-domain, per metered block), unlike
+  // the FFT-based signal-meter SNR which is NaN when no channel-FFT estimate
+  // runs.
   // This is a reception-quality figure, not a calibrated absolute. Returns 0
   // until the estimator has settled or when the channel is too narrow to
   // contain the hiss band.
@@ -79,8 +94,22 @@ public:
   }
 
   bool isStereo() const { return m_stereoDetected; }
+  // Mono fast path: taken once the output is mono anyway (force-mono, or no
+  // pilot for a couple of seconds). processAudio() then skips the pilot
+  // band-pass, PLL and L-R matrix, writes left == right, and only watches for
+  // the pilot with a single-bin 19 kHz DFT. True for the block just returned.
+  bool isMonoOutput() const { return m_monoFastPath; }
 
 private:
+  size_t processMonoBlock(const float *mono, float *left, float *right,
+                          size_t numSamples, const float *wideHiss);
+  // Single-bin DFT at 19 kHz on a phasor that runs on across blocks: returns
+  // the complex amplitude a of this block (pilot ~ Re(a * conj(phasor))) and
+  // adds the block to the watch window.
+  std::complex<double> accumulatePilotWatch(const float *mono,
+                                            size_t numSamples);
+  void leaveMonoFastPath();
+
   int m_inputRate;
   bool m_stereoDetected;
   bool m_forceStereo;
@@ -102,11 +131,29 @@ private:
   float m_lrRawMagnitude;
   float m_lrAudioMagnitude;
 
-  float m_pllPhase;
+  // Rate-scaled versions of the per-sample constants in stereo_decoder.cpp.
+  float m_envSmooth = 0.0f;
+  float m_envInject = 0.0f;
+  float m_iqSmooth = 0.0f;
+  float m_iqInject = 0.0f;
+  float m_pilotCancelMu = 0.0f;
+  float m_pllBwAcquire = 0.0f;
+  float m_pllBwHold = 0.0f;
+  // 38 kHz reference rotation away from the 256 kHz rate (0 rad there).
+  float m_subcarrierRotCos = 1.0f;
+  float m_subcarrierRotSin = 0.0f;
   float m_pllFreq;
   float m_pllMinFreq;
   float m_pllMaxFreq;
   float m_pilotConfidence;
+  // Mono fast path state: time since the stereo path last saw a pilot, and
+  // the 19 kHz watch (phasor e^{-j w n}, window sum and length).
+  bool m_monoFastPath = false;
+  float m_pilotAbsentSec = 0.0f;
+  std::complex<double> m_watchPhasor{1.0, 0.0};
+  std::complex<double> m_watchStep{1.0, 0.0};
+  std::complex<double> m_watchSum{0.0, 0.0};
+  size_t m_watchSamples = 0;
   // Hi-Blend LPF on the L-R signal. 2nd-order Butterworth biquad, Direct Form
   // II Transposed. Cutoff scales with m_stereoBlend² so under weak reception
   // stereo imagery retains LF detail while HF (which carries most of the
@@ -129,13 +176,30 @@ private:
   float m_pilotCancelGainQ;
   bool m_pilotCancellerEnabled;
 
-  std::vector<std::complex<float>> m_delayLine;
+  std::vector<float> m_delayLine;
   size_t m_delayPos;
   int m_delaySamples;
-  fm_tuner::dsp::liquid::FIRFilter m_liquidPilotBandFilter;
-  fm_tuner::dsp::liquid::FIRFilter m_liquidRdsBandFilter;
+  // Real-tap band-passes on the real MPX (designBandpassTaps()).
+  fm_tuner::dsp::RealFirFilter m_pilotBandFilter;
+  fm_tuner::dsp::RealFirFilter m_rdsBandFilter;
   fm_tuner::dsp::liquid::IIRFilterReal m_liquidHissBandFilter;
-  fm_tuner::dsp::liquid::NCO m_liquidPilotPll;
+  fm_tuner::dsp::MeteringScheduler m_rdsMeter;
+  fm_tuner::dsp::MeteringScheduler m_hissMeter;
+  fm_tuner::dsp::PilotPll m_pilotPll;
+  // Feed-forward band filters run over the whole block before the PLL loop.
+  std::vector<float> m_pilotBand;
+  std::vector<float> m_rdsBand;
+  std::vector<float> m_hissBand;
+  // Per-sample PLL outputs for the block: phase detector input, phase
+  // advance, and the 19 kHz / 38 kHz references at the post-step phase (the
+  // 38 kHz one rotated by the rate skew, see the constructor).
+  std::vector<float> m_pllMixedI;
+  std::vector<float> m_pllMixedQ;
+  std::vector<float> m_pllAdvance;
+  std::vector<float> m_pilotRefCos;
+  std::vector<float> m_pilotRefSin;
+  std::vector<float> m_subcarrierRef;
+  std::vector<float> m_subcarrierRefQ;
 };
 
 #endif
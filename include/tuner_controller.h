@@ -1,21 +1,31 @@
 #ifndef TUNER_CONTROLLER_H
 #define TUNER_CONTROLLER_H
 
+#include <atomic>
 #include <complex>
 #include <cstddef>
 #include <cstdint>
 #include <string>
 
+#include "file_source.h"
 #include "rtl_sdr_device.h"
 #include "rtl_tcp_client.h"
 #include "sdrplay_device.h"
 
 class TunerController {
 public:
-  enum class SourceKind { RtlSdr, RtlTcp, SdrPlay };
+  enum class SourceKind { RtlSdr, RtlTcp, SdrPlay, File };
   // Native IQ sample format a source delivers. U8 = RTL's interleaved unsigned
-  // 8-bit; CF32 = normalized complex<float> (SDRplay, full 16-bit range).
+  // 8-bit; CF32 = normalized complex<float> (SDRplay, full 16-bit range, and
+  // CF32 / CS16 recordings).
   enum class IqFormat { U8, CF32 };
+  // Read-only view of IQ still owned by the source (see leaseIQ). Exactly one
+  // of u8 / cf32 is set, matching nativeFormat().
+  struct IqLease {
+    const uint8_t *u8 = nullptr;
+    const std::complex<float> *cf32 = nullptr;
+    size_t samples = 0;
+  };
 
   TunerController(const std::string &source, const std::string &tcpHost,
                   uint16_t tcpPort, uint32_t rtlDeviceIndex);
@@ -23,20 +33,36 @@ public:
   SourceKind kind() const { return m_kind; }
   bool isDirectRtlSdr() const { return m_kind == SourceKind::RtlSdr; }
   bool isSdrPlay() const { return m_kind == SourceKind::SdrPlay; }
+  bool isFile() const { return m_kind == SourceKind::File; }
   IqFormat nativeFormat() const {
-    return m_kind == SourceKind::SdrPlay ? IqFormat::CF32 : IqFormat::U8;
+    if (m_kind == SourceKind::SdrPlay ||
+        (m_kind == SourceKind::File &&
+         m_fileSource.format() != FileSource::Format::U8)) {
+      return IqFormat::CF32;
+    }
+    return IqFormat::U8;
   }
   const char *name() const;
 
   // SDRplay-only knobs, applied at connect (and immediately when connected).
   // No-ops for RTL sources.
   void configureSdrplay(int lnaState, int antenna, bool biasTee);
+  // File-replay source settings (see FileSource::configure), applied at
+  // connect. No-ops for live sources.
+  void configureReplay(const std::string &path, const std::string &format,
+                       bool paced, bool loop);
 
   void setLowLatencyMode(bool enable);
+  // Periodic receive-stats log (rtl_tcp only).
+  void setVerboseLogging(bool enable);
 
   bool connect();
   void disconnect();
   bool setFrequency(uint32_t freqHz);
+  // Last frequency the source accepted (0 before the first tune).
+  uint32_t frequencyHz() const {
+    return m_frequencyHz.load(std::memory_order_relaxed);
+  }
   bool setSampleRate(uint32_t sampleRate);
   bool setFrequencyCorrection(int ppm);
   bool setGainMode(bool manual);
@@ -52,12 +78,23 @@ public:
   // returns 0 for non-SDRplay sources (caller keeps its normal rate).
   uint32_t setScanWideMode(bool wide);
   // Drop buffered IQ so the next readIQ returns only post-call samples. Used
-  // after a scan retune to discard stale pre-retune data. No-op where the
-  // source has no large buffer (rtl_tcp reads on demand; SDRplay already
-  // flushes its ring on retune).
+  // after a scan retune to discard stale pre-retune data. No-op for SDRplay,
+  // which already flushes its ring on retune, and for file replay, which has
+  // no buffer.
   void flushBuffers();
   size_t readIQ(uint8_t *buffer, size_t maxSamples);
   size_t readIQ(std::complex<float> *buffer, size_t maxSamples);
+  // Zero-copy read: waits like readIQ, then hands out up to maxSamples of IQ
+  // in the source's native format straight from its receive ring, so the DSP
+  // front end reads the samples where the driver left them. The span is valid
+  // until releaseIQ(); hold at most one lease, and don't call readIQ or
+  // flushBuffers while it is outstanding. samples == 0 means no data.
+  IqLease leaseIQ(size_t maxSamples);
+  void releaseIQ(const IqLease &lease);
+  // IQ the source has received but not yet released, including a lease
+  // still held: how far the read side trails the receiver. 0 for file
+  // replay, which has no receive buffer.
+  size_t queuedSamples() const;
 
   // Number of selectable antenna inputs (1 = none / not applicable).
   int antennaCount() const;
@@ -65,9 +102,12 @@ public:
   // name otherwise.
   const char *modelName() const;
 
-  // True after a fatal streaming error / device loss (SDRplay only; always
-  // false for RTL sources, which surface failures via zero-length reads).
+  // True after a fatal streaming error / device loss (SDRplay) or once the
+  // rtl_tcp server closed the stream; local RTL-SDR surfaces failures via
+  // zero-length reads.
   bool deviceFailed() const;
+  // True once a non-looping file replay has played to the end.
+  bool endOfStream() const;
   // Effective IQ sample rate the source delivers (SDRplay reports its post
   // decimation rate; 0 = "use the configured iqSampleRate").
   int deliveredSampleRate() const;
@@ -77,6 +117,8 @@ private:
   RTLTCPClient m_rtlTcpClient;
   RTLSDRDevice m_rtlSdrDevice;
   SDRplayDevice m_sdrplayDevice;
+  FileSource m_fileSource;
+  std::atomic<uint32_t> m_frequencyHz{0};
   int m_sdrplayLnaState = 4;
   int m_sdrplayAntenna = 0;
   bool m_sdrplayBiasTee = false;
@@ -11,7 +11,7 @@
 #include <thread>
 #include <vector>
 
-#include "dsp/liquid_primitives.h"
+#include "dsp/polyphase_resampler.h"
 
 class WavWriter {
 public:
@@ -72,9 +72,7 @@ private:
   // Optional input-side resampler for the mono path (e.g. MPX at 256 kHz →
   // 192 kHz). Inactive when m_resampleEnabled is false.
   bool m_resampleEnabled;
-  fm_tuner::dsp::liquid::Resampler m_resampler;
-  std::array<float, fm_tuner::dsp::liquid::Resampler::kMaxOutput>
-      m_resampleTmp{};
+  fm_tuner::dsp::PolyphaseResampler m_resampler;
   std::vector<float> m_resampleAccum;
 };
 
@@ -8,7 +8,7 @@ CONFIG_FILE="${CONFIG_FILE:-$ROOT_DIR/fm-sdr-tuner.ini}"
 
 if [ ! -f "$BUILD_DIR/CMakeCache.txt" ]; then
   echo "configuring build directory: $BUILD_DIR"
-  cmake -S "$ROOT_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Debug -DFM_TUNER_ENABLE_X86_AVX2=OFF
+  cmake -S "$ROOT_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Debug
 fi
 
 echo "Rebuilding fm-sdr-tuner"
@@ -7,7 +7,7 @@ BIN="$BUILD_DIR/tests/test_rtl_sdr_live"
 
 if [ ! -f "$BUILD_DIR/CMakeCache.txt" ]; then
   echo "configuring build directory: $BUILD_DIR"
-  cmake -S "$ROOT_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Debug -DFM_TUNER_ENABLE_X86_AVX2=OFF
+  cmake -S "$ROOT_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Debug
 fi
 
 echo "Rebuilding test_rtl_sdr_live"
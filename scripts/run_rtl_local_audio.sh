@@ -9,7 +9,7 @@ CONFIG_FILE="${CONFIG_FILE:-$ROOT_DIR/fm-sdr-tuner.ini}"
 if [ ! -x "$BIN" ]; then
   echo "binary not found: $BIN" >&2
   echo "build it first with:" >&2
-  echo "  cmake -S . -B build -DCMAKE_BUILD_TYPE=Debug -DFM_TUNER_ENABLE_X86_AVX2=OFF" >&2
+  echo "  cmake -S . -B build -DCMAKE_BUILD_TYPE=Debug" >&2
   echo "  cmake --build build -j4" >&2
   exit 1
 fi
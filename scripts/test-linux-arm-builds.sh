@@ -22,7 +22,7 @@ run_ubuntu_24_04() {
     -v "${REPO_ROOT}:/src" \
     -w /src \
     ubuntu:24.04 \
-    bash -lc "apt-get update && apt-get install -y cmake g++ file dpkg-dev pkg-config librtlsdr-dev libusb-1.0-0-dev libssl-dev libasound2-dev libliquid-dev && cmake -S . -B build-ubuntu-arm -DCMAKE_BUILD_TYPE=Release -DFM_TUNER_ENABLE_X86_AVX2=OFF && cmake --build build-ubuntu-arm -j\$(nproc) && cd build-ubuntu-arm && cpack -G DEB && cp ./*.deb /src/.docker-artifacts/ubuntu-arm64/"
+    bash -lc "apt-get update && apt-get install -y cmake g++ file dpkg-dev pkg-config librtlsdr-dev libusb-1.0-0-dev libssl-dev libasound2-dev libliquid-dev && cmake -S . -B build-ubuntu-arm -DCMAKE_BUILD_TYPE=Release && cmake --build build-ubuntu-arm -j\$(nproc) && cd build-ubuntu-arm && cpack -G DEB && cp ./*.deb /src/.docker-artifacts/ubuntu-arm64/"
 }
 
 run_debian_trixie() {
@@ -33,7 +33,7 @@ run_debian_trixie() {
     -v "${REPO_ROOT}:/src" \
     -w /src \
     debian:trixie \
-    bash -lc "apt-get update && apt-get install -y cmake g++ file dpkg-dev pkg-config librtlsdr-dev libusb-1.0-0-dev libssl-dev libasound2-dev libliquid-dev && cmake -S . -B build-debian-arm -DCMAKE_BUILD_TYPE=Release -DFM_TUNER_ENABLE_X86_AVX2=OFF && cmake --build build-debian-arm -j\$(nproc) && cd build-debian-arm && cpack -G DEB && cp ./*.deb /src/.docker-artifacts/debian-arm64/"
+    bash -lc "apt-get update && apt-get install -y cmake g++ file dpkg-dev pkg-config librtlsdr-dev libusb-1.0-0-dev libssl-dev libasound2-dev libliquid-dev && cmake -S . -B build-debian-arm -DCMAKE_BUILD_TYPE=Release && cmake --build build-debian-arm -j\$(nproc) && cd build-debian-arm && cpack -G DEB && cp ./*.deb /src/.docker-artifacts/debian-arm64/"
 }
 
 run_fedora() {
@@ -47,7 +47,7 @@ run_fedora() {
     -v "${REPO_ROOT}:/src" \
     -w /src \
     "fedora:${version}" \
-    bash -lc "dnf install -y cmake gcc-c++ make pkgconfig openssl-devel alsa-lib-devel rtl-sdr-devel liquid-dsp-devel rpm-build && cmake -S . -B ${build_dir} -DCMAKE_BUILD_TYPE=Release -DFM_TUNER_ENABLE_X86_AVX2=OFF && cmake --build ${build_dir} -j\$(nproc) && cd ${build_dir} && cpack -G RPM && cp ./*.rpm /src/.docker-artifacts/fedora-${version}-arm64/"
+    bash -lc "dnf install -y cmake gcc-c++ make pkgconfig openssl-devel alsa-lib-devel rtl-sdr-devel liquid-dsp-devel rpm-build && cmake -S . -B ${build_dir} -DCMAKE_BUILD_TYPE=Release && cmake --build ${build_dir} -j\$(nproc) && cd ${build_dir} && cpack -G RPM && cp ./*.rpm /src/.docker-artifacts/fedora-${version}-arm64/"
 }
 
 smoke_test_deb_pkg() {
@@ -9,45 +9,40 @@ AFPostProcessor::AFPostProcessor(int inputRate, int outputRate)
       m_outputRate(std::max(1, outputRate)), m_deemphasisEnabled(false),
       m_deemphasisTauUs(0), m_hicutMode(HicutMode::Off), m_signalQuality(1.0f),
       m_currentHicutWeight(0.0f) {
-  const float ratio =
-      static_cast<float>(m_outputRate) / static_cast<float>(m_inputRate);
   // The resampler is also the audio anti-alias / band-limiting filter: the
   // stereo decoder's mono path is the raw MPX (pilot 19 kHz, stereo subcarrier
   // 23-53 kHz, RDS 57 kHz all present), so without a band-limit those fold into
   // the 0-24 kHz output and alias to ~9-10 kHz — audible "ringing"/lossy-codec
-  // artifacts. liquid's default cutoff (0.47) does NOT band-limit a 5.33x
-  // downsample at all (it passes everything). Set the cutoff to the ~16 kHz FM
+  // artifacts. A generic 0.47 cutoff does NOT band-limit a 5.33x downsample at
+  // all (it passes everything). Set the cutoff to the ~16 kHz FM
   // audio edge (normalized to the input rate) with enough taps for a steep
   // transition: passband flat to ~14 kHz, subcarrier/RDS rejected by 85+ dB.
   constexpr float kAudioCutoffHz = 16000.0f;
-  constexpr std::uint32_t kResampHalfLen = 48;
   constexpr float kResampStopBandDb = 80.0f;
-  constexpr std::uint32_t kResampPolyphase = 64;
+  // 48 input samples either side at 256 kHz. The span is kept constant in
+  // time, so the transition width in Hz does not depend on the input rate
+  // (and a 128 kHz half-rate MPX needs half the taps per output).
+  constexpr double kResampHalfLenAt256k = 48.0;
+  const std::uint32_t resampHalfLen = std::max<std::uint32_t>(
+      8, static_cast<std::uint32_t>(
+             std::ceil(kResampHalfLenAt256k *
+                       static_cast<double>(m_inputRate) / 256000.0)));
   const float cutoffNorm =
       std::min(0.45f, kAudioCutoffHz / static_cast<float>(m_inputRate));
-  m_liquidLeftResampler.init(ratio, kResampHalfLen, cutoffNorm,
-                             kResampStopBandDb, kResampPolyphase);
-  m_liquidRightResampler.init(ratio, kResampHalfLen, cutoffNorm,
-                              kResampStopBandDb, kResampPolyphase);
-  m_liquidLeftDcBlock.initDCBlocker(kDcBlockAlpha);
-  m_liquidRightDcBlock.initDCBlocker(kDcBlockAlpha);
+  m_resampler.init(static_cast<std::uint32_t>(m_inputRate),
+                   static_cast<std::uint32_t>(m_outputRate), resampHalfLen,
+                   cutoffNorm, kResampStopBandDb);
+  m_dcBlock.setDcBlockerLane(0, kDcBlockAlpha);
+  m_dcBlock.setDcBlockerLane(1, kDcBlockAlpha);
   reset();
   setDeemphasis(kDefaultDeemphasisUs);
 }
 
 void AFPostProcessor::reset() {
-  m_liquidLeftResampler.reset();
-  m_liquidRightResampler.reset();
-  m_liquidLeftDcBlock.reset();
-  m_liquidRightDcBlock.reset();
-  if (m_deemphasisEnabled) {
-    m_liquidLeftDeemphasis.reset();
-    m_liquidRightDeemphasis.reset();
-    if (m_hicutMode != HicutMode::Off) {
-      m_liquidLeftDeemphasisNarrow.reset();
-      m_liquidRightDeemphasisNarrow.reset();
-    }
-  }
+  m_resampler.reset();
+  m_dcBlock.reset();
+  m_deemphasis.reset();
+  m_deemphasisHicut.reset();
   m_currentHicutWeight = 0.0f;
 }
 
@@ -55,8 +50,8 @@ void AFPostProcessor::setDeemphasis(int tau_us) {
   if (tau_us <= 0) {
     m_deemphasisEnabled = false;
     m_deemphasisTauUs = 0;
-    m_liquidLeftDeemphasis.reset();
-    m_liquidRightDeemphasis.reset();
+    m_deemphasis.reset();
+    m_deemphasisHicut.reset();
     return;
   }
   m_deemphasisEnabled = true;
@@ -90,79 +85,123 @@ void AFPostProcessor::rebuildDeemphasis() {
     const float wpp = std::tan(wp / (2.0f * fs));
     const float b0 = wpp / (wpp + 1.0f);
     const float a1 = (wpp - 1.0f) / (wpp + 1.0f);
-    return std::pair<std::vector<float>, std::vector<float>>{
-        {b0, b0}, {1.0f, a1}};
+    return std::pair<float, float>{b0, a1};
   };
-  auto [coeffsNormal, fbNormal] = designForTau(tau);
-  m_liquidLeftDeemphasis.init(coeffsNormal, fbNormal);
-  m_liquidRightDeemphasis.init(coeffsNormal, fbNormal);
+  const auto [b0Normal, a1Normal] = designForTau(tau);
+  m_deemphasis.setLane(0, b0Normal, b0Normal, a1Normal);
+  m_deemphasis.setLane(1, b0Normal, b0Normal, a1Normal);
 
   if (m_hicutMode != HicutMode::Off) {
     // Narrow-τ design: Gentle = 2×, Strong = 5× the configured τ. Steeper
     // top-end rolloff burying hiss on marginal signals; gentle stays close
     // to spec, strong is the SCA / DXer setting.
     const float multiplier = (m_hicutMode == HicutMode::Gentle) ? 2.0f : 5.0f;
-    auto [coeffsNarrow, fbNarrow] = designForTau(tau * multiplier);
-    m_liquidLeftDeemphasisNarrow.init(coeffsNarrow, fbNarrow);
-    m_liquidRightDeemphasisNarrow.init(coeffsNarrow, fbNarrow);
+    const auto [b0Narrow, a1Narrow] = designForTau(tau * multiplier);
+    m_deemphasisHicut.setLane(0, b0Normal, b0Normal, a1Normal);
+    m_deemphasisHicut.setLane(1, b0Normal, b0Normal, a1Normal);
+    m_deemphasisHicut.setLane(2, b0Narrow, b0Narrow, a1Narrow);
+    m_deemphasisHicut.setLane(3, b0Narrow, b0Narrow, a1Narrow);
+  }
+}
+
+size_t AFPostProcessor::processInterleaved(const float *inLeft,
+                                           const float *inRight,
+                                           size_t inSamples, float *outFrames,
+                                           size_t outCapacity) {
+  if (!inLeft || !inRight || !outFrames || inSamples == 0 ||
+      outCapacity == 0 || m_resampler.maxOutput(inSamples) > outCapacity) {
+    return 0;
   }
+  const size_t produced =
+      m_resampler.executeStereo(inLeft, inRight, inSamples, outFrames);
+  filterFrames(outFrames, produced);
+  return produced;
+}
+
+size_t AFPostProcessor::processMonoInterleaved(const float *in,
+                                               size_t inSamples,
+                                               float *outFrames,
+                                               size_t outCapacity) {
+  if (!in || !outFrames || inSamples == 0 || outCapacity == 0 ||
+      m_resampler.maxOutput(inSamples) > outCapacity) {
+    return 0;
+  }
+  const size_t produced =
+      m_resampler.executeMonoToStereo(in, inSamples, outFrames);
+  filterFrames(outFrames, produced);
+  return produced;
 }
 
 size_t AFPostProcessor::process(const float *inLeft, const float *inRight,
                                 size_t inSamples, float *outLeft,
                                 float *outRight, size_t outCapacity) {
-  if (!inLeft || !inRight || !outLeft || !outRight || inSamples == 0 ||
-      outCapacity == 0) {
+  if (!outLeft || !outRight) {
     return 0;
   }
+  m_frameScratch.resize(2 * m_resampler.maxOutput(inSamples));
+  const size_t frames =
+      processInterleaved(inLeft, inRight, inSamples, m_frameScratch.data(),
+                         m_frameScratch.size() / 2);
+  return deinterleave(std::min(frames, outCapacity), outLeft, outRight);
+}
 
-  // HiCut crossfade target. Lower quality → more narrow blend. (1-q)² gives
-  // a gentler ramp than linear; HiCut only opens up meaningfully when quality
-  // is below ~0.7. Smoothing alpha at output-rate is ~50 ms time constant so
-  // the crossfade tracks stereo quality without ringing.
-  const float targetHicutWeight =
-      (m_hicutMode == HicutMode::Off)
-          ? 0.0f
-          : std::clamp((1.0f - m_signalQuality) * (1.0f - m_signalQuality),
-                       0.0f, 1.0f);
-  const float weightSmoothAlpha =
-      1.0f - std::exp(-1.0f / (0.050f * static_cast<float>(m_outputRate)));
+size_t AFPostProcessor::processMono(const float *in, size_t inSamples,
+                                    float *outLeft, float *outRight,
+                                    size_t outCapacity) {
+  if (!outLeft || !outRight) {
+    return 0;
+  }
+  m_frameScratch.resize(2 * m_resampler.maxOutput(inSamples));
+  const size_t frames = processMonoInterleaved(
+      in, inSamples, m_frameScratch.data(), m_frameScratch.size() / 2);
+  return deinterleave(std::min(frames, outCapacity), outLeft, outRight);
+}
 
-  size_t outCount = 0;
-  for (size_t i = 0; i < inSamples && outCount < outCapacity; i++) {
-    const uint32_t leftProduced =
-        m_liquidLeftResampler.execute(inLeft[i], m_liquidLeftTmp);
-    const uint32_t rightProduced =
-        m_liquidRightResampler.execute(inRight[i], m_liquidRightTmp);
-    const uint32_t produced = std::min(leftProduced, rightProduced);
+size_t AFPostProcessor::deinterleave(size_t frames, float *outLeft,
+                                     float *outRight) const {
+  for (size_t i = 0; i < frames; i++) {
+    outLeft[i] = m_frameScratch[2 * i];
+    outRight[i] = m_frameScratch[2 * i + 1];
+  }
+  return frames;
+}
 
-    for (uint32_t idx = 0; idx < produced && outCount < outCapacity; idx++) {
-      float left = m_liquidLeftTmp[idx];
-      float right = m_liquidRightTmp[idx];
-      if (m_deemphasisEnabled) {
-        const float leftNormal = m_liquidLeftDeemphasis.execute(left);
-        const float rightNormal = m_liquidRightDeemphasis.execute(right);
-        if (m_hicutMode != HicutMode::Off) {
-          m_currentHicutWeight +=
-              weightSmoothAlpha * (targetHicutWeight - m_currentHicutWeight);
-          const float leftNarrow =
-              m_liquidLeftDeemphasisNarrow.execute(left);
-          const float rightNarrow =
-              m_liquidRightDeemphasisNarrow.execute(right);
-          const float w = m_currentHicutWeight;
-          left = leftNormal * (1.0f - w) + leftNarrow * w;
-          right = rightNormal * (1.0f - w) + rightNarrow * w;
-        } else {
-          left = leftNormal;
-          right = rightNormal;
-        }
-      }
-      left = m_liquidLeftDcBlock.execute(left);
-      right = m_liquidRightDcBlock.execute(right);
-      outLeft[outCount] = left;
-      outRight[outCount] = right;
-      outCount++;
+void AFPostProcessor::filterFrames(float *frames, size_t count) {
+  if (m_deemphasisEnabled && m_hicutMode != HicutMode::Off) {
+    // HiCut crossfade target. Lower quality → more narrow blend. (1-q)²
+    // gives a gentler ramp than linear; HiCut only opens up meaningfully
+    // when quality is below ~0.7. Smoothing alpha at output-rate is ~50 ms
+    // time constant so the crossfade tracks stereo quality without ringing.
+    const float targetHicutWeight = std::clamp(
+        (1.0f - m_signalQuality) * (1.0f - m_signalQuality), 0.0f, 1.0f);
+    const float weightSmoothAlpha =
+        1.0f - std::exp(-1.0f / (0.050f * static_cast<float>(m_outputRate)));
+    // Normal and narrow de-emphasis of both channels in one 4-lane step,
+    // then the per-sample smoothed crossfade and the DC blocker.
+    for (size_t i = 0; i < count; i++) {
+      float *frame = frames + 2 * i;
+      const float in[4] = {frame[0], frame[1], frame[0], frame[1]};
+      float filtered[4];
+      m_deemphasisHicut.step(in, filtered);
+      m_currentHicutWeight +=
+          weightSmoothAlpha * (targetHicutWeight - m_currentHicutWeight);
+      const float w = m_currentHicutWeight;
+      const float mixed[2] = {filtered[0] * (1.0f - w) + filtered[2] * w,
+                              filtered[1] * (1.0f - w) + filtered[3] * w};
+      m_dcBlock.step(mixed, frame);
+    }
+  } else if (m_deemphasisEnabled) {
+    for (size_t i = 0; i < count; i++) {
+      float *frame = frames + 2 * i;
+      float filtered[2];
+      m_deemphasis.step(frame, filtered);
+      m_dcBlock.step(filtered, frame);
+    }
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      float *frame = frames + 2 * i;
+      const float in[2] = {frame[0], frame[1]};
+      m_dcBlock.step(in, frame);
     }
   }
-  return outCount;
 }
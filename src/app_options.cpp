@@ -12,6 +12,9 @@
 
 namespace {
 
+constexpr uint32_t kMinIqRate = Config::RTLTCPSection::kMinSampleRate;
+constexpr uint32_t kMaxIqRate = Config::RTLTCPSection::kMaxSampleRate;
+
 bool parseSourceOption(std::string value, std::string &outSource) {
   std::transform(
       value.begin(), value.end(), value.begin(),
@@ -28,6 +31,10 @@ bool parseSourceOption(std::string value, std::string &outSource) {
     outSource = "sdrplay";
     return true;
   }
+  if (value == "file" || value == "replay") {
+    outSource = "file";
+    return true;
+  }
   return false;
 }
 
@@ -40,12 +47,21 @@ void printUsage(const char *prog) {
       << "  -c, --config <file>    INI config file\n"
       << "  -t, --tcp <host:port>  rtl_tcp server address (default: "
          "localhost:1234)\n"
-      << "      --iq-rate <rate>   IQ sample rate: 256000, 1024000, or 2048000 "
-         "(default: 256000)\n"
-      << "      --source <name>    Tuner source: rtl_tcp, rtl_sdr, or sdrplay "
-         "(default: rtl_sdr)\n"
+      << "      --iq-rate <rate>   IQ sample rate, 256000 to 10000000; other than "
+         "256000 it is\n"
+      << "                         decimated / resampled to 256000 (default: "
+         "256000)\n"
+      << "      --source <name>    Tuner source: rtl_tcp, rtl_sdr, sdrplay, or "
+         "file (default: rtl_sdr)\n"
       << "      --rtl-device <id>  RTL-SDR device index for --source rtl_sdr "
          "(default: 0)\n"
+      << "      --replay <file>    Replay an IQ recording (u8 as written by -i, "
+         "or CF32); implies --source file\n"
+      << "      --replay-format <fmt>\n"
+      << "                        auto|u8|cf32|cs16 (default: auto, by extension)\n"
+      << "      --replay-fast      Replay as fast as possible instead of at the "
+         "IQ rate\n"
+      << "      --replay-loop      Restart the recording when it ends\n"
       << "  -f, --freq <khz>      Frequency in kHz (default: 87500)\n"
       << "  -g, --gain <db>       RTL-SDR gain in dB (default: auto)\n"
       << "  -b, --blend <mode>    Stereo blend: soft|normal|aggressive (default: "
@@ -65,8 +81,19 @@ void printUsage(const char *prog) {
          "-6; full scale = 150 kHz deviation). 0 restores the legacy 1.0 = "
          "75 kHz scale, which clips on real broadcast peaks\n"
       << "  -i, --iq <file>       Capture raw IQ bytes to file\n"
+      << "      --iq-format <fmt> IQ capture format: auto|u8|cf32|cs16 "
+         "(default: auto, by extension: .cf32 / .cs16, else u8)\n"
+      << "      --iq-rotate-mb <n>\n"
+      << "                        Start a new IQ capture file every n MiB "
+         "(file_0000.iq, file_0001.iq, ...)\n"
+      << "      --iq-rotate-sec <n>\n"
+      << "                        Start a new IQ capture file every n seconds "
+         "of IQ\n"
       << "      --low-latency-iq  Keep newest IQ samples (drop backlog on "
          "overload)\n"
+      << "      --latency <ms>    Aim for this IQ-to-DAC latency: small DSP "
+         "blocks, a tight speaker ring and device buffer, newest-IQ reads "
+         "(20 to 500; 0 = off; overrides [audio] target_latency_ms)\n"
       << "      --auto-start      Start tuner immediately without waiting for "
          "an XDR start command\n"
       << "  -s, --audio           Enable audio output\n"
@@ -83,6 +110,10 @@ void printUsage(const char *prog) {
          "overrides [rest] port)\n"
       << "      --rest-bind <addr> REST control API bind address (default: "
          "127.0.0.1)\n"
+      << "      --kernels <spec>   SIMD kernel variants: auto, an ISA ceiling "
+         "(scalar|neon|avx2|avx512) or kernel:isa list, e.g. "
+         "channel_fir:avx2,resampler:scalar (overrides [processing] "
+         "kernels)\n"
       << "  -v, --verbose          Enable verbose diagnostic logging "
          "(overrides [debug] log_level)\n"
       << "  -q, --quiet            Disable diagnostic logging "
@@ -143,10 +174,15 @@ AppParseResult parseAppOptions(int argc, char *argv[], int inputRate) {
   opts.xdrPort = opts.config.xdr.port;
   opts.autoReconnect = opts.config.reconnection.auto_reconnect;
   opts.lowLatencyIq = opts.config.sdr.low_latency_iq;
+  opts.targetLatencyMs = opts.config.audio.target_latency_ms;
+  opts.replayFile = opts.config.replay.file;
+  opts.replayFormat = opts.config.replay.format;
+  opts.replayRealtime = opts.config.replay.realtime;
+  opts.replayLoop = opts.config.replay.loop;
 
   if (!parseSourceOption(opts.tunerSource, opts.tunerSource)) {
     std::cerr << "[Config] invalid tuner.source: " << opts.config.tuner.source
-              << " (expected rtl_tcp or rtl_sdr), using rtl_sdr\n";
+              << " (expected rtl_tcp, rtl_sdr, sdrplay or file), using rtl_sdr\n";
     opts.tunerSource = "rtl_sdr";
   }
 
@@ -250,6 +286,14 @@ AppParseResult parseAppOptions(int argc, char *argv[], int inputRate) {
       opts.lowLatencyIq = true;
       continue;
     }
+    if (arg == "--replay-fast") {
+      opts.replayRealtime = false;
+      continue;
+    }
+    if (arg == "--replay-loop") {
+      opts.replayLoop = true;
+      continue;
+    }
     if (arg == "--auto-start") {
       opts.autoStart = true;
       continue;
@@ -306,11 +350,13 @@ AppParseResult parseAppOptions(int argc, char *argv[], int inputRate) {
       const std::string value = readValue(i, arg, "iq-rate");
       try {
         const int parsed = std::stoi(value);
-        if (parsed == 256000 || parsed == 1024000 || parsed == 2048000) {
+        if (parsed >= static_cast<int>(kMinIqRate) &&
+            parsed <= static_cast<int>(kMaxIqRate)) {
           opts.iqSampleRate = static_cast<uint32_t>(parsed);
         } else {
           std::cerr << "[CLI] invalid --iq-rate value: " << value
-                    << " (expected 256000, 1024000, or 2048000)\n";
+                    << " (expected " << kMinIqRate << " to " << kMaxIqRate
+                    << ")\n";
           result.outcome = AppParseOutcome::ExitFailure;
           return result;
         }
@@ -321,11 +367,31 @@ AppParseResult parseAppOptions(int argc, char *argv[], int inputRate) {
       }
       continue;
     }
+    if (arg == "--latency" || arg.rfind("--latency=", 0) == 0) {
+      const std::string value = readValue(i, arg, "latency");
+      int parsed = 0;
+      if (value.empty() || !parseIntOption("latency", value, parsed)) {
+        result.outcome = AppParseOutcome::ExitFailure;
+        return result;
+      }
+      if (parsed != 0 &&
+          (parsed < Config::AudioSection::kMinTargetLatencyMs ||
+           parsed > Config::AudioSection::kMaxTargetLatencyMs)) {
+        std::cerr << "[CLI] invalid --latency value: " << value
+                  << " (expected 0 or "
+                  << Config::AudioSection::kMinTargetLatencyMs << " to "
+                  << Config::AudioSection::kMaxTargetLatencyMs << ")\n";
+        result.outcome = AppParseOutcome::ExitFailure;
+        return result;
+      }
+      opts.targetLatencyMs = parsed;
+      continue;
+    }
     if (arg == "--source" || arg.rfind("--source=", 0) == 0) {
       const std::string value = readValue(i, arg, "source");
       if (value.empty() || !parseSourceOption(value, opts.tunerSource)) {
         std::cerr << "[CLI] invalid source value: " << value
-                  << " (expected rtl_tcp or rtl_sdr)\n";
+                  << " (expected rtl_tcp, rtl_sdr, sdrplay or file)\n";
         result.outcome = AppParseOutcome::ExitFailure;
         return result;
       }
@@ -375,6 +441,16 @@ AppParseResult parseAppOptions(int argc, char *argv[], int inputRate) {
       opts.mpxWavFile = value;
       continue;
     }
+    if (arg == "--kernels" || arg.rfind("--kernels=", 0) == 0) {
+      const std::string value = readValue(i, arg, "kernels");
+      if (value.empty()) {
+        std::cerr << "[CLI] missing value for --kernels\n";
+        result.outcome = AppParseOutcome::ExitFailure;
+        return result;
+      }
+      opts.config.processing.kernels = value;
+      continue;
+    }
     if (arg == "--mpx-audio") {
       opts.mpxAudioEnabled = true;
       continue;
@@ -447,6 +523,60 @@ AppParseResult parseAppOptions(int argc, char *argv[], int inputRate) {
       opts.iqFile = value;
       continue;
     }
+    if (arg == "--replay" || arg.rfind("--replay=", 0) == 0) {
+      const std::string value = readValue(i, arg, "replay");
+      if (value.empty()) {
+        std::cerr << "[CLI] missing value for --replay\n";
+        result.outcome = AppParseOutcome::ExitFailure;
+        return result;
+      }
+      opts.replayFile = value;
+      opts.tunerSource = "file";
+      continue;
+    }
+    if (arg == "--replay-format" || arg.rfind("--replay-format=", 0) == 0) {
+      const std::string value = readValue(i, arg, "replay-format");
+      if (value != "auto" && value != "u8" && value != "cf32" &&
+          value != "cs16") {
+        std::cerr << "[CLI] invalid --replay-format value: '" << value
+                  << "' (expected auto|u8|cf32|cs16)\n";
+        result.outcome = AppParseOutcome::ExitFailure;
+        return result;
+      }
+      opts.replayFormat = value;
+      continue;
+    }
+    if (arg == "--iq-format" || arg.rfind("--iq-format=", 0) == 0) {
+      const std::string value = readValue(i, arg, "iq-format");
+      if (value != "auto" && value != "u8" && value != "cf32" &&
+          value != "cs16") {
+        std::cerr << "[CLI] invalid --iq-format value: '" << value
+                  << "' (expected auto|u8|cf32|cs16)\n";
+        result.outcome = AppParseOutcome::ExitFailure;
+        return result;
+      }
+      opts.iqFormat = value;
+      continue;
+    }
+    if (arg == "--iq-rotate-mb" || arg.rfind("--iq-rotate-mb=", 0) == 0 ||
+        arg == "--iq-rotate-sec" || arg.rfind("--iq-rotate-sec=", 0) == 0) {
+      const bool bySize = arg.rfind("--iq-rotate-mb", 0) == 0;
+      const char *name = bySize ? "iq-rotate-mb" : "iq-rotate-sec";
+      const std::string value = readValue(i, arg, name);
+      int parsed = 0;
+      if (!parseIntOption(name, value, parsed)) {
+        result.outcome = AppParseOutcome::ExitFailure;
+        return result;
+      }
+      if (parsed < 0) {
+        std::cerr << "[CLI] --" << name << " must be >= 0\n";
+        result.outcome = AppParseOutcome::ExitFailure;
+        return result;
+      }
+      (bySize ? opts.iqRotateMb : opts.iqRotateSeconds) =
+          static_cast<uint32_t>(parsed);
+      continue;
+    }
     if (arg == "-d" || arg == "--device" || arg.rfind("--device=", 0) == 0) {
       const std::string value = readValue(i, arg, "device");
       if (value.empty()) {
@@ -532,17 +662,10 @@ AppParseResult parseAppOptions(int argc, char *argv[], int inputRate) {
     return result;
   }
 
-  if (!(opts.iqSampleRate == 256000 || opts.iqSampleRate == 1024000 ||
-        opts.iqSampleRate == 2048000)) {
+  if (opts.iqSampleRate < static_cast<uint32_t>(std::max(0, inputRate)) ||
+      opts.iqSampleRate > kMaxIqRate) {
     std::cerr << "[SDR] unsupported iq sample rate: " << opts.iqSampleRate
-              << " (expected 256000, 1024000, or 2048000)\n";
-    result.outcome = AppParseOutcome::ExitFailure;
-    return result;
-  }
-  const size_t iqDecimation = static_cast<size_t>(opts.iqSampleRate / inputRate);
-  if (iqDecimation == 0 || (opts.iqSampleRate % inputRate) != 0) {
-    std::cerr << "[SDR] iq sample rate must be an integer multiple of "
-              << inputRate << "\n";
+              << " (expected " << inputRate << " to " << kMaxIqRate << ")\n";
     result.outcome = AppParseOutcome::ExitFailure;
     return result;
   }
@@ -15,8 +15,11 @@
 
 #include "audio_output.h"
 #include "cpu_features.h"
+#include "dsp/kernel_registry.h"
 #include "dsp/runtime.h"
 #include "dsp_pipeline.h"
+#include "iq_capture_writer.h"
+#include "latency_meter.h"
 #include "mpx_audio_output.h"
 #include "processing_runner.h"
 #include "rds_worker.h"
@@ -45,12 +48,16 @@ void Application::logStartup(const CPUFeatures &cpu) const {
     return;
   }
   std::cout << "[CPU] " << cpu.summary() << "\n";
+  std::cout << "[DSP] kernels: " << fm_tuner::dsp::kernelSelectionSummary()
+            << "\n";
   if (!m_options.configPath.empty()) {
     std::cout << "[Config] loaded: " << m_options.configPath << "\n";
   }
   std::cout << "[Config] audio.device='" << config.audio.device << "'\n";
   std::cout << "[Config] audio.startup_volume=" << config.audio.startup_volume
             << "\n";
+  std::cout << "[Config] audio.target_latency_ms="
+            << config.audio.target_latency_ms << "\n";
   std::cout << "[Config] processing.dsp_block_samples="
             << config.processing.dsp_block_samples << "\n";
   std::cout << "[Config] processing.w0_bandwidth_hz="
@@ -80,6 +87,7 @@ bool Application::initAudioOutput(AudioOutput &audioOut,
   }
   const std::string &audioDeviceToUse =
       !m_options.audioDevice.empty() ? m_options.audioDevice : config.audio.device;
+  audioOut.setTargetLatencyMs(m_options.targetLatencyMs);
   if (!audioOut.init(m_options.enableSpeaker, m_options.wavFile, audioDeviceToUse,
                      verboseLogging)) {
     std::cerr << "[AUDIO] failed to initialize audio output\n";
@@ -93,24 +101,51 @@ bool Application::initAudioOutput(AudioOutput &audioOut,
   return true;
 }
 
-FILE *Application::openIqCapture(AudioOutput &audioOut,
-                                 TunerSession &tunerSession) const {
+bool Application::openIqCapture(IqCaptureWriter &iqCapture, uint32_t sampleRate,
+                                TunerController::IqFormat sourceFormat,
+                                AudioOutput &audioOut,
+                                TunerSession &tunerSession) const {
   const bool verboseLogging = m_options.verboseLogging;
   if (m_options.iqFile.empty()) {
-    return nullptr;
+    return true;
   }
-  FILE *iqHandle = std::fopen(m_options.iqFile.c_str(), "wb");
-  if (!iqHandle) {
+  IqCaptureWriter::Options options;
+  options.sampleRate = sampleRate;
+  // The ring holds the source's native samples; conversion to the file
+  // format happens on the writer thread.
+  options.inputFormat = (sourceFormat == TunerController::IqFormat::CF32)
+                            ? IqCaptureWriter::Format::CF32
+                            : IqCaptureWriter::Format::U8;
+  (void)IqCaptureWriter::parseFormat(m_options.iqFormat, m_options.iqFile,
+                                     options.fileFormat);
+  options.rotateBytes =
+      static_cast<uint64_t>(m_options.iqRotateMb) * 1024ULL * 1024ULL;
+  options.rotateSeconds = m_options.iqRotateSeconds;
+  options.verboseLogging = verboseLogging;
+  if (!iqCapture.init(m_options.iqFile, options)) {
     std::cerr << "[IQ] failed to open IQ output file: " << m_options.iqFile
               << "\n";
     audioOut.shutdown();
     tunerSession.disconnect();
-    return nullptr;
+    return false;
   }
   if (verboseLogging) {
-    std::cout << "[IQ] capture enabled: " << m_options.iqFile << "\n";
+    std::cout << "[IQ] capture enabled: " << m_options.iqFile << " ("
+              << IqCaptureWriter::formatName(options.fileFormat) << ")";
+    if (options.rotateBytes > 0 || options.rotateSeconds > 0) {
+      std::cout << " (rotating every";
+      if (m_options.iqRotateMb > 0) {
+        std::cout << " " << m_options.iqRotateMb << " MiB";
+      }
+      if (m_options.iqRotateSeconds > 0) {
+        std::cout << (m_options.iqRotateMb > 0 ? " or " : " ")
+                  << m_options.iqRotateSeconds << " s";
+      }
+      std::cout << ")";
+    }
+    std::cout << "\n";
   }
-  return iqHandle;
+  return true;
 }
 
 bool Application::initMpxCapture(WavWriter &mpxWavOut,
@@ -219,19 +254,18 @@ bool Application::initMpxAudio(MpxAudioOutput &mpxAudioOut,
   return true;
 }
 
-bool Application::readIqSamples(
-    const std::function<size_t(uint8_t *, size_t)> &tunerReadIQ,
-    const std::function<void(const uint8_t *, size_t)> &writeIqCapture,
-    uint8_t *iqBuffer, size_t sdrBufSamples,
-    const std::chrono::milliseconds &noDataSleep, TunerSession &tunerSession,
-    bool verboseLogging, size_t &samples) const {
-  samples = tunerReadIQ(iqBuffer, sdrBufSamples);
+bool Application::leaseIqSamples(TunerController &tuner, size_t sdrBufSamples,
+                                 const std::chrono::milliseconds &noDataSleep,
+                                 TunerSession &tunerSession,
+                                 bool verboseLogging,
+                                 TunerController::IqLease &lease) const {
+  lease = tuner.leaseIQ(sdrBufSamples);
+  const size_t samples = lease.samples;
   if (samples == 0) {
     tunerSession.noteReadFailureAndMaybeReconnect();
     std::this_thread::sleep_for(noDataSleep);
     return false;
   }
-  writeIqCapture(iqBuffer, samples);
   if (verboseLogging && samples < sdrBufSamples) {
     static uint32_t shortIqReadCount = 0;
     const uint32_t count = ++shortIqReadCount;
@@ -244,15 +278,13 @@ bool Application::readIqSamples(
   return true;
 }
 
-void Application::shutdownResources(AudioOutput &audioOut, FILE *&iqHandle,
+void Application::shutdownResources(AudioOutput &audioOut,
+                                    IqCaptureWriter &iqCapture,
                                     WavWriter &mpxWavOut, XDRServer &xdrServer,
                                     TunerSession &tunerSession) const {
   audioOut.shutdown();
   mpxWavOut.shutdown();
-  if (iqHandle) {
-    std::fclose(iqHandle);
-    iqHandle = nullptr;
-  }
+  iqCapture.shutdown();
   xdrServer.stop();
   tunerSession.disconnect();
 }
@@ -265,6 +297,13 @@ int Application::run() {
 
   const Config &config = m_options.config;
   const bool verboseLogging = m_options.verboseLogging;
+  std::string kernelError;
+  if (!fm_tuner::dsp::setKernelOverrides(config.processing.kernels,
+                                         kernelError)) {
+    std::cerr << "[DSP] invalid kernels setting '" << config.processing.kernels
+              << "': " << kernelError << "\n";
+    return 1;
+  }
   logStartup(cpu);
   std::string tcpHost = m_options.tcpHost;
   uint16_t tcpPort = m_options.tcpPort;
@@ -289,6 +328,12 @@ int Application::run() {
   bool autoReconnect = m_options.autoReconnect;
   const bool autoStartTuner = m_options.autoStart;
   bool lowLatencyIq = m_options.lowLatencyIq;
+  const int targetLatencyMs = m_options.targetLatencyMs;
+  if (targetLatencyMs > 0) {
+    // A backlog in the source ring is latency like any other: read the
+    // newest IQ.
+    lowLatencyIq = true;
+  }
 
   if (tunerSource == "sdrplay") {
     // The RSP front end is configured to deliver INPUT_RATE directly
@@ -297,20 +342,21 @@ int Application::run() {
     iqSampleRate = static_cast<uint32_t>(INPUT_RATE);
   }
 
-  const size_t iqDecimation = static_cast<size_t>(iqSampleRate / INPUT_RATE);
-
   signal(SIGINT, signalHandler);
   signal(SIGTERM, signalHandler);
 
   TunerController tuner(tunerSource, tcpHost, tcpPort, rtlDeviceIndex);
   tuner.setLowLatencyMode(lowLatencyIq);
+  tuner.setVerboseLogging(verboseLogging);
   if (tuner.isSdrPlay()) {
     tuner.configureSdrplay(config.sdrplay.lna_state, config.sdrplay.antenna,
                            config.sdrplay.bias_tee);
   }
+  if (tuner.isFile()) {
+    tuner.configureReplay(m_options.replayFile, m_options.replayFormat,
+                          m_options.replayRealtime, m_options.replayLoop);
+  }
   const bool useDirectRtlSdr = tuner.isDirectRtlSdr();
-  const bool sourceIsComplex =
-      tuner.nativeFormat() == TunerController::IqFormat::CF32;
   bool rtlConnected = false;
   XdrCommandState xdrState(freqKHz * 1000U, defaultCustomGainFlags,
                            std::clamp(config.processing.agc_mode, 0, 3), 0,
@@ -510,19 +556,36 @@ int Application::run() {
       [&]() { return requestedCustomGain.load(); },
       [&](const char *reason) { applyRtlGainAndAgc(reason); });
 
-  if (verboseLogging) {
-    std::cout << "[SDR] iq_sample_rate=" << iqSampleRate
-              << " decimation=" << iqDecimation
-              << " dsp_input_rate=" << INPUT_RATE << "\n";
-  }
-  const std::size_t dspBlockSize = static_cast<std::size_t>(
+  std::size_t dspBlockSize = static_cast<std::size_t>(
       std::clamp(config.processing.dsp_block_samples, 1024, 32768));
+  if (targetLatencyMs > 0) {
+    // 4 ms / 8 ms blocks at 256 kHz; a block's IQ has to be complete before
+    // any of it is demodulated, so the default 32 ms block alone would use
+    // most of a tight budget.
+    dspBlockSize = std::min<std::size_t>(dspBlockSize,
+                                         targetLatencyMs < 60 ? 1024 : 2048);
+  }
   fm_tuner::dsp::Runtime dspRuntime(dspBlockSize, verboseLogging);
   if (verboseLogging) {
     std::cout << "[DSP] block_samples=" << dspBlockSize << "\n";
+    if (targetLatencyMs > 0) {
+      std::cout << "[LATENCY] target " << targetLatencyMs
+                << " ms: block_samples=" << dspBlockSize
+                << ", newest-IQ reads, adaptive speaker ring\n";
+    }
   }
   DspPipeline dspPipeline(INPUT_RATE, OUTPUT_RATE, config.processing,
-                          verboseLogging, dspBlockSize, iqDecimation);
+                          verboseLogging, dspBlockSize, iqSampleRate);
+  if (verboseLogging) {
+    std::cout << "[SDR] iq_sample_rate=" << iqSampleRate
+              << " dsp_input_rate=" << INPUT_RATE
+              << " front_end: " << dspPipeline.iqFrontEndSummary() << "\n";
+    if (dspPipeline.pipelineStages() > 1) {
+      std::cout << "[DSP] pipeline_stages=" << dspPipeline.pipelineStages()
+                << " latency=+" << dspPipeline.pipelineStages() - 1
+                << " blocks\n";
+    }
+  }
   if (!m_options.stereoBlendOverride.empty()) {
     if (m_options.stereoBlendOverride == "soft") {
       dspPipeline.setBlendMode(StereoDecoder::BlendMode::Soft);
@@ -569,17 +632,23 @@ int Application::run() {
     return 1;
   }
 
-  FILE *iqHandle = openIqCapture(audioOut, tunerSession);
-  if (!m_options.iqFile.empty() && !iqHandle) {
+  IqCaptureWriter iqCapture;
+  if (!openIqCapture(iqCapture, iqSampleRate, tuner.nativeFormat(), audioOut,
+                     tunerSession)) {
     mpxAudioOut.shutdown();
     mpxWavOut.shutdown();
     return 1;
   }
   auto writeIqCapture = [&](const uint8_t *data, size_t sampleCount) {
-    if (!iqHandle || !data || sampleCount == 0) {
-      return;
+    if (iqCapture.isOpen()) {
+      (void)iqCapture.enqueue(data, sampleCount, tuner.frequencyHz());
+    }
+  };
+  auto writeIqCaptureComplex = [&](const std::complex<float> *data,
+                                   size_t sampleCount) {
+    if (iqCapture.isOpen()) {
+      (void)iqCapture.enqueue(data, sampleCount, tuner.frequencyHz());
     }
-    (void)std::fwrite(data, 1, sampleCount * 2, iqHandle);
   };
 
   std::atomic<bool> tunerActive(false);
@@ -632,6 +701,9 @@ int Application::run() {
   // Set by the REST "reset_stats" action; consumed on the processing thread to
   // restart the MPX 60 s window and peak hold.
   std::atomic<bool> statsResetRequest{false};
+  // Set on every /api/status request; the processing thread uses it to keep
+  // the telemetry-only meters running while a REST client is polling.
+  std::atomic<bool> restStatusPolled{false};
   // RDS statistics (updated on the RDS worker thread). BER is an EMA of the
   // per-group block-error fraction (same definition as MPXPrime's blockErrorRate
   // = failed/received, but windowed so it tracks current link quality and
@@ -762,6 +834,7 @@ int Application::run() {
       return true;
     };
     controls.statusJson = [&]() -> std::string {
+      restStatusPolled.store(true, std::memory_order_relaxed);
       std::ostringstream oss;
       // All metrics reported to one decimal (N.N); the small ratios clip/rds_ber
       // keep more precision so they don't collapse to 0.0.
@@ -858,15 +931,11 @@ int Application::run() {
                                            : std::chrono::milliseconds(10);
   const auto scanRetrySleep = useDirectRtlSdr ? std::chrono::milliseconds(2)
                                               : std::chrono::milliseconds(5);
+  // Steady-state audio blocks are leased straight from the source's ring
+  // (u8 or CF32, metered and demodulated natively); iqBuffer is only the scan
+  // engine's read buffer.
   std::vector<uint8_t> iqBufferStorage(SDR_BUF_SAMPLES * 2, 0);
   uint8_t *iqBuffer = iqBufferStorage.data();
-  // CF32 sources (SDRplay) deliver full-precision complex<float> for the demod;
-  // we also quantize them into iqBuffer as an 8-bit shadow so the signal meter,
-  // scan engine, and IQ capture (all RTL-format consumers) work unchanged.
-  std::vector<std::complex<float>> iqComplexStorage;
-  if (sourceIsComplex) {
-    iqComplexStorage.assign(SDR_BUF_SAMPLES, std::complex<float>(0.0f, 0.0f));
-  }
 
   // Pre-armed so the very first processed samples after startup (including
   // the --auto-start path, which connects before this loop) get the same
@@ -886,6 +955,11 @@ int Application::run() {
   constexpr double kMpxDevFullScaleKHz = 75.0; // demod 1.0 == 75 kHz
   float mpxPeakHold = 0.0f;
 
+  // [LATENCY] report: with a target, or in verbose mode.
+  LatencyMeter latencyMeter(targetLatencyMs);
+  LatencyMeter *activeLatencyMeter =
+      (targetLatencyMs > 0 || verboseLogging) ? &latencyMeter : nullptr;
+
   ScanEngine scanEngine;
   auto lastGainDown =
       std::chrono::steady_clock::now() - std::chrono::seconds(5);
@@ -898,6 +972,12 @@ int Application::run() {
   // inaudible (the auto-gain path already does live gain writes routinely).
   constexpr auto kDeviceReassertInterval = std::chrono::minutes(5);
   auto lastDeviceReassert = std::chrono::steady_clock::now();
+  // The RDS deviation meter runs only while /api/status is being polled; the
+  // hold covers a client's poll interval.
+  constexpr auto kRestTelemetryHold = std::chrono::seconds(10);
+  auto lastRestStatusPoll =
+      std::chrono::steady_clock::now() - kRestTelemetryHold;
+  bool appliedRestTelemetry = false;
   fm_tuner::AdaptiveBandwidthState adaptiveBwState;
   fm_tuner::AdaptiveBandwidthMode adaptiveBwMode =
       fm_tuner::AdaptiveBandwidthMode::Off;
@@ -925,6 +1005,56 @@ int Application::run() {
     retuneMuteTotalSamples = kRetuneMuteSamples;
     rdsWorker.requestReset();
   };
+  // One lease through meter, DSP and outputs. samples == 0 plays a block
+  // the pipelined DSP still holds at end of stream instead.
+  const auto playBlock = [&](const uint8_t *iqData, size_t samples,
+                             const std::complex<float> *iqComplexPtr,
+                             std::chrono::steady_clock::time_point iqArrival) {
+    return processing_runner::processAudioBlock(
+        iqData, samples, OUTPUT_RATE, iqSampleRate, appliedBandwidthHz,
+        effectiveAppliedGainDb(),
+        kSignalGainCompFactor, config, verboseLogging, rfLevelSmoother,
+        [&](const SignalLevelResult &signal, double clipRatio,
+            float rfLevelFiltered) {
+          // Publish live telemetry for the REST API. Overload uses the same
+          // condition the auto-gain loop acts on (heavy IQ clipping or channel
+          // power into the top few dB of full scale).
+          liveSignalLevel.store(rfLevelFiltered, std::memory_order_relaxed);
+          liveSignalDbfs.store(signal.dbfs, std::memory_order_relaxed);
+          liveClipRatio.store(clipRatio, std::memory_order_relaxed);
+          liveOverload.store((clipRatio > 0.0200) || (signal.dbfs > -5.0),
+                             std::memory_order_relaxed);
+          runtime_loop::maybeAdjustAutoGain(
+              useSdrppGainStrategy, gain, isImsAgcEnabled(), requestedAGCMode,
+              pendingAGC, lastGainDown, lastGainUp, signal, clipRatio,
+              rfLevelFiltered, verboseLogging, agcModeToGainDb);
+          runtime_loop::maybeAdjustAdaptiveBandwidth(
+              adaptiveBwMode, adaptiveBwState, requestedBandwidthHz,
+              pendingBandwidth, appliedBandwidthHz, signal, verboseLogging);
+        },
+        appliedForceMono, appliedEffectiveForceMono, dspPipeline, rdsWorker,
+        xdrServer, retuneMuteSamplesRemaining, retuneMuteTotalSamples, audioOut,
+        &mpxWavOut, m_options.mpxAudioEnabled ? &mpxAudioOut : nullptr,
+        iqComplexPtr,
+        [&](float pilotKHz, bool stereo, float quality, float mpxMag,
+            float mpxPeak, float rdsDevKHz, float demodSnrDb) {
+          livePilotKHz.store(pilotKHz, std::memory_order_relaxed);
+          liveRdsDevKHz.store(rdsDevKHz, std::memory_order_relaxed);
+          liveStereo.store(stereo, std::memory_order_relaxed);
+          liveStereoQuality.store(quality, std::memory_order_relaxed);
+          liveDemodSnrDb.store(demodSnrDb, std::memory_order_relaxed);
+          liveMpxMagnitude.store(mpxMag, std::memory_order_relaxed);
+          // MAX DEV: ~1 s decaying peak hold of the composite deviation.
+          if (statsResetRequest.exchange(false, std::memory_order_acquire)) {
+            mpxPeakHold = 0.0f;
+          }
+          mpxPeakHold = std::max(mpxPeak, mpxPeakHold * kMpxPeakDecay);
+          liveMpxPeakKhz.store(
+              static_cast<double>(mpxPeakHold) * kMpxDevFullScaleKHz,
+              std::memory_order_relaxed);
+        },
+        activeLatencyMeter, iqArrival);
+  };
   while (g_running) {
     if (pendingStopRequest.exchange(false, std::memory_order_acq_rel)) {
       pendingStartRequest.store(false, std::memory_order_release);
@@ -1010,73 +1140,50 @@ int Application::run() {
       }
     }
 
-    size_t samples = 0;
-    const std::complex<float> *iqComplexPtr = nullptr;
-    if (sourceIsComplex) {
-      samples = tuner.readIQ(iqComplexStorage.data(), SDR_BUF_SAMPLES);
-      if (samples == 0) {
-        tunerSession.noteReadFailureAndMaybeReconnect();
-        std::this_thread::sleep_for(noDataSleep);
-        continue;
-      }
-      for (size_t i = 0; i < samples; i++) {
-        const float si = std::lround(iqComplexStorage[i].real() * 127.5f + 127.5f);
-        const float sq = std::lround(iqComplexStorage[i].imag() * 127.5f + 127.5f);
-        iqBuffer[2 * i] = static_cast<uint8_t>(std::clamp(si, 0.0f, 255.0f));
-        iqBuffer[2 * i + 1] = static_cast<uint8_t>(std::clamp(sq, 0.0f, 255.0f));
+    if (restStatusPolled.exchange(false, std::memory_order_relaxed)) {
+      lastRestStatusPoll = std::chrono::steady_clock::now();
+    }
+    const bool restTelemetry =
+        (std::chrono::steady_clock::now() - lastRestStatusPoll) <
+        kRestTelemetryHold;
+    if (restTelemetry != appliedRestTelemetry) {
+      dspPipeline.setRestTelemetryActive(restTelemetry);
+      appliedRestTelemetry = restTelemetry;
+    }
+
+    TunerController::IqLease lease;
+    if (!leaseIqSamples(tuner, SDR_BUF_SAMPLES, noDataSleep, tunerSession,
+                        verboseLogging, lease)) {
+      if (tuner.endOfStream()) {
+        // Non-looping replay finished: play out what the pipelined DSP
+        // still holds, then stop.
+        while (playBlock(nullptr, 0, nullptr, {})) {
+        }
+        break;
       }
-      writeIqCapture(iqBuffer, samples);
-      tunerSession.resetReadFailures();
-      iqComplexPtr = iqComplexStorage.data();
-    } else if (!readIqSamples(tunerReadIQ, writeIqCapture, iqBuffer,
-                              SDR_BUF_SAMPLES, noDataSleep, tunerSession,
-                              verboseLogging, samples)) {
       continue;
     }
+    // The lease is the oldest IQ in the source ring: it arrived as long ago
+    // as the ring's contents take to receive, and at least a block ago (a
+    // paced replay has no ring but hands out a block once it is due).
+    const size_t sourceBacklog =
+        std::max(tuner.queuedSamples(), lease.samples);
+    const auto iqArrival =
+        std::chrono::steady_clock::now() -
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(
+                static_cast<double>(sourceBacklog) / iqSampleRate));
+    const size_t samples = lease.samples;
+    const uint8_t *iqData = lease.u8;
+    const std::complex<float> *iqComplexPtr = lease.cf32;
+    if (iqComplexPtr) {
+      writeIqCaptureComplex(iqComplexPtr, samples);
+    } else {
+      writeIqCapture(iqData, samples);
+    }
 
-    (void)processing_runner::processAudioBlock(
-        iqBuffer, samples, OUTPUT_RATE, iqSampleRate, appliedBandwidthHz,
-        effectiveAppliedGainDb(),
-        kSignalGainCompFactor, config, verboseLogging, rfLevelSmoother,
-        [&](const SignalLevelResult &signal, double clipRatio,
-            float rfLevelFiltered) {
-          // Publish live telemetry for the REST API. Overload uses the same
-          // condition the auto-gain loop acts on (heavy IQ clipping or channel
-          // power into the top few dB of full scale).
-          liveSignalLevel.store(rfLevelFiltered, std::memory_order_relaxed);
-          liveSignalDbfs.store(signal.dbfs, std::memory_order_relaxed);
-          liveClipRatio.store(clipRatio, std::memory_order_relaxed);
-          liveOverload.store((clipRatio > 0.0200) || (signal.dbfs > -5.0),
-                             std::memory_order_relaxed);
-          runtime_loop::maybeAdjustAutoGain(
-              useSdrppGainStrategy, gain, isImsAgcEnabled(), requestedAGCMode,
-              pendingAGC, lastGainDown, lastGainUp, signal, clipRatio,
-              rfLevelFiltered, verboseLogging, agcModeToGainDb);
-          runtime_loop::maybeAdjustAdaptiveBandwidth(
-              adaptiveBwMode, adaptiveBwState, requestedBandwidthHz,
-              pendingBandwidth, appliedBandwidthHz, signal, verboseLogging);
-        },
-        targetForceMono, appliedEffectiveForceMono, dspPipeline, rdsWorker,
-        xdrServer, retuneMuteSamplesRemaining, retuneMuteTotalSamples, audioOut,
-        &mpxWavOut, m_options.mpxAudioEnabled ? &mpxAudioOut : nullptr,
-        iqComplexPtr,
-        [&](float pilotKHz, bool stereo, float quality, float mpxMag,
-            float mpxPeak, float rdsDevKHz, float demodSnrDb) {
-          livePilotKHz.store(pilotKHz, std::memory_order_relaxed);
-          liveRdsDevKHz.store(rdsDevKHz, std::memory_order_relaxed);
-          liveStereo.store(stereo, std::memory_order_relaxed);
-          liveStereoQuality.store(quality, std::memory_order_relaxed);
-          liveDemodSnrDb.store(demodSnrDb, std::memory_order_relaxed);
-          liveMpxMagnitude.store(mpxMag, std::memory_order_relaxed);
-          // MAX DEV: ~1 s decaying peak hold of the composite deviation.
-          if (statsResetRequest.exchange(false, std::memory_order_acquire)) {
-            mpxPeakHold = 0.0f;
-          }
-          mpxPeakHold = std::max(mpxPeak, mpxPeakHold * kMpxPeakDecay);
-          liveMpxPeakKhz.store(
-              static_cast<double>(mpxPeakHold) * kMpxDevFullScaleKHz,
-              std::memory_order_relaxed);
-        });
+    (void)playBlock(iqData, samples, iqComplexPtr, iqArrival);
+    tuner.releaseIQ(lease);
   }
 
   rdsWorker.stop();
@@ -1085,7 +1192,7 @@ int Application::run() {
     restServer->stop();
   }
   mpxAudioOut.shutdown();
-  shutdownResources(audioOut, iqHandle, mpxWavOut, xdrServer, tunerSession);
+  shutdownResources(audioOut, iqCapture, mpxWavOut, xdrServer, tunerSession);
 
   std::cout << "[APP] shutdown complete.\n";
   return 0;
@@ -5,6 +5,7 @@
 #include <cmath>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #if defined(__APPLE__) && defined(FM_TUNER_HAS_COREAUDIO)
 #include <CoreAudio/CoreAudio.h>
 #include <CoreFoundation/CoreFoundation.h>
@@ -310,6 +311,10 @@ void AudioOutput::clearSpeakerQueueLocked() {
   m_speakerReadPos = 0;
   m_speakerWritePos = 0;
   m_speakerSize = 0;
+  m_speakerPrimed = false;
+  m_ringWindowMin = std::numeric_limits<size_t>::max();
+  m_ringWindowPopped = 0;
+  m_ringWindowStarved = false;
 }
 
 void AudioOutput::logSpeakerOverflow(const char *backendLabel,
@@ -334,19 +339,18 @@ void AudioOutput::logSpeakerOverflow(const char *backendLabel,
   }
 }
 
-void AudioOutput::pushSpeakerSamples(const float *left, const float *right,
-                                     size_t numSamples,
+void AudioOutput::pushSpeakerSamples(const float *frames, size_t numFrames,
                                      const char *backendLabel) {
-  if (!left || !right || numSamples == 0 || m_speakerRing.empty()) {
+  if (!frames || numFrames == 0 || m_speakerRing.empty()) {
     return;
   }
-  const size_t incomingSamples = numSamples * CHANNELS;
+  const size_t incomingSamples = numFrames * CHANNELS;
   const size_t capacity = m_speakerRing.size();
   size_t startSample = 0;
   if (incomingSamples >= capacity) {
     startSample = (incomingSamples - capacity) / CHANNELS;
   }
-  const size_t keptSamples = (numSamples - startSample) * CHANNELS;
+  const size_t keptSamples = (numFrames - startSample) * CHANNELS;
 
   std::lock_guard<std::mutex> lock(m_speakerMutex);
   if (keptSamples > capacity) {
@@ -362,13 +366,14 @@ void AudioOutput::pushSpeakerSamples(const float *left, const float *right,
     logSpeakerOverflow(backendLabel, ++overflowCount);
   }
 
-  for (size_t i = startSample; i < numSamples; i++) {
-    m_speakerRing[m_speakerWritePos] = left[i];
-    m_speakerWritePos = (m_speakerWritePos + 1) % capacity;
-    m_speakerRing[m_speakerWritePos] = right[i];
-    m_speakerWritePos = (m_speakerWritePos + 1) % capacity;
-  }
+  // Copy in at most two contiguous runs around the ring wrap.
+  const float *src = frames + startSample * CHANNELS;
+  const size_t firstRun = std::min(keptSamples, capacity - m_speakerWritePos);
+  std::copy(src, src + firstRun, m_speakerRing.begin() + m_speakerWritePos);
+  std::copy(src + firstRun, src + keptSamples, m_speakerRing.begin());
+  m_speakerWritePos = (m_speakerWritePos + keptSamples) % capacity;
   m_speakerSize += keptSamples;
+  m_speakerPrimed = true;
   m_speakerCv.notify_one();
 }
 
@@ -376,6 +381,9 @@ size_t AudioOutput::popSpeakerSamplesLocked(float *dest, size_t maxSamples) {
   if (!dest || maxSamples == 0 || m_speakerRing.empty()) {
     return 0;
   }
+  if (m_targetLatencyMs > 0 && m_speakerPrimed) {
+    trackSpeakerDepthLocked(maxSamples);
+  }
   const size_t toRead = std::min(maxSamples, m_speakerSize);
   const size_t capacity = m_speakerRing.size();
   for (size_t i = 0; i < toRead; i++) {
@@ -386,6 +394,84 @@ size_t AudioOutput::popSpeakerSamplesLocked(float *dest, size_t maxSamples) {
   return toRead;
 }
 
+// The producer side is bursty (a USB transfer's worth of blocks at a time)
+// and the DAC clock drifts against the tuner's, so the ring has no fixed
+// right depth. Instead the lowest fill seen over a window says how much of
+// it was never needed: that much is dropped, keeping an allowance that grows
+// by a device period whenever the ring ran dry and shrinks again while it
+// stays clean. The allowance never goes below one period nor above a third
+// of the latency target.
+void AudioOutput::trackSpeakerDepthLocked(size_t popSamples) {
+  const size_t floor = popSamples;
+  const size_t ceiling = std::max(
+      floor, static_cast<size_t>(m_targetLatencyMs) * SAMPLE_RATE / 1000 *
+                 CHANNELS / 3);
+  if (m_ringAllowance == 0) {
+    m_ringAllowance = std::min(2 * floor, ceiling);
+  }
+  m_ringWindowMin = std::min(m_ringWindowMin, m_speakerSize);
+  if (m_speakerSize < popSamples) {
+    m_ringWindowStarved = true;
+  }
+  m_ringWindowPopped += popSamples;
+  if (m_ringWindowPopped < kRingWindowSamples) {
+    return;
+  }
+
+  if (m_ringWindowStarved) {
+    m_ringCalmWindows = 0;
+    if (m_ringAllowance < ceiling) {
+      m_ringAllowance = std::min(m_ringAllowance + popSamples, ceiling);
+      if (m_verboseLogging) {
+        std::cout << "[AUDIO] speaker ring ran dry, keeping "
+                  << (m_ringAllowance / CHANNELS) * 1000 / SAMPLE_RATE
+                  << " ms in reserve\n";
+      }
+    }
+  } else {
+    if (++m_ringCalmWindows >= kRingCalmWindows) {
+      m_ringCalmWindows = 0;
+      // The device period can grow past the allowance (e.g. a larger
+      // CoreAudio buffer), so step down without wrapping below the floor.
+      const size_t step = popSamples / 2;
+      m_ringAllowance =
+          (m_ringAllowance > floor + step) ? m_ringAllowance - step : floor;
+    }
+    if (m_ringWindowMin > m_ringAllowance) {
+      trimSpeakerRingLocked(m_ringWindowMin - m_ringAllowance);
+    }
+  }
+  m_ringWindowMin = std::numeric_limits<size_t>::max();
+  m_ringWindowPopped = 0;
+  m_ringWindowStarved = false;
+}
+
+void AudioOutput::trimSpeakerRingLocked(size_t dropSamples) {
+  dropSamples -= dropSamples % CHANNELS;
+  if (dropSamples == 0 || dropSamples > m_speakerSize) {
+    return;
+  }
+  const size_t capacity = m_speakerRing.size();
+  // Fade from the audio being skipped into what follows it, so the jump is
+  // a crossfade rather than a click.
+  const size_t fadeFrames = std::min(
+      kRingTrimFadeFrames, (m_speakerSize - dropSamples) / CHANNELS);
+  for (size_t f = 0; f < fadeFrames; f++) {
+    const float w =
+        static_cast<float>(f + 1) / static_cast<float>(fadeFrames + 1);
+    for (size_t c = 0; c < CHANNELS; c++) {
+      const size_t offset = f * CHANNELS + c;
+      const float skipped =
+          m_speakerRing[(m_speakerReadPos + offset) % capacity];
+      float &kept =
+          m_speakerRing[(m_speakerReadPos + dropSamples + offset) % capacity];
+      kept = skipped + (kept - skipped) * w;
+    }
+  }
+  m_speakerReadPos = (m_speakerReadPos + dropSamples) % capacity;
+  m_speakerSize -= dropSamples;
+}
+
 #if defined(_WIN32) && defined(FM_TUNER_HAS_WINMM)
 bool AudioOutput::listWinMMDevices() {
   const UINT num = waveOutGetNumDevs();
@@ -434,25 +520,35 @@ OSStatus AudioOutput::coreAudioRenderCallback(void *inRefCon,
     return noErr;
   }
 
+  // Pull through popSpeakerSamplesLocked (in scratch-sized pieces) so the
+  // adaptive ring depth applies here as it does on the other backends.
   std::lock_guard<std::mutex> lock(self->m_speakerMutex);
-  const size_t samplePairs = std::min(self->m_speakerSize / 2,
-                                      static_cast<size_t>(inNumberFrames));
-  for (size_t i = 0; i < samplePairs; i++) {
-    const float l = self->m_speakerRing[self->m_speakerReadPos];
-    self->m_speakerReadPos =
-        (self->m_speakerReadPos + 1) % self->m_speakerRing.size();
-    const float r = self->m_speakerRing[self->m_speakerReadPos];
-    self->m_speakerReadPos =
-        (self->m_speakerReadPos + 1) % self->m_speakerRing.size();
-    if (outB) {
-      outA[i] = l;
-      outB[i] = r;
-    } else {
-      outA[i * 2] = l;
-      outA[i * 2 + 1] = r;
+  const size_t totalFrames = static_cast<size_t>(inNumberFrames);
+  const size_t chunkFrames = self->m_speakerScratch.size() / CHANNELS;
+  size_t samplePairs = 0;
+  while (samplePairs < totalFrames) {
+    const size_t want = std::min(chunkFrames, totalFrames - samplePairs);
+    const size_t got = self->popSpeakerSamplesLocked(
+                           self->m_speakerScratch.data(), want * CHANNELS) /
+                       CHANNELS;
+    for (size_t i = 0; i < got; i++) {
+      const float l = self->m_speakerScratch[i * 2];
+      const float r = self->m_speakerScratch[i * 2 + 1];
+      const size_t frame = samplePairs + i;
+      if (outB) {
+        outA[frame] = l;
+        outB[frame] = r;
+      } else {
+        outA[frame * 2] = l;
+        outA[frame * 2 + 1] = r;
+      }
+    }
+    samplePairs += got;
+    if (got < want) {
+      break;
     }
   }
-  for (size_t i = samplePairs; i < static_cast<size_t>(inNumberFrames); i++) {
+  for (size_t i = samplePairs; i < totalFrames; i++) {
     if (outB) {
       outA[i] = 0.0f;
       outB[i] = 0.0f;
@@ -461,7 +557,6 @@ OSStatus AudioOutput::coreAudioRenderCallback(void *inRefCon,
       outA[i * 2 + 1] = 0.0f;
     }
   }
-  self->m_speakerSize -= samplePairs * 2;
   return noErr;
 }
 #endif
@@ -582,12 +677,16 @@ bool AudioOutput::initAlsa(const std::string &deviceName) {
               << rate << " (will resample)\n";
   }
 
-  // Lower-latency target: ~128 ms device buffer at 48 kHz.
+  // Lower-latency target: ~85 ms device buffer at 48 kHz, ~11 ms periods.
+  // With a latency target the device gets a third of it, in four periods.
   snd_pcm_uframes_t bufferSize = 4096;
+  if (m_targetLatencyMs > 0) {
+    bufferSize = static_cast<snd_pcm_uframes_t>(std::clamp(
+        m_targetLatencyMs * SAMPLE_RATE / 1000 / 3, 256, 4096));
+  }
   snd_pcm_hw_params_set_buffer_size_near(m_alsaPcm, hwparams, &bufferSize);
 
-  // Lower-latency target: ~16 ms period at 48 kHz.
-  snd_pcm_uframes_t periodSize = 512;
+  snd_pcm_uframes_t periodSize = m_targetLatencyMs > 0 ? bufferSize / 4 : 512;
   snd_pcm_hw_params_set_period_size_near(m_alsaPcm, hwparams, &periodSize,
                                          &dir);
 
@@ -675,6 +774,11 @@ void AudioOutput::runAlsaOutputThread() {
 
     snd_pcm_sframes_t frames =
         snd_pcm_writei(m_alsaPcm, interleaved.data(), kWriteFrames);
+    snd_pcm_sframes_t delay = 0;
+    if (frames >= 0 && snd_pcm_delay(m_alsaPcm, &delay) == 0) {
+      m_deviceDelayFrames.store(static_cast<long>(delay),
+                                std::memory_order_relaxed);
+    }
     if (frames < 0) {
       if (frames == -EPIPE) {
         snd_pcm_prepare(m_alsaPcm);
@@ -828,8 +932,11 @@ AudioOutput::AudioOutput()
       m_verboseLogging(true),
       m_requestedVolumePercent(kMaxVolumePercent),
       m_currentVolumeScale(kDefaultVolumeScale), m_speakerReadPos(0),
-      m_speakerWritePos(0), m_speakerSize(0), m_wavReadPos(0), m_wavWritePos(0),
-      m_wavSize(0)
+      m_speakerWritePos(0), m_speakerSize(0), m_targetLatencyMs(0),
+      m_speakerPrimed(false), m_ringAllowance(0),
+      m_ringWindowMin(std::numeric_limits<size_t>::max()),
+      m_ringWindowPopped(0), m_ringWindowStarved(false), m_ringCalmWindows(0),
+      m_deviceDelayFrames(0), m_wavReadPos(0), m_wavWritePos(0), m_wavSize(0)
 #if defined(__APPLE__) && defined(FM_TUNER_HAS_COREAUDIO)
       ,
       m_audioUnit(nullptr)
@@ -851,6 +958,24 @@ AudioOutput::AudioOutput()
 
 AudioOutput::~AudioOutput() { shutdown(); }
 
+void AudioOutput::setTargetLatencyMs(int targetLatencyMs) {
+  std::lock_guard<std::mutex> lock(m_speakerMutex);
+  m_targetLatencyMs = std::max(0, targetLatencyMs);
+  m_ringAllowance = 0;
+  m_ringCalmWindows = 0;
+}
+
+double AudioOutput::speakerRingSeconds() {
+  std::lock_guard<std::mutex> lock(m_speakerMutex);
+  return static_cast<double>(m_speakerSize / CHANNELS) / SAMPLE_RATE;
+}
+
+double AudioOutput::deviceDelaySeconds() const {
+  return static_cast<double>(
+             std::max(0L, m_deviceDelayFrames.load(std::memory_order_relaxed))) /
+         SAMPLE_RATE;
+}
+
 bool AudioOutput::init(bool enableSpeaker, const std::string &wavFile,
                        const std::string &deviceSelector, bool verboseLogging) {
   m_enableSpeaker = enableSpeaker;
@@ -1183,20 +1308,17 @@ bool AudioOutput::writeWAVData(const int16_t *samples, size_t sampleCount) {
   return true;
 }
 
-bool AudioOutput::enqueueWavSamples(const float *left, const float *right,
-                                    size_t numSamples) {
-  if (!m_wavHandle || !left || !right || numSamples == 0 || m_wavRing.empty()) {
+bool AudioOutput::enqueueWavSamples(const float *frames, size_t numFrames) {
+  if (!m_wavHandle || !frames || numFrames == 0 || m_wavRing.empty()) {
     return false;
   }
-  const size_t sampleCount = numSamples * CHANNELS;
+  const size_t sampleCount = numFrames * CHANNELS;
   if (m_wavEncodeScratch.size() < sampleCount) {
     m_wavEncodeScratch.resize(sampleCount);
   }
-  for (size_t i = 0; i < numSamples; i++) {
-    const float l = std::clamp(left[i], -1.0f, 1.0f);
-    const float r = std::clamp(right[i], -1.0f, 1.0f);
-    m_wavEncodeScratch[i * 2] = static_cast<int16_t>(l * kInt16Max);
-    m_wavEncodeScratch[i * 2 + 1] = static_cast<int16_t>(r * kInt16Max);
+  for (size_t i = 0; i < sampleCount; i++) {
+    const float v = std::clamp(frames[i], -1.0f, 1.0f);
+    m_wavEncodeScratch[i] = static_cast<int16_t>(v * kInt16Max);
   }
 
   std::lock_guard<std::mutex> lock(m_wavMutex);
@@ -1278,18 +1400,32 @@ void AudioOutput::clearRealtimeQueue() {
 
 bool AudioOutput::write(const float *left, const float *right,
                         size_t numSamples) {
+  if (!m_running) {
+    return false;
+  }
+  if (!left || !right) {
+    return writeInterleaved(nullptr, numSamples);
+  }
+  if (m_interleaveScratch.size() < numSamples * CHANNELS) {
+    m_interleaveScratch.resize(numSamples * CHANNELS);
+  }
+  for (size_t i = 0; i < numSamples; i++) {
+    m_interleaveScratch[2 * i] = left[i];
+    m_interleaveScratch[2 * i + 1] = right[i];
+  }
+  return writeInterleaved(m_interleaveScratch.data(), numSamples);
+}
+
+bool AudioOutput::writeInterleaved(const float *frames, size_t numFrames) {
   if (!m_running)
     return false;
 
-  const float *writeLeft = left;
-  const float *writeRight = right;
+  const float *writeFrames = frames;
 
-  if (left && right && numSamples > 0) {
-    if (m_scaledLeftScratch.size() < numSamples) {
-      m_scaledLeftScratch.resize(numSamples);
-    }
-    if (m_scaledRightScratch.size() < numSamples) {
-      m_scaledRightScratch.resize(numSamples);
+  if (frames && numFrames > 0) {
+    const size_t sampleCount = numFrames * CHANNELS;
+    if (m_scaledScratch.size() < sampleCount) {
+      m_scaledScratch.resize(sampleCount);
     }
     const float targetVolumeScale =
         (static_cast<float>(
@@ -1300,7 +1436,7 @@ bool AudioOutput::write(const float *left, const float *right,
     const float step = (targetVolumeScale - m_currentVolumeScale) /
                        std::max(1.0f, rampSamples);
 
-    for (size_t i = 0; i < numSamples; i++) {
+    for (size_t i = 0; i < numFrames; i++) {
       if (std::abs(targetVolumeScale - m_currentVolumeScale) > kVolumeEpsilon) {
         m_currentVolumeScale += step;
         if ((step > 0.0f && m_currentVolumeScale > targetVolumeScale) ||
@@ -1308,31 +1444,30 @@ bool AudioOutput::write(const float *left, const float *right,
           m_currentVolumeScale = targetVolumeScale;
         }
       }
-      m_scaledLeftScratch[i] = left[i] * m_currentVolumeScale;
-      m_scaledRightScratch[i] = right[i] * m_currentVolumeScale;
+      m_scaledScratch[2 * i] = frames[2 * i] * m_currentVolumeScale;
+      m_scaledScratch[2 * i + 1] = frames[2 * i + 1] * m_currentVolumeScale;
     }
-    writeLeft = m_scaledLeftScratch.data();
-    writeRight = m_scaledRightScratch.data();
+    writeFrames = m_scaledScratch.data();
   }
 
   if (m_wavHandle) {
-    (void)enqueueWavSamples(writeLeft, writeRight, numSamples);
+    (void)enqueueWavSamples(writeFrames, numFrames);
   }
 
 #if defined(__linux__) && defined(FM_TUNER_HAS_ALSA)
   if (m_enableSpeaker && m_alsaPcm) {
-    pushSpeakerSamples(writeLeft, writeRight, numSamples, "ALSA");
+    pushSpeakerSamples(writeFrames, numFrames, "ALSA");
   }
 #endif
 
 #if defined(__APPLE__) && defined(FM_TUNER_HAS_COREAUDIO)
   if (m_enableSpeaker && m_audioUnit) {
-    pushSpeakerSamples(writeLeft, writeRight, numSamples, "CoreAudio");
+    pushSpeakerSamples(writeFrames, numFrames, "CoreAudio");
   }
 #endif
 #if defined(_WIN32) && defined(FM_TUNER_HAS_WINMM)
   if (m_enableSpeaker && m_waveOut) {
-    pushSpeakerSamples(writeLeft, writeRight, numSamples, "WinMM");
+    pushSpeakerSamples(writeFrames, numFrames, "WinMM");
   }
 #endif
 
@@ -101,7 +101,8 @@ void parseRtlTcpSection(const std::string &key, const std::string &value,
   } else if (key == "sample_rate") {
     int parsed = 0;
     if (parseInt(value, parsed) &&
-        (parsed == 256000 || parsed == 1024000 || parsed == 2048000)) {
+        parsed >= static_cast<int>(Config::RTLTCPSection::kMinSampleRate) &&
+        parsed <= static_cast<int>(Config::RTLTCPSection::kMaxSampleRate)) {
       rtl_tcp.sample_rate = static_cast<uint32_t>(parsed);
     }
   }
@@ -121,6 +122,15 @@ void parseAudioSection(const std::string &key, const std::string &value,
     if (parseInt(value, parsed)) {
       audio.startup_volume = std::clamp(parsed, 0, 100);
     }
+  } else if (key == "target_latency_ms") {
+    int parsed = 0;
+    if (parseInt(value, parsed)) {
+      audio.target_latency_ms =
+          parsed <= 0 ? 0
+                      : std::clamp(parsed,
+                                   Config::AudioSection::kMinTargetLatencyMs,
+                                   Config::AudioSection::kMaxTargetLatencyMs);
+    }
   }
 }
 
@@ -185,7 +195,8 @@ void parseTunerSection(const std::string &key, const std::string &value,
                        Config::TunerSection &tuner) {
   if (key == "source") {
     const std::string parsed = toLower(trim(value));
-    if (parsed == "rtl_sdr" || parsed == "rtl_tcp" || parsed == "sdrplay") {
+    if (parsed == "rtl_sdr" || parsed == "rtl_tcp" || parsed == "sdrplay" ||
+        parsed == "file") {
       tuner.source = parsed;
     }
   } else if (key == "rtl_device") {
@@ -232,6 +243,29 @@ void parseSdrplaySection(const std::string &key, const std::string &value,
   }
 }
 
+void parseReplaySection(const std::string &key, const std::string &value,
+                        Config::ReplaySection &replay) {
+  if (key == "file") {
+    replay.file = trim(value);
+  } else if (key == "format") {
+    const std::string parsed = toLower(trim(value));
+    if (parsed == "auto" || parsed == "u8" || parsed == "cf32" ||
+        parsed == "cs16") {
+      replay.format = parsed;
+    }
+  } else if (key == "realtime") {
+    bool parsed = false;
+    if (parseBool(value, parsed)) {
+      replay.realtime = parsed;
+    }
+  } else if (key == "loop") {
+    bool parsed = false;
+    if (parseBool(value, parsed)) {
+      replay.loop = parsed;
+    }
+  }
+}
+
 void parseRestSection(const std::string &key, const std::string &value,
                       Config::RestSection &rest) {
   if (key == "enabled") {
@@ -286,6 +320,11 @@ void parseProcessingSection(const std::string &key, const std::string &value,
     if (parseInt(value, parsed)) {
       processing.dsp_block_samples = std::clamp(parsed, 1024, 32768);
     }
+  } else if (key == "dsp_pipeline_stages") {
+    int parsed = 0;
+    if (parseInt(value, parsed)) {
+      processing.dsp_pipeline_stages = std::clamp(parsed, 1, 3);
+    }
   } else if (key == "w0_bandwidth_hz") {
     int parsed = 0;
     if (parseInt(value, parsed)) {
@@ -311,6 +350,11 @@ void parseProcessingSection(const std::string &key, const std::string &value,
     if (parseBool(value, parsed)) {
       processing.pilot_canceller = parsed;
     }
+  } else if (key == "half_rate_mpx") {
+    bool parsed = false;
+    if (parseBool(value, parsed)) {
+      processing.half_rate_mpx = parsed;
+    }
   } else if (key == "hicut") {
     const std::string parsed = toLower(trim(value));
     if (parsed == "off" || parsed == "gentle" || parsed == "strong") {
@@ -337,6 +381,18 @@ void parseProcessingSection(const std::string &key, const std::string &value,
     if (parsed == "off" || parsed == "gentle" || parsed == "strong") {
       processing.fade_mute = parsed;
     }
+  } else if (key == "metering") {
+    const std::string parsed = toLower(trim(value));
+    if (parsed == "auto" || parsed == "always") {
+      processing.metering = parsed;
+    }
+  } else if (key == "kernels") {
+    // Validated against the kernel registry at startup, where an unknown
+    // name is a hard error rather than a silent fallback.
+    const std::string parsed = toLower(trim(value));
+    if (!parsed.empty()) {
+      processing.kernels = parsed;
+    }
   } else if (key == "iq_fir_l1_normalize") {
     bool parsed = false;
     if (parseBool(value, parsed)) {
@@ -347,6 +403,11 @@ void parseProcessingSection(const std::string &key, const std::string &value,
     if (parseDouble(value, parsed)) {
       processing.squelch_dbfs = std::clamp(parsed, -120.0, 0.0);
     }
+  } else if (key == "squelch_idle") {
+    bool parsed = false;
+    if (parseBool(value, parsed)) {
+      processing.squelch_idle = parsed;
+    }
   }
 }
 
@@ -382,6 +443,8 @@ void parseSection(const std::string &section, const std::string &key,
     parseTunerSection(key, value, config.tuner);
   } else if (section == "sdrplay") {
     parseSdrplaySection(key, value, config.sdrplay);
+  } else if (section == "replay") {
+    parseReplaySection(key, value, config.replay);
   } else if (section == "rest") {
     parseRestSection(key, value, config.rest);
   } else if (section == "xdr") {
@@ -403,6 +466,7 @@ void Config::loadDefaults() {
   sdr = Config::SDRSection{};
   tuner = Config::TunerSection{};
   sdrplay = Config::SDRplaySection{};
+  replay = Config::ReplaySection{};
   rest = Config::RestSection{};
   xdr = Config::XDRSection{};
   processing = Config::ProcessingSection{};
@@ -20,6 +20,7 @@ CPUFeatures detectCPUFeatures() {
   out.avx = __builtin_cpu_supports("avx");
   out.avx2 = __builtin_cpu_supports("avx2");
   out.fma = __builtin_cpu_supports("fma");
+  out.avx512f = __builtin_cpu_supports("avx512f");
 #elif defined(_MSC_VER)
   int regs[4] = {0, 0, 0, 0};
   __cpuid(regs, 1);
@@ -29,9 +30,12 @@ CPUFeatures detectCPUFeatures() {
   const bool cpuAvx = (regs[2] & (1 << 28)) != 0;
   const bool cpuFma = (regs[2] & (1 << 12)) != 0;
   bool osYmm = false;
+  bool osZmm = false;
   if (osxsave && cpuAvx) {
     const unsigned long long xcr0 = _xgetbv(0);
     osYmm = (xcr0 & 0x6ULL) == 0x6ULL;
+    // opmask + ZMM_Hi256 + Hi16_ZMM state enabled by the OS.
+    osZmm = (xcr0 & 0xE6ULL) == 0xE6ULL;
   }
   out.avx = cpuAvx && osYmm;
   out.fma = cpuFma && out.avx;
@@ -39,6 +43,7 @@ CPUFeatures detectCPUFeatures() {
     int regs7[4] = {0, 0, 0, 0};
     __cpuidex(regs7, 7, 0);
     out.avx2 = (regs7[1] & (1 << 5)) != 0;
+    out.avx512f = osZmm && (regs7[1] & (1 << 16)) != 0;
   }
 #endif
 #endif
@@ -63,7 +68,7 @@ std::string CPUFeatures::summary() const {
     oss << "arch=x86"
         << " sse2=" << (sse2 ? 1 : 0) << " sse4.1=" << (sse41 ? 1 : 0)
         << " avx=" << (avx ? 1 : 0) << " avx2=" << (avx2 ? 1 : 0)
-        << " fma=" << (fma ? 1 : 0);
+        << " fma=" << (fma ? 1 : 0) << " avx512f=" << (avx512f ? 1 : 0);
   } else if (isArm) {
     oss << "arch=arm"
         << " neon=" << (neon ? 1 : 0);
@@ -0,0 +1,52 @@
+#include "dsp/block_queue.h"
+
+namespace fm_tuner::dsp {
+
+void BlockQueue::reset(size_t slots) {
+  m_ring.reset(slots);
+  m_closed.store(false);
+}
+
+void BlockQueue::push(size_t slot) {
+  m_ring.write(&slot, 1);
+  // Taking the lock orders the write against a consumer that has just found
+  // the ring empty and is about to sleep, so the notify cannot be lost.
+  { std::lock_guard<std::mutex> lock(m_mutex); }
+  m_cv.notify_all();
+}
+
+bool BlockQueue::tryPop(size_t &slot) { return m_ring.read(&slot, 1) == 1; }
+
+bool BlockQueue::pop(size_t &slot) {
+  if (tryPop(slot)) {
+    return true;
+  }
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [&]() {
+    return m_closed.load() || m_ring.readAvailable() > 0;
+  });
+  if (m_closed.load()) {
+    return false;
+  }
+  return tryPop(slot);
+}
+
+void BlockQueue::waitForSize(size_t count) {
+  if (m_ring.readAvailable() >= count) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [&]() {
+    return m_closed.load() || m_ring.readAvailable() >= count;
+  });
+}
+
+void BlockQueue::close() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed.store(true);
+  }
+  m_cv.notify_all();
+}
+
+} // namespace fm_tuner::dsp
@@ -0,0 +1,541 @@
+#include "dsp/fm_front_end.h"
+
+#include "dsp/iq_saturation.h"
+#include "dsp/kernel_registry.h"
+#include "dsp/liquid_primitives.h"
+#include "dsp/phase_discriminator.h"
+#include "dsp/simd_dot.h"
+#include "dsp/simd_target.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace fm_tuner::dsp {
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+// Taps per FIR inner-loop step: one AVX2 vector of interleaved I/Q, two NEON
+// vectors. The tap array is zero padded to a multiple of this.
+constexpr size_t kTapBlock = 4;
+// u8 -> float mapping used by the demod since the liquid chain: centred on
+// 127, scaled by 1/127.5.
+constexpr float kU8Center = 127.0f;
+constexpr float kU8Scale = 1.0f / 127.5f;
+// CF32 samples this close to full scale count as clipped for the demod's
+// overload flag.
+constexpr float kCf32DemodClip = 0.995f;
+
+const std::array<float, 256> &u8NormLut() {
+  static const std::array<float, 256> lut = []() {
+    std::array<float, 256> out{};
+    for (int v = 0; v < 256; v++) {
+      out[static_cast<size_t>(v)] = (static_cast<float>(v) - kU8Center) * kU8Scale;
+    }
+    return out;
+  }();
+  return lut;
+}
+
+// Number of set bits among the even positions of a 2-bits-per-sample mask,
+// after folding the odd (Q) bit onto the even (I) bit.
+inline size_t countFlaggedPairs(uint32_t mask, uint32_t evenBits) {
+  uint32_t pairs = (mask | (mask >> 1)) & evenBits;
+  size_t count = 0;
+  while (pairs != 0) {
+    pairs &= pairs - 1;
+    count++;
+  }
+  return count;
+}
+
+// ---- u8 -> float + clip count ------------------------------------------
+
+size_t convertU8Scalar(const uint8_t *iq, size_t samples, float *out) {
+  const auto &lut = u8NormLut();
+  size_t clips = 0;
+  for (size_t s = 0; s < samples; s++) {
+    const uint8_t iByte = iq[2 * s];
+    const uint8_t qByte = iq[2 * s + 1];
+    if (isRtlSdrIqByteSaturated(iByte) || isRtlSdrIqByteSaturated(qByte)) {
+      clips++;
+    }
+    out[2 * s] = lut[iByte];
+    out[2 * s + 1] = lut[qByte];
+  }
+  return clips;
+}
+
+#if FM_TUNER_SIMD_AVX2
+FM_TUNER_AVX2_TARGET size_t convertU8Avx2(const uint8_t *iq, size_t samples,
+                                          float *out) {
+  const __m128i low = _mm_set1_epi8(static_cast<char>(kRtlSdrIqLowSaturated));
+  const __m128i high = _mm_set1_epi8(static_cast<char>(kRtlSdrIqHighSaturated));
+  const __m256 center = _mm256_set1_ps(kU8Center);
+  const __m256 scale = _mm256_set1_ps(kU8Scale);
+  size_t clips = 0;
+  size_t s = 0;
+  for (; s + 8 <= samples; s += 8) {
+    const __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(iq + 2 * s));
+    // b <= low  <=>  min(b, low) == b;  b >= high  <=>  max(b, high) == b.
+    const __m128i saturated =
+        _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(bytes, low), bytes),
+                     _mm_cmpeq_epi8(_mm_max_epu8(bytes, high), bytes));
+    clips += countFlaggedPairs(
+        static_cast<uint32_t>(_mm_movemask_epi8(saturated)), 0x5555U);
+    const __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+    const __m256 hi =
+        _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+    _mm256_storeu_ps(out + 2 * s, _mm256_mul_ps(_mm256_sub_ps(lo, center), scale));
+    _mm256_storeu_ps(out + 2 * s + 8,
+                     _mm256_mul_ps(_mm256_sub_ps(hi, center), scale));
+  }
+  return clips + convertU8Scalar(iq + 2 * s, samples - s, out + 2 * s);
+}
+#endif
+
+#if FM_TUNER_SIMD_NEON
+size_t convertU8Neon(const uint8_t *iq, size_t samples, float *out) {
+  const uint8x16_t low = vdupq_n_u8(kRtlSdrIqLowSaturated);
+  const uint8x16_t high = vdupq_n_u8(kRtlSdrIqHighSaturated);
+  const float32x4_t center = vdupq_n_f32(kU8Center);
+  const float32x4_t scale = vdupq_n_f32(kU8Scale);
+  size_t clips = 0;
+  size_t s = 0;
+  for (; s + 8 <= samples; s += 8) {
+    const uint8x16_t bytes = vld1q_u8(iq + 2 * s);
+    const uint8x16_t saturated =
+        vorrq_u8(vcleq_u8(bytes, low), vcgeq_u8(bytes, high));
+    // One u16 lane per IQ pair: non-zero if I or Q is saturated.
+    const uint16x8_t pairs = vreinterpretq_u16_u8(saturated);
+    const uint16x8_t flagged = vshrq_n_u16(vtstq_u16(pairs, pairs), 15);
+    uint16_t lanes[8];
+    vst1q_u16(lanes, flagged);
+    for (uint16_t lane : lanes) {
+      clips += lane;
+    }
+    const uint16x8_t lo16 = vmovl_u8(vget_low_u8(bytes));
+    const uint16x8_t hi16 = vmovl_u8(vget_high_u8(bytes));
+    const float32x4_t f0 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo16)));
+    const float32x4_t f1 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo16)));
+    const float32x4_t f2 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi16)));
+    const float32x4_t f3 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi16)));
+    vst1q_f32(out + 2 * s, vmulq_f32(vsubq_f32(f0, center), scale));
+    vst1q_f32(out + 2 * s + 4, vmulq_f32(vsubq_f32(f1, center), scale));
+    vst1q_f32(out + 2 * s + 8, vmulq_f32(vsubq_f32(f2, center), scale));
+    vst1q_f32(out + 2 * s + 12, vmulq_f32(vsubq_f32(f3, center), scale));
+  }
+  return clips + convertU8Scalar(iq + 2 * s, samples - s, out + 2 * s);
+}
+#endif
+
+// ---- CF32 clip count -----------------------------------------------------
+
+size_t countCf32ClipsScalar(const float *iq, size_t samples) {
+  size_t clips = 0;
+  for (size_t s = 0; s < samples; s++) {
+    if (std::fabs(iq[2 * s]) >= kCf32DemodClip ||
+        std::fabs(iq[2 * s + 1]) >= kCf32DemodClip) {
+      clips++;
+    }
+  }
+  return clips;
+}
+
+#if FM_TUNER_SIMD_AVX2
+FM_TUNER_AVX2_TARGET size_t countCf32ClipsAvx2(const float *iq,
+                                                size_t samples) {
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  const __m256 level = _mm256_set1_ps(kCf32DemodClip);
+  size_t clips = 0;
+  size_t s = 0;
+  for (; s + 4 <= samples; s += 4) {
+    const __m256 a = _mm256_and_ps(_mm256_loadu_ps(iq + 2 * s), absMask);
+    clips += countFlaggedPairs(
+        static_cast<uint32_t>(
+            _mm256_movemask_ps(_mm256_cmp_ps(a, level, _CMP_GE_OQ))),
+        0x55U);
+  }
+  return clips + countCf32ClipsScalar(iq + 2 * s, samples - s);
+}
+#endif
+
+#if FM_TUNER_SIMD_NEON
+size_t countCf32ClipsNeon(const float *iq, size_t samples) {
+  const float32x4_t level = vdupq_n_f32(kCf32DemodClip);
+  uint32x4_t count = vdupq_n_u32(0);
+  size_t s = 0;
+  for (; s + 4 <= samples; s += 4) {
+    const float32x4x2_t v = vld2q_f32(iq + 2 * s);
+    const float32x4_t peak = vmaxq_f32(vabsq_f32(v.val[0]), vabsq_f32(v.val[1]));
+    count = vsubq_u32(count, vcgeq_f32(peak, level));
+  }
+  uint32_t lanes[4];
+  vst1q_u32(lanes, count);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+         countCf32ClipsScalar(iq + 2 * s, samples - s);
+}
+#endif
+
+// ---- channel FIR ---------------------------------------------------------
+//
+// out[i] = sum_j taps[j] * x[i + j] over interleaved complex history x with
+// time-reversed taps; returns sum |out[i]|^2.
+
+double firBlockScalar(const float *x, const float *taps, size_t tapCount,
+                      size_t samples, std::complex<float> *out) {
+  double power = 0.0;
+  for (size_t i = 0; i < samples; i++) {
+    const float *xi = x + 2 * i;
+    float re = 0.0f;
+    float im = 0.0f;
+    for (size_t j = 0; j < tapCount; j++) {
+      re += taps[2 * j] * xi[2 * j];
+      im += taps[2 * j + 1] * xi[2 * j + 1];
+    }
+    out[i] = {re, im};
+    power += static_cast<double>(re) * re + static_cast<double>(im) * im;
+  }
+  return power;
+}
+
+#if FM_TUNER_SIMD_AVX2
+FM_TUNER_AVX2_TARGET double firBlockAvx2(const float *x, const float *taps,
+                                         size_t tapCount, size_t samples,
+                                         std::complex<float> *out) {
+  double power = 0.0;
+  for (size_t i = 0; i < samples; i++) {
+    const float *xi = x + 2 * i;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t j = 0;
+    for (; j + 2 * kTapBlock <= tapCount; j += 2 * kTapBlock) {
+      acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(taps + 2 * j),
+                             _mm256_loadu_ps(xi + 2 * j), acc0);
+      acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(taps + 2 * j + 8),
+                             _mm256_loadu_ps(xi + 2 * j + 8), acc1);
+    }
+    if (j < tapCount) {
+      acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(taps + 2 * j),
+                             _mm256_loadu_ps(xi + 2 * j), acc0);
+    }
+    // Lanes alternate I, Q: fold 8 -> 4 -> 2.
+    __m128 sum = foldAvx2(_mm256_add_ps(acc0, acc1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, sum);
+    out[i] = {lanes[0], lanes[1]};
+    power += static_cast<double>(lanes[0]) * lanes[0] +
+             static_cast<double>(lanes[1]) * lanes[1];
+  }
+  return power;
+}
+#endif
+
+#if FM_TUNER_SIMD_NEON
+double firBlockNeon(const float *x, const float *taps, size_t tapCount,
+                    size_t samples, std::complex<float> *out) {
+  double power = 0.0;
+  for (size_t i = 0; i < samples; i++) {
+    const float *xi = x + 2 * i;
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (size_t j = 0; j < tapCount; j += kTapBlock) {
+      acc0 = vmlaq_f32(acc0, vld1q_f32(taps + 2 * j), vld1q_f32(xi + 2 * j));
+      acc1 = vmlaq_f32(acc1, vld1q_f32(taps + 2 * j + 4),
+                       vld1q_f32(xi + 2 * j + 4));
+    }
+    const float32x4_t acc = vaddq_f32(acc0, acc1);
+    const float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    const float re = vget_lane_f32(sum, 0);
+    const float im = vget_lane_f32(sum, 1);
+    out[i] = {re, im};
+    power += static_cast<double>(re) * re + static_cast<double>(im) * im;
+  }
+  return power;
+}
+#endif
+
+#if FM_TUNER_SIMD_AVX512
+// One zmm holds two kTapBlocks of interleaved taps; an odd block goes
+// through a masked half-width load.
+FM_TUNER_AVX512_TARGET double firBlockAvx512(const float *x, const float *taps,
+                                             size_t tapCount, size_t samples,
+                                             std::complex<float> *out) {
+  double power = 0.0;
+  for (size_t i = 0; i < samples; i++) {
+    const float *xi = x + 2 * i;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    size_t j = 0;
+    for (; j + 4 * kTapBlock <= tapCount; j += 4 * kTapBlock) {
+      acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(taps + 2 * j),
+                             _mm512_loadu_ps(xi + 2 * j), acc0);
+      acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(taps + 2 * j + 16),
+                             _mm512_loadu_ps(xi + 2 * j + 16), acc1);
+    }
+    if (j + 2 * kTapBlock <= tapCount) {
+      acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(taps + 2 * j),
+                             _mm512_loadu_ps(xi + 2 * j), acc0);
+      j += 2 * kTapBlock;
+    }
+    if (j < tapCount) {
+      acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(kHalfTail, taps + 2 * j),
+                             _mm512_maskz_loadu_ps(kHalfTail, xi + 2 * j),
+                             acc1);
+    }
+    // Lanes alternate I, Q: fold 16 -> 8 -> 4 -> 2.
+    __m128 sum = foldAvx2(foldAvx512(_mm512_add_ps(acc0, acc1)));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, sum);
+    out[i] = {lanes[0], lanes[1]};
+    power += static_cast<double>(lanes[0]) * lanes[0] +
+             static_cast<double>(lanes[1]) * lanes[1];
+  }
+  return power;
+}
+#endif
+
+struct IqKernels {
+  size_t (*convertU8)(const uint8_t *, size_t, float *) = convertU8Scalar;
+  size_t (*countCf32Clips)(const float *, size_t) = countCf32ClipsScalar;
+};
+
+using FirBlockFn = double (*)(const float *, const float *, size_t, size_t,
+                              std::complex<float> *);
+
+const IqKernels &iqKernels() {
+  static const KernelTable<IqKernels> table = []() {
+    KernelTable<IqKernels> t{IqKernels{}};
+#if FM_TUNER_SIMD_AVX2
+    t.set(KernelIsa::Avx2, IqKernels{convertU8Avx2, countCf32ClipsAvx2});
+#endif
+#if FM_TUNER_SIMD_NEON
+    t.set(KernelIsa::Neon, IqKernels{convertU8Neon, countCf32ClipsNeon});
+#endif
+    return t;
+  }();
+  return table.select(KernelId::IqConvert);
+}
+
+FirBlockFn firKernel() {
+  static const KernelTable<FirBlockFn> table = []() {
+    KernelTable<FirBlockFn> t(firBlockScalar);
+#if FM_TUNER_SIMD_AVX2
+    t.set(KernelIsa::Avx2, firBlockAvx2);
+#endif
+#if FM_TUNER_SIMD_AVX512
+    t.set(KernelIsa::Avx512, firBlockAvx512);
+#endif
+#if FM_TUNER_SIMD_NEON
+    t.set(KernelIsa::Neon, firBlockNeon);
+#endif
+    return t;
+  }();
+  return table.select(KernelId::ChannelFir);
+}
+
+} // namespace
+
+FmFrontEnd::FmFrontEnd() {
+  setDcBlocker(0.0005f);
+  setChannelTaps(prepareChannelTaps({1.0f}, 1.0f));
+}
+
+std::shared_ptr<const FmFrontEnd::ChannelTaps>
+FmFrontEnd::designChannelTaps(std::uint32_t length, float cutoff,
+                              float stopBandAtten, bool l1Normalize,
+                              size_t delay) {
+  std::vector<float> taps;
+  const float scale = liquid::designLowpassTaps(length, cutoff, stopBandAtten,
+                                                l1Normalize, taps);
+  return prepareChannelTaps(taps, scale, delay);
+}
+
+std::shared_ptr<const FmFrontEnd::ChannelTaps>
+FmFrontEnd::prepareChannelTaps(const std::vector<float> &taps, float scale,
+                               size_t delay) {
+  if (taps.empty()) {
+    return prepareChannelTaps({1.0f}, 1.0f, delay);
+  }
+  auto prepared = std::make_shared<ChannelTaps>();
+  const size_t n = taps.size();
+  const size_t padded = ((n + kTapBlock - 1) / kTapBlock) * kTapBlock;
+  prepared->length = n;
+  prepared->delay = std::max(delay, (n - 1) / 2);
+  prepared->interleaved.assign(2 * padded, 0.0f);
+  for (size_t j = 0; j < n; j++) {
+    const float tap = taps[n - 1 - j] * scale;
+    prepared->interleaved[2 * j] = tap;
+    prepared->interleaved[2 * j + 1] = tap;
+  }
+  return prepared;
+}
+
+void FmFrontEnd::setDcBlocker(float alpha) {
+  m_dcAlpha = std::clamp(alpha, 0.0f, 1.0f);
+  m_dcGain = std::sqrt(1.0f - m_dcAlpha);
+  m_dcPole = 1.0f - m_dcAlpha;
+  m_dcPrevInI = m_dcPrevInQ = 0.0f;
+  m_dcPrevOutI = m_dcPrevOutQ = 0.0f;
+}
+
+void FmFrontEnd::setChannelFilter(std::uint32_t length, float cutoff,
+                                  float stopBandAtten, bool l1Normalize) {
+  setChannelTaps(designChannelTaps(length, cutoff, stopBandAtten, l1Normalize));
+}
+
+void FmFrontEnd::setChannelTaps(std::shared_ptr<const ChannelTaps> taps) {
+  m_channel = taps ? std::move(taps) : prepareChannelTaps({1.0f}, 1.0f);
+  m_fadeFrom.reset();
+  m_fadeRemaining = 0;
+  m_historyKeep = m_channel->history();
+  m_history.assign(m_historyKeep, std::complex<float>(0.0f, 0.0f));
+}
+
+void FmFrontEnd::swapChannelTaps(std::shared_ptr<const ChannelTaps> taps,
+                                 size_t crossfadeSamples) {
+  if (!taps || taps == m_channel) {
+    return;
+  }
+  // A swap in the middle of a fade starts over from the current filter; the
+  // blend it leaves behind is within one short fade of either filter.
+  m_fadeFrom = std::move(m_channel);
+  m_channel = std::move(taps);
+  m_fadeLength = crossfadeSamples;
+  m_fadeRemaining = crossfadeSamples;
+  if (m_fadeRemaining == 0) {
+    m_fadeFrom.reset();
+  }
+  // Keep enough history for both filters; one that reads further back starts
+  // with zeros for its oldest taps, which the fade keeps out of the output.
+  const size_t keep = m_channel->history();
+  if (keep > m_historyKeep) {
+    m_history.resize(m_historyKeep);
+    m_history.insert(m_history.begin(), keep - m_historyKeep,
+                     std::complex<float>(0.0f, 0.0f));
+    m_historyKeep = keep;
+  }
+}
+
+void FmFrontEnd::setModulationFactor(float kf) {
+  m_discriminatorGain = 1.0f / (2.0f * kPi * kf);
+}
+
+void FmFrontEnd::reset() {
+  m_dcPrevInI = m_dcPrevInQ = 0.0f;
+  m_dcPrevOutI = m_dcPrevOutQ = 0.0f;
+  m_fadeFrom.reset();
+  m_fadeRemaining = 0;
+  m_historyKeep = m_channel->history();
+  m_history.assign(m_historyKeep, std::complex<float>(0.0f, 0.0f));
+  m_discriminatorPrev = {0.0f, 0.0f};
+}
+
+FmFrontEnd::BlockStats FmFrontEnd::filter(const uint8_t *iq, size_t samples,
+                                          std::complex<float> *out) {
+  if (m_raw.size() < samples * 2) {
+    m_raw.resize(samples * 2);
+  }
+  const size_t clips = iqKernels().convertU8(iq, samples, m_raw.data());
+  return dcBlockAndFilter(m_raw.data(), clips, samples, out);
+}
+
+FmFrontEnd::BlockStats FmFrontEnd::filter(const std::complex<float> *iq,
+                                          size_t samples,
+                                          std::complex<float> *out) {
+  const float *in = reinterpret_cast<const float *>(iq);
+  const size_t clips = iqKernels().countCf32Clips(in, samples);
+  return dcBlockAndFilter(in, clips, samples, out);
+}
+
+FmFrontEnd::BlockStats FmFrontEnd::dcBlockAndFilter(const float *in,
+                                                    size_t clipCount,
+                                                    size_t samples,
+                                                    std::complex<float> *out) {
+  const size_t keep = m_historyKeep;
+  m_history.resize(keep + samples + kTapBlock);
+  std::fill(m_history.begin() + static_cast<std::ptrdiff_t>(keep + samples),
+            m_history.end(), std::complex<float>(0.0f, 0.0f));
+
+  // First-order DC blocker per rail, y = g (x - x[-1]) + (1 - alpha) y[-1].
+  // Direct form I, so a DC offset never builds up in an internal state; I
+  // and Q run interleaved in one loop.
+  std::complex<float> *dst = m_history.data() + keep;
+  float pi = m_dcPrevInI, pq = m_dcPrevInQ;
+  float yi = m_dcPrevOutI, yq = m_dcPrevOutQ;
+  for (size_t s = 0; s < samples; s++) {
+    const float xi = in[2 * s];
+    const float xq = in[2 * s + 1];
+    yi = m_dcGain * (xi - pi) + m_dcPole * yi;
+    yq = m_dcGain * (xq - pq) + m_dcPole * yq;
+    pi = xi;
+    pq = xq;
+    dst[s] = {yi, yq};
+  }
+  m_dcPrevInI = pi;
+  m_dcPrevInQ = pq;
+  m_dcPrevOutI = yi;
+  m_dcPrevOutQ = yq;
+
+  BlockStats stats;
+  stats.clipCount = clipCount;
+  stats.powerSum = runChannelFilter(*m_channel, samples, out);
+  if (m_fadeRemaining > 0) {
+    stats.powerSum += crossfade(samples, out);
+  }
+  // Carry the last m_historyKeep inputs into the next block.
+  if (keep > 0) {
+    std::memmove(m_history.data(), m_history.data() + samples,
+                 keep * sizeof(std::complex<float>));
+  }
+  return stats;
+}
+
+double FmFrontEnd::runChannelFilter(const ChannelTaps &channel,
+                                    size_t samples, std::complex<float> *out) {
+  // The history holds at least channel.history() samples before the block;
+  // a filter that reads less far back starts further in. The window ends
+  // (delay - (length - 1) / 2) samples before the current one.
+  const size_t offset = m_historyKeep - channel.history();
+  return firKernel()(
+      reinterpret_cast<const float *>(m_history.data() + offset),
+      channel.interleaved.data(), channel.interleaved.size() / 2, samples,
+      out);
+}
+
+double FmFrontEnd::crossfade(size_t samples, std::complex<float> *out) {
+  // Old filter on the head of the block, blended linearly into the new one.
+  const size_t n = std::min(samples, m_fadeRemaining);
+  if (m_fadeScratch.size() < n) {
+    m_fadeScratch.resize(n);
+  }
+  (void)runChannelFilter(*m_fadeFrom, n, m_fadeScratch.data());
+  const float step = 1.0f / static_cast<float>(m_fadeLength + 1);
+  size_t done = m_fadeLength - m_fadeRemaining;
+  double powerDelta = 0.0;
+  for (size_t i = 0; i < n; i++) {
+    const float w = static_cast<float>(++done) * step;
+    const std::complex<float> y = out[i];
+    const std::complex<float> blended =
+        m_fadeScratch[i] + w * (y - m_fadeScratch[i]);
+    powerDelta += static_cast<double>(std::norm(blended)) - std::norm(y);
+    out[i] = blended;
+  }
+  m_fadeRemaining -= n;
+  if (m_fadeRemaining == 0) {
+    m_fadeFrom.reset();
+  }
+  return powerDelta;
+}
+
+void FmFrontEnd::discriminate(const std::complex<float> *in, size_t samples,
+                              float *out) {
+  discriminateBlock(in, samples, m_discriminatorPrev, m_discriminatorGain, out);
+}
+
+} // namespace fm_tuner::dsp
@@ -0,0 +1,106 @@
+#include "dsp/half_band_decimator.h"
+
+#include "dsp/liquid_primitives.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace fm_tuner::dsp {
+
+std::vector<float> designHalfBandSideTaps(float passbandEdge,
+                                          float stopBandAtten) {
+  if (!(passbandEdge > 0.0f && passbandEdge < 0.25f)) {
+    throw std::runtime_error("half-band passband edge must be in (0, 0.25)");
+  }
+  // Kaiser length estimate for a transition of 0.5 - 2 * edge, rounded up to
+  // 4K - 1 taps so both ends are non-zero side taps.
+  const float transition = 0.5f - 2.0f * passbandEdge;
+  const float estimate =
+      (stopBandAtten - 7.95f) / (14.36f * transition) + 1.0f;
+  const size_t sideTaps = std::max<size_t>(
+      1, static_cast<size_t>(std::ceil((estimate + 1.0f) / 4.0f)));
+  const size_t length = 4 * sideTaps - 1;
+
+  std::vector<float> taps;
+  liquid::designLowpassTaps(static_cast<std::uint32_t>(length), 0.25f,
+                            stopBandAtten, false, taps);
+  // Keep only the odd-offset taps (the even ones are zero up to rounding) and
+  // scale them to sum to 1/2, so the centre tap is exactly 1/2 and the
+  // lowpass and its complement add up to a pure delay.
+  const size_t mid = (length - 1) / 2;
+  std::vector<float> side(sideTaps, 0.0f);
+  double sum = 0.0;
+  for (size_t k = 0; k < sideTaps; k++) {
+    side[k] = taps[mid + 2 * k + 1];
+    sum += 2.0 * side[k];
+  }
+  const float scale =
+      (std::abs(sum) > 1e-12) ? static_cast<float>(0.5 / sum) : 1.0f;
+  for (float &tap : side) {
+    tap *= scale;
+  }
+  return side;
+}
+
+void HalfBandDecimator::init(float passbandEdge, float stopBandAtten) {
+  m_sideTaps = designHalfBandSideTaps(passbandEdge, stopBandAtten);
+  reset();
+}
+
+void HalfBandDecimator::reset() {
+  m_history.assign(length() > 0 ? length() - 1 : 0, 0.0f);
+  m_emitNext = false;
+}
+
+size_t HalfBandDecimator::execute(const float *in, size_t inSamples,
+                                  float *out, float *highBand) {
+  if (!in || !out || inSamples == 0 || m_sideTaps.empty()) {
+    return 0;
+  }
+  const size_t keep = length() - 1;
+  const size_t mid = keep / 2;
+  const size_t sideTaps = m_sideTaps.size();
+  const float *taps = m_sideTaps.data();
+  m_history.resize(keep + inSamples);
+  std::memcpy(m_history.data() + keep, in, inSamples * sizeof(float));
+
+  const size_t first = m_emitNext ? 0 : 1;
+  size_t produced = 0;
+  for (size_t i = first; i < inSamples; i += 2) {
+    // Window history[i .. i + keep], centred on history[i + mid].
+    const float *centre = m_history.data() + i + mid;
+    float acc0 = 0.0f;
+    float acc1 = 0.0f;
+    size_t k = 0;
+    for (; k + 1 < sideTaps; k += 2) {
+      acc0 += taps[k] * (centre[-static_cast<std::ptrdiff_t>(2 * k + 1)] +
+                         centre[2 * k + 1]);
+      acc1 += taps[k + 1] * (centre[-static_cast<std::ptrdiff_t>(2 * k + 3)] +
+                             centre[2 * k + 3]);
+    }
+    if (k < sideTaps) {
+      acc0 += taps[k] * (centre[-static_cast<std::ptrdiff_t>(2 * k + 1)] +
+                         centre[2 * k + 1]);
+    }
+    const float c = 0.5f * centre[0];
+    const float s = acc0 + acc1;
+    out[produced] = c + s;
+    if (highBand) {
+      highBand[produced] = c - s;
+    }
+    produced++;
+  }
+  // Outputs sit at first, first + 2, ...; carry that parity into the next
+  // block.
+  m_emitNext = ((inSamples - first) % 2) == 0;
+
+  std::memmove(m_history.data(), m_history.data() + inSamples,
+               keep * sizeof(float));
+  m_history.resize(keep);
+  return produced;
+}
+
+} // namespace fm_tuner::dsp
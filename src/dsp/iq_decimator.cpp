@@ -0,0 +1,368 @@
+#include "dsp/iq_decimator.h"
+
+#include "dsp/half_band_decimator.h"
+#include "dsp/kernel_registry.h"
+#include "dsp/simd_target.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace fm_tuner::dsp {
+
+namespace {
+
+// out[n] = gain * (0.5 * odd[n + K - 1] +
+//                  sum_k h[k] * (even[n + K - 1 - k] + even[n + K + k]))
+//          + offset
+// over interleaved I/Q, where even/odd start with the (2K - 1) history pairs.
+void halfBandScalar(const float *even, const float *odd, const float *taps,
+                    size_t sideTaps, float gain, float offset, size_t outputs,
+                    float *out) {
+  for (size_t n = 0; n < outputs; n++) {
+    const float *centre = odd + 2 * (n + sideTaps - 1);
+    const float *lo = even + 2 * (n + sideTaps - 1);
+    const float *hi = even + 2 * (n + sideTaps);
+    float accI = 0.5f * centre[0];
+    float accQ = 0.5f * centre[1];
+    for (size_t k = 0; k < sideTaps; k++) {
+      const size_t back = 2 * k;
+      accI += taps[k] * (lo[-static_cast<std::ptrdiff_t>(back)] + hi[back]);
+      accQ += taps[k] * (lo[1 - static_cast<std::ptrdiff_t>(back)] +
+                         hi[back + 1]);
+    }
+    out[2 * n] = accI * gain + offset;
+    out[2 * n + 1] = accQ * gain + offset;
+  }
+}
+
+#if FM_TUNER_SIMD_AVX2
+// Four complex outputs per register; the side-tap pairs for consecutive
+// outputs are consecutive even-phase samples.
+FM_TUNER_AVX2_TARGET void halfBandAvx2(const float *even, const float *odd,
+                                       const float *taps, size_t sideTaps,
+                                       float gain, float offset,
+                                       size_t outputs, float *out) {
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 vgain = _mm256_set1_ps(gain);
+  const __m256 voffset = _mm256_set1_ps(offset);
+  size_t n = 0;
+  for (; n + 4 <= outputs; n += 4) {
+    const float *lo = even + 2 * (n + sideTaps - 1);
+    const float *hi = even + 2 * (n + sideTaps);
+    __m256 acc0 =
+        _mm256_mul_ps(half, _mm256_loadu_ps(odd + 2 * (n + sideTaps - 1)));
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t k = 0;
+    for (; k + 1 < sideTaps; k += 2) {
+      acc0 = _mm256_fmadd_ps(_mm256_set1_ps(taps[k]),
+                             _mm256_add_ps(_mm256_loadu_ps(lo - 2 * k),
+                                           _mm256_loadu_ps(hi + 2 * k)),
+                             acc0);
+      acc1 = _mm256_fmadd_ps(_mm256_set1_ps(taps[k + 1]),
+                             _mm256_add_ps(_mm256_loadu_ps(lo - 2 * k - 2),
+                                           _mm256_loadu_ps(hi + 2 * k + 2)),
+                             acc1);
+    }
+    if (k < sideTaps) {
+      acc0 = _mm256_fmadd_ps(_mm256_set1_ps(taps[k]),
+                             _mm256_add_ps(_mm256_loadu_ps(lo - 2 * k),
+                                           _mm256_loadu_ps(hi + 2 * k)),
+                             acc0);
+    }
+    const __m256 acc = _mm256_add_ps(acc0, acc1);
+    _mm256_storeu_ps(out + 2 * n, _mm256_fmadd_ps(acc, vgain, voffset));
+  }
+  halfBandScalar(even + 2 * n, odd + 2 * n, taps, sideTaps, gain, offset,
+                 outputs - n, out + 2 * n);
+}
+#endif
+
+#if FM_TUNER_SIMD_AVX512
+FM_TUNER_AVX512_TARGET void halfBandAvx512(const float *even, const float *odd,
+                                           const float *taps, size_t sideTaps,
+                                           float gain, float offset,
+                                           size_t outputs, float *out) {
+  const __m512 half = _mm512_set1_ps(0.5f);
+  const __m512 vgain = _mm512_set1_ps(gain);
+  const __m512 voffset = _mm512_set1_ps(offset);
+  size_t n = 0;
+  for (; n + 8 <= outputs; n += 8) {
+    const float *lo = even + 2 * (n + sideTaps - 1);
+    const float *hi = even + 2 * (n + sideTaps);
+    __m512 acc0 =
+        _mm512_mul_ps(half, _mm512_loadu_ps(odd + 2 * (n + sideTaps - 1)));
+    __m512 acc1 = _mm512_setzero_ps();
+    size_t k = 0;
+    for (; k + 1 < sideTaps; k += 2) {
+      acc0 = _mm512_fmadd_ps(_mm512_set1_ps(taps[k]),
+                             _mm512_add_ps(_mm512_loadu_ps(lo - 2 * k),
+                                           _mm512_loadu_ps(hi + 2 * k)),
+                             acc0);
+      acc1 = _mm512_fmadd_ps(_mm512_set1_ps(taps[k + 1]),
+                             _mm512_add_ps(_mm512_loadu_ps(lo - 2 * k - 2),
+                                           _mm512_loadu_ps(hi + 2 * k + 2)),
+                             acc1);
+    }
+    if (k < sideTaps) {
+      acc0 = _mm512_fmadd_ps(_mm512_set1_ps(taps[k]),
+                             _mm512_add_ps(_mm512_loadu_ps(lo - 2 * k),
+                                           _mm512_loadu_ps(hi + 2 * k)),
+                             acc0);
+    }
+    const __m512 acc = _mm512_add_ps(acc0, acc1);
+    _mm512_storeu_ps(out + 2 * n, _mm512_fmadd_ps(acc, vgain, voffset));
+  }
+  halfBandScalar(even + 2 * n, odd + 2 * n, taps, sideTaps, gain, offset,
+                 outputs - n, out + 2 * n);
+}
+#endif
+
+#if FM_TUNER_SIMD_NEON
+void halfBandNeon(const float *even, const float *odd, const float *taps,
+                  size_t sideTaps, float gain, float offset, size_t outputs,
+                  float *out) {
+  const float32x4_t voffset = vdupq_n_f32(offset);
+  size_t n = 0;
+  for (; n + 4 <= outputs; n += 4) {
+    const float *centre = odd + 2 * (n + sideTaps - 1);
+    const float *lo = even + 2 * (n + sideTaps - 1);
+    const float *hi = even + 2 * (n + sideTaps);
+    float32x4_t acc0 = vmulq_n_f32(vld1q_f32(centre), 0.5f);
+    float32x4_t acc1 = vmulq_n_f32(vld1q_f32(centre + 4), 0.5f);
+    for (size_t k = 0; k < sideTaps; k++) {
+      const float *a = lo - 2 * k;
+      const float *b = hi + 2 * k;
+      acc0 = vmlaq_n_f32(acc0, vaddq_f32(vld1q_f32(a), vld1q_f32(b)), taps[k]);
+      acc1 = vmlaq_n_f32(acc1, vaddq_f32(vld1q_f32(a + 4), vld1q_f32(b + 4)),
+                         taps[k]);
+    }
+    vst1q_f32(out + 2 * n, vmlaq_n_f32(voffset, acc0, gain));
+    vst1q_f32(out + 2 * n + 4, vmlaq_n_f32(voffset, acc1, gain));
+  }
+  halfBandScalar(even + 2 * n, odd + 2 * n, taps, sideTaps, gain, offset,
+                 outputs - n, out + 2 * n);
+}
+#endif
+
+using HalfBandFn = void (*)(const float *, const float *, const float *,
+                            size_t, float, float, size_t, float *);
+
+HalfBandFn halfBandKernel() {
+  static const KernelTable<HalfBandFn> table = []() {
+    KernelTable<HalfBandFn> t(halfBandScalar);
+#if FM_TUNER_SIMD_AVX2
+    t.set(KernelIsa::Avx2, halfBandAvx2);
+#endif
+#if FM_TUNER_SIMD_AVX512
+    t.set(KernelIsa::Avx512, halfBandAvx512);
+#endif
+#if FM_TUNER_SIMD_NEON
+    t.set(KernelIsa::Neon, halfBandNeon);
+#endif
+    return t;
+  }();
+  return table.select(KernelId::HalfBand);
+}
+
+constexpr float kU8Center = 127.5f;
+
+void growTo(std::vector<float> &buffer, size_t floats) {
+  if (buffer.size() < floats) {
+    buffer.resize(floats, 0.0f);
+  }
+}
+
+} // namespace
+
+void IqDecimator::init(std::uint32_t factor, float passbandEdge,
+                       float stopBandAtten) {
+  if (factor == 0 || (factor & (factor - 1)) != 0) {
+    throw std::runtime_error("IQ decimation factor must be a power of two");
+  }
+  if (!(passbandEdge > 0.0f && passbandEdge < 0.5f)) {
+    throw std::runtime_error("IQ decimator passband edge must be in (0, 0.5)");
+  }
+  m_factor = factor;
+  m_stages.clear();
+  // Stage s runs at (factor >> s) times the output rate, so the shared
+  // passband edge gets relatively narrower (and the stage shorter) the
+  // earlier it sits in the cascade.
+  for (std::uint32_t ratio = factor; ratio > 1; ratio /= 2) {
+    Stage stage;
+    stage.sideTaps = designHalfBandSideTaps(
+        passbandEdge / static_cast<float>(ratio), stopBandAtten);
+    m_stages.push_back(std::move(stage));
+  }
+  reset();
+}
+
+void IqDecimator::reset() {
+  for (Stage &stage : m_stages) {
+    stage.even.assign(2 * stage.keep(), 0.0f);
+    stage.odd.assign(2 * stage.keep(), 0.0f);
+    stage.hasPending = false;
+  }
+  m_rawHistory = false;
+}
+
+size_t IqDecimator::stageLength(size_t stage) const {
+  return stage < m_stages.size() ? 4 * m_stages[stage].sideTaps.size() - 1 : 0;
+}
+
+double IqDecimator::multipliesPerInputSample() const {
+  // Per output: K folded side taps plus the centre tap, on I and Q; stage s
+  // emits one output per 2^(s + 1) cascade inputs.
+  double total = 0.0;
+  double outputsPerInput = 0.5;
+  for (const Stage &stage : m_stages) {
+    total += 2.0 * static_cast<double>(stage.sideTaps.size() + 1) *
+             outputsPerInput;
+    outputsPerInput *= 0.5;
+  }
+  return total;
+}
+
+size_t IqDecimator::split(Stage &stage, const float *iq, size_t samples) {
+  const size_t keep = stage.keep();
+  const size_t pairs = (samples + (stage.hasPending ? 1 : 0)) / 2;
+  growTo(stage.even, 2 * (keep + pairs));
+  growTo(stage.odd, 2 * (keep + pairs));
+  float *even = stage.even.data() + 2 * keep;
+  float *odd = stage.odd.data() + 2 * keep;
+  size_t i = 0;
+  size_t p = 0;
+  if (stage.hasPending && samples > 0) {
+    even[0] = stage.pending[0];
+    even[1] = stage.pending[1];
+    odd[0] = iq[0];
+    odd[1] = iq[1];
+    stage.hasPending = false;
+    i = 1;
+    p = 1;
+  }
+  for (; i + 2 <= samples; i += 2, p++) {
+    even[2 * p] = iq[2 * i];
+    even[2 * p + 1] = iq[2 * i + 1];
+    odd[2 * p] = iq[2 * i + 2];
+    odd[2 * p + 1] = iq[2 * i + 3];
+  }
+  if (i < samples) {
+    stage.pending[0] = iq[2 * i];
+    stage.pending[1] = iq[2 * i + 1];
+    stage.hasPending = true;
+  }
+  return p;
+}
+
+size_t IqDecimator::splitU8(Stage &stage, const uint8_t *iq, size_t samples) {
+  const size_t keep = stage.keep();
+  const size_t pairs = (samples + (stage.hasPending ? 1 : 0)) / 2;
+  growTo(stage.even, 2 * (keep + pairs));
+  growTo(stage.odd, 2 * (keep + pairs));
+  float *even = stage.even.data() + 2 * keep;
+  float *odd = stage.odd.data() + 2 * keep;
+  size_t i = 0;
+  size_t p = 0;
+  if (stage.hasPending && samples > 0) {
+    even[0] = stage.pending[0];
+    even[1] = stage.pending[1];
+    odd[0] = static_cast<float>(iq[0]);
+    odd[1] = static_cast<float>(iq[1]);
+    stage.hasPending = false;
+    i = 1;
+    p = 1;
+  }
+  for (; i + 2 <= samples; i += 2, p++) {
+    even[2 * p] = static_cast<float>(iq[2 * i]);
+    even[2 * p + 1] = static_cast<float>(iq[2 * i + 1]);
+    odd[2 * p] = static_cast<float>(iq[2 * i + 2]);
+    odd[2 * p + 1] = static_cast<float>(iq[2 * i + 3]);
+  }
+  if (i < samples) {
+    stage.pending[0] = static_cast<float>(iq[2 * i]);
+    stage.pending[1] = static_cast<float>(iq[2 * i + 1]);
+    stage.hasPending = true;
+  }
+  return p;
+}
+
+size_t IqDecimator::runCascade(size_t pairs, float firstGain,
+                               float firstOffset, std::complex<float> *out,
+                               size_t outCapacity) {
+  const HalfBandFn kernel = halfBandKernel();
+  const float *in = nullptr;
+  float *dst = nullptr;
+  size_t count = pairs;
+  for (size_t s = 0; s < m_stages.size(); s++) {
+    Stage &stage = m_stages[s];
+    if (s > 0) {
+      count = split(stage, in, count);
+    }
+    const bool last = (s + 1 == m_stages.size());
+    if (last && count <= outCapacity) {
+      dst = reinterpret_cast<float *>(out);
+    } else {
+      growTo(m_scratch[s & 1], 2 * count);
+      dst = m_scratch[s & 1].data();
+    }
+    kernel(stage.even.data(), stage.odd.data(), stage.sideTaps.data(),
+           stage.sideTaps.size(), s == 0 ? firstGain : 1.0f,
+           s == 0 ? firstOffset : 0.0f, count, dst);
+
+    const size_t keep = stage.keep();
+    std::memmove(stage.even.data(), stage.even.data() + 2 * count,
+                 2 * keep * sizeof(float));
+    std::memmove(stage.odd.data(), stage.odd.data() + 2 * count,
+                 2 * keep * sizeof(float));
+    in = dst;
+  }
+  const size_t produced = std::min(count, outCapacity);
+  float *outFloats = reinterpret_cast<float *>(out);
+  if (dst != outFloats) {
+    std::memcpy(outFloats, dst, 2 * produced * sizeof(float));
+  }
+  return produced;
+}
+
+size_t IqDecimator::execute(const uint8_t *iq, size_t inSamples,
+                            std::complex<float> *out, size_t outCapacity) {
+  if (!iq || !out || inSamples == 0 || outCapacity == 0 || m_factor == 0) {
+    return 0;
+  }
+  if (m_stages.empty()) {
+    const size_t n = std::min(inSamples, outCapacity);
+    for (size_t i = 0; i < n; i++) {
+      out[i] = {(static_cast<float>(iq[2 * i]) - kU8Center) / kU8Center,
+                (static_cast<float>(iq[2 * i + 1]) - kU8Center) / kU8Center};
+    }
+    return n;
+  }
+  if (!m_rawHistory) {
+    Stage &first = m_stages[0];
+    std::fill(first.even.begin(), first.even.end(), kU8Center);
+    std::fill(first.odd.begin(), first.odd.end(), kU8Center);
+    m_rawHistory = true;
+  }
+  // The side taps sum to 1/2 against a 1/2 centre tap, so the raw 127.5 bias
+  // comes out of the first stage as exactly 127.5 * gain = 1.
+  const size_t pairs = splitU8(m_stages[0], iq, inSamples);
+  return runCascade(pairs, 1.0f / kU8Center, -1.0f, out, outCapacity);
+}
+
+size_t IqDecimator::execute(const std::complex<float> *iq, size_t inSamples,
+                            std::complex<float> *out, size_t outCapacity) {
+  if (!iq || !out || inSamples == 0 || outCapacity == 0 || m_factor == 0) {
+    return 0;
+  }
+  if (m_stages.empty()) {
+    const size_t n = std::min(inSamples, outCapacity);
+    std::memcpy(out, iq, n * sizeof(std::complex<float>));
+    return n;
+  }
+  const size_t pairs =
+      split(m_stages[0], reinterpret_cast<const float *>(iq), inSamples);
+  return runCascade(pairs, 1.0f, 0.0f, out, outCapacity);
+}
+
+} // namespace fm_tuner::dsp
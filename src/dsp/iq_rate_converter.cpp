@@ -0,0 +1,199 @@
+#include "dsp/iq_rate_converter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace fm_tuner::dsp {
+
+namespace {
+
+// num / den as L / M with L <= maxInterp: exact when the reduced ratio fits,
+// else the last continued-fraction convergent that does.
+void reduceRatio(std::uint64_t num, std::uint64_t den, std::uint64_t maxInterp,
+                 std::uint32_t &interp, std::uint32_t &decim) {
+  const std::uint64_t g = std::gcd(num, den);
+  if (num / g <= maxInterp) {
+    interp = static_cast<std::uint32_t>(num / g);
+    decim = static_cast<std::uint32_t>(den / g);
+    return;
+  }
+  std::uint64_t h0 = 0;
+  std::uint64_t h1 = 1;
+  std::uint64_t k0 = 1;
+  std::uint64_t k1 = 0;
+  std::uint64_t a = num;
+  std::uint64_t b = den;
+  while (b != 0) {
+    const std::uint64_t q = a / b;
+    const std::uint64_t h2 = q * h1 + h0;
+    const std::uint64_t k2 = q * k1 + k0;
+    if (h2 > maxInterp) {
+      break;
+    }
+    h0 = h1;
+    h1 = h2;
+    k0 = k1;
+    k1 = k2;
+    const std::uint64_t r = a - q * b;
+    a = b;
+    b = r;
+  }
+  interp = static_cast<std::uint32_t>(h1);
+  decim = static_cast<std::uint32_t>(k1);
+}
+
+} // namespace
+
+void IqRateConverter::init(std::uint32_t inputRate, std::uint32_t outputRate,
+                           float passbandHz, float stopBandAtten) {
+  if (outputRate == 0 || inputRate < outputRate) {
+    throw std::runtime_error(
+        "IQ rate converter input rate must be at least the output rate");
+  }
+  if (!(passbandHz > 0.0f &&
+        2.0f * passbandHz < static_cast<float>(outputRate))) {
+    throw std::runtime_error(
+        "IQ rate converter passband must be below half the output rate");
+  }
+  m_inputRate = inputRate;
+  m_outputRate = outputRate;
+
+  std::uint32_t factor = 1;
+  while (2ULL * factor * outputRate <= inputRate) {
+    factor *= 2;
+  }
+  const double stageRate =
+      static_cast<double>(inputRate) / static_cast<double>(factor);
+  m_decimator.init(factor, static_cast<float>(passbandHz / stageRate),
+                   stopBandAtten);
+
+  m_fractional = (static_cast<std::uint64_t>(outputRate) * factor != inputRate);
+  if (m_fractional) {
+    std::uint32_t interp = 1;
+    std::uint32_t decim = 1;
+    reduceRatio(static_cast<std::uint64_t>(outputRate) * factor, inputRate,
+                PolyphaseResampler::kMaxInterpolation, interp, decim);
+    // Flat to the passband, fully stopped where it would fold back into it:
+    // a transition from passbandHz to outputRate - passbandHz.
+    const double cutoff = 0.5 * outputRate / stageRate;
+    const double transition = (outputRate - 2.0 * passbandHz) / stageRate;
+    const double taps = (stopBandAtten - 7.95) / (14.36 * transition) + 1.0;
+    const auto halfLength =
+        static_cast<std::uint32_t>(std::max(1.0, std::ceil(taps / 2.0)));
+    m_resampler.init(decim, interp, halfLength, static_cast<float>(cutoff),
+                     stopBandAtten);
+  }
+  reset();
+}
+
+void IqRateConverter::reset() {
+  m_decimator.reset();
+  if (m_fractional) {
+    m_resampler.reset();
+  }
+}
+
+double IqRateConverter::actualOutputRate() const {
+  if (!m_fractional) {
+    return static_cast<double>(m_outputRate);
+  }
+  return static_cast<double>(m_inputRate) / m_decimator.factor() *
+         m_resampler.interpolation() / m_resampler.decimation();
+}
+
+size_t IqRateConverter::inputBlockFor(size_t outputBlock) const {
+  const size_t factor = m_decimator.factor();
+  if (!m_fractional) {
+    return outputBlock * factor;
+  }
+  // n inputs to the resampler yield at most ceil(n * L / M) outputs.
+  const size_t resamplerInputs =
+      outputBlock * m_resampler.decimation() / m_resampler.interpolation();
+  return std::max<size_t>(1, resamplerInputs) * factor;
+}
+
+double IqRateConverter::multipliesPerInputSample() const {
+  double total = m_decimator.multipliesPerInputSample();
+  if (m_fractional) {
+    // One branch dot product per output, on I and Q.
+    total += 2.0 * static_cast<double>(m_resampler.branchTaps()) *
+             m_resampler.interpolation() / m_resampler.decimation() /
+             m_decimator.factor();
+  }
+  return total;
+}
+
+std::string IqRateConverter::summary() const {
+  std::ostringstream oss;
+  oss << m_inputRate;
+  if (m_decimator.factor() > 1) {
+    oss << " -> "
+        << static_cast<double>(m_inputRate) / m_decimator.factor() << " ("
+        << m_decimator.stageCount() << " half-band stage"
+        << (m_decimator.stageCount() == 1 ? "" : "s") << ")";
+  }
+  if (m_fractional) {
+    oss << " -> " << m_outputRate << " (resampler "
+        << m_resampler.interpolation() << "/" << m_resampler.decimation()
+        << ", " << m_resampler.branchTaps() << " taps/branch";
+    const double errorPpm =
+        (actualOutputRate() / m_outputRate - 1.0) * 1e6;
+    if (std::abs(errorPpm) > 1e-6) {
+      oss << ", " << std::setprecision(3) << errorPpm << " ppm";
+    }
+    oss << ")";
+  }
+  oss << ", " << std::fixed << std::setprecision(1)
+      << multipliesPerInputSample() << " mult/sample";
+  return oss.str();
+}
+
+size_t IqRateConverter::execute(const uint8_t *iq, size_t inSamples,
+                                std::complex<float> *out, size_t outCapacity) {
+  if (!m_fractional) {
+    return m_decimator.execute(iq, inSamples, out, outCapacity);
+  }
+  m_decimated.resize(inSamples / m_decimator.factor() + 1);
+  const size_t decimated = m_decimator.execute(
+      iq, inSamples, m_decimated.data(), m_decimated.size());
+  return resample(decimated, out, outCapacity);
+}
+
+size_t IqRateConverter::execute(const std::complex<float> *iq,
+                                size_t inSamples, std::complex<float> *out,
+                                size_t outCapacity) {
+  if (!m_fractional) {
+    return m_decimator.execute(iq, inSamples, out, outCapacity);
+  }
+  m_decimated.resize(inSamples / m_decimator.factor() + 1);
+  const size_t decimated = m_decimator.execute(
+      iq, inSamples, m_decimated.data(), m_decimated.size());
+  return resample(decimated, out, outCapacity);
+}
+
+size_t IqRateConverter::resample(size_t samples, std::complex<float> *out,
+                                 size_t outCapacity) {
+  if (samples == 0 || !out) {
+    return 0;
+  }
+  m_inI.resize(samples);
+  m_inQ.resize(samples);
+  for (size_t i = 0; i < samples; i++) {
+    m_inI[i] = m_decimated[i].real();
+    m_inQ[i] = m_decimated[i].imag();
+  }
+  m_frames.resize(2 * m_resampler.maxOutput(samples));
+  const size_t produced = m_resampler.executeStereo(
+      m_inI.data(), m_inQ.data(), samples, m_frames.data());
+  const size_t written = std::min(produced, outCapacity);
+  std::memcpy(reinterpret_cast<float *>(out), m_frames.data(),
+              2 * written * sizeof(float));
+  return written;
+}
+
+} // namespace fm_tuner::dsp
@@ -0,0 +1,223 @@
+#include "dsp/kernel_registry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <sstream>
+
+#include "cpu_features.h"
+#include "dsp/simd_target.h"
+
+namespace fm_tuner::dsp {
+
+namespace {
+
+constexpr std::uint8_t isaBit(KernelIsa isa) {
+  return static_cast<std::uint8_t>(1u << static_cast<unsigned>(isa));
+}
+
+// Variants each kernel's translation unit compiles. Keep in sync with the
+// KernelTable::set() calls in the kernel modules.
+std::uint8_t compiledMask(KernelId id) {
+  std::uint8_t mask = isaBit(KernelIsa::Scalar);
+  if (FM_TUNER_SIMD_NEON) {
+    mask |= isaBit(KernelIsa::Neon);
+  }
+  if (FM_TUNER_SIMD_AVX2) {
+    mask |= isaBit(KernelIsa::Avx2);
+  }
+  if (FM_TUNER_SIMD_AVX512) {
+    switch (id) {
+    case KernelId::ChannelFir:
+    case KernelId::Resampler:
+    case KernelId::RealFir:
+    case KernelId::HalfBand:
+      mask |= isaBit(KernelIsa::Avx512);
+      break;
+    default:
+      break;
+    }
+  }
+  return mask;
+}
+
+std::uint8_t supportedMask(const CPUFeatures &cpu) {
+  std::uint8_t mask = isaBit(KernelIsa::Scalar);
+  if (cpu.neon) {
+    mask |= isaBit(KernelIsa::Neon);
+  }
+  if (cpu.avx2 && cpu.fma) {
+    mask |= isaBit(KernelIsa::Avx2);
+    if (cpu.avx512f) {
+      mask |= isaBit(KernelIsa::Avx512);
+    }
+  }
+  return mask;
+}
+
+class Registry {
+public:
+  Registry() {
+    const std::uint8_t supported = supportedMask(detectCPUFeatures());
+    for (std::size_t k = 0; k < kKernelCount; k++) {
+      m_usable[k] = compiledMask(static_cast<KernelId>(k)) & supported;
+      m_selected[k].store(static_cast<std::uint8_t>(best(k, KernelIsa::Avx512)),
+                          std::memory_order_relaxed);
+    }
+  }
+
+  KernelIsa best(std::size_t kernel, KernelIsa ceiling) const {
+    for (int isa = static_cast<int>(ceiling); isa > 0; isa--) {
+      if (m_usable[kernel] & isaBit(static_cast<KernelIsa>(isa))) {
+        return static_cast<KernelIsa>(isa);
+      }
+    }
+    return KernelIsa::Scalar;
+  }
+
+  KernelIsa selected(KernelId id) const {
+    return static_cast<KernelIsa>(
+        m_selected[static_cast<std::size_t>(id)].load(std::memory_order_relaxed));
+  }
+
+  void select(std::size_t kernel, KernelIsa isa) {
+    m_selected[kernel].store(static_cast<std::uint8_t>(isa),
+                             std::memory_order_relaxed);
+  }
+
+private:
+  std::uint8_t m_usable[kKernelCount] = {};
+  std::atomic<std::uint8_t> m_selected[kKernelCount];
+};
+
+Registry &registry() {
+  static Registry instance;
+  return instance;
+}
+
+std::string trimLower(const std::string &value) {
+  const auto notSpace = [](unsigned char c) { return !std::isspace(c); };
+  auto begin = std::find_if(value.begin(), value.end(), notSpace);
+  auto end = std::find_if(value.rbegin(), value.rend(), notSpace).base();
+  std::string out = begin < end ? std::string(begin, end) : std::string();
+  std::transform(out.begin(), out.end(), out.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return out;
+}
+
+bool parseIsaCeiling(const std::string &name, KernelIsa &out) {
+  if (name == "auto" || name == "avx512") {
+    out = KernelIsa::Avx512;
+  } else if (name == "avx2") {
+    out = KernelIsa::Avx2;
+  } else if (name == "neon") {
+    out = KernelIsa::Neon;
+  } else if (name == "scalar") {
+    out = KernelIsa::Scalar;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool parseKernelId(const std::string &name, std::size_t &out) {
+  for (std::size_t k = 0; k < kKernelCount; k++) {
+    if (name == kernelIdName(static_cast<KernelId>(k))) {
+      out = k;
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+const char *kernelIdName(KernelId id) {
+  switch (id) {
+  case KernelId::IqConvert:
+    return "iq_convert";
+  case KernelId::ChannelFir:
+    return "channel_fir";
+  case KernelId::Discriminator:
+    return "discriminator";
+  case KernelId::Resampler:
+    return "resampler";
+  case KernelId::RealFir:
+    return "real_fir";
+  case KernelId::MultipathEq:
+    return "multipath_eq";
+  case KernelId::PowerSum:
+    return "power_sum";
+  case KernelId::HalfBand:
+    return "half_band";
+  }
+  return "unknown";
+}
+
+const char *kernelIsaName(KernelIsa isa) {
+  switch (isa) {
+  case KernelIsa::Scalar:
+    return "scalar";
+  case KernelIsa::Neon:
+    return "neon";
+  case KernelIsa::Avx2:
+    return "avx2";
+  case KernelIsa::Avx512:
+    return "avx512";
+  }
+  return "unknown";
+}
+
+KernelIsa kernelIsa(KernelId id) { return registry().selected(id); }
+
+bool setKernelOverrides(const std::string &spec, std::string &error) {
+  Registry &reg = registry();
+  KernelIsa ceilings[kKernelCount];
+  std::fill(std::begin(ceilings), std::end(ceilings), KernelIsa::Avx512);
+
+  std::stringstream entries(spec);
+  std::string entry;
+  while (std::getline(entries, entry, ',')) {
+    entry = trimLower(entry);
+    if (entry.empty()) {
+      continue;
+    }
+    const std::size_t colon = entry.find(':');
+    KernelIsa ceiling = KernelIsa::Avx512;
+    const std::string isaName =
+        colon == std::string::npos ? entry : trimLower(entry.substr(colon + 1));
+    if (!parseIsaCeiling(isaName, ceiling)) {
+      error = "unknown kernel ISA '" + isaName +
+              "' (expected auto, scalar, neon, avx2 or avx512)";
+      return false;
+    }
+    if (colon == std::string::npos) {
+      std::fill(std::begin(ceilings), std::end(ceilings), ceiling);
+      continue;
+    }
+    const std::string kernelName = trimLower(entry.substr(0, colon));
+    std::size_t kernel = 0;
+    if (!parseKernelId(kernelName, kernel)) {
+      error = "unknown kernel '" + kernelName + "'";
+      return false;
+    }
+    ceilings[kernel] = ceiling;
+  }
+
+  for (std::size_t k = 0; k < kKernelCount; k++) {
+    reg.select(k, reg.best(k, ceilings[k]));
+  }
+  return true;
+}
+
+std::string kernelSelectionSummary() {
+  std::ostringstream oss;
+  for (std::size_t k = 0; k < kKernelCount; k++) {
+    const auto id = static_cast<KernelId>(k);
+    oss << (k ? " " : "") << kernelIdName(id) << "="
+        << kernelIsaName(kernelIsa(id));
+  }
+  return oss.str();
+}
+
+} // namespace fm_tuner::dsp
@@ -16,6 +16,67 @@
 
 namespace fm_tuner::dsp::liquid {
 
+float designLowpassTaps(std::uint32_t length, float cutoff, float stopBandAtten,
+                        bool l1Normalize, std::vector<float>& taps) {
+    taps.assign(length, 0.0f);
+#if FM_TUNER_LIQUID_FIRDES_KAISER_RETURNS_VOID
+    liquid_firdes_kaiser(length, cutoff, stopBandAtten, 0.0f, taps.data());
+#else
+    if (liquid_firdes_kaiser(length, cutoff, stopBandAtten, 0.0f, taps.data()) != LIQUID_OK) {
+        throw std::runtime_error("failed to design liquid kaiser taps");
+    }
+#endif
+    // Scale = 2·cutoff is the standard passband-gain compensation for lowpass
+    // Kaiser FIRs. L1 norm is not guaranteed unless asked for.
+    const float nominalScale = 2.0f * cutoff;
+    if (!l1Normalize) {
+        return nominalScale;
+    }
+    // L1-normalized lowpass: compute sum(|tap|) and clamp the post-design
+    // scale so scale·L1 ≤ 1. The DC passband gain (scale·sum(tap)) shifts at
+    // most by min(1, 2·cutoff·L1) → 1, i.e. it drops by 20·log10(2·cutoff·L1)
+    // dB when L1 > 1/(2·cutoff). For typical FM lowpass at cutoff ≈ 0.45 the
+    // shift is < 1 dB.
+    double sumAbs = 0.0;
+    for (float tap : taps) {
+        sumAbs += std::abs(tap);
+    }
+    // If the nominal scale already keeps L1·scale ≤ 1, leave it alone.
+    // Otherwise clamp scale to 1/L1 — gives |y| ≤ max|x|.
+    const float l1NormScale = (sumAbs > 1e-12)
+        ? static_cast<float>(1.0 / sumAbs)
+        : nominalScale;
+    return std::min(nominalScale, l1NormScale);
+}
+
+void designBandpassTaps(std::uint32_t length, float cutoff, float stopBandAtten,
+                        float center, std::vector<float>& taps) {
+    taps.assign(length, 0.0f);
+#if FM_TUNER_LIQUID_FIRDES_KAISER_RETURNS_VOID
+    liquid_firdes_kaiser(length, cutoff, stopBandAtten, 0.0f, taps.data());
+#else
+    if (liquid_firdes_kaiser(length, cutoff, stopBandAtten, 0.0f, taps.data()) != LIQUID_OK) {
+        throw std::runtime_error("failed to design liquid kaiser taps");
+    }
+#endif
+    const int mid = static_cast<int>(length / 2);
+    constexpr float kTwoPi = 6.28318530717958647692f;
+    for (std::uint32_t n = 0; n < length; ++n) {
+        const float phase = kTwoPi * center * static_cast<float>(static_cast<int>(n) - mid);
+        taps[n] = 2.0f * taps[n] * std::cos(phase);
+    }
+    double sumAbs = 0.0;
+    for (float tap : taps) {
+        sumAbs += std::abs(tap);
+    }
+    if (sumAbs > 1e-12) {
+        const float invSumAbs = static_cast<float>(1.0 / sumAbs);
+        for (float& tap : taps) {
+            tap *= invSumAbs;
+        }
+    }
+}
+
 AGC::~AGC() {
     if (m_object != nullptr) {
         agc_crcf_destroy(m_object);
@@ -53,6 +114,22 @@ std::complex<float> AGC::execute(std::complex<float> sample) const {
     return out;
 }
 
+void AGC::executeBlock(const std::complex<float>* input, std::size_t count,
+                       std::complex<float>* output) const {
+    if (count == 0) {
+        return;
+    }
+    if (m_object == nullptr) {
+        if (output != input) {
+            std::copy(input, input + count, output);
+        }
+        return;
+    }
+    // liquid's block APIs take non-const input but never write it.
+    agc_crcf_execute_block(m_object, const_cast<std::complex<float>*>(input),
+                           static_cast<unsigned int>(count), output);
+}
+
 FIRFilter::~FIRFilter() {
     if (m_object != nullptr) {
         firfilt_crcf_destroy(m_object);
@@ -72,76 +149,18 @@ void FIRFilter::init(std::uint32_t length, float cutoff, float stopBandAtten, fl
     m_useDirectTaps = false;
 
     if (std::abs(m_center) < 1e-6f) {
-        if (!l1Normalize) {
-            // Original Kaiser-create shortcut: liquid handles the design + scaling
-            // internally. Scale = 2·cutoff is the standard passband-gain
-            // compensation for lowpass Kaiser FIRs. L1 norm is not guaranteed.
-            m_object = firfilt_crcf_create_kaiser(length, cutoff, stopBandAtten, 0.0f);
-            if (m_object == nullptr) {
-                throw std::runtime_error("failed to create liquid firfilt_crcf");
-            }
-            m_taps.clear();
-            m_scale = 2.0f * m_cutoff;
-            firfilt_crcf_set_scale(m_object, m_scale);
-            return;
-        }
-
-        // L1-normalized lowpass: design taps explicitly, compute sum(|tap|),
-        // and clamp the post-design scale so scale·L1 ≤ 1. The DC passband
-        // gain (scale·sum(tap)) shifts at most by min(1, 2·cutoff·L1) → 1,
-        // i.e. it drops by 20·log10(2·cutoff·L1) dB when L1 > 1/(2·cutoff).
-        // For typical FM lowpass at cutoff ≈ 0.45 the shift is < 1 dB.
-        m_taps.assign(length, 0.0f);
-#if FM_TUNER_LIQUID_FIRDES_KAISER_RETURNS_VOID
-        liquid_firdes_kaiser(length, cutoff, stopBandAtten, 0.0f, m_taps.data());
-#else
-        if (liquid_firdes_kaiser(length, cutoff, stopBandAtten, 0.0f, m_taps.data()) != LIQUID_OK) {
-            throw std::runtime_error("failed to design liquid kaiser taps");
-        }
-#endif
-        double sumAbs = 0.0;
-        for (float tap : m_taps) {
-            sumAbs += std::abs(tap);
-        }
-        const float nominalScale = 2.0f * m_cutoff;
-        // If the nominal scale already keeps L1·scale ≤ 1, leave it alone.
-        // Otherwise clamp scale to 1/L1 — gives |y| ≤ max|x|.
-        const float l1NormScale = (sumAbs > 1e-12)
-            ? static_cast<float>(1.0 / sumAbs)
-            : nominalScale;
-        m_scale = std::min(nominalScale, l1NormScale);
-        m_object = firfilt_crcf_create(m_taps.data(), length);
+        std::vector<float> taps;
+        m_scale = designLowpassTaps(length, cutoff, stopBandAtten, l1Normalize, taps);
+        m_taps.clear();
+        m_object = firfilt_crcf_create(taps.data(), length);
         if (m_object == nullptr) {
-            throw std::runtime_error("failed to create liquid firfilt_crcf (L1 path)");
+            throw std::runtime_error("failed to create liquid firfilt_crcf");
         }
         firfilt_crcf_set_scale(m_object, m_scale);
         return;
     }
 
-    m_taps.assign(length, 0.0f);
-#if FM_TUNER_LIQUID_FIRDES_KAISER_RETURNS_VOID
-    liquid_firdes_kaiser(length, cutoff, stopBandAtten, 0.0f, m_taps.data());
-#else
-    if (liquid_firdes_kaiser(length, cutoff, stopBandAtten, 0.0f, m_taps.data()) != LIQUID_OK) {
-        throw std::runtime_error("failed to design liquid kaiser taps");
-    }
-#endif
-    const int mid = static_cast<int>(length / 2);
-    constexpr float kTwoPi = 6.28318530717958647692f;
-    for (std::uint32_t n = 0; n < length; ++n) {
-        const float phase = kTwoPi * m_center * static_cast<float>(static_cast<int>(n) - mid);
-        m_taps[n] = 2.0f * m_taps[n] * std::cos(phase);
-    }
-    double sumAbs = 0.0;
-    for (float tap : m_taps) {
-        sumAbs += std::abs(tap);
-    }
-    if (sumAbs > 1e-12) {
-        const float invSumAbs = static_cast<float>(1.0 / sumAbs);
-        for (float& tap : m_taps) {
-            tap *= invSumAbs;
-        }
-    }
+    designBandpassTaps(length, cutoff, stopBandAtten, m_center, m_taps);
     m_object = firfilt_crcf_create(m_taps.data(), length);
     if (m_object == nullptr) {
         throw std::runtime_error("failed to create liquid firfilt_crcf from shifted taps");
@@ -198,6 +217,19 @@ std::complex<float> FIRFilter::execute() const {
     return out;
 }
 
+void FIRFilter::executeBlock(const std::complex<float>* input, std::size_t count,
+                             std::complex<float>* output) const {
+    if (count == 0) {
+        return;
+    }
+    if (m_object == nullptr) {
+        std::fill(output, output + count, std::complex<float>{});
+        return;
+    }
+    firfilt_crcf_execute_block(m_object, const_cast<std::complex<float>*>(input),
+                               static_cast<unsigned int>(count), output);
+}
+
 std::size_t FIRFilter::length() const {
     if (m_object == nullptr) {
         return 0;
@@ -256,6 +288,19 @@ float FreqDemod::execute(std::complex<float> sample) const {
     return out;
 }
 
+void FreqDemod::executeBlock(const std::complex<float>* input, std::size_t count,
+                             float* output) const {
+    if (count == 0) {
+        return;
+    }
+    if (m_object == nullptr) {
+        std::fill(output, output + count, 0.0f);
+        return;
+    }
+    freqdem_demodulate_block(m_object, const_cast<std::complex<float>*>(input),
+                             static_cast<unsigned int>(count), output);
+}
+
 IIRFilterReal::~IIRFilterReal() {
     if (m_object != nullptr) {
         iirfilt_rrrf_destroy(m_object);
@@ -347,6 +392,21 @@ float IIRFilterReal::execute(float input) const {
     return out;
 }
 
+void IIRFilterReal::executeBlock(const float* input, std::size_t count,
+                                 float* output) const {
+    if (count == 0) {
+        return;
+    }
+    if (m_object == nullptr) {
+        if (output != input) {
+            std::copy(input, input + count, output);
+        }
+        return;
+    }
+    iirfilt_rrrf_execute_block(m_object, const_cast<float*>(input),
+                               static_cast<unsigned int>(count), output);
+}
+
 void NCO::reset() {
     if (m_object != nullptr) {
         nco_crcf_reset(m_object);
@@ -379,6 +439,21 @@ float NCO::phase() const {
     return nco_crcf_get_phase(m_object);
 }
 
+void NCO::mixBlockDown(const std::complex<float>* input, std::size_t count,
+                       std::complex<float>* output) const {
+    if (count == 0) {
+        return;
+    }
+    if (m_object == nullptr) {
+        if (output != input) {
+            std::copy(input, input + count, output);
+        }
+        return;
+    }
+    nco_crcf_mix_block_down(m_object, const_cast<std::complex<float>*>(input),
+                            output, static_cast<unsigned int>(count));
+}
+
 Resampler::~Resampler() {
     if (m_object != nullptr) {
         resamp_rrrf_destroy(m_object);
@@ -1,7 +1,11 @@
 #include "dsp/multipath_eq.h"
 
+#include "dsp/kernel_registry.h"
+#include "dsp/simd_dot.h"
+
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace fm_tuner::dsp {
 
@@ -51,6 +55,153 @@ float leakForMode(MultipathEqMode mode) {
   }
   return 0.0f;
 }
+
+// One CMA step over N contiguous taps / history samples (split I/Q):
+//   convolve: y = sum w[j] * h[j]
+//   update:   w[j] = decay * w[j] - c * conj(h[j])
+// The vector kernels run the largest multiple of their width and finish the
+// odd tail (N is odd) in scalar code, so no padding tap ever drifts.
+struct CmaKernels {
+  std::complex<float> (*convolve)(const float *wRe, const float *wIm,
+                                  const float *hRe, const float *hIm,
+                                  size_t count);
+  void (*update)(float *wRe, float *wIm, const float *hRe, const float *hIm,
+                 size_t count, float decay, std::complex<float> c);
+};
+
+void convolveTail(const float *wRe, const float *wIm, const float *hRe,
+                  const float *hIm, size_t begin, size_t count, float &yRe,
+                  float &yIm) {
+  for (size_t j = begin; j < count; j++) {
+    yRe += wRe[j] * hRe[j] - wIm[j] * hIm[j];
+    yIm += wRe[j] * hIm[j] + wIm[j] * hRe[j];
+  }
+}
+
+void updateTail(float *wRe, float *wIm, const float *hRe, const float *hIm,
+                size_t begin, size_t count, float decay,
+                std::complex<float> c) {
+  const float cRe = c.real();
+  const float cIm = c.imag();
+  for (size_t j = begin; j < count; j++) {
+    const float gRe = cRe * hRe[j] + cIm * hIm[j];
+    const float gIm = cIm * hRe[j] - cRe * hIm[j];
+    wRe[j] = decay * wRe[j] - gRe;
+    wIm[j] = decay * wIm[j] - gIm;
+  }
+}
+
+std::complex<float> convolveScalar(const float *wRe, const float *wIm,
+                                   const float *hRe, const float *hIm,
+                                   size_t count) {
+  float yRe = 0.0f;
+  float yIm = 0.0f;
+  convolveTail(wRe, wIm, hRe, hIm, 0, count, yRe, yIm);
+  return {yRe, yIm};
+}
+
+void updateScalar(float *wRe, float *wIm, const float *hRe, const float *hIm,
+                  size_t count, float decay, std::complex<float> c) {
+  updateTail(wRe, wIm, hRe, hIm, 0, count, decay, c);
+}
+
+#if FM_TUNER_SIMD_AVX2
+FM_TUNER_AVX2_TARGET std::complex<float>
+convolveAvx2(const float *wRe, const float *wIm, const float *hRe,
+             const float *hIm, size_t count) {
+  __m256 accRR = _mm256_setzero_ps();
+  __m256 accII = _mm256_setzero_ps();
+  __m256 accRI = _mm256_setzero_ps();
+  __m256 accIR = _mm256_setzero_ps();
+  size_t j = 0;
+  for (; j + 8 <= count; j += 8) {
+    const __m256 wr = _mm256_loadu_ps(wRe + j);
+    const __m256 wi = _mm256_loadu_ps(wIm + j);
+    const __m256 hr = _mm256_loadu_ps(hRe + j);
+    const __m256 hi = _mm256_loadu_ps(hIm + j);
+    accRR = _mm256_fmadd_ps(wr, hr, accRR);
+    accII = _mm256_fmadd_ps(wi, hi, accII);
+    accRI = _mm256_fmadd_ps(wr, hi, accRI);
+    accIR = _mm256_fmadd_ps(wi, hr, accIR);
+  }
+  float yRe = hsumAvx2(_mm256_sub_ps(accRR, accII));
+  float yIm = hsumAvx2(_mm256_add_ps(accRI, accIR));
+  convolveTail(wRe, wIm, hRe, hIm, j, count, yRe, yIm);
+  return {yRe, yIm};
+}
+
+FM_TUNER_AVX2_TARGET void updateAvx2(float *wRe, float *wIm, const float *hRe,
+                                     const float *hIm, size_t count,
+                                     float decay, std::complex<float> c) {
+  const __m256 d = _mm256_set1_ps(decay);
+  const __m256 cr = _mm256_set1_ps(c.real());
+  const __m256 ci = _mm256_set1_ps(c.imag());
+  size_t j = 0;
+  for (; j + 8 <= count; j += 8) {
+    const __m256 hr = _mm256_loadu_ps(hRe + j);
+    const __m256 hi = _mm256_loadu_ps(hIm + j);
+    const __m256 gRe = _mm256_fmadd_ps(cr, hr, _mm256_mul_ps(ci, hi));
+    const __m256 gIm = _mm256_fmsub_ps(ci, hr, _mm256_mul_ps(cr, hi));
+    _mm256_storeu_ps(wRe + j,
+                     _mm256_fmsub_ps(d, _mm256_loadu_ps(wRe + j), gRe));
+    _mm256_storeu_ps(wIm + j,
+                     _mm256_fmsub_ps(d, _mm256_loadu_ps(wIm + j), gIm));
+  }
+  updateTail(wRe, wIm, hRe, hIm, j, count, decay, c);
+}
+#endif
+
+#if FM_TUNER_SIMD_NEON
+std::complex<float> convolveNeon(const float *wRe, const float *wIm,
+                                 const float *hRe, const float *hIm,
+                                 size_t count) {
+  float32x4_t accRe = vdupq_n_f32(0.0f);
+  float32x4_t accIm = vdupq_n_f32(0.0f);
+  size_t j = 0;
+  for (; j + 4 <= count; j += 4) {
+    const float32x4_t wr = vld1q_f32(wRe + j);
+    const float32x4_t wi = vld1q_f32(wIm + j);
+    const float32x4_t hr = vld1q_f32(hRe + j);
+    const float32x4_t hi = vld1q_f32(hIm + j);
+    accRe = vmlsq_f32(vmlaq_f32(accRe, wr, hr), wi, hi);
+    accIm = vmlaq_f32(vmlaq_f32(accIm, wr, hi), wi, hr);
+  }
+  float yRe = hsumNeon(accRe);
+  float yIm = hsumNeon(accIm);
+  convolveTail(wRe, wIm, hRe, hIm, j, count, yRe, yIm);
+  return {yRe, yIm};
+}
+
+void updateNeon(float *wRe, float *wIm, const float *hRe, const float *hIm,
+                size_t count, float decay, std::complex<float> c) {
+  const float cRe = c.real();
+  const float cIm = c.imag();
+  size_t j = 0;
+  for (; j + 4 <= count; j += 4) {
+    const float32x4_t hr = vld1q_f32(hRe + j);
+    const float32x4_t hi = vld1q_f32(hIm + j);
+    const float32x4_t gRe = vmlaq_n_f32(vmulq_n_f32(hr, cRe), hi, cIm);
+    const float32x4_t gIm = vmlsq_n_f32(vmulq_n_f32(hr, cIm), hi, cRe);
+    vst1q_f32(wRe + j, vsubq_f32(vmulq_n_f32(vld1q_f32(wRe + j), decay), gRe));
+    vst1q_f32(wIm + j, vsubq_f32(vmulq_n_f32(vld1q_f32(wIm + j), decay), gIm));
+  }
+  updateTail(wRe, wIm, hRe, hIm, j, count, decay, c);
+}
+#endif
+
+const CmaKernels &cmaKernels() {
+  static const KernelTable<CmaKernels> table = []() {
+    KernelTable<CmaKernels> t{CmaKernels{convolveScalar, updateScalar}};
+#if FM_TUNER_SIMD_AVX2
+    t.set(KernelIsa::Avx2, CmaKernels{convolveAvx2, updateAvx2});
+#endif
+#if FM_TUNER_SIMD_NEON
+    t.set(KernelIsa::Neon, CmaKernels{convolveNeon, updateNeon});
+#endif
+    return t;
+  }();
+  return table.select(KernelId::MultipathEq);
+}
 } // namespace
 
 MultipathEqualizer::MultipathEqualizer() = default;
@@ -95,75 +246,97 @@ void MultipathEqualizer::rebuildTaps() {
   if (m_tapCount == 0U) {
     m_tapCount = 17U;
   }
-  m_taps.assign(m_tapCount, std::complex<float>(0.0f, 0.0f));
-  m_history.assign(m_tapCount, std::complex<float>(0.0f, 0.0f));
+  m_tapsRe.assign(m_tapCount, 0.0f);
+  m_tapsIm.assign(m_tapCount, 0.0f);
+  m_historyRe.assign(m_tapCount - 1U, 0.0f);
+  m_historyIm.assign(m_tapCount - 1U, 0.0f);
   // Initialize to a delta at the centre tap so the equalizer starts as a
   // pure unit delay (transparent). CMA adapts away from this only when a
   // strong constant-modulus reference is available.
-  m_taps[m_tapCount / 2U] = std::complex<float>(1.0f, 0.0f);
-  m_writePos = 0;
+  m_tapsRe[m_tapCount / 2U] = 1.0f;
 }
 
 std::complex<float> MultipathEqualizer::execute(std::complex<float> input) {
-  if (m_mode == MultipathEqMode::Off || m_taps.empty()) {
-    return input;
-  }
+  std::complex<float> output;
+  executeBlock(&input, &output, 1);
+  return output;
+}
 
-  // Track input envelope power (|x|²) with a slow EMA. The first sample
-  // primes the average to avoid a long pull-up transient from zero.
-  const float xMagSq =
-      input.real() * input.real() + input.imag() * input.imag();
-  if (!m_targetPrimed) {
-    m_inputMeanSqMag = xMagSq;
-    m_targetPrimed = true;
-  } else {
-    m_inputMeanSqMag += kInputMeanAlpha * (xMagSq - m_inputMeanSqMag);
+void MultipathEqualizer::executeBlock(const std::complex<float> *in,
+                                      std::complex<float> *out,
+                                      size_t samples) {
+  if (samples == 0) {
+    return;
+  }
+  if (m_mode == MultipathEqMode::Off || m_tapsRe.empty()) {
+    if (out != in) {
+      std::memmove(out, in, samples * sizeof(std::complex<float>));
+    }
+    return;
   }
 
-  // Newest sample at m_writePos.
-  m_history[m_writePos] = input;
-
-  // Convolve. We index history backwards from writePos so tap[0] is the
-  // newest sample, tap[N-1] is the oldest — matches a standard transversal
-  // FIR (taps[k] multiplies x[n-k]).
-  const std::uint32_t N = m_tapCount;
-  std::complex<float> y(0.0f, 0.0f);
-  for (std::uint32_t k = 0; k < N; ++k) {
-    const std::uint32_t idx =
-        (m_writePos + N - k) % N;
-    y += m_taps[k] * m_history[idx];
+  const size_t N = m_tapCount;
+  const size_t keep = N - 1U;
+  m_historyRe.resize(keep + samples);
+  m_historyIm.resize(keep + samples);
+  for (size_t i = 0; i < samples; i++) {
+    m_historyRe[keep + i] = in[i].real();
+    m_historyIm[keep + i] = in[i].imag();
   }
 
-  // Dispersion-CMA update: minimize (|y|² - E[|x|²])². The target tracks the
-  // input envelope so on a constant-envelope signal the error is near zero
-  // and the filter stays put. Multipath shows up as envelope variation
-  // around the running mean — that's what gets driven down.
-  if (m_adaptEnabled && m_mu > 0.0f) {
-    const float yMagSq = y.real() * y.real() + y.imag() * y.imag();
-    const float envErr = yMagSq - m_inputMeanSqMag;
-    m_envelopeError +=
-        kEnvErrorAlpha * (std::abs(envErr) - m_envelopeError);
-
-    const std::complex<float> errTimesY = y * envErr;
-    const std::uint32_t centreIdx = N / 2U;
-    for (std::uint32_t k = 0; k < N; ++k) {
-      const std::uint32_t idx =
-          (m_writePos + N - k) % N;
-      const std::complex<float> grad = errTimesY * std::conj(m_history[idx]);
+  const CmaKernels &kernels = cmaKernels();
+  const bool adapt = m_adaptEnabled && m_mu > 0.0f;
+  const float decay = 1.0f - m_leak;
+  const size_t centreIdx = N / 2U;
+  float *tapsRe = m_tapsRe.data();
+  float *tapsIm = m_tapsIm.data();
+  for (size_t i = 0; i < samples; i++) {
+    // Track input envelope power (|x|²) with a slow EMA. The first sample
+    // primes the average to avoid a long pull-up transient from zero.
+    const float xRe = m_historyRe[keep + i];
+    const float xIm = m_historyIm[keep + i];
+    const float xMagSq = xRe * xRe + xIm * xIm;
+    if (!m_targetPrimed) {
+      m_inputMeanSqMag = xMagSq;
+      m_targetPrimed = true;
+    } else {
+      m_inputMeanSqMag += kInputMeanAlpha * (xMagSq - m_inputMeanSqMag);
+    }
+
+    // history[i .. i+N-1] runs oldest to newest, matching the reversed taps
+    // (taps[k] multiplies x[n-k] of a standard transversal FIR).
+    const float *hRe = m_historyRe.data() + i;
+    const float *hIm = m_historyIm.data() + i;
+    const std::complex<float> y =
+        kernels.convolve(tapsRe, tapsIm, hRe, hIm, N);
+    out[i] = y;
+
+    // Dispersion-CMA update: minimize (|y|² - E[|x|²])². The target tracks
+    // the input envelope so on a constant-envelope signal the error is near
+    // zero and the filter stays put. Multipath shows up as envelope
+    // variation around the running mean — that's what gets driven down.
+    if (adapt) {
+      const float yMagSq = y.real() * y.real() + y.imag() * y.imag();
+      const float envErr = yMagSq - m_inputMeanSqMag;
+      m_envelopeError +=
+          kEnvErrorAlpha * (std::abs(envErr) - m_envelopeError);
+
       // CMA step + leak toward delta: every tap shrinks by (1 - leak),
       // and the centre tap is then nudged back toward 1. Pulls the filter
       // back to a pure pass-through when the LMS gradient is small —
       // preventing CMA's known phase-ambiguity wandering on clean FM.
-      m_taps[k] = m_taps[k] * (1.0f - m_leak) - m_mu * grad;
-      if (k == centreIdx) {
-        m_taps[k] += m_leak * std::complex<float>(1.0f, 0.0f);
-      }
+      kernels.update(tapsRe, tapsIm, hRe, hIm, N, decay,
+                     (m_mu * envErr) * y);
+      tapsRe[centreIdx] += m_leak;
     }
   }
 
-  // Advance ring write pointer for next sample.
-  m_writePos = (m_writePos + 1U) % m_tapCount;
-  return y;
+  std::memmove(m_historyRe.data(), m_historyRe.data() + samples,
+               keep * sizeof(float));
+  std::memmove(m_historyIm.data(), m_historyIm.data() + samples,
+               keep * sizeof(float));
+  m_historyRe.resize(keep);
+  m_historyIm.resize(keep);
 }
 
 } // namespace fm_tuner::dsp
@@ -0,0 +1,180 @@
+#include "dsp/phase_discriminator.h"
+
+#include "dsp/kernel_registry.h"
+#include "dsp/simd_target.h"
+
+#include <cstdint>
+
+namespace fm_tuner::dsp {
+
+namespace {
+
+using namespace detail;
+
+// Scalar body for x[start..samples); x[start - 1] must be valid (or start is
+// 0 and prev stands in for it).
+void discriminateScalar(const std::complex<float> *in, size_t start,
+                        size_t samples, std::complex<float> prev, float gain,
+                        float *out) {
+  if (start > 0) {
+    prev = in[start - 1];
+  }
+  for (size_t i = start; i < samples; i++) {
+    const std::complex<float> x = in[i];
+    // conj(prev) * x, written out so it stays a plain 4-mul kernel.
+    const float re = prev.real() * x.real() + prev.imag() * x.imag();
+    const float im = prev.real() * x.imag() - prev.imag() * x.real();
+    out[i] = fastAtan2(im, re) * gain;
+    prev = x;
+  }
+}
+
+#if FM_TUNER_SIMD_AVX2
+// Eight samples per step. Real and imaginary parts are split with
+// shuffle_ps, which leaves lanes in sample order 0,1,4,5 | 2,3,6,7; the
+// math is lane-wise, so the result is put back in order once at the end.
+FM_TUNER_AVX2_TARGET void discriminateAvx2(const std::complex<float> *in,
+                                           size_t samples,
+                                           std::complex<float> prev,
+                                           float gain, float *out) {
+  if (samples == 0) {
+    return;
+  }
+  discriminateScalar(in, 0, 1, prev, gain, out);
+  const float *f = reinterpret_cast<const float *>(in);
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+  const __m256 tiny = _mm256_set1_ps(1e-30f);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 halfPi = _mm256_set1_ps(kHalfPi);
+  const __m256 pi = _mm256_set1_ps(kPi);
+  const __m256 vGain = _mm256_set1_ps(gain);
+  size_t i = 1;
+  for (; i + 8 <= samples; i += 8) {
+    const __m256 x0 = _mm256_loadu_ps(f + 2 * i);
+    const __m256 x1 = _mm256_loadu_ps(f + 2 * i + 8);
+    const __m256 p0 = _mm256_loadu_ps(f + 2 * i - 2);
+    const __m256 p1 = _mm256_loadu_ps(f + 2 * i + 6);
+    const __m256 xr = _mm256_shuffle_ps(x0, x1, 0x88);
+    const __m256 xi = _mm256_shuffle_ps(x0, x1, 0xDD);
+    const __m256 pr = _mm256_shuffle_ps(p0, p1, 0x88);
+    const __m256 pq = _mm256_shuffle_ps(p0, p1, 0xDD);
+    const __m256 re = _mm256_fmadd_ps(pr, xr, _mm256_mul_ps(pq, xi));
+    const __m256 im = _mm256_fmsub_ps(pr, xi, _mm256_mul_ps(pq, xr));
+
+    const __m256 ax = _mm256_andnot_ps(signMask, re);
+    const __m256 ay = _mm256_andnot_ps(signMask, im);
+    const __m256 a = _mm256_div_ps(
+        _mm256_min_ps(ax, ay), _mm256_max_ps(_mm256_max_ps(ax, ay), tiny));
+    const __m256 s = _mm256_mul_ps(a, a);
+    __m256 poly = _mm256_set1_ps(kAtanC11);
+    poly = _mm256_fmadd_ps(poly, s, _mm256_set1_ps(kAtanC9));
+    poly = _mm256_fmadd_ps(poly, s, _mm256_set1_ps(kAtanC7));
+    poly = _mm256_fmadd_ps(poly, s, _mm256_set1_ps(kAtanC5));
+    poly = _mm256_fmadd_ps(poly, s, _mm256_set1_ps(kAtanC3));
+    poly = _mm256_fmadd_ps(poly, s, _mm256_set1_ps(kAtanC1));
+    __m256 r = _mm256_mul_ps(poly, a);
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(halfPi, r),
+                         _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(pi, r),
+                         _mm256_cmp_ps(re, zero, _CMP_LT_OQ));
+    // r >= 0 here, so copysign is a plain OR of the sign bit.
+    r = _mm256_or_ps(r, _mm256_and_ps(im, signMask));
+    r = _mm256_mul_ps(r, vGain);
+    r = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), 0xD8));
+    _mm256_storeu_ps(out + i, r);
+  }
+  discriminateScalar(in, i, samples, prev, gain, out);
+}
+#endif
+
+#if FM_TUNER_SIMD_NEON
+inline float32x4_t divideNeon(float32x4_t num, float32x4_t den) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+  return vdivq_f32(num, den);
+#else
+  float32x4_t inv = vrecpeq_f32(den);
+  inv = vmulq_f32(inv, vrecpsq_f32(den, inv));
+  inv = vmulq_f32(inv, vrecpsq_f32(den, inv));
+  return vmulq_f32(num, inv);
+#endif
+}
+
+void discriminateNeon(const std::complex<float> *in, size_t samples,
+                      std::complex<float> prev, float gain, float *out) {
+  if (samples == 0) {
+    return;
+  }
+  discriminateScalar(in, 0, 1, prev, gain, out);
+  const float *f = reinterpret_cast<const float *>(in);
+  const uint32x4_t signMask = vdupq_n_u32(0x80000000U);
+  const float32x4_t tiny = vdupq_n_f32(1e-30f);
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  const float32x4_t halfPi = vdupq_n_f32(kHalfPi);
+  const float32x4_t pi = vdupq_n_f32(kPi);
+  size_t i = 1;
+  for (; i + 4 <= samples; i += 4) {
+    const float32x4x2_t x = vld2q_f32(f + 2 * i);
+    const float32x4x2_t p = vld2q_f32(f + 2 * i - 2);
+    const float32x4_t re =
+        vmlaq_f32(vmulq_f32(p.val[0], x.val[0]), p.val[1], x.val[1]);
+    const float32x4_t im =
+        vmlsq_f32(vmulq_f32(p.val[0], x.val[1]), p.val[1], x.val[0]);
+
+    const float32x4_t ax = vabsq_f32(re);
+    const float32x4_t ay = vabsq_f32(im);
+    const float32x4_t a = divideNeon(vminq_f32(ax, ay),
+                                     vmaxq_f32(vmaxq_f32(ax, ay), tiny));
+    const float32x4_t s = vmulq_f32(a, a);
+    float32x4_t poly = vdupq_n_f32(kAtanC11);
+    poly = vmlaq_f32(vdupq_n_f32(kAtanC9), poly, s);
+    poly = vmlaq_f32(vdupq_n_f32(kAtanC7), poly, s);
+    poly = vmlaq_f32(vdupq_n_f32(kAtanC5), poly, s);
+    poly = vmlaq_f32(vdupq_n_f32(kAtanC3), poly, s);
+    poly = vmlaq_f32(vdupq_n_f32(kAtanC1), poly, s);
+    float32x4_t r = vmulq_f32(poly, a);
+    r = vbslq_f32(vcgtq_f32(ay, ax), vsubq_f32(halfPi, r), r);
+    r = vbslq_f32(vcltq_f32(re, zero), vsubq_f32(pi, r), r);
+    r = vreinterpretq_f32_u32(vorrq_u32(
+        vreinterpretq_u32_f32(r), vandq_u32(vreinterpretq_u32_f32(im), signMask)));
+    vst1q_f32(out + i, vmulq_n_f32(r, gain));
+  }
+  discriminateScalar(in, i, samples, prev, gain, out);
+}
+#endif
+
+void discriminateScalarBlock(const std::complex<float> *in, size_t samples,
+                             std::complex<float> prev, float gain,
+                             float *out) {
+  discriminateScalar(in, 0, samples, prev, gain, out);
+}
+
+using DiscriminateFn = void (*)(const std::complex<float> *, size_t,
+                                std::complex<float>, float, float *);
+
+const KernelTable<DiscriminateFn> &discriminateKernels() {
+  static const KernelTable<DiscriminateFn> table = []() {
+    KernelTable<DiscriminateFn> t(discriminateScalarBlock);
+#if FM_TUNER_SIMD_AVX2
+    t.set(KernelIsa::Avx2, discriminateAvx2);
+#endif
+#if FM_TUNER_SIMD_NEON
+    t.set(KernelIsa::Neon, discriminateNeon);
+#endif
+    return t;
+  }();
+  return table;
+}
+
+} // namespace
+
+void discriminateBlock(const std::complex<float> *in, size_t samples,
+                       std::complex<float> &prev, float gain, float *out) {
+  if (!in || !out || samples == 0) {
+    return;
+  }
+  discriminateKernels().select(KernelId::Discriminator)(in, samples, prev, gain,
+                                                       out);
+  prev = in[samples - 1];
+}
+
+} // namespace fm_tuner::dsp
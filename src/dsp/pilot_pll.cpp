@@ -0,0 +1,167 @@
+#include "dsp/pilot_pll.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fm_tuner::dsp {
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+constexpr float kHalfPi = 1.5707963267948966f;
+constexpr float kTwoPi = 6.28318530717959f;
+// One accumulator unit is 2*pi / 2^32 rad.
+constexpr float kUnitsPerRad = 4294967296.0f / kTwoPi;
+constexpr float kRadPerUnit = kTwoPi / 4294967296.0f;
+
+// 1024-entry sin/cos LUT with linear interpolation (N+1 entries so the
+// upper-bound interpolation lookup doesn't need a separate wrap). Max
+// error ~1.9e-5 (~13.7 bits) — well under the PLL's phase jitter and far
+// below the FM noise floor.
+struct PhaseLUT {
+  static constexpr unsigned kBits = 10;
+  static constexpr unsigned N = 1U << kBits;
+  float sinTbl[N + 1];
+  float cosTbl[N + 1];
+  PhaseLUT() {
+    for (unsigned i = 0; i <= N; ++i) {
+      const float p = static_cast<float>(i) * kTwoPi / static_cast<float>(N);
+      sinTbl[i] = std::sin(p);
+      cosTbl[i] = std::cos(p);
+    }
+  }
+};
+
+inline const PhaseLUT &phaseLUT() {
+  static const PhaseLUT lut;
+  return lut;
+}
+
+// The top 10 bits of the accumulator are the table index, the remaining 22
+// the interpolation fraction.
+inline void lutSinCos(const PhaseLUT &lut, std::uint32_t phase, float &s,
+                      float &c) {
+  constexpr unsigned kFracBits = 32 - PhaseLUT::kBits;
+  constexpr float kFracScale = 1.0f / static_cast<float>(1U << kFracBits);
+  const unsigned i = phase >> kFracBits;
+  const float f =
+      static_cast<float>(phase & ((1U << kFracBits) - 1U)) * kFracScale;
+  s = lut.sinTbl[i] + f * (lut.sinTbl[i + 1] - lut.sinTbl[i]);
+  c = lut.cosTbl[i] + f * (lut.cosTbl[i + 1] - lut.cosTbl[i]);
+}
+
+// Signed radians -> accumulator units (two's complement wrap).
+inline std::uint32_t toUnits(float rad) {
+  return static_cast<std::uint32_t>(
+      static_cast<std::int32_t>(std::lrint(rad * kUnitsPerRad)));
+}
+
+// Polynomial approximation of atan2 — max error ~0.0015 rad (~0.09°), more
+// than tight enough for the pilot-PLL phase detector at 19 kHz. Branch-light
+// to keep the hot path predictable.
+inline float fast_atan2f(float y, float x) {
+  if (x == 0.0f) {
+    return (y > 0.0f) ? kHalfPi : (y < 0.0f) ? -kHalfPi : 0.0f;
+  }
+  constexpr float kPiOver4 = 0.7853981633974483f;
+  const float ax = std::fabs(x);
+  const float ay = std::fabs(y);
+  const bool xDom = (ax >= ay);
+  const float a = xDom ? (ay / ax) : (ax / ay);
+  // Rajan / Volder polynomial: angle ≈ a·(π/4 - (a-1)(0.2447 + 0.0663·a))
+  const float base = a * (kPiOver4 - (a - 1.0f) * (0.2447f + 0.0663f * a));
+  float result = xDom ? base : (kHalfPi - base);
+  if (x < 0.0f) {
+    result = kPi - result;
+  }
+  return (y < 0.0f) ? -result : result;
+}
+
+} // namespace
+
+void PilotPll::init(float angularFrequency) {
+  m_nominalFreq = toUnits(angularFrequency);
+  reset();
+}
+
+void PilotPll::reset() {
+  m_phase = 0;
+  m_freq = m_nominalFreq;
+}
+
+void PilotPll::setBandwidth(float bandwidth) {
+  m_alpha = bandwidth;
+  m_beta = std::sqrt(std::max(bandwidth, 0.0f));
+}
+
+void PilotPll::process(const float *pilot, size_t samples, const Block &out) {
+  if (!pilot || samples == 0 || !out.mixedI || !out.mixedQ) {
+    return;
+  }
+  const PhaseLUT &lut = phaseLUT();
+  std::uint32_t phase = m_phase;
+  std::uint32_t freq = m_freq;
+  for (size_t i = 0; i < samples; i++) {
+    float vcoSin;
+    float vcoCos;
+    lutSinCos(lut, phase, vcoSin, vcoCos);
+    // Real pilot times conj(vco).
+    const float mixedI = pilot[i] * vcoCos;
+    const float mixedQ = -pilot[i] * vcoSin;
+    out.mixedI[i] = mixedI;
+    out.mixedQ[i] = mixedQ;
+    const float error = fast_atan2f(mixedQ, mixedI);
+    freq += toUnits(error * m_alpha);
+    const std::uint32_t advance = freq + toUnits(error * m_beta);
+    phase += advance;
+    if (out.freq) {
+      out.freq[i] =
+          static_cast<float>(static_cast<std::int32_t>(advance)) * kRadPerUnit;
+    }
+    if (out.cos19 || out.sin19) {
+      float s;
+      float c;
+      lutSinCos(lut, phase, s, c);
+      if (out.cos19) {
+        out.cos19[i] = c;
+      }
+      if (out.sin19) {
+        out.sin19[i] = s;
+      }
+    }
+    if (out.cos38 || out.sin38) {
+      float s;
+      float c;
+      lutSinCos(lut, phase * 2U, s, c);
+      if (out.cos38) {
+        out.cos38[i] = c;
+      }
+      if (out.sin38) {
+        out.sin38[i] = s;
+      }
+    }
+    if (out.cos57 || out.sin57) {
+      float s;
+      float c;
+      lutSinCos(lut, phase * 3U, s, c);
+      if (out.cos57) {
+        out.cos57[i] = c;
+      }
+      if (out.sin57) {
+        out.sin57[i] = s;
+      }
+    }
+  }
+  m_phase = phase;
+  m_freq = freq;
+}
+
+float PilotPll::phase() const {
+  return static_cast<float>(static_cast<std::int32_t>(m_phase)) * kRadPerUnit;
+}
+
+float PilotPll::frequency() const {
+  return static_cast<float>(static_cast<std::int32_t>(m_freq)) * kRadPerUnit;
+}
+
+} // namespace fm_tuner::dsp
@@ -0,0 +1,361 @@
+#include "dsp/polyphase_resampler.h"
+
+#include "dsp/kernel_registry.h"
+#include "dsp/liquid_primitives.h"
+#include "dsp/simd_dot.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace fm_tuner::dsp {
+
+namespace {
+
+// Two inputs against the same taps, with the same per-lane accumulation
+// order as the single-channel kernels (so each lane is bit-identical to dot).
+void dot2Scalar(const float *taps, const float *x0, const float *x1,
+                size_t count, float *y0, float *y1) {
+  float a0 = 0.0f;
+  float a1 = 0.0f;
+  float b0 = 0.0f;
+  float b1 = 0.0f;
+  for (size_t k = 0; k < count; k += 2) {
+    a0 += taps[k] * x0[k];
+    a1 += taps[k + 1] * x0[k + 1];
+    b0 += taps[k] * x1[k];
+    b1 += taps[k + 1] * x1[k + 1];
+  }
+  *y0 = a0 + a1;
+  *y1 = b0 + b1;
+}
+
+#if FM_TUNER_SIMD_AVX2
+FM_TUNER_AVX2_TARGET void dot2Avx2(const float *taps, const float *x0,
+                                   const float *x1, size_t count, float *y0,
+                                   float *y1) {
+  __m256 a0 = _mm256_setzero_ps();
+  __m256 a1 = _mm256_setzero_ps();
+  __m256 b0 = _mm256_setzero_ps();
+  __m256 b1 = _mm256_setzero_ps();
+  size_t k = 0;
+  for (; k + 2 * kDotTapBlock <= count; k += 2 * kDotTapBlock) {
+    const __m256 t0 = _mm256_loadu_ps(taps + k);
+    const __m256 t1 = _mm256_loadu_ps(taps + k + 8);
+    a0 = _mm256_fmadd_ps(t0, _mm256_loadu_ps(x0 + k), a0);
+    a1 = _mm256_fmadd_ps(t1, _mm256_loadu_ps(x0 + k + 8), a1);
+    b0 = _mm256_fmadd_ps(t0, _mm256_loadu_ps(x1 + k), b0);
+    b1 = _mm256_fmadd_ps(t1, _mm256_loadu_ps(x1 + k + 8), b1);
+  }
+  if (k < count) {
+    const __m256 t0 = _mm256_loadu_ps(taps + k);
+    a0 = _mm256_fmadd_ps(t0, _mm256_loadu_ps(x0 + k), a0);
+    b0 = _mm256_fmadd_ps(t0, _mm256_loadu_ps(x1 + k), b0);
+  }
+  *y0 = hsumAvx2(_mm256_add_ps(a0, a1));
+  *y1 = hsumAvx2(_mm256_add_ps(b0, b1));
+}
+#endif
+
+#if FM_TUNER_SIMD_AVX512
+FM_TUNER_AVX512_TARGET void dot2Avx512(const float *taps, const float *x0,
+                                       const float *x1, size_t count,
+                                       float *y0, float *y1) {
+  __m512 a0 = _mm512_setzero_ps();
+  __m512 a1 = _mm512_setzero_ps();
+  __m512 b0 = _mm512_setzero_ps();
+  __m512 b1 = _mm512_setzero_ps();
+  size_t k = 0;
+  for (; k + 4 * kDotTapBlock <= count; k += 4 * kDotTapBlock) {
+    const __m512 t0 = _mm512_loadu_ps(taps + k);
+    const __m512 t1 = _mm512_loadu_ps(taps + k + 16);
+    a0 = _mm512_fmadd_ps(t0, _mm512_loadu_ps(x0 + k), a0);
+    a1 = _mm512_fmadd_ps(t1, _mm512_loadu_ps(x0 + k + 16), a1);
+    b0 = _mm512_fmadd_ps(t0, _mm512_loadu_ps(x1 + k), b0);
+    b1 = _mm512_fmadd_ps(t1, _mm512_loadu_ps(x1 + k + 16), b1);
+  }
+  if (k + 2 * kDotTapBlock <= count) {
+    const __m512 t0 = _mm512_loadu_ps(taps + k);
+    a0 = _mm512_fmadd_ps(t0, _mm512_loadu_ps(x0 + k), a0);
+    b0 = _mm512_fmadd_ps(t0, _mm512_loadu_ps(x1 + k), b0);
+    k += 2 * kDotTapBlock;
+  }
+  if (k < count) {
+    const __m512 t1 = _mm512_maskz_loadu_ps(kHalfTail, taps + k);
+    a1 = _mm512_fmadd_ps(t1, _mm512_maskz_loadu_ps(kHalfTail, x0 + k), a1);
+    b1 = _mm512_fmadd_ps(t1, _mm512_maskz_loadu_ps(kHalfTail, x1 + k), b1);
+  }
+  *y0 = hsumAvx512(_mm512_add_ps(a0, a1));
+  *y1 = hsumAvx512(_mm512_add_ps(b0, b1));
+}
+#endif
+
+#if FM_TUNER_SIMD_NEON
+void dot2Neon(const float *taps, const float *x0, const float *x1,
+              size_t count, float *y0, float *y1) {
+  float32x4_t a0 = vdupq_n_f32(0.0f);
+  float32x4_t a1 = vdupq_n_f32(0.0f);
+  float32x4_t b0 = vdupq_n_f32(0.0f);
+  float32x4_t b1 = vdupq_n_f32(0.0f);
+  for (size_t k = 0; k < count; k += kDotTapBlock) {
+    const float32x4_t t0 = vld1q_f32(taps + k);
+    const float32x4_t t1 = vld1q_f32(taps + k + 4);
+    a0 = vmlaq_f32(a0, t0, vld1q_f32(x0 + k));
+    a1 = vmlaq_f32(a1, t1, vld1q_f32(x0 + k + 4));
+    b0 = vmlaq_f32(b0, t0, vld1q_f32(x1 + k));
+    b1 = vmlaq_f32(b1, t1, vld1q_f32(x1 + k + 4));
+  }
+  *y0 = hsumNeon(vaddq_f32(a0, a1));
+  *y1 = hsumNeon(vaddq_f32(b0, b1));
+}
+#endif
+
+using Dot2Fn = void (*)(const float *, const float *, const float *, size_t,
+                        float *, float *);
+
+Dot2Fn dot2Kernel() {
+  static const KernelTable<Dot2Fn> table = []() {
+    KernelTable<Dot2Fn> t(dot2Scalar);
+#if FM_TUNER_SIMD_AVX2
+    t.set(KernelIsa::Avx2, dot2Avx2);
+#endif
+#if FM_TUNER_SIMD_AVX512
+    t.set(KernelIsa::Avx512, dot2Avx512);
+#endif
+#if FM_TUNER_SIMD_NEON
+    t.set(KernelIsa::Neon, dot2Neon);
+#endif
+    return t;
+  }();
+  return table.select(KernelId::Resampler);
+}
+
+} // namespace
+
+void PolyphaseResampler::init(std::uint32_t inputRate,
+                              std::uint32_t outputRate,
+                              std::uint32_t halfLength, float cutoff,
+                              float stopBandAtten) {
+  if (inputRate == 0 || outputRate == 0) {
+    throw std::runtime_error("resampler rates must be > 0");
+  }
+  const std::uint32_t g = std::gcd(inputRate, outputRate);
+  const std::uint32_t interp = outputRate / g;
+  const std::uint32_t decim = inputRate / g;
+  if (interp > kMaxInterpolation) {
+    throw std::runtime_error("resampler ratio " + std::to_string(outputRate) +
+                             "/" + std::to_string(inputRate) +
+                             " needs too many polyphase branches");
+  }
+  m_interp = interp;
+  m_decim = decim;
+
+  if (interp == 1 && decim == 1) {
+    m_kind = Kind::Passthrough;
+    m_branchTaps = 0;
+    m_prototypeLength = 0;
+    m_branches.clear();
+    reset();
+    return;
+  }
+  if (interp == 3 && decim == 16) {
+    m_kind = Kind::Ratio3Over16;
+  } else if (interp == 3 && decim == 8) {
+    m_kind = Kind::Ratio3Over8;
+  } else if (interp == 3 && decim == 4) {
+    m_kind = Kind::Ratio3Over4;
+  } else {
+    m_kind = Kind::Generic;
+  }
+
+  const float ratio = static_cast<float>(interp) / static_cast<float>(decim);
+  const float fc = (cutoff > 0.0f) ? std::min(cutoff, 0.49f)
+                                   : 0.47f * std::min(1.0f, ratio);
+  const size_t taps =
+      2 * static_cast<size_t>(std::max<std::uint32_t>(1, halfLength));
+  m_prototypeLength = taps * interp;
+  std::vector<float> prototype;
+  liquid::designLowpassTaps(static_cast<std::uint32_t>(m_prototypeLength),
+                            fc / static_cast<float>(interp), stopBandAtten,
+                            false, prototype);
+  // Unity passband gain per branch: the prototype sums to L.
+  double sum = 0.0;
+  for (float tap : prototype) {
+    sum += tap;
+  }
+  const float scale =
+      (std::abs(sum) > 1e-12) ? static_cast<float>(interp / sum) : 1.0f;
+
+  m_branchTaps = ((taps + kDotTapBlock - 1) / kDotTapBlock) * kDotTapBlock;
+  m_branches.assign(static_cast<size_t>(interp) * m_branchTaps, 0.0f);
+  for (std::uint32_t p = 0; p < interp; p++) {
+    float *branch = m_branches.data() + static_cast<size_t>(p) * m_branchTaps;
+    for (size_t k = 0; k < taps; k++) {
+      branch[m_branchTaps - 1 - k] = prototype[p + k * interp] * scale;
+    }
+  }
+  reset();
+}
+
+void PolyphaseResampler::reset() {
+  m_history.assign(m_branchTaps > 0 ? m_branchTaps - 1 : 0, 0.0f);
+  m_historyRight = m_history;
+  m_rightFollowsLeft = false;
+  m_nextTime = 0;
+}
+
+size_t PolyphaseResampler::maxOutput(size_t inSamples) const {
+  if (m_kind == Kind::Passthrough) {
+    return inSamples;
+  }
+  return (inSamples * m_interp + m_decim - 1) / m_decim + 1;
+}
+
+double PolyphaseResampler::groupDelayInputSamples() const {
+  if (m_kind == Kind::Passthrough || m_interp == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(m_prototypeLength - 1) /
+         (2.0 * static_cast<double>(m_interp));
+}
+
+void PolyphaseResampler::appendHistory(std::vector<float> &history,
+                                       size_t keep, const float *in,
+                                       size_t inSamples) {
+  history.resize(keep + inSamples);
+  std::memcpy(history.data() + keep, in, inSamples * sizeof(float));
+}
+
+void PolyphaseResampler::trimHistory(std::vector<float> &history, size_t keep,
+                                     size_t inSamples) {
+  if (keep > 0) {
+    std::memmove(history.data(), history.data() + inSamples,
+                 keep * sizeof(float));
+  }
+  history.resize(keep);
+}
+
+template <std::uint32_t L, std::uint32_t M, typename Emit>
+size_t PolyphaseResampler::walk(size_t inSamples, Emit &&emit) {
+  // L == 0: ratio known only at run time.
+  const std::uint64_t interp = (L != 0) ? L : m_interp;
+  const std::uint64_t decim = (M != 0) ? M : m_decim;
+  const std::uint64_t end = static_cast<std::uint64_t>(inSamples) * interp;
+  std::uint64_t t = m_nextTime;
+  size_t produced = 0;
+  while (t < end) {
+    const std::uint64_t i = t / interp;
+    const std::uint64_t p = t - i * interp;
+    emit(m_branches.data() + p * m_branchTaps, static_cast<size_t>(i),
+         produced++);
+    t += decim;
+  }
+  m_nextTime = t - end;
+  return produced;
+}
+
+template <typename Emit>
+size_t PolyphaseResampler::dispatchWalk(size_t inSamples, Emit &&emit) {
+  switch (m_kind) {
+  case Kind::Ratio3Over16:
+    return walk<3, 16>(inSamples, emit);
+  case Kind::Ratio3Over8:
+    return walk<3, 8>(inSamples, emit);
+  case Kind::Ratio3Over4:
+    return walk<3, 4>(inSamples, emit);
+  case Kind::Passthrough:
+  case Kind::Generic:
+    break;
+  }
+  return walk<0, 0>(inSamples, emit);
+}
+
+size_t PolyphaseResampler::execute(const float *in, size_t inSamples,
+                                   float *out) {
+  if (!in || !out || inSamples == 0 || m_interp == 0) {
+    return 0;
+  }
+  if (m_kind == Kind::Passthrough) {
+    std::memcpy(out, in, inSamples * sizeof(float));
+    return inSamples;
+  }
+  const size_t keep = m_branchTaps - 1;
+  appendHistory(m_history, keep, in, inSamples);
+  const DotFn dot = dotKernels().select(KernelId::Resampler);
+  const float *history = m_history.data();
+  const size_t taps = m_branchTaps;
+  const size_t produced = dispatchWalk(
+      inSamples, [&](const float *branch, size_t i, size_t n) {
+        out[n] = dot(branch, history + i, taps);
+      });
+  trimHistory(m_history, keep, inSamples);
+  return produced;
+}
+
+size_t PolyphaseResampler::executeMonoToStereo(const float *in,
+                                               size_t inSamples,
+                                               float *outFrames) {
+  if (!in || !outFrames || inSamples == 0 || m_interp == 0) {
+    return 0;
+  }
+  m_rightFollowsLeft = true;
+  if (m_kind == Kind::Passthrough) {
+    for (size_t n = 0; n < inSamples; n++) {
+      outFrames[2 * n] = in[n];
+      outFrames[2 * n + 1] = in[n];
+    }
+    return inSamples;
+  }
+  const size_t keep = m_branchTaps - 1;
+  appendHistory(m_history, keep, in, inSamples);
+  const DotFn dot = dotKernels().select(KernelId::Resampler);
+  const float *history = m_history.data();
+  const size_t taps = m_branchTaps;
+  const size_t produced = dispatchWalk(
+      inSamples, [&](const float *branch, size_t i, size_t n) {
+        const float y = dot(branch, history + i, taps);
+        outFrames[2 * n] = y;
+        outFrames[2 * n + 1] = y;
+      });
+  trimHistory(m_history, keep, inSamples);
+  return produced;
+}
+
+size_t PolyphaseResampler::executeStereo(const float *inLeft,
+                                         const float *inRight,
+                                         size_t inSamples, float *outFrames) {
+  if (!inLeft || !inRight || !outFrames || inSamples == 0 || m_interp == 0) {
+    return 0;
+  }
+  if (m_kind == Kind::Passthrough) {
+    for (size_t n = 0; n < inSamples; n++) {
+      outFrames[2 * n] = inLeft[n];
+      outFrames[2 * n + 1] = inRight[n];
+    }
+    return inSamples;
+  }
+  const size_t keep = m_branchTaps - 1;
+  if (m_rightFollowsLeft) {
+    m_historyRight = m_history;
+    m_rightFollowsLeft = false;
+  }
+  appendHistory(m_history, keep, inLeft, inSamples);
+  appendHistory(m_historyRight, keep, inRight, inSamples);
+  const Dot2Fn dot2 = dot2Kernel();
+  const float *left = m_history.data();
+  const float *right = m_historyRight.data();
+  const size_t taps = m_branchTaps;
+  const size_t produced = dispatchWalk(
+      inSamples, [&](const float *branch, size_t i, size_t n) {
+        dot2(branch, left + i, right + i, taps, outFrames + 2 * n,
+             outFrames + 2 * n + 1);
+      });
+  trimHistory(m_history, keep, inSamples);
+  trimHistory(m_historyRight, keep, inSamples);
+  return produced;
+}
+
+} // namespace fm_tuner::dsp
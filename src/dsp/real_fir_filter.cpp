@@ -0,0 +1,49 @@
+#include "dsp/real_fir_filter.h"
+
+#include "dsp/simd_dot.h"
+
+#include <cstring>
+
+namespace fm_tuner::dsp {
+
+void RealFirFilter::setTaps(const std::vector<float> &taps, float scale) {
+  m_length = taps.size();
+  const size_t padded =
+      ((m_length + kDotTapBlock - 1) / kDotTapBlock) * kDotTapBlock;
+  m_taps.assign(padded, 0.0f);
+  for (size_t k = 0; k < m_length; k++) {
+    m_taps[padded - 1 - k] = taps[k] * scale;
+  }
+  reset();
+}
+
+void RealFirFilter::reset() {
+  m_history.assign(m_taps.empty() ? 0 : m_taps.size() - 1, 0.0f);
+}
+
+void RealFirFilter::executeBlock(const float *in, size_t samples, float *out) {
+  if (!in || !out || samples == 0) {
+    return;
+  }
+  if (m_taps.empty()) {
+    if (out != in) {
+      std::memmove(out, in, samples * sizeof(float));
+    }
+    return;
+  }
+  const size_t keep = m_taps.size() - 1;
+  m_history.resize(keep + samples);
+  std::memcpy(m_history.data() + keep, in, samples * sizeof(float));
+  const DotFn dot = dotKernels().select(KernelId::RealFir);
+  const float *taps = m_taps.data();
+  const float *history = m_history.data();
+  const size_t count = m_taps.size();
+  for (size_t i = 0; i < samples; i++) {
+    out[i] = dot(taps, history + i, count);
+  }
+  std::memmove(m_history.data(), m_history.data() + samples,
+               keep * sizeof(float));
+  m_history.resize(keep);
+}
+
+} // namespace fm_tuner::dsp
@@ -0,0 +1,95 @@
+#include "dsp/simd_dot.h"
+
+namespace fm_tuner::dsp {
+
+namespace {
+
+float dotScalar(const float *taps, const float *x, size_t count) {
+  float acc0 = 0.0f;
+  float acc1 = 0.0f;
+  for (size_t k = 0; k < count; k += 2) {
+    acc0 += taps[k] * x[k];
+    acc1 += taps[k + 1] * x[k + 1];
+  }
+  return acc0 + acc1;
+}
+
+#if FM_TUNER_SIMD_AVX2
+FM_TUNER_AVX2_TARGET float dotAvx2(const float *taps, const float *x,
+                                   size_t count) {
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  size_t k = 0;
+  for (; k + 2 * kDotTapBlock <= count; k += 2 * kDotTapBlock) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(taps + k), _mm256_loadu_ps(x + k),
+                           acc0);
+    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(taps + k + 8),
+                           _mm256_loadu_ps(x + k + 8), acc1);
+  }
+  if (k < count) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(taps + k), _mm256_loadu_ps(x + k),
+                           acc0);
+  }
+  return hsumAvx2(_mm256_add_ps(acc0, acc1));
+}
+#endif
+
+#if FM_TUNER_SIMD_AVX512
+// count is a multiple of kDotTapBlock: whole zmm steps, then at most one
+// half-width step through a masked load.
+FM_TUNER_AVX512_TARGET float dotAvx512(const float *taps, const float *x,
+                                       size_t count) {
+  __m512 acc0 = _mm512_setzero_ps();
+  __m512 acc1 = _mm512_setzero_ps();
+  size_t k = 0;
+  for (; k + 4 * kDotTapBlock <= count; k += 4 * kDotTapBlock) {
+    acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(taps + k), _mm512_loadu_ps(x + k),
+                           acc0);
+    acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(taps + k + 16),
+                           _mm512_loadu_ps(x + k + 16), acc1);
+  }
+  if (k + 2 * kDotTapBlock <= count) {
+    acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(taps + k), _mm512_loadu_ps(x + k),
+                           acc0);
+    k += 2 * kDotTapBlock;
+  }
+  if (k < count) {
+    acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(kHalfTail, taps + k),
+                           _mm512_maskz_loadu_ps(kHalfTail, x + k), acc1);
+  }
+  return hsumAvx512(_mm512_add_ps(acc0, acc1));
+}
+#endif
+
+#if FM_TUNER_SIMD_NEON
+float dotNeon(const float *taps, const float *x, size_t count) {
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (size_t k = 0; k < count; k += kDotTapBlock) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(taps + k), vld1q_f32(x + k));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(taps + k + 4), vld1q_f32(x + k + 4));
+  }
+  return hsumNeon(vaddq_f32(acc0, acc1));
+}
+#endif
+
+} // namespace
+
+const KernelTable<DotFn> &dotKernels() {
+  static const KernelTable<DotFn> table = []() {
+    KernelTable<DotFn> t(dotScalar);
+#if FM_TUNER_SIMD_AVX2
+    t.set(KernelIsa::Avx2, dotAvx2);
+#endif
+#if FM_TUNER_SIMD_AVX512
+    t.set(KernelIsa::Avx512, dotAvx512);
+#endif
+#if FM_TUNER_SIMD_NEON
+    t.set(KernelIsa::Neon, dotNeon);
+#endif
+    return t;
+  }();
+  return table;
+}
+
+} // namespace fm_tuner::dsp
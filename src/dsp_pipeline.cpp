@@ -4,12 +4,32 @@
 #include <cctype>
 #include <cmath>
 #include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 
 namespace {
 
 constexpr size_t kIqStagingBlocks = 4;
 
+// The half-rate MPX has to keep the RDS subcarrier (57 kHz +/- 2.4 kHz) clear
+// of the half-band transition, which needs at least ~128 kHz out.
+constexpr int kMinHalfRateMpx = 128000;
+// Half-band passband edge: the top of the RDS band.
+constexpr float kHalfRateMpxPassbandHz = 59500.0f;
+// IQ front-end passband: +/-100 kHz covers a full FM channel.
+constexpr float kIqFrontEndPassbandHz = 100000.0f;
+// Verbose pipeline occupancy log interval.
+constexpr std::chrono::seconds kPipelineStatsLogInterval{10};
+
+int stereoRateFor(int inputRate, const Config::ProcessingSection &processing) {
+  if (processing.stereo && processing.half_rate_mpx &&
+      (inputRate % 2) == 0 && inputRate / 2 >= kMinHalfRateMpx) {
+    return inputRate / 2;
+  }
+  return inputRate;
+}
+
 } // namespace
 
 // Audio-output soft limiter: passthrough below |x| = kSoftLimitThreshold,
@@ -32,17 +52,18 @@ float DspPipeline::softLimitSample(float x, uint32_t &softCount) {
 DspPipeline::DspPipeline(int inputRate, int outputRate,
                          const Config::ProcessingSection &processing,
                          bool verboseLogging, size_t blockSamples,
-                         size_t iqDecimation)
+                         uint32_t iqSampleRate)
     : m_inputRate(std::max(1, inputRate)),
       m_outputRate(std::max(1, outputRate)),
       m_stereoEnabled(processing.stereo), m_verboseLogging(verboseLogging),
       m_blockSamples(std::max<size_t>(1, blockSamples)),
-      m_iqDecimation(std::max<size_t>(1, iqDecimation)),
-      m_demod(m_inputRate, m_outputRate), m_stereo(m_inputRate, m_outputRate),
-      m_afPost(m_inputRate, m_outputRate), m_iqDecimatedComplex(m_blockSamples),
-      m_demodBuffer(m_blockSamples, 0.0f), m_stereoLeft(m_blockSamples, 0.0f),
-      m_stereoRight(m_blockSamples, 0.0f), m_audioLeft(m_blockSamples, 0.0f),
-      m_audioRight(m_blockSamples, 0.0f) {
+      m_iqSampleRate(iqSampleRate == 0 ? static_cast<uint32_t>(m_inputRate)
+                                       : iqSampleRate),
+      m_sdrBlockSamples(m_blockSamples),
+      m_stereoRate(stereoRateFor(m_inputRate, processing)),
+      m_demod(m_inputRate, m_outputRate), m_stereo(m_stereoRate, m_outputRate),
+      m_afPost(m_stereoRate, m_outputRate), m_stereoLeft(m_blockSamples, 0.0f),
+      m_stereoRight(m_blockSamples, 0.0f) {
   m_demod.setW0BandwidthHz(processing.w0_bandwidth_hz);
 
   std::string dspAgc = processing.dsp_agc;
@@ -122,36 +143,155 @@ DspPipeline::DspPipeline(int inputRate, int outputRate,
   } else {
     m_squelch.configure(static_cast<float>(processing.squelch_dbfs), 3.0f,
                         0.030f, m_outputRate);
+    // Fade-mute closes on short dropouts, where idling would only cost the
+    // stereo pilot lock and RDS sync; the threshold squelch closes on empty
+    // channels, for as long as they stay empty.
+    m_squelchIdleEnabled = processing.squelch_idle;
   }
 
-  const uint32_t decimFactor = static_cast<uint32_t>(m_iqDecimation);
-  const uint32_t decimTapsPerPhase =
-      (decimFactor >= 8U) ? 28U : ((decimFactor >= 4U) ? 20U : 12U);
-  m_iqDecimator.init(decimFactor, decimTapsPerPhase, 80.0f);
-  if (m_iqDecimation > 1) {
+  // Telemetry meters: until the run loop reports a REST poller, only the
+  // consumers inside the pipeline (fade-mute, signal-meter SNR cap) count.
+  std::string metering = processing.metering;
+  std::transform(
+      metering.begin(), metering.end(), metering.begin(),
+      [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  m_meteringAlways = (metering == "always");
+  setRestTelemetryActive(false);
+
+  if (m_stereoRate != m_inputRate) {
+    m_mpxDecimator.init(kHalfRateMpxPassbandHz /
+                        static_cast<float>(m_inputRate));
+    m_mpxHalf.assign(fm_tuner::dsp::HalfBandDecimator::maxOutput(m_blockSamples),
+                     0.0f);
+    m_mpxHiss.assign(m_mpxHalf.size(), 0.0f);
+  }
+
+  if (m_iqSampleRate != static_cast<uint32_t>(m_inputRate)) {
+    m_iqConverter.init(m_iqSampleRate, static_cast<uint32_t>(m_inputRate),
+                       kIqFrontEndPassbandHz, 80.0f);
+    m_sdrBlockSamples = m_iqConverter.inputBlockFor(m_blockSamples);
     const size_t stagingBytes = sdrBlockSamples() * 2 * kIqStagingBlocks;
     m_iqStagingRing.assign(stagingBytes, 0);
     m_iqLinearizedBlock.assign(sdrBlockSamples() * 2, 0);
   }
+
+  const int stages = std::clamp(processing.dsp_pipeline_stages, 1, 3);
+  // Pipelined: a block in flight per worker stage, the one being submitted
+  // and the one the caller's last Result points into.
+  m_blocks.resize(stages == 1 ? 1 : static_cast<size_t>(stages) + 2);
+  for (Block &block : m_blocks) {
+    if (m_iqConverter.ready()) {
+      block.decimated.assign(m_blockSamples, std::complex<float>(0.0f, 0.0f));
+    }
+    block.mpx.assign(m_blockSamples, 0.0f);
+    if (!m_stereoEnabled) {
+      block.mono.assign(m_blockSamples, 0.0f);
+    }
+    block.frames.assign(2 * m_blockSamples, 0.0f);
+    if (stages > 1) {
+      block.iqU8.assign(sdrBlockSamples() * 2, 0);
+    }
+  }
+  publishAudioState();
+
+  if (stages > 1) {
+    if (stages == 2) {
+      auto stage = std::make_unique<Stage>();
+      stage->name = "dsp";
+      stage->front = true;
+      stage->back = true;
+      m_stages.push_back(std::move(stage));
+    } else {
+      auto front = std::make_unique<Stage>();
+      front->name = "demod";
+      front->front = true;
+      m_stages.push_back(std::move(front));
+      auto back = std::make_unique<Stage>();
+      back->name = "audio";
+      back->back = true;
+      m_stages.push_back(std::move(back));
+    }
+    m_done.reset(m_blocks.size());
+    for (size_t i = 0; i < m_stages.size(); i++) {
+      m_stages[i]->input.reset(m_blocks.size());
+      m_stages[i]->output =
+          (i + 1 < m_stages.size()) ? &m_stages[i + 1]->input : &m_done;
+    }
+    for (size_t i = m_blocks.size(); i > 0; i--) {
+      m_freeSlots.push_back(i - 1);
+    }
+    m_statsStart = std::chrono::steady_clock::now();
+    for (auto &stage : m_stages) {
+      stage->thread = std::thread(&DspPipeline::runStage, this,
+                                  std::ref(*stage));
+    }
+  }
+}
+
+DspPipeline::~DspPipeline() {
+  for (auto &stage : m_stages) {
+    stage->input.close();
+  }
+  for (auto &stage : m_stages) {
+    if (stage->thread.joinable()) {
+      stage->thread.join();
+    }
+  }
+}
+
+std::string DspPipeline::iqFrontEndSummary() const {
+  if (!m_iqConverter.ready()) {
+    return std::to_string(m_iqSampleRate) + " (direct)";
+  }
+  return m_iqConverter.summary();
+}
+
+void DspPipeline::setRestTelemetryActive(bool active) {
+  drainPipeline();
+  using Mode = fm_tuner::dsp::MeteringScheduler::Mode;
+  if (m_meteringAlways) {
+    m_stereo.setMetering(Mode::Always, Mode::Always);
+    return;
+  }
+  // RDS deviation is only ever shown by /api/status. The hiss SNR also gates
+  // fade-mute, which wants every block, and caps the signal meter, which
+  // can live with a ~0.1 s refresh.
+  m_stereo.setMetering(active ? Mode::DutyCycled : Mode::Off,
+                       m_squelch.adaptiveEnabled() ? Mode::Always
+                                                   : Mode::DutyCycled);
 }
 
 void DspPipeline::reset() {
+  // Blocks still in flight belong to the stream being reset: let them
+  // finish, then drop them.
+  drainPipeline();
+  size_t slot = 0;
+  while (m_inFlight > 0 && m_done.tryPop(slot)) {
+    m_freeSlots.push_back(slot);
+    --m_inFlight;
+  }
+
   m_demod.reset();
   m_stereo.reset();
   m_afPost.reset();
-  m_iqDecimator.reset();
+  m_mpxDecimator.reset();
+  m_iqConverter.reset();
   m_squelch.reset();
+  m_idle = false;
   clearIqStaging();
   clearIqStagingC();
   m_pendingAudioReset = false;
+  publishAudioState();
 }
 
 void DspPipeline::setBandwidthHz(int bandwidthHz) {
+  drainPipeline();
+  // Crossfaded inside the demod; the stereo and audio chains run on.
   m_demod.setBandwidthHz(bandwidthHz);
-  m_pendingAudioReset = true;
 }
 
 void DspPipeline::setDeemphasisMode(int deemphasisMode) {
+  drainPipeline();
   if (deemphasisMode == 0) {
     m_afPost.setDeemphasis(50);
     m_demod.setDeemphasis(50);
@@ -163,9 +303,18 @@ void DspPipeline::setDeemphasisMode(int deemphasisMode) {
     m_demod.setDeemphasis(0);
   }
   m_pendingAudioReset = true;
+  publishAudioState();
 }
 
-void DspPipeline::setForceMono(bool forceMono) { m_stereo.setForceMono(forceMono); }
+void DspPipeline::setForceMono(bool forceMono) {
+  drainPipeline();
+  m_stereo.setForceMono(forceMono);
+}
+
+void DspPipeline::setBlendMode(StereoDecoder::BlendMode mode) {
+  drainPipeline();
+  m_stereo.setBlendMode(mode);
+}
 
 void DspPipeline::clearIqStaging() {
   m_iqStagingReadPos = 0;
@@ -290,141 +439,400 @@ bool DspPipeline::linearizeDecimatorBlockC(size_t sampleCount) {
   return true;
 }
 
+
+const uint8_t *DspPipeline::nextSourceBlock(const uint8_t *iq, size_t samples,
+                                            size_t &blockSamples) {
+  blockSamples = samples;
+  if (!m_iqConverter.ready()) {
+    return iq;
+  }
+  blockSamples = sdrBlockSamples();
+  if (m_iqStagingSize == 0 && samples >= sdrBlockSamples()) {
+    // A whole block arrived in one span (the usual case when the caller
+    // leases source ring memory): decimate it in place and only stage the
+    // tail, skipping the staging-ring and linearize copies.
+    appendIqToStaging(iq + sdrBlockSamples() * 2, samples - sdrBlockSamples());
+    return iq;
+  }
+  appendIqToStaging(iq, samples);
+  if (!linearizeDecimatorBlock(sdrBlockSamples())) {
+    return nullptr;
+  }
+  return m_iqLinearizedBlock.data();
+}
+
+const std::complex<float> *
+DspPipeline::nextSourceBlock(const std::complex<float> *iq, size_t samples,
+                             size_t &blockSamples) {
+  blockSamples = samples;
+  if (!m_iqConverter.ready()) {
+    return iq;
+  }
+  blockSamples = sdrBlockSamples();
+  if (m_iqStagingRingC.empty()) {
+    m_iqStagingRingC.assign(sdrBlockSamples() * kIqStagingBlocks,
+                            std::complex<float>(0.0f, 0.0f));
+    m_iqLinearizedBlockC.assign(sdrBlockSamples(),
+                                std::complex<float>(0.0f, 0.0f));
+  }
+  if (m_iqStagingSizeC == 0 && samples >= sdrBlockSamples()) {
+    appendIqToStagingC(iq + sdrBlockSamples(), samples - sdrBlockSamples());
+    return iq;
+  }
+  appendIqToStagingC(iq, samples);
+  if (!linearizeDecimatorBlockC(sdrBlockSamples())) {
+    return nullptr;
+  }
+  return m_iqLinearizedBlockC.data();
+}
+
 bool DspPipeline::process(
     const uint8_t *iq, size_t samples,
-    const std::function<void(const float *, size_t)> &rdsSink, Result &out) {
+    const std::function<void(const float *, size_t)> &rdsSink, Result &out,
+    std::chrono::steady_clock::time_point arrival,
+    const SignalLevelResult &signal) {
   out = Result{};
   if (!iq || samples == 0) {
     return false;
   }
-
-  if (m_pendingAudioReset) {
-    m_stereo.reset();
-    m_afPost.reset();
-    m_pendingAudioReset = false;
+  size_t blockSamples = 0;
+  const uint8_t *block = nextSourceBlock(iq, samples, blockSamples);
+  if (block == nullptr) {
+    return false;
   }
+  if (arrival == std::chrono::steady_clock::time_point{}) {
+    arrival = std::chrono::steady_clock::now();
+  }
+  return runBlock(block, nullptr, blockSamples, arrival, signal, rdsSink,
+                  out);
+}
 
-  // Only let the multipath equalizer adapt when we have a strong, locked
-  // signal. CMA on a noisy or absent signal will wander to a wrong solution.
-  m_demod.setMultipathAdaptEnabled(m_stereo.isStereo());
-
-  const uint8_t *iqForDemod = iq;
-  const std::complex<float> *iqForDemodComplex = nullptr;
-  size_t demodSamples = samples;
-
-  if (m_iqDecimation > 1) {
-    appendIqToStaging(iq, samples);
-
-    if (m_iqStagingSize < (sdrBlockSamples() * 2)) {
-      return false;
-    }
-    if (!linearizeDecimatorBlock(sdrBlockSamples())) {
-      return false;
-    }
+bool DspPipeline::process(
+    const std::complex<float> *iq, size_t samples,
+    const std::function<void(const float *, size_t)> &rdsSink, Result &out,
+    std::chrono::steady_clock::time_point arrival,
+    const SignalLevelResult &signal) {
+  out = Result{};
+  if (!iq || samples == 0) {
+    return false;
+  }
+  size_t blockSamples = 0;
+  const std::complex<float> *block = nextSourceBlock(iq, samples, blockSamples);
+  if (block == nullptr) {
+    return false;
+  }
+  if (arrival == std::chrono::steady_clock::time_point{}) {
+    arrival = std::chrono::steady_clock::now();
+  }
+  return runBlock(nullptr, block, blockSamples, arrival, signal, rdsSink,
+                  out);
+}
 
-    demodSamples = m_iqDecimator.executeComplex(
-        m_iqLinearizedBlock.data(), sdrBlockSamples(),
-        m_iqDecimatedComplex.data(),
-        m_blockSamples);
-    iqForDemodComplex = m_iqDecimatedComplex.data();
+bool DspPipeline::runBlock(
+    const uint8_t *iqU8, const std::complex<float> *iqComplex, size_t samples,
+    std::chrono::steady_clock::time_point arrival,
+    const SignalLevelResult &signal,
+    const std::function<void(const float *, size_t)> &rdsSink, Result &out) {
+  if (!m_stages.empty()) {
+    return runPipelined(iqU8, iqComplex, samples, arrival, signal, rdsSink,
+                        out);
+  }
+  Block &block = m_blocks.front();
+  block.sourceU8 = iqU8;
+  block.sourceComplex = iqComplex;
+  block.sourceSamples = samples;
+  if (!runFront(block)) {
+    return false;
+  }
+  if (block.demodulated && rdsSink) {
+    rdsSink(block.mpx.data(), block.demodSamples);
+  }
+  runBack(block);
+  out = block.result;
+  out.arrival = arrival;
+  out.signal = signal;
+  return true;
+}
 
-    if (demodSamples == 0) {
-      return false;
+bool DspPipeline::runPipelined(
+    const uint8_t *iqU8, const std::complex<float> *iqComplex, size_t samples,
+    std::chrono::steady_clock::time_point arrival,
+    const SignalLevelResult &signal,
+    const std::function<void(const float *, size_t)> &rdsSink, Result &out) {
+  releaseHeldSlot();
+  const size_t slot = m_freeSlots.back();
+  m_freeSlots.pop_back();
+  Block &block = m_blocks[slot];
+  // The caller reuses its buffer (and the staging ring moves on) as soon as
+  // this returns, so the block travels with its own copy.
+  const size_t count = std::min(samples, sdrBlockSamples());
+  if (iqComplex != nullptr) {
+    if (block.iqComplex.empty()) {
+      block.iqComplex.assign(sdrBlockSamples(),
+                             std::complex<float>(0.0f, 0.0f));
     }
+    std::memcpy(block.iqComplex.data(), iqComplex,
+                count * sizeof(std::complex<float>));
+    block.sourceU8 = nullptr;
+    block.sourceComplex = block.iqComplex.data();
   } else {
-    iqForDemod = iq;
+    std::memcpy(block.iqU8.data(), iqU8, count * 2);
+    block.sourceU8 = block.iqU8.data();
+    block.sourceComplex = nullptr;
   }
-
-  return runDemodChain(iqForDemod, iqForDemodComplex, demodSamples, rdsSink,
-                       out);
+  block.sourceSamples = count;
+  block.arrival = arrival;
+  block.signal = signal;
+  m_stages.front()->input.push(slot);
+  ++m_inFlight;
+
+  // One block stays in flight per worker stage; past that, collect the
+  // oldest. This bounds the added latency to one block per stage.
+  if (m_inFlight <= m_stages.size()) {
+    return false;
+  }
+  return collectOldest(rdsSink, out);
 }
 
-bool DspPipeline::process(
-    const std::complex<float> *iq, size_t samples,
+bool DspPipeline::flush(
     const std::function<void(const float *, size_t)> &rdsSink, Result &out) {
   out = Result{};
-  if (!iq || samples == 0) {
-    return false;
+  releaseHeldSlot();
+  // A block the front stage produced nothing for has no result; move on to
+  // the next one.
+  while (m_inFlight > 0) {
+    if (collectOldest(rdsSink, out)) {
+      return true;
+    }
+    releaseHeldSlot();
   }
+  return false;
+}
 
-  if (m_pendingAudioReset) {
-    m_stereo.reset();
-    m_afPost.reset();
-    m_pendingAudioReset = false;
+void DspPipeline::releaseHeldSlot() {
+  if (m_heldSlot != kNoSlot) {
+    m_freeSlots.push_back(m_heldSlot);
+    m_heldSlot = kNoSlot;
   }
+}
 
-  m_demod.setMultipathAdaptEnabled(m_stereo.isStereo());
+bool DspPipeline::collectOldest(
+    const std::function<void(const float *, size_t)> &rdsSink, Result &out) {
+  const auto waitStart = std::chrono::steady_clock::now();
+  size_t done = 0;
+  if (!m_done.pop(done)) {
+    return false;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  m_waitNs += static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - waitStart)
+          .count());
+  --m_inFlight;
+  m_heldSlot = done;
+  if (m_verboseLogging && now - m_statsStart >= kPipelineStatsLogInterval) {
+    logPipelineStats();
+  }
 
-  const std::complex<float> *iqForDemodComplex = iq;
-  size_t demodSamples = samples;
+  const Block &finished = m_blocks[done];
+  if (!finished.ok) {
+    return false;
+  }
+  if (finished.demodulated && rdsSink) {
+    rdsSink(finished.mpx.data(), finished.demodSamples);
+  }
+  out = finished.result;
+  out.arrival = finished.arrival;
+  out.signal = finished.signal;
+  return true;
+}
 
-  if (m_iqDecimation > 1) {
-    if (m_iqStagingRingC.empty()) {
-      m_iqStagingRingC.assign(sdrBlockSamples() * kIqStagingBlocks,
-                              std::complex<float>(0.0f, 0.0f));
-      m_iqLinearizedBlockC.assign(sdrBlockSamples(),
-                                  std::complex<float>(0.0f, 0.0f));
+void DspPipeline::runStage(Stage &stage) {
+  size_t slot = 0;
+  while (stage.input.pop(slot)) {
+    const size_t queued = stage.input.size();
+    const auto start = std::chrono::steady_clock::now();
+    Block &block = m_blocks[slot];
+    if (stage.front) {
+      block.ok = runFront(block);
     }
-    appendIqToStagingC(iq, samples);
-    if (m_iqStagingSizeC < sdrBlockSamples()) {
-      return false;
+    if (stage.back && block.ok) {
+      runBack(block);
     }
-    if (!linearizeDecimatorBlockC(sdrBlockSamples())) {
-      return false;
+    const auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    stage.busyNs.fetch_add(static_cast<uint64_t>(busy.count()),
+                           std::memory_order_relaxed);
+    stage.blocks.fetch_add(1, std::memory_order_relaxed);
+    stage.queuedSum.fetch_add(queued, std::memory_order_relaxed);
+    if (queued > stage.queuedMax.load(std::memory_order_relaxed)) {
+      stage.queuedMax.store(queued, std::memory_order_relaxed);
     }
-    demodSamples = m_iqDecimator.executeComplexFromComplex(
-        m_iqLinearizedBlockC.data(), sdrBlockSamples(),
-        m_iqDecimatedComplex.data(), m_blockSamples);
-    iqForDemodComplex = m_iqDecimatedComplex.data();
+    stage.output->push(slot);
+  }
+}
+
+void DspPipeline::drainPipeline() {
+  if (m_inFlight == 0) {
+    return;
+  }
+  const auto waitStart = std::chrono::steady_clock::now();
+  m_done.waitForSize(m_inFlight);
+  m_waitNs += static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - waitStart)
+          .count());
+}
+
+DspPipeline::PipelineStats DspPipeline::takePipelineStats() {
+  PipelineStats stats;
+  const auto now = std::chrono::steady_clock::now();
+  stats.seconds = std::chrono::duration<double>(now - m_statsStart).count();
+  m_statsStart = now;
+  const double windowNs = std::max(1.0, stats.seconds * 1e9);
+  for (auto &stage : m_stages) {
+    StageStats entry;
+    entry.name = stage->name;
+    entry.blocks = stage->blocks.exchange(0, std::memory_order_relaxed);
+    entry.busyRatio =
+        static_cast<double>(
+            stage->busyNs.exchange(0, std::memory_order_relaxed)) /
+        windowNs;
+    const uint64_t queued =
+        stage->queuedSum.exchange(0, std::memory_order_relaxed);
+    entry.meanQueueDepth =
+        (entry.blocks > 0)
+            ? static_cast<double>(queued) / static_cast<double>(entry.blocks)
+            : 0.0;
+    entry.maxQueueDepth =
+        stage->queuedMax.exchange(0, std::memory_order_relaxed);
+    stats.stages.push_back(entry);
+  }
+  stats.waitRatio = static_cast<double>(m_waitNs) / windowNs;
+  m_waitNs = 0;
+  return stats;
+}
+
+void DspPipeline::logPipelineStats() {
+  const PipelineStats stats = takePipelineStats();
+  std::ostringstream oss;
+  oss << "[DSP] pipeline" << std::fixed;
+  for (const StageStats &stage : stats.stages) {
+    oss << " " << stage.name << " busy=" << std::setprecision(1)
+        << stage.busyRatio * 100.0 << "% queue=" << std::setprecision(2)
+        << stage.meanQueueDepth << "/" << stage.maxQueueDepth;
+  }
+  oss << " wait=" << std::setprecision(1) << stats.waitRatio * 100.0
+      << "%\n";
+  std::cout << oss.str();
+}
+
+bool DspPipeline::runFront(Block &block) {
+  block.demodulated = false;
+  const uint8_t *iqForDemod = block.sourceU8;
+  const std::complex<float> *iqForDemodComplex = block.sourceComplex;
+  size_t demodSamples = block.sourceSamples;
+
+  if (m_iqConverter.ready()) {
+    demodSamples =
+        (iqForDemodComplex != nullptr)
+            ? m_iqConverter.execute(iqForDemodComplex, demodSamples,
+                                    block.decimated.data(), m_blockSamples)
+            : m_iqConverter.execute(iqForDemod, demodSamples,
+                                    block.decimated.data(), m_blockSamples);
+    iqForDemod = nullptr;
+    iqForDemodComplex = block.decimated.data();
     if (demodSamples == 0) {
       return false;
     }
   }
+  block.demodSamples = demodSamples;
+
+  // Only let the multipath equalizer adapt when we have a strong, locked
+  // signal. CMA on a noisy or absent signal will wander to a wrong solution.
+  m_demod.setMultipathAdaptEnabled(
+      m_stereoLocked.load(std::memory_order_relaxed));
 
-  return runDemodChain(nullptr, iqForDemodComplex, demodSamples, rdsSink, out);
+  float *mono = m_stereoEnabled ? nullptr : block.mono.data();
+  if (m_squelchIdleEnabled && m_audioSilent.load(std::memory_order_relaxed)) {
+    if (iqForDemodComplex != nullptr) {
+      m_demod.measureChannelComplex(iqForDemodComplex, demodSamples);
+    } else {
+      m_demod.measureChannel(iqForDemod, demodSamples);
+    }
+  } else {
+    block.monoSamples =
+        (iqForDemodComplex != nullptr)
+            ? m_demod.processSplitComplex(iqForDemodComplex, block.mpx.data(),
+                                          mono, demodSamples)
+            : m_demod.processSplit(iqForDemod, block.mpx.data(), mono,
+                                   demodSamples);
+    block.demodulated = true;
+  }
+  block.channelPowerDbfs = m_demod.getFilteredChannelPowerDbfs();
+  block.envelopeError = m_demod.getMultipathEnvelopeError();
+  return true;
 }
 
-bool DspPipeline::runDemodChain(
-    const uint8_t *iqForDemod, const std::complex<float> *iqForDemodComplex,
-    size_t demodSamples,
-    const std::function<void(const float *, size_t)> &rdsSink, Result &out) {
+void DspPipeline::runBack(Block &block) {
+  if (m_pendingAudioReset) {
+    m_stereo.reset();
+    m_afPost.reset();
+    m_pendingAudioReset = false;
+  }
+  if (!block.demodulated || (m_squelchIdleEnabled && m_squelch.isSilent())) {
+    runIdle(block);
+  } else {
+    runAudioChain(block);
+  }
+  publishAudioState();
+}
+
+void DspPipeline::publishAudioState() {
+  m_stereoLocked.store(!m_pendingAudioReset && m_stereo.isStereo(),
+                       std::memory_order_relaxed);
+  m_audioSilent.store(m_squelch.isSilent(), std::memory_order_relaxed);
+}
+
+void DspPipeline::runAudioChain(Block &block) {
+  const size_t demodSamples = block.demodSamples;
+  const float *mpx = block.mpx.data();
+  float *frames = block.frames.data();
+  Result &out = block.result;
+  out = Result{};
+
   size_t outSamples = 0;
   bool stereoDetected = false;
   int pilotTenthsKHz = 0;
 
   if (!m_stereoEnabled) {
-    outSamples =
-        (iqForDemodComplex != nullptr)
-            ? m_demod.processSplitComplex(iqForDemodComplex, m_demodBuffer.data(),
-                                          m_audioLeft.data(), demodSamples)
-            : m_demod.processSplit(iqForDemod, m_demodBuffer.data(),
-                                   m_audioLeft.data(), demodSamples);
-    if (rdsSink) {
-      rdsSink(m_demodBuffer.data(), demodSamples);
-    }
+    outSamples = block.monoSamples;
     for (size_t i = 0; i < outSamples; i++) {
-      const float mono = m_audioLeft[i] * 0.5f;
-      m_audioLeft[i] = mono;
-      m_audioRight[i] = mono;
+      const float mono = block.mono[i] * 0.5f;
+      frames[2 * i] = mono;
+      frames[2 * i + 1] = mono;
     }
   } else {
-    if (iqForDemodComplex != nullptr) {
-      m_demod.processSplitComplex(iqForDemodComplex, m_demodBuffer.data(),
-                                  nullptr, demodSamples);
+    size_t stereoSamples = 0;
+    if (m_mpxDecimator.ready()) {
+      const size_t halfSamples = m_mpxDecimator.execute(
+          mpx, demodSamples, m_mpxHalf.data(), m_mpxHiss.data());
+      stereoSamples = m_stereo.processAudio(m_mpxHalf.data(), m_stereoLeft.data(),
+                                            m_stereoRight.data(), halfSamples,
+                                            m_mpxHiss.data());
     } else {
-      m_demod.processSplit(iqForDemod, m_demodBuffer.data(), nullptr,
-                           demodSamples);
-    }
-    if (rdsSink) {
-      rdsSink(m_demodBuffer.data(), demodSamples);
+      stereoSamples = m_stereo.processAudio(mpx, m_stereoLeft.data(),
+                                            m_stereoRight.data(), demodSamples);
     }
-    const size_t stereoSamples =
-        m_stereo.processAudio(m_demodBuffer.data(), m_stereoLeft.data(),
-                              m_stereoRight.data(), demodSamples);
     m_afPost.setSignalQuality(m_stereo.getStereoQuality());
-    outSamples =
-        m_afPost.process(m_stereoLeft.data(), m_stereoRight.data(), stereoSamples,
-                         m_audioLeft.data(), m_audioRight.data(), m_blockSamples);
+    if (m_stereo.isMonoOutput()) {
+      // Mono fast path: left == right, so resample one channel.
+      outSamples = m_afPost.processMonoInterleaved(
+          m_stereoLeft.data(), stereoSamples, frames, m_blockSamples);
+    } else {
+      outSamples = m_afPost.processInterleaved(
+          m_stereoLeft.data(), m_stereoRight.data(), stereoSamples, frames,
+          m_blockSamples);
+    }
     stereoDetected = m_stereo.isStereo();
     pilotTenthsKHz = m_stereo.getPilotLevelTenthsKHz();
   }
@@ -433,18 +841,15 @@ bool DspPipeline::runDemodChain(
   // channel-power estimate), but the per-sample gain ramp inside
   // m_squelch.process() avoids audible clicks at the open/close edge.
   // No-op when squelch_dbfs is at the disable sentinel.
-  m_squelch.updateGate(m_demod.getFilteredChannelPowerDbfs(),
-                       m_stereo.getDemodSnrDb());
-  m_squelch.process(m_audioLeft.data(), m_audioRight.data(), outSamples);
+  m_squelch.updateGate(block.channelPowerDbfs, m_stereo.getDemodSnrDb());
+  m_squelch.processInterleaved(frames, outSamples);
 
   uint32_t softClipCount = 0;
-  for (size_t i = 0; i < outSamples; i++) {
-    m_audioLeft[i] = softLimitSample(m_audioLeft[i], softClipCount);
-    m_audioRight[i] = softLimitSample(m_audioRight[i], softClipCount);
+  for (size_t i = 0; i < 2 * outSamples; i++) {
+    frames[i] = softLimitSample(frames[i], softClipCount);
   }
 
-  out.left = m_audioLeft.data();
-  out.right = m_audioRight.data();
+  out.audio = frames;
   out.outSamples = outSamples;
   out.demodSamples = demodSamples;
   out.stereoDetected = stereoDetected;
@@ -463,7 +868,7 @@ bool DspPipeline::runDemodChain(
   {
     float peak = 0.0f;
     for (size_t i = 0; i < demodSamples; i++) {
-      const float a = std::fabs(m_demodBuffer[i]);
+      const float a = std::fabs(mpx[i]);
       if (a > peak) {
         peak = a;
       }
@@ -475,12 +880,12 @@ bool DspPipeline::runDemodChain(
           ? static_cast<float>(softClipCount) /
                 static_cast<float>(outSamples * 2U)
           : 0.0f;
-  out.channelPowerDbfs = m_demod.getFilteredChannelPowerDbfs();
+  out.channelPowerDbfs = block.channelPowerDbfs;
 
   // Multipath equalizer telemetry. Only emit when the equalizer is active and
   // adapting, throttled so it doesn't drown out the rest of the log.
   if (m_verboseLogging) {
-    const float envErr = m_demod.getMultipathEnvelopeError();
+    const float envErr = block.envelopeError;
     if (envErr > 0.0f) {
       static uint32_t eqLogCount = 0;
       const uint32_t count = ++eqLogCount;
@@ -489,6 +894,49 @@ bool DspPipeline::runDemodChain(
       }
     }
   }
+}
 
-  return true;
+void DspPipeline::runIdle(Block &block) {
+  // With three stages the front can still be a block behind the gate in
+  // either direction: a demodulated block lands here after the close, or a
+  // measured one right after the reopen. Both come out as silence.
+  if (!m_idle && !m_squelch.isOpen()) {
+    m_idle = true;
+    m_idleOutCarry = 0;
+    if (m_verboseLogging) {
+      std::cout << "[SQUELCH] closed, audio chain idle\n";
+    }
+  }
+
+  // As many frames as the AF resampler would have produced, so the sinks'
+  // stream timing holds.
+  const uint64_t owed = static_cast<uint64_t>(block.demodSamples) *
+                            static_cast<uint64_t>(m_outputRate) +
+                        m_idleOutCarry;
+  const size_t outSamples = std::min(
+      static_cast<size_t>(owed / static_cast<uint64_t>(m_inputRate)),
+      m_blockSamples);
+  m_idleOutCarry = owed % static_cast<uint64_t>(m_inputRate);
+  std::fill(block.frames.begin(),
+            block.frames.begin() + static_cast<std::ptrdiff_t>(2 * outSamples),
+            0.0f);
+
+  m_squelch.updateGate(block.channelPowerDbfs);
+  if (m_idle && m_squelch.isOpen()) {
+    // The stereo decoder and AF chain still hold the audio from before the
+    // close; start them clean at the next block, under the squelch fade-in.
+    m_idle = false;
+    m_pendingAudioReset = true;
+    if (m_verboseLogging) {
+      std::cout << "[SQUELCH] open, audio chain resumed\n";
+    }
+  }
+
+  Result &out = block.result;
+  out = Result{};
+  out.audio = block.frames.data();
+  out.outSamples = outSamples;
+  out.demodSamples = block.demodSamples;
+  out.channelPowerDbfs = block.channelPowerDbfs;
+  out.idle = true;
 }
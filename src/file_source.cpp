@@ -0,0 +1,546 @@
+// Recordings routinely exceed 2 GB; use 64-bit file offsets on 32-bit systems.
+#if !defined(_WIN32) && !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "file_source.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// Paced playback that falls this far behind (stalled consumer, debugger,
+// blocked audio sink) re-anchors its clock instead of bursting to catch up.
+constexpr auto kMaxPaceLag = std::chrono::milliseconds(250);
+
+std::string lowerExtension(const std::string &path) {
+  const size_t dot = path.find_last_of('.');
+  const size_t slash = path.find_last_of("/\\");
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return std::string();
+  }
+  std::string ext = path.substr(dot + 1);
+  std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  return ext;
+}
+
+FileSource::Format resolveFormat(const std::string &path,
+                                 const std::string &format) {
+  if (format == "cf32") {
+    return FileSource::Format::CF32;
+  }
+  if (format == "cs16") {
+    return FileSource::Format::CS16;
+  }
+  if (format == "u8") {
+    return FileSource::Format::U8;
+  }
+  const std::string ext = lowerExtension(path);
+  if (ext == "cf32" || ext == "fc32" || ext == "cfile") {
+    return FileSource::Format::CF32;
+  }
+  if (ext == "cs16" || ext == "sc16") {
+    return FileSource::Format::CS16;
+  }
+  return FileSource::Format::U8;
+}
+
+size_t bytesPerSample(FileSource::Format format) {
+  switch (format) {
+  case FileSource::Format::CF32:
+    return sizeof(std::complex<float>);
+  case FileSource::Format::CS16:
+    return 2 * sizeof(int16_t);
+  case FileSource::Format::U8:
+    break;
+  }
+  return 2;
+}
+
+const char *formatName(FileSource::Format format) {
+  switch (format) {
+  case FileSource::Format::CF32:
+    return "cf32";
+  case FileSource::Format::CS16:
+    return "cs16";
+  case FileSource::Format::U8:
+    break;
+  }
+  return "u8";
+}
+
+// Same scale as the SDRplay source: int16 / 32768.
+void cs16ToCf32(const uint8_t *src, size_t samples, std::complex<float> *dst) {
+  constexpr float kScale = 1.0f / 32768.0f;
+  for (size_t i = 0; i < samples; i++) {
+    int16_t v[2];
+    std::memcpy(v, src + i * sizeof(v), sizeof(v));
+    dst[i] = std::complex<float>(static_cast<float>(v[0]) * kScale,
+                                 static_cast<float>(v[1]) * kScale);
+  }
+}
+} // namespace
+
+FileSource::~FileSource() { disconnect(); }
+
+void FileSource::configure(const std::string &path, const std::string &format,
+                           bool paced, bool loop) {
+  m_path = path;
+  m_formatName = format;
+  // Known before connect(), so consumers can size themselves for it.
+  m_format = resolveFormat(path, format);
+  m_paced = paced;
+  m_loop = loop;
+}
+
+bool FileSource::connect() {
+  disconnect();
+  if (m_path.empty()) {
+    std::cerr << "[FILE] no IQ recording configured (use --replay <file>)\n";
+    return false;
+  }
+  m_format = resolveFormat(m_path, m_formatName);
+  if (!mapFile()) {
+    return false;
+  }
+  m_totalSamples = m_fileBytes / bytesPerSample(m_format);
+  if (m_totalSamples == 0) {
+    std::cerr << "[FILE] IQ recording is empty: " << m_path << "\n";
+    unmapFile();
+    return false;
+  }
+  loadIndex();
+  m_endOfStream = false;
+  m_samplesDelivered = 0;
+  m_connectTime = std::chrono::steady_clock::now();
+  seekTo(0, m_totalSamples);
+  std::cout << "[FILE] replaying " << m_path << " ("
+            << formatName(m_format) << ", "
+            << m_totalSamples << " samples, "
+            << (m_paced ? "paced" : "unthrottled")
+            << (m_loop ? ", looping" : "") << ")\n";
+  if (!m_segments.empty()) {
+    std::cout << "[FILE] tune index: " << m_segments.size() << " segment(s)\n";
+  }
+  return true;
+}
+
+void FileSource::disconnect() {
+  unmapFile();
+  m_segments.clear();
+  m_totalSamples = 0;
+  m_position = 0;
+  m_playBegin = 0;
+  m_playEnd = 0;
+  m_frequency = 0;
+}
+
+bool FileSource::mapFile() {
+  uint64_t fileBytes = 0;
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(m_path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    std::cerr << "[FILE] failed to open IQ recording: " << m_path << "\n";
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+    std::cerr << "[FILE] IQ recording is empty: " << m_path << "\n";
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    std::cerr << "[FILE] failed to map IQ recording: " << m_path << "\n";
+    CloseHandle(file);
+    return false;
+  }
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  m_viewGranularity = info.dwAllocationGranularity;
+  m_fileHandle = file;
+  m_mappingHandle = mapping;
+  fileBytes = static_cast<uint64_t>(size.QuadPart);
+#else
+  // file_source.cpp is built with 64-bit off_t, so this also opens and sizes
+  // recordings of 2 GB and more on 32-bit systems.
+  const int fd = ::open(m_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::cerr << "[FILE] failed to open IQ recording: " << m_path << " ("
+              << std::strerror(errno) << ")\n";
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    std::cerr << "[FILE] IQ recording is empty: " << m_path << "\n";
+    ::close(fd);
+    return false;
+  }
+  const long page = sysconf(_SC_PAGESIZE);
+  m_viewGranularity = page > 0 ? static_cast<size_t>(page) : 4096;
+  m_fd = fd;
+  fileBytes = static_cast<uint64_t>(st.st_size);
+#endif
+  m_fileBytes = fileBytes;
+  m_windowed = false;
+  if (fileBytes <= m_wholeMapLimit && fileBytes <= SIZE_MAX &&
+      mapView(0, static_cast<size_t>(fileBytes))) {
+    return true;
+  }
+  // Larger than the address space can take in one piece: slide a window.
+  m_windowed = true;
+  if (!mapView(0, static_cast<size_t>(
+                      std::min<uint64_t>(fileBytes, m_windowBytes)))) {
+    std::cerr << "[FILE] failed to map IQ recording: " << m_path << "\n";
+    unmapFile();
+    return false;
+  }
+  std::cout << "[FILE] recording exceeds the address space; mapping it in "
+            << (m_windowBytes >> 20) << " MB windows\n";
+  return true;
+}
+
+bool FileSource::mapView(uint64_t offset, size_t bytes) {
+  unmapView();
+#if defined(_WIN32)
+  const void *view = MapViewOfFile(
+      static_cast<HANDLE>(m_mappingHandle), FILE_MAP_READ,
+      static_cast<DWORD>(offset >> 32),
+      static_cast<DWORD>(offset & 0xFFFFFFFFu), bytes);
+  if (!view) {
+    return false;
+  }
+#else
+  void *view = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, m_fd,
+                    static_cast<off_t>(offset));
+  if (view == MAP_FAILED) {
+    return false;
+  }
+  // Playback is strictly sequential; let the kernel read ahead aggressively.
+  (void)madvise(view, bytes, MADV_SEQUENTIAL);
+#endif
+  m_base = static_cast<const uint8_t *>(view);
+  m_viewOffset = offset;
+  m_viewBytes = bytes;
+  return true;
+}
+
+void FileSource::unmapView() {
+  if (!m_base) {
+    return;
+  }
+#if defined(_WIN32)
+  UnmapViewOfFile(m_base);
+#else
+  munmap(const_cast<uint8_t *>(m_base), m_viewBytes);
+#endif
+  m_base = nullptr;
+  m_viewOffset = 0;
+  m_viewBytes = 0;
+}
+
+void FileSource::unmapFile() {
+  unmapView();
+#if defined(_WIN32)
+  if (m_mappingHandle) {
+    CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    m_mappingHandle = nullptr;
+  }
+  if (m_fileHandle) {
+    CloseHandle(static_cast<HANDLE>(m_fileHandle));
+    m_fileHandle = nullptr;
+  }
+#else
+  if (m_fd >= 0) {
+    ::close(m_fd);
+    m_fd = -1;
+  }
+#endif
+  m_fileBytes = 0;
+  m_windowed = false;
+}
+
+const uint8_t *FileSource::viewAt(size_t samples) {
+  const uint64_t begin = m_position * bytesPerSample(m_format);
+  const uint64_t end = begin + samples * bytesPerSample(m_format);
+  if (!m_base) {
+    return nullptr;
+  }
+  if (begin < m_viewOffset || end > m_viewOffset + m_viewBytes) {
+    if (!m_windowed) {
+      return nullptr;
+    }
+    // Window starts are granularity aligned, which keeps CF32 leases float
+    // aligned; the window always covers the whole lease.
+    const uint64_t offset = begin - begin % m_viewGranularity;
+    const uint64_t bytes =
+        std::min<uint64_t>(std::max<uint64_t>(m_windowBytes, end - offset),
+                           m_fileBytes - offset);
+    if (!mapView(offset, static_cast<size_t>(bytes))) {
+      std::cerr << "[FILE] failed to map IQ recording at byte " << offset
+                << ": " << m_path << "\n";
+      return nullptr;
+    }
+  }
+  return m_base + (begin - m_viewOffset);
+}
+
+void FileSource::loadIndex() {
+  m_segments.clear();
+  std::ifstream index(m_path + ".tunes");
+  if (!index.is_open()) {
+    return;
+  }
+  std::string line;
+  while (std::getline(index, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    uint64_t offset = 0;
+    uint32_t freqHz = 0;
+    if (!(fields >> offset >> freqHz) || offset >= m_totalSamples) {
+      continue;
+    }
+    if (!m_segments.empty() && offset <= m_segments.back().begin) {
+      continue; // offsets must increase; ignore out-of-order lines
+    }
+    Segment segment;
+    segment.begin = offset;
+    segment.freqHz = freqHz;
+    m_segments.push_back(segment);
+  }
+  for (size_t i = 0; i < m_segments.size(); i++) {
+    m_segments[i].end = (i + 1 < m_segments.size()) ? m_segments[i + 1].begin
+                                                    : m_totalSamples;
+  }
+}
+
+void FileSource::seekTo(uint64_t begin, uint64_t end) {
+  m_playBegin = begin;
+  m_playEnd = end;
+  m_position = begin;
+  m_endOfStream = false;
+  m_paceAnchor = std::chrono::steady_clock::now();
+  m_pacedSamples = 0;
+}
+
+bool FileSource::setFrequency(uint32_t freqHz) {
+  if (!isConnected()) {
+    return false;
+  }
+  const uint32_t previous = m_frequency;
+  m_frequency = freqHz;
+  if (m_segments.empty()) {
+    return true;
+  }
+  const auto it = std::find_if(
+      m_segments.begin(), m_segments.end(),
+      [freqHz](const Segment &s) { return s.freqHz == freqHz; });
+  if (it != m_segments.end()) {
+    if (freqHz != previous || m_playBegin != it->begin ||
+        m_playEnd != it->end) {
+      seekTo(it->begin, it->end);
+    }
+    return true;
+  }
+  // Not in the recording: keep playing from here, through the whole file.
+  if (m_playBegin != 0 || m_playEnd != m_totalSamples) {
+    std::cerr << "[FILE] " << (freqHz / 1000U)
+              << " kHz is not in the tune index; continuing linearly\n";
+    m_playBegin = 0;
+    m_playEnd = m_totalSamples;
+  }
+  return true;
+}
+
+bool FileSource::setSampleRate(uint32_t rate) {
+  if (rate == 0) {
+    return false;
+  }
+  m_sampleRate = rate;
+  m_paceAnchor = std::chrono::steady_clock::now();
+  m_pacedSamples = 0;
+  return isConnected();
+}
+
+void FileSource::noteEndOfStream() {
+  if (m_endOfStream) {
+    return;
+  }
+  m_endOfStream = true;
+  const double wallSec =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                    m_connectTime)
+          .count();
+  const double iqSec = static_cast<double>(m_samplesDelivered) /
+                       static_cast<double>(std::max<uint32_t>(1, m_sampleRate));
+  std::cout << "[FILE] end of recording: " << m_samplesDelivered
+            << " samples (" << iqSec << " s of IQ) in " << wallSec << " s";
+  if (wallSec > 0.0) {
+    std::cout << " = " << (iqSec / wallSec) << "x real time";
+  }
+  std::cout << "\n";
+}
+
+size_t FileSource::acquire(size_t maxSamples) {
+  if (!isConnected() || maxSamples == 0 || m_endOfStream) {
+    return 0;
+  }
+  if (m_position >= m_playEnd) {
+    if (!m_loop) {
+      noteEndOfStream();
+      return 0;
+    }
+    m_position = m_playBegin;
+  }
+  const size_t samples = static_cast<size_t>(
+      std::min<uint64_t>(maxSamples, m_playEnd - m_position));
+  pace(samples);
+  return samples;
+}
+
+void FileSource::pace(size_t samples) {
+  if (!m_paced) {
+    return;
+  }
+  const double rate = static_cast<double>(std::max<uint32_t>(1, m_sampleRate));
+  // A block is due once its last sample would have arrived from a live tuner.
+  const auto due =
+      m_paceAnchor + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(
+                             static_cast<double>(m_pacedSamples + samples) / rate));
+  const auto now = std::chrono::steady_clock::now();
+  if (now > due + kMaxPaceLag) {
+    m_paceAnchor = now;
+    m_pacedSamples = 0;
+    return;
+  }
+  if (due > now) {
+    std::this_thread::sleep_until(due);
+  }
+  m_pacedSamples += samples;
+}
+
+size_t FileSource::leaseIQ(size_t maxSamples, const uint8_t *&data) {
+  data = nullptr;
+  if (m_format != Format::U8) {
+    return 0;
+  }
+  const size_t samples = acquire(maxSamples);
+  if (samples > 0) {
+    data = viewAt(samples);
+  }
+  return data ? samples : 0;
+}
+
+size_t FileSource::leaseIQ(size_t maxSamples,
+                           const std::complex<float> *&data) {
+  data = nullptr;
+  if (m_format == Format::U8) {
+    return 0;
+  }
+  const size_t samples = acquire(maxSamples);
+  const uint8_t *src = samples > 0 ? viewAt(samples) : nullptr;
+  if (!src) {
+    return 0;
+  }
+  if (m_format == Format::CS16) {
+    if (m_convert.size() < samples) {
+      m_convert.resize(samples);
+    }
+    cs16ToCf32(src, samples, m_convert.data());
+    data = m_convert.data();
+  } else {
+    // The view is page aligned, so every sample is float aligned.
+    data = reinterpret_cast<const std::complex<float> *>(src);
+  }
+  return samples;
+}
+
+void FileSource::releaseIQ(size_t samples) {
+  const uint64_t advance = std::min<uint64_t>(samples, m_playEnd - m_position);
+  m_position += advance;
+  m_samplesDelivered += advance;
+}
+
+size_t FileSource::readIQ(uint8_t *buffer, size_t maxSamples) {
+  if (!buffer) {
+    return 0;
+  }
+  const size_t samples = acquire(maxSamples);
+  const uint8_t *view = samples > 0 ? viewAt(samples) : nullptr;
+  if (!view) {
+    return 0;
+  }
+  if (m_format == Format::U8) {
+    std::memcpy(buffer, view, samples * 2);
+  } else {
+    const std::complex<float> *src =
+        reinterpret_cast<const std::complex<float> *>(view);
+    if (m_format == Format::CS16) {
+      if (m_convert.size() < samples) {
+        m_convert.resize(samples);
+      }
+      cs16ToCf32(view, samples, m_convert.data());
+      src = m_convert.data();
+    }
+    for (size_t i = 0; i < samples; i++) {
+      const float si = std::lround(src[i].real() * 127.5f + 127.5f);
+      const float sq = std::lround(src[i].imag() * 127.5f + 127.5f);
+      buffer[2 * i] = static_cast<uint8_t>(std::clamp(si, 0.0f, 255.0f));
+      buffer[2 * i + 1] = static_cast<uint8_t>(std::clamp(sq, 0.0f, 255.0f));
+    }
+  }
+  releaseIQ(samples);
+  return samples;
+}
+
+size_t FileSource::readIQ(std::complex<float> *buffer, size_t maxSamples) {
+  if (!buffer) {
+    return 0;
+  }
+  const size_t samples = acquire(maxSamples);
+  const uint8_t *view = samples > 0 ? viewAt(samples) : nullptr;
+  if (!view) {
+    return 0;
+  }
+  if (m_format == Format::CF32) {
+    std::memcpy(buffer, view, samples * sizeof(std::complex<float>));
+  } else if (m_format == Format::CS16) {
+    cs16ToCf32(view, samples, buffer);
+  } else {
+    const uint8_t *src = view;
+    for (size_t i = 0; i < samples; i++) {
+      buffer[i] = std::complex<float>(
+          (static_cast<float>(src[2 * i]) - 127.5f) / 127.5f,
+          (static_cast<float>(src[2 * i + 1]) - 127.5f) / 127.5f);
+    }
+  }
+  releaseIQ(samples);
+  return samples;
+}
@@ -1,7 +1,5 @@
 #include "fm_demod.h"
 
-#include "dsp/iq_saturation.h"
-
 #include <algorithm>
 #include <array>
 #include <cmath>
@@ -9,23 +7,44 @@
 #include <limits>
 
 namespace {
-constexpr float kPi = 3.14159265358979323846f;
 constexpr std::array<int, 30> kXdrFmBwHz = {
     309000, 298000, 281000, 263000, 246000, 229000, 211000, 194000,
     177000, 159000, 142000, 125000, 108000, 95000,  90000,  83000,
     73000,  63000,  55000,  48000,  42000,  36000,  32000,  27000,
     24000,  20000,  17000,  15000,  9000,   0};
 
-const std::array<float, 256> &iqNormLut() {
-  static const std::array<float, 256> lut = []() {
-    std::array<float, 256> out{};
-    for (int v = 0; v < 256; v++) {
-      out[static_cast<size_t>(v)] = (static_cast<float>(v) - 127.0f) / 127.5f;
-    }
-    return out;
-  }();
-  return lut;
+// Channel FIR crossfade on a bandwidth change, in seconds: long enough that
+// the step in passband doesn't click, short next to the adaptive-bandwidth
+// interval.
+constexpr double kBandwidthCrossfadeSeconds = 0.002;
+// Longest channel FIR; every one runs at its group delay so that a swap is
+// no step in time (see FmFrontEnd::swapChannelTaps).
+constexpr std::uint32_t kChannelFilterMaxLength = 121;
+constexpr size_t kChannelFilterDelay = (kChannelFilterMaxLength - 1) / 2;
+
+struct ChannelFilterDesign {
+  std::uint32_t length;
+  float cutoff;
+  float stopBandAtten;
+};
+
+// Channel FIR for an RF bandwidth (0 = widest): channel BW -> baseband
+// half-band cutoff, clamped to the available Nyquist headroom.
+ChannelFilterDesign channelFilterDesign(int bwHz, int inputRate) {
+  const double nyquistHeadroomHz = 0.45 * static_cast<double>(inputRate);
+  const double iqCutoffHz =
+      (bwHz > 0) ? std::clamp(static_cast<double>(bwHz) * 0.5, 9000.0,
+                              nyquistHeadroomHz)
+                 : nyquistHeadroomHz;
+  ChannelFilterDesign design;
+  design.cutoff = std::clamp(
+      static_cast<float>(iqCutoffHz / static_cast<double>(inputRate)), 0.01f,
+      0.45f);
+  design.length = (bwHz > 0 && bwHz <= 73000) ? kChannelFilterMaxLength : 81U;
+  design.stopBandAtten = (bwHz > 0 && bwHz <= 42000) ? 70.0f : 60.0f;
+  return design;
 }
+
 } // namespace
 
 FMDemod::FMDemod(int inputRate, int outputRate)
@@ -36,12 +55,20 @@ FMDemod::FMDemod(int inputRate, int outputRate)
       m_filteredChannelPowerDbfs(-120.0) {
   const float iqCutoffNorm =
       std::clamp(110000.0f / static_cast<float>(m_inputRate), 0.01f, 0.45f);
-  m_liquidIqFilter.init(81, iqCutoffNorm, 60.0f, 0.0f, m_iqFirL1Normalize);
-  m_liquidIqDcBlockI.initDCBlocker(0.0005f);
-  m_liquidIqDcBlockQ.initDCBlocker(0.0005f);
-  const float ratio =
-      static_cast<float>(m_outputRate) / static_cast<float>(m_inputRate);
-  m_liquidMonoResampler.init(ratio);
+  m_frontEnd.setChannelTaps(fm_tuner::dsp::FmFrontEnd::designChannelTaps(
+      81, iqCutoffNorm, 60.0f, m_iqFirL1Normalize, kChannelFilterDelay));
+  m_frontEnd.setDcBlocker(0.0005f);
+  for (int l1 = 0; l1 < 2; l1++) {
+    m_channelTaps[l1].reserve(kXdrFmBwHz.size());
+    for (const int bwHz : kXdrFmBwHz) {
+      const ChannelFilterDesign design = channelFilterDesign(bwHz, m_inputRate);
+      m_channelTaps[l1].push_back(fm_tuner::dsp::FmFrontEnd::designChannelTaps(
+          design.length, design.cutoff, design.stopBandAtten, l1 != 0,
+          kChannelFilterDelay));
+    }
+  }
+  m_monoResampler.init(static_cast<std::uint32_t>(m_inputRate),
+                       static_cast<std::uint32_t>(m_outputRate));
   m_liquidMonoDcBlock.initDCBlocker(0.0008f);
   setDeviation(75000.0);
   setDeemphasis(50);
@@ -72,7 +99,7 @@ void FMDemod::setDeviation(double deviation) {
   // liquid freqdem expects kf in cycles/sample; match legacy gain:
   // out = delta_phase * Fs / (2*pi*deviation)
   // => kf = deviation / Fs
-  m_liquidFreqDemod.init(
+  m_frontEnd.setModulationFactor(
       static_cast<float>(m_deviation / static_cast<double>(m_inputRate)));
 }
 
@@ -80,15 +107,12 @@ void FMDemod::reset() {
   m_clipping = false;
   m_clippingRatio = 0.0f;
   m_filteredChannelPowerDbfs = -120.0;
-  m_liquidIqFilter.reset();
-  m_liquidFreqDemod.reset();
-  m_liquidIqDcBlockI.reset();
-  m_liquidIqDcBlockQ.reset();
+  m_frontEnd.reset();
   if (m_deemphasisEnabled) {
     m_liquidMonoDeemphasis.reset();
   }
   m_liquidMonoDcBlock.reset();
-  m_liquidMonoResampler.reset();
+  m_monoResampler.reset();
   if (m_liquidIqAgc.ready()) {
     m_liquidIqAgc.reset();
   }
@@ -123,25 +147,12 @@ void FMDemod::setBandwidthHz(int bwHz) {
     return;
   }
   m_bandwidthMode = selected;
-  const int selectedBwHz = kXdrFmBwHz[static_cast<size_t>(selected)];
-  // Parameterize liquid LPF from the mapped RF bandwidth:
-  // channel BW -> baseband half-band cutoff, clamped to available Nyquist
-  // headroom.
-  const double nyquistHeadroomHz = 0.45 * static_cast<double>(m_inputRate);
-  const double iqCutoffHz =
-      (selectedBwHz > 0) ? std::clamp(static_cast<double>(selectedBwHz) * 0.5,
-                                      9000.0, nyquistHeadroomHz)
-                         : nyquistHeadroomHz;
-  const float cutoffNorm = std::clamp(
-      static_cast<float>(iqCutoffHz / static_cast<double>(m_inputRate)), 0.01f,
-      0.45f);
-  const std::uint32_t filterLen =
-      (selectedBwHz > 0 && selectedBwHz <= 73000) ? 121U : 81U;
-  const float stopBandAtten =
-      (selectedBwHz > 0 && selectedBwHz <= 42000) ? 70.0f : 60.0f;
-  m_liquidIqFilter.init(filterLen, cutoffNorm, stopBandAtten, 0.0f,
-                        m_iqFirL1Normalize);
-  reset();
+  // Hot swap: the FIR keeps its history and the discriminator, AGC,
+  // equalizer and audio filters their state, so the change is a short
+  // crossfade instead of a restart.
+  m_frontEnd.swapChannelTaps(
+      m_channelTaps[m_iqFirL1Normalize ? 1 : 0][static_cast<size_t>(selected)],
+      static_cast<size_t>(kBandwidthCrossfadeSeconds * m_inputRate));
 }
 
 void FMDemod::setIqFirL1Normalize(bool enabled) {
@@ -149,9 +160,9 @@ void FMDemod::setIqFirL1Normalize(bool enabled) {
     return;
   }
   m_iqFirL1Normalize = enabled;
-  // Re-design the IQ FIR with the current bandwidth + new normalization flag.
-  // Forcing a re-init by bumping the mode through a sentinel keeps the
-  // setBandwidthHz path canonical (it owns the cutoff/taps math).
+  // Switch to the other tap set at the current bandwidth. Forcing a re-init
+  // by bumping the mode through a sentinel keeps the setBandwidthHz path
+  // canonical (it owns the bandwidth -> filter mapping).
   const int currentBw = (m_bandwidthMode >= 0 &&
                          m_bandwidthMode < static_cast<int>(kXdrFmBwHz.size()))
                             ? kXdrFmBwHz[static_cast<size_t>(m_bandwidthMode)]
@@ -183,110 +194,84 @@ void FMDemod::setDspAgcMode(DspAgcMode mode) {
 }
 
 void FMDemod::demodulate(const uint8_t *iq, float *audio, size_t len) {
-  const auto &kIqNorm = iqNormLut();
-  const uint8_t *iqPtr = iq;
-  size_t clipCount = 0;
-  double powerSum = 0.0;
-
-  for (size_t i = 0; i < len; i++) {
-    const uint8_t iByte = iqPtr[0];
-    const uint8_t qByte = iqPtr[1];
-    iqPtr += 2;
-    if (fm_tuner::dsp::isRtlSdrIqByteSaturated(iByte) ||
-        fm_tuner::dsp::isRtlSdrIqByteSaturated(qByte)) {
-      clipCount++;
-    }
+  if (m_iqScratch.size() < len) {
+    m_iqScratch.resize(len);
+  }
+  finishDemodulate(m_frontEnd.filter(iq, len, m_iqScratch.data()), audio, len);
+}
 
-    const float iRaw = kIqNorm[iByte];
-    const float qRaw = kIqNorm[qByte];
-    const float iDc = m_liquidIqDcBlockI.execute(iRaw);
-    const float qDc = m_liquidIqDcBlockQ.execute(qRaw);
+void FMDemod::demodulateComplex(const std::complex<float> *iq, float *audio,
+                                size_t len) {
+  if (m_iqScratch.size() < len) {
+    m_iqScratch.resize(len);
+  }
+  finishDemodulate(m_frontEnd.filter(iq, len, m_iqScratch.data()), audio, len);
+}
 
-    m_liquidIqFilter.push(std::complex<float>(iDc, qDc));
-    std::complex<float> iqFiltered = m_liquidIqFilter.execute();
-    powerSum += static_cast<double>(iqFiltered.real()) * iqFiltered.real() +
-                static_cast<double>(iqFiltered.imag()) * iqFiltered.imag();
-    std::complex<float> iqDemodIn = iqFiltered;
-    if (m_dspAgcMode != DspAgcMode::Off) {
-      iqDemodIn = m_liquidIqAgc.execute(iqDemodIn);
-    }
-    // Multipath equalizer (CMA). No-op when mode == Off. Sits *after* the
-    // channel FIR and IF AGC so the CMA sees a normalized envelope.
-    iqDemodIn = m_liquidMultipathEq.execute(iqDemodIn);
-    audio[i] = m_liquidFreqDemod.execute(iqDemodIn);
+void FMDemod::finishDemodulate(
+    const fm_tuner::dsp::FmFrontEnd::BlockStats &stats, float *audio,
+    size_t len) {
+  std::complex<float> *iq = m_iqScratch.data();
+  if (m_dspAgcMode != DspAgcMode::Off) {
+    m_liquidIqAgc.executeBlock(iq, len, iq);
+  }
+  if (m_liquidMultipathEq.isActive()) {
+    // Multipath equalizer (CMA). Sits *after* the channel FIR and IF AGC so
+    // the CMA sees a normalized envelope.
+    m_liquidMultipathEq.executeBlock(iq, iq, len);
   }
+  m_frontEnd.discriminate(iq, len, audio);
+  updateBlockStats(stats, len);
+}
 
-  m_clipping = (clipCount > 0);
-  m_clippingRatio =
-      (len > 0) ? (static_cast<float>(clipCount) / static_cast<float>(len))
-                : 0.0f;
+void FMDemod::updateBlockStats(
+    const fm_tuner::dsp::FmFrontEnd::BlockStats &stats, size_t len) {
+  m_clipping = (stats.clipCount > 0);
+  m_clippingRatio = (len > 0) ? (static_cast<float>(stats.clipCount) /
+                                 static_cast<float>(len))
+                              : 0.0f;
   // Cap at 0 dBFS so ADC-rail overload (IQ FIR rings past full scale under
   // heavy IF AGC) doesn't report physically nonsensical positive dBFS.
   m_filteredChannelPowerDbfs =
       (len > 0)
           ? std::min(0.0,
                      10.0 *
-                         std::log10((powerSum / static_cast<double>(len)) +
+                         std::log10((stats.powerSum / static_cast<double>(len)) +
                                     1e-20))
           : -120.0;
 }
 
-void FMDemod::demodulateComplex(const std::complex<float> *iq, float *audio,
-                                size_t len) {
-  size_t clipCount = 0;
-  double powerSum = 0.0;
-
-  for (size_t i = 0; i < len; i++) {
-    const float iRaw = iq[i].real();
-    const float qRaw = iq[i].imag();
-    if (std::abs(iRaw) >= 0.995f || std::abs(qRaw) >= 0.995f) {
-      clipCount++;
-    }
-
-    const float iDc = m_liquidIqDcBlockI.execute(iRaw);
-    const float qDc = m_liquidIqDcBlockQ.execute(qRaw);
-
-    m_liquidIqFilter.push(std::complex<float>(iDc, qDc));
-    std::complex<float> iqFiltered = m_liquidIqFilter.execute();
-    powerSum += static_cast<double>(iqFiltered.real()) * iqFiltered.real() +
-                static_cast<double>(iqFiltered.imag()) * iqFiltered.imag();
-    std::complex<float> iqDemodIn = iqFiltered;
-    if (m_dspAgcMode != DspAgcMode::Off) {
-      iqDemodIn = m_liquidIqAgc.execute(iqDemodIn);
-    }
-    iqDemodIn = m_liquidMultipathEq.execute(iqDemodIn);
-    audio[i] = m_liquidFreqDemod.execute(iqDemodIn);
+void FMDemod::measureChannel(const uint8_t *iq, size_t numSamples) {
+  if (m_iqScratch.size() < numSamples) {
+    m_iqScratch.resize(numSamples);
   }
+  updateBlockStats(m_frontEnd.filter(iq, numSamples, m_iqScratch.data()),
+                   numSamples);
+}
 
-  m_clipping = (clipCount > 0);
-  m_clippingRatio =
-      (len > 0) ? (static_cast<float>(clipCount) / static_cast<float>(len))
-                : 0.0f;
-  m_filteredChannelPowerDbfs =
-      (len > 0)
-          ? std::min(0.0,
-                     10.0 *
-                         std::log10((powerSum / static_cast<double>(len)) +
-                                    1e-20))
-          : -120.0;
+void FMDemod::measureChannelComplex(const std::complex<float> *iq,
+                                    size_t numSamples) {
+  if (m_iqScratch.size() < numSamples) {
+    m_iqScratch.resize(numSamples);
+  }
+  updateBlockStats(m_frontEnd.filter(iq, numSamples, m_iqScratch.data()),
+                   numSamples);
 }
 
 size_t FMDemod::downsampleAudio(const float *demod, float *audio,
                                 size_t numSamples) {
-  size_t outCount = 0;
-  for (size_t i = 0; i < numSamples; i++) {
-    const uint32_t produced =
-        m_liquidMonoResampler.execute(demod[i], m_liquidResampleTmp);
-    for (uint32_t p = 0; p < produced; p++) {
-      float sample = m_liquidResampleTmp[p];
-      if (m_deemphasisEnabled) {
-        sample = m_liquidMonoDeemphasis.execute(sample);
-      }
-      sample = m_liquidMonoDcBlock.execute(sample);
-      audio[outCount++] = sample;
-    }
+  const size_t capacity = m_monoResampler.maxOutput(numSamples);
+  if (m_resampleScratch.size() < capacity) {
+    m_resampleScratch.resize(capacity);
+  }
+  const size_t produced =
+      m_monoResampler.execute(demod, numSamples, m_resampleScratch.data());
+  if (m_deemphasisEnabled) {
+    m_liquidMonoDeemphasis.executeBlock(m_resampleScratch.data(), produced,
+                                        m_resampleScratch.data());
   }
-  return outCount;
+  m_liquidMonoDcBlock.executeBlock(m_resampleScratch.data(), produced, audio);
+  return produced;
 }
 
 void FMDemod::process(const uint8_t *iq, float *audio, size_t numSamples) {
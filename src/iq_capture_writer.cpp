@@ -0,0 +1,543 @@
+#include "iq_capture_writer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Queue depth in seconds of IQ (never less than kMinQueueBytes). Rides out
+// multi-second stalls of slow media without touching the DSP thread.
+constexpr size_t kQueueSeconds = 4;
+constexpr size_t kMinQueueBytes = 8U * 1024U * 1024U;
+// Largest single write(); the writer also flushes whatever is queued every
+// kFlushInterval, so slow sample rates still reach the disk promptly.
+constexpr size_t kBatchBytes = 1U << 20;
+constexpr auto kFlushInterval = std::chrono::milliseconds(100);
+#if defined(__linux__)
+// Disk space is reserved this far ahead of the data, so the filesystem can
+// allocate large extents instead of growing the file write by write.
+constexpr uint64_t kPreallocateBytes = 64ULL * 1024ULL * 1024ULL;
+#endif
+
+int openForWrite(const std::string &path) {
+#if defined(_WIN32)
+  return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+               _S_IREAD | _S_IWRITE);
+#else
+  return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+}
+
+long writeSome(int fd, const uint8_t *data, size_t bytes) {
+#if defined(_WIN32)
+  return _write(fd, data, static_cast<unsigned int>(bytes));
+#else
+  return static_cast<long>(::write(fd, data, bytes));
+#endif
+}
+
+void closeFd(int fd) {
+#if defined(_WIN32)
+  _close(fd);
+#else
+  ::close(fd);
+#endif
+}
+
+// capture.iq -> capture_0003.iq when rotating; the plain path otherwise.
+std::string rotatedPath(const std::string &path, uint32_t index, bool rotating) {
+  if (!rotating) {
+    return path;
+  }
+  char suffix[16];
+  std::snprintf(suffix, sizeof(suffix), "_%04u", index);
+  const size_t slash = path.find_last_of("/\\");
+  const size_t dot = path.find_last_of('.');
+  if (dot == std::string::npos || dot == 0 ||
+      (slash != std::string::npos && dot < slash + 2)) {
+    return path + suffix;
+  }
+  return path.substr(0, dot) + suffix + path.substr(dot);
+}
+
+std::string lowerExtension(const std::string &path) {
+  const size_t dot = path.find_last_of('.');
+  const size_t slash = path.find_last_of("/\\");
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return std::string();
+  }
+  std::string ext = path.substr(dot + 1);
+  std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  return ext;
+}
+
+// Sample i of an interleaved block, normalized to [-1, 1]. CS16 uses the
+// SDRplay scale (int16 / 32768), so SDRplay samples round-trip exactly.
+std::complex<float> loadSample(IqCaptureWriter::Format format,
+                               const uint8_t *src, size_t i) {
+  switch (format) {
+  case IqCaptureWriter::Format::CF32: {
+    std::complex<float> v;
+    std::memcpy(&v, src + i * sizeof(v), sizeof(v));
+    return v;
+  }
+  case IqCaptureWriter::Format::CS16: {
+    int16_t v[2];
+    std::memcpy(v, src + i * sizeof(v), sizeof(v));
+    return {static_cast<float>(v[0]) / 32768.0f,
+            static_cast<float>(v[1]) / 32768.0f};
+  }
+  case IqCaptureWriter::Format::U8:
+    break;
+  }
+  return {(static_cast<float>(src[2 * i]) - 127.5f) / 127.5f,
+          (static_cast<float>(src[2 * i + 1]) - 127.5f) / 127.5f};
+}
+
+void storeSample(IqCaptureWriter::Format format, uint8_t *dst, size_t i,
+                 std::complex<float> v) {
+  switch (format) {
+  case IqCaptureWriter::Format::CF32:
+    std::memcpy(dst + i * sizeof(v), &v, sizeof(v));
+    return;
+  case IqCaptureWriter::Format::CS16: {
+    const int16_t s[2] = {
+        static_cast<int16_t>(
+            std::clamp(std::lrint(v.real() * 32768.0f), -32768L, 32767L)),
+        static_cast<int16_t>(
+            std::clamp(std::lrint(v.imag() * 32768.0f), -32768L, 32767L))};
+    std::memcpy(dst + i * sizeof(s), s, sizeof(s));
+    return;
+  }
+  case IqCaptureWriter::Format::U8:
+    break;
+  }
+  const float si = std::lround(v.real() * 127.5f + 127.5f);
+  const float sq = std::lround(v.imag() * 127.5f + 127.5f);
+  dst[2 * i] = static_cast<uint8_t>(std::clamp(si, 0.0f, 255.0f));
+  dst[2 * i + 1] = static_cast<uint8_t>(std::clamp(sq, 0.0f, 255.0f));
+}
+
+void convertSamples(IqCaptureWriter::Format from, const uint8_t *src,
+                    size_t samples, IqCaptureWriter::Format to,
+                    std::vector<uint8_t> &dst) {
+  dst.resize(samples * IqCaptureWriter::bytesPerSample(to));
+  for (size_t i = 0; i < samples; i++) {
+    storeSample(to, dst.data(), i, loadSample(from, src, i));
+  }
+}
+
+} // namespace
+
+bool IqCaptureWriter::parseFormat(const std::string &name,
+                                  const std::string &path, Format &format) {
+  if (name == "u8") {
+    format = Format::U8;
+  } else if (name == "cf32") {
+    format = Format::CF32;
+  } else if (name == "cs16") {
+    format = Format::CS16;
+  } else if (name == "auto") {
+    const std::string ext = lowerExtension(path);
+    if (ext == "cf32" || ext == "fc32" || ext == "cfile") {
+      format = Format::CF32;
+    } else if (ext == "cs16" || ext == "sc16") {
+      format = Format::CS16;
+    } else {
+      format = Format::U8;
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+const char *IqCaptureWriter::formatName(Format format) {
+  switch (format) {
+  case Format::CF32:
+    return "cf32";
+  case Format::CS16:
+    return "cs16";
+  case Format::U8:
+    break;
+  }
+  return "u8";
+}
+
+size_t IqCaptureWriter::bytesPerSample(Format format) {
+  switch (format) {
+  case Format::CF32:
+    return sizeof(std::complex<float>);
+  case Format::CS16:
+    return 2 * sizeof(int16_t);
+  case Format::U8:
+    break;
+  }
+  return 2;
+}
+
+IqCaptureWriter::IqCaptureWriter()
+    : m_threadRunning(false), m_fatalError(false), m_streamSamplesQueued(0),
+      m_lastQueuedFreqHz(0), m_fd(-1), m_indexHandle(nullptr), m_fileIndex(0),
+      m_fileBytes(0), m_filePreallocated(0), m_fileStartSample(0),
+      m_streamSamplesWritten(0), m_currentFreqHz(0), m_indexNeedsHeader(false),
+      m_dropEventsReported(0), m_bytesWritten(0), m_droppedBytes(0),
+      m_dropEvents(0) {}
+
+IqCaptureWriter::~IqCaptureWriter() { shutdown(); }
+
+bool IqCaptureWriter::init(const std::string &path, const Options &options) {
+  shutdown();
+  if (path.empty() || options.sampleRate == 0) {
+    return false;
+  }
+  m_path = path;
+  m_options = options;
+  if (m_options.inputFormat == Format::CS16) {
+    m_options.inputFormat = Format::CF32; // no CS16 sources
+  }
+  // Whole samples only.
+  const uint64_t fileBps = bytesPerSample(m_options.fileFormat);
+  if (m_options.rotateBytes > 0) {
+    m_options.rotateBytes =
+        std::max(fileBps, m_options.rotateBytes - m_options.rotateBytes % fileBps);
+  }
+  m_ring.reset(std::max(kMinQueueBytes,
+                        static_cast<size_t>(options.sampleRate) *
+                            bytesPerSample(m_options.inputFormat) *
+                            kQueueSeconds));
+  m_fatalError = false;
+  m_pendingEvents.clear();
+  m_writerEvents.clear();
+  m_streamSamplesQueued = 0;
+  m_lastQueuedFreqHz = 0;
+  m_fileIndex = 0;
+  m_fileStartSample = 0;
+  m_streamSamplesWritten = 0;
+  m_currentFreqHz = 0;
+  m_dropEventsReported = 0;
+  m_bytesWritten = 0;
+  m_droppedBytes = 0;
+  m_dropEvents = 0;
+  if (!openFile()) {
+    return false;
+  }
+  m_threadRunning = true;
+  m_thread = std::thread(&IqCaptureWriter::runWriterThread, this);
+  return true;
+}
+
+void IqCaptureWriter::shutdown() {
+  if (!m_threadRunning.load() && !m_thread.joinable()) {
+    return;
+  }
+  m_threadRunning = false;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cv.notify_all();
+  }
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+  closeFile();
+  if (m_options.verboseLogging) {
+    std::cout << "[IQ] capture closed: "
+              << (bytesWritten() / bytesPerSample(m_options.fileFormat))
+              << " samples in " << m_fileIndex << " file(s)";
+    if (dropEvents() > 0) {
+      std::cout << ", dropped " << droppedSamples() << " samples ("
+                << dropEvents() << " events)";
+    }
+    std::cout << "\n";
+  }
+}
+
+bool IqCaptureWriter::enqueue(const uint8_t *data, size_t sampleCount,
+                              uint32_t freqHz) {
+  if (m_options.inputFormat != Format::U8 && data &&
+      m_threadRunning.load(std::memory_order_relaxed)) {
+    convertSamples(Format::U8, data, sampleCount, m_options.inputFormat,
+                   m_inputConvert);
+    data = m_inputConvert.data();
+  }
+  return push(data, sampleCount, freqHz);
+}
+
+bool IqCaptureWriter::enqueue(const std::complex<float> *data,
+                              size_t sampleCount, uint32_t freqHz) {
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+  if (m_options.inputFormat != Format::CF32 && data &&
+      m_threadRunning.load(std::memory_order_relaxed)) {
+    convertSamples(Format::CF32, bytes, sampleCount, m_options.inputFormat,
+                   m_inputConvert);
+    bytes = m_inputConvert.data();
+  }
+  return push(bytes, sampleCount, freqHz);
+}
+
+bool IqCaptureWriter::push(const uint8_t *data, size_t sampleCount,
+                           uint32_t freqHz) {
+  if (!m_threadRunning.load(std::memory_order_relaxed) || !data ||
+      sampleCount == 0) {
+    return false;
+  }
+  if (freqHz != m_lastQueuedFreqHz) {
+    std::lock_guard<std::mutex> lock(m_eventMutex);
+    m_pendingEvents.push_back({m_streamSamplesQueued, freqHz});
+    m_lastQueuedFreqHz = freqHz;
+  }
+  const size_t bps = bytesPerSample(m_options.inputFormat);
+  const size_t bytes = sampleCount * bps;
+  const size_t before = m_ring.readAvailable();
+  size_t queued = 0;
+  if (!m_fatalError.load(std::memory_order_relaxed)) {
+    const size_t available = m_ring.writeAvailable();
+    queued = m_ring.write(data, std::min(bytes, available - available % bps));
+  }
+  m_streamSamplesQueued += queued / bps;
+  if (queued < bytes) {
+    m_dropEvents.fetch_add(1, std::memory_order_relaxed);
+    m_droppedBytes.fetch_add(bytes - queued, std::memory_order_relaxed);
+  }
+  // The writer wakes on its own every kFlushInterval; only nudge it when the
+  // queue is filling up faster than that.
+  const size_t halfFull = m_ring.capacity() / 2;
+  if (before < halfFull && before + queued >= halfFull) {
+    m_cv.notify_one();
+  }
+  return queued == bytes;
+}
+
+bool IqCaptureWriter::openFile() {
+  const bool rotating = m_options.rotateBytes > 0 || m_options.rotateSeconds > 0;
+  const std::string path = rotatedPath(m_path, m_fileIndex, rotating);
+  m_fd = openForWrite(path);
+  if (m_fd < 0) {
+    std::cerr << "[IQ] failed to open IQ output file: " << path << " ("
+              << std::strerror(errno) << ")\n";
+    return false;
+  }
+  m_indexHandle = std::fopen((path + ".tunes").c_str(), "w");
+  m_fileBytes = 0;
+  m_filePreallocated = 0;
+  m_fileIndex++;
+  if (m_options.verboseLogging && rotating) {
+    std::cout << "[IQ] writing " << path << "\n";
+  }
+  // Every index starts at offset 0 with the frequency in effect, written
+  // with the first data (a retune landing exactly on the boundary wins).
+  m_indexNeedsHeader = true;
+  return true;
+}
+
+void IqCaptureWriter::closeFile() {
+  if (m_fd >= 0) {
+#if defined(__linux__)
+    // Give back the preallocated tail past the last sample.
+    if (m_filePreallocated > m_fileBytes) {
+      (void)ftruncate(m_fd, static_cast<off_t>(m_fileBytes));
+    }
+#endif
+    closeFd(m_fd);
+    m_fd = -1;
+  }
+  if (m_indexHandle) {
+    std::fclose(m_indexHandle);
+    m_indexHandle = nullptr;
+  }
+}
+
+void IqCaptureWriter::writeTuneEvents(uint64_t streamEnd) {
+  {
+    std::lock_guard<std::mutex> lock(m_eventMutex);
+    m_writerEvents.insert(m_writerEvents.end(), m_pendingEvents.begin(),
+                          m_pendingEvents.end());
+    m_pendingEvents.clear();
+  }
+  auto writeLine = [&](uint64_t offset, uint32_t freqHz) {
+    if (m_indexHandle) {
+      std::fprintf(m_indexHandle, "%llu %u\n",
+                   static_cast<unsigned long long>(offset), freqHz);
+      std::fflush(m_indexHandle);
+    }
+  };
+  size_t done = 0;
+  for (; done < m_writerEvents.size(); done++) {
+    const TuneEvent &event = m_writerEvents[done];
+    if (event.streamSample >= streamEnd) {
+      break;
+    }
+    if (m_indexNeedsHeader && event.streamSample <= m_fileStartSample) {
+      m_currentFreqHz = event.freqHz;
+      continue;
+    }
+    if (m_indexNeedsHeader) {
+      if (m_currentFreqHz != 0) {
+        writeLine(0, m_currentFreqHz);
+      }
+      m_indexNeedsHeader = false;
+    }
+    if (event.freqHz != m_currentFreqHz) {
+      m_currentFreqHz = event.freqHz;
+      writeLine(event.streamSample - m_fileStartSample, event.freqHz);
+    }
+  }
+  m_writerEvents.erase(m_writerEvents.begin(),
+                       m_writerEvents.begin() + static_cast<long>(done));
+  if (m_indexNeedsHeader && m_currentFreqHz != 0) {
+    writeLine(0, m_currentFreqHz);
+    m_indexNeedsHeader = false;
+  }
+}
+
+bool IqCaptureWriter::writeAll(const uint8_t *data, size_t bytes) {
+#if defined(__linux__)
+  if (m_fileBytes + bytes > m_filePreallocated) {
+    uint64_t length = kPreallocateBytes;
+    if (m_options.rotateBytes > 0) {
+      length = std::min(length, m_options.rotateBytes - m_filePreallocated);
+    }
+    length = std::max<uint64_t>(length, bytes);
+    if (fallocate(m_fd, FALLOC_FL_KEEP_SIZE,
+                  static_cast<off_t>(m_filePreallocated),
+                  static_cast<off_t>(length)) == 0) {
+      m_filePreallocated += length;
+    } else {
+      // Unsupported here (tmpfs, NFS, ...): stop asking.
+      m_filePreallocated = UINT64_MAX;
+    }
+  }
+#endif
+  while (bytes > 0) {
+    const long n = writeSome(m_fd, data, std::min(bytes, kBatchBytes));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      std::cerr << "[IQ] capture write failed (" << std::strerror(errno)
+                << "), stopping capture\n";
+      m_fatalError = true;
+      return false;
+    }
+    data += n;
+    bytes -= static_cast<size_t>(n);
+    m_fileBytes += static_cast<uint64_t>(n);
+    m_bytesWritten.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+  }
+  return true;
+}
+
+// bytes of queued input; every ring span holds whole samples because the
+// capacity is a power of two and enqueue() only writes whole samples.
+bool IqCaptureWriter::writeSamples(const uint8_t *data, size_t bytes) {
+  if (m_options.inputFormat == m_options.fileFormat) {
+    return writeChunk(data, bytes);
+  }
+  convertSamples(m_options.inputFormat, data,
+                 bytes / bytesPerSample(m_options.inputFormat),
+                 m_options.fileFormat, m_fileConvert);
+  return writeChunk(m_fileConvert.data(), m_fileConvert.size());
+}
+
+bool IqCaptureWriter::writeChunk(const uint8_t *data, size_t bytes) {
+  const uint64_t bps = bytesPerSample(m_options.fileFormat);
+  const uint64_t rotateBytes = m_options.rotateBytes;
+  const uint64_t rotateTimeBytes =
+      static_cast<uint64_t>(m_options.rotateSeconds) * m_options.sampleRate *
+      bps;
+  while (bytes > 0) {
+    if (m_fd < 0 || m_fatalError.load()) {
+      return false;
+    }
+    uint64_t room = UINT64_MAX;
+    if (rotateBytes > 0) {
+      room = std::min(room, rotateBytes - std::min(rotateBytes, m_fileBytes));
+    }
+    if (rotateTimeBytes > 0) {
+      room = std::min(room,
+                      rotateTimeBytes - std::min(rotateTimeBytes, m_fileBytes));
+    }
+    if (room == 0) {
+      closeFile();
+      m_fileStartSample = m_streamSamplesWritten;
+      if (!openFile()) {
+        m_fatalError = true;
+        return false;
+      }
+      continue;
+    }
+    const size_t chunk = static_cast<size_t>(std::min<uint64_t>(bytes, room));
+    writeTuneEvents(m_streamSamplesWritten + chunk / bps);
+    if (!writeAll(data, chunk)) {
+      return false;
+    }
+    m_streamSamplesWritten += chunk / bps;
+    data += chunk;
+    bytes -= chunk;
+  }
+  return true;
+}
+
+void IqCaptureWriter::drain(size_t minBytes) {
+  while (m_ring.readAvailable() >= std::max<size_t>(minBytes, 1)) {
+    if (m_fatalError.load()) {
+      const size_t lost = m_ring.discardAll();
+      m_droppedBytes.fetch_add(lost, std::memory_order_relaxed);
+      return;
+    }
+    const auto spans = m_ring.peek(kBatchBytes);
+    if (spans.firstCount > 0) {
+      writeSamples(spans.first, spans.firstCount);
+    }
+    if (spans.secondCount > 0) {
+      writeSamples(spans.second, spans.secondCount);
+    }
+    m_ring.discard(spans.size());
+  }
+}
+
+void IqCaptureWriter::reportDrops() {
+  const uint32_t events = m_dropEvents.load(std::memory_order_relaxed);
+  if (events == m_dropEventsReported || !m_options.verboseLogging) {
+    return;
+  }
+  if (events <= 5 || (events / 100) != (m_dropEventsReported / 100)) {
+    std::cerr << "[IQ] capture queue overflow (" << events << " events, "
+              << droppedSamples() << " samples dropped)\n";
+  }
+  m_dropEventsReported = events;
+}
+
+void IqCaptureWriter::runWriterThread() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait_for(lock, kFlushInterval, [&]() {
+        return !m_threadRunning.load() ||
+               m_ring.readAvailable() >= m_ring.capacity() / 2;
+      });
+    }
+    const bool running = m_threadRunning.load();
+    drain(1);
+    reportDrops();
+    if (!running) {
+      break;
+    }
+  }
+}
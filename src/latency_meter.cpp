@@ -0,0 +1,67 @@
+#include "latency_meter.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+LatencyMeter::LatencyMeter(int targetLatencyMs)
+    : m_targetLatencyMs(targetLatencyMs),
+      m_windowStart(std::chrono::steady_clock::now()) {}
+
+void LatencyMeter::addBlock(std::chrono::steady_clock::time_point arrival,
+                            std::chrono::steady_clock::time_point written,
+                            double speakerRingSeconds, double deviceSeconds) {
+  const double iqToOutput = std::max(
+      0.0, std::chrono::duration<double>(written - arrival).count());
+  const double total = iqToOutput + speakerRingSeconds + deviceSeconds;
+  m_blocks++;
+  m_totalSum += total;
+  m_totalMax = std::max(m_totalMax, total);
+  m_iqSum += iqToOutput;
+  m_ringSum += speakerRingSeconds;
+  m_deviceSum += deviceSeconds;
+}
+
+void LatencyMeter::maybeLog(std::chrono::steady_clock::time_point now) {
+  if (now - m_windowStart < kLogInterval) {
+    return;
+  }
+  const Report report = take();
+  m_windowStart = now;
+  if (report.blocks > 0) {
+    std::cout << format(report) << "\n";
+  }
+}
+
+LatencyMeter::Report LatencyMeter::take() {
+  Report report;
+  report.blocks = m_blocks;
+  if (m_blocks > 0) {
+    const double toMs = 1000.0 / static_cast<double>(m_blocks);
+    report.avgMs = m_totalSum * toMs;
+    report.maxMs = m_totalMax * 1000.0;
+    report.iqToOutputMs = m_iqSum * toMs;
+    report.speakerRingMs = m_ringSum * toMs;
+    report.deviceMs = m_deviceSum * toMs;
+  }
+  m_blocks = 0;
+  m_totalSum = 0.0;
+  m_totalMax = 0.0;
+  m_iqSum = 0.0;
+  m_ringSum = 0.0;
+  m_deviceSum = 0.0;
+  return report;
+}
+
+std::string LatencyMeter::format(const Report &report) const {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1) << "[LATENCY] iq->dac avg "
+      << report.avgMs << " ms, max " << report.maxMs << " ms (iq->output "
+      << report.iqToOutputMs << ", speaker ring " << report.speakerRingMs
+      << ", device " << report.deviceMs << ")";
+  if (m_targetLatencyMs > 0) {
+    oss << " target " << m_targetLatencyMs << " ms";
+  }
+  return oss.str();
+}
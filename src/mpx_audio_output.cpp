@@ -160,19 +160,14 @@ bool MpxAudioOutput::enqueueMpx(const float *samples, size_t sampleCount) {
   rsAccum.clear();
 
   if (m_resampleEnabled) {
-    rsAccum.reserve(sampleCount);
-    for (size_t i = 0; i < sampleCount; i++) {
-      const uint32_t produced =
-          m_resampler.execute(samples[i], m_resampleTmp);
-      for (uint32_t p = 0; p < produced; p++) {
-        rsAccum.push_back(m_resampleTmp[p]);
-      }
-    }
-    if (rsAccum.empty()) {
+    rsAccum.resize(m_resampler.maxOutput(sampleCount));
+    const size_t produced =
+        m_resampler.execute(samples, sampleCount, rsAccum.data());
+    if (produced == 0) {
       return true; // resampler hasn't produced anything yet (common downsample)
     }
     samples = rsAccum.data();
-    sampleCount = rsAccum.size();
+    sampleCount = produced;
   }
 
   std::lock_guard<std::mutex> lock(m_mutex);
@@ -359,10 +354,8 @@ bool MpxAudioOutput::init(const std::string &deviceSelector,
   m_resampleEnabled = false;
 
   if (sourceSampleRate != targetSampleRate) {
-    const float ratio =
-        static_cast<float>(targetSampleRate) / static_cast<float>(sourceSampleRate);
     try {
-      m_resampler.init(ratio);
+      m_resampler.init(sourceSampleRate, targetSampleRate);
       m_resampleEnabled = true;
     } catch (const std::exception &ex) {
       std::cerr << "[MPX-AUDIO] resampler init failed: " << ex.what() << "\n";
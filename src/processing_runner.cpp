@@ -42,12 +42,27 @@ bool processAudioBlock(
     AudioOutput &audioOut, WavWriter *mpxWavOut,
     MpxAudioOutput *mpxAudioOut, const std::complex<float> *iqComplex,
     const std::function<void(float, bool, float, float, float, float, float)>
-        &dspTelemetryHook) {
-  SignalLevelResult signal = computeSignalLevel(
-      iqBuffer, samples, effectiveAppliedGainDb, signalGainCompFactor,
-      config.sdr.signal_bias_db, config.sdr.signal_floor_dbfs,
-      config.sdr.signal_ceil_dbfs, iqSampleRate, channelBandwidthHz);
-  SignalLevelResult displaySignal = signal;
+        &dspTelemetryHook,
+    LatencyMeter *latencyMeter, std::chrono::steady_clock::time_point iqArrival) {
+  // samples == 0: end of stream, emit what the pipelined DSP still holds.
+  const bool flushing = samples == 0;
+  SignalLevelResult leaseSignal;
+  if (!flushing) {
+    leaseSignal =
+        (iqComplex != nullptr)
+            ? computeSignalLevel(iqComplex, samples, effectiveAppliedGainDb,
+                                 signalGainCompFactor,
+                                 config.sdr.signal_bias_db,
+                                 config.sdr.signal_floor_dbfs,
+                                 config.sdr.signal_ceil_dbfs, iqSampleRate,
+                                 channelBandwidthHz)
+            : computeSignalLevel(iqBuffer, samples, effectiveAppliedGainDb,
+                                 signalGainCompFactor,
+                                 config.sdr.signal_bias_db,
+                                 config.sdr.signal_floor_dbfs,
+                                 config.sdr.signal_ceil_dbfs, iqSampleRate,
+                                 channelBandwidthHz);
+  }
 
   const bool effectiveForceMono = targetForceMono;
   if (effectiveForceMono != appliedEffectiveForceMono) {
@@ -79,17 +94,27 @@ bool processAudioBlock(
       (void)mpxAudioOut->enqueueMpx(out, count);
     }
   };
-  // SDRplay (and other 16-bit sources) feed the demod the full-precision
-  // complex<float> samples; the uint8 iqBuffer is the quantized shadow used by
-  // the signal meter above. RTL sources pass iqComplex == nullptr and demod
-  // straight from the uint8 buffer.
-  const bool haveDsp =
-      (iqComplex != nullptr)
-          ? dspPipeline.process(iqComplex, samples, rdsSink, dspOut)
-          : dspPipeline.process(iqBuffer, samples, rdsSink, dspOut);
+  // SDRplay (and other CF32 sources) meter and demod the full-precision
+  // complex<float> samples and pass iqBuffer == nullptr. RTL sources pass
+  // iqComplex == nullptr and run everything straight from the uint8 buffer.
+  bool haveDsp = false;
+  if (flushing) {
+    haveDsp = dspPipeline.flush(rdsSink, dspOut);
+  } else if (iqComplex != nullptr) {
+    haveDsp = dspPipeline.process(iqComplex, samples, rdsSink, dspOut,
+                                  iqArrival, leaseSignal);
+  } else {
+    haveDsp = dspPipeline.process(iqBuffer, samples, rdsSink, dspOut,
+                                  iqArrival, leaseSignal);
+  }
   if (!haveDsp) {
     return false;
   }
+  // Metered on the lease this block's audio came from, which in pipelined
+  // mode is pipelineStages() - 1 leases back; auto-gain and the adaptive
+  // bandwidth act on the same block the meter shows.
+  const SignalLevelResult signal = dspOut.signal;
+  SignalLevelResult displaySignal = signal;
 
   if (std::isfinite(dspOut.channelPowerDbfs)) {
     displaySignal.dbfs = dspOut.channelPowerDbfs;
@@ -210,8 +235,7 @@ bool processAudioBlock(
   autoGainHook(signal, clipRatio, rfLevelFiltered);
 
   const size_t outSamples = dspOut.outSamples;
-  float *audioLeft = dspOut.left;
-  float *audioRight = dspOut.right;
+  float *audioFrames = dspOut.audio;
   // When the user has forced mono, the audio we deliver is mono regardless of
   // what the decoder detects on the MPX. Clear the stereo indicator in that
   // case so clients show a coherent "mono" state on both the audio and the
@@ -243,8 +267,8 @@ bool processAudioBlock(
         gain = static_cast<float>(tail) / static_cast<float>(fadeSamples);
       }
       gain = std::clamp(gain, 0.0f, 1.0f);
-      audioLeft[i] *= gain;
-      audioRight[i] *= gain;
+      audioFrames[2 * i] *= gain;
+      audioFrames[2 * i + 1] *= gain;
     }
     retuneMuteSamplesRemaining -= muteCount;
     if (retuneMuteSamplesRemaining == 0) {
@@ -253,7 +277,17 @@ bool processAudioBlock(
   }
 
   if (outSamples > 0) {
-    audioOut.write(audioLeft, audioRight, outSamples);
+    // What is queued ahead of this block: sampled before the write, which
+    // would otherwise count the block itself as ring latency.
+    const double ringAheadSeconds =
+        latencyMeter != nullptr ? audioOut.speakerRingSeconds() : 0.0;
+    audioOut.writeInterleaved(audioFrames, outSamples);
+    if (latencyMeter != nullptr) {
+      const auto now = std::chrono::steady_clock::now();
+      latencyMeter->addBlock(dspOut.arrival, now, ringAheadSeconds,
+                             audioOut.deviceDelaySeconds());
+      latencyMeter->maybeLog(now);
+    }
   }
   return true;
 }
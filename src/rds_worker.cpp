@@ -42,8 +42,14 @@ void RdsWorker::enqueue(const float *samples, size_t count) {
       // Keep continuity for decoder lock; drop newest block under overload.
       return;
     }
-    m_queue.emplace_back(count);
-    std::memcpy(m_queue.back().data(), samples, count * sizeof(float));
+    std::vector<float> buffer;
+    if (!m_spare.empty()) {
+      buffer = std::move(m_spare.back());
+      m_spare.pop_back();
+    }
+    buffer.resize(count);
+    std::memcpy(buffer.data(), samples, count * sizeof(float));
+    m_queue.push_back(std::move(buffer));
   }
   m_cv.notify_one();
 }
@@ -52,6 +58,11 @@ void RdsWorker::requestReset() {
   m_reset = true;
   {
     std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &buffer : m_queue) {
+      if (m_spare.size() < kQueueLimit) {
+        m_spare.push_back(std::move(buffer));
+      }
+    }
     m_queue.clear();
   }
   m_cv.notify_one();
@@ -86,6 +97,10 @@ void RdsWorker::run() {
 
     if (!block.empty()) {
       rds.process(block.data(), block.size(), m_onGroup);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_spare.size() < kQueueLimit) {
+        m_spare.push_back(std::move(block));
+      }
     }
   }
 }
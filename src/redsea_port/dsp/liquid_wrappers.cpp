@@ -250,4 +250,13 @@ std::uint32_t Resampler::execute(float in, std::array<float, kOutputArraySize>&
   return static_cast<std::uint32_t>(num_written);
 }
 
+std::uint32_t Resampler::executeBlock(const float* in, std::uint32_t n, float* out) {
+  // NOLINTNEXTLINE(cppcoreguidelines-init-variables)
+  unsigned num_written;
+  // liquid-dsp never writes the input, it just isn't declared const
+  resamp_rrrf_execute_block(object_, const_cast<float*>(in), n, out, &num_written);
+
+  return static_cast<std::uint32_t>(num_written);
+}
+
 }  // namespace liquid
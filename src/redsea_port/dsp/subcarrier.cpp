@@ -119,28 +119,13 @@ const MPXBuffer& SubcarrierSet::resampleChunk(const MPXBuffer& input_chunk) {
     return input_chunk;
   }
 
-  // ceil(resample_ratio) is enough, as per liquid-dsp's API, but std::ceil is not constexpr in
-  // C++17
-  constexpr std::size_t kMaxResamplerOutputSize = static_cast<std::size_t>(kMaxResampleRatio) + 1;
-  std::array<float, kMaxResamplerOutputSize> resamp_output{};
+  // Fits due to our selection of maximum resampler ratio and extra room in the chunk
+  assert(input_chunk.used_size <= kInputChunkSize);
 
-  std::size_t i_resampled{};
-  for (std::size_t i_input{}; i_input < input_chunk.used_size; i_input++) {
-    const auto num_resampled = resampler_.execute(input_chunk.data[i_input], resamp_output);
-
-    // Always true as per liquid-dsp API
-    assert(num_resampled <= resamp_output.size());
-
-    for (std::uint32_t i_buf{}; i_buf < num_resampled; i_buf++) {
-      // Must always be true due to our selection of maximum resampler ratio and extra room in
-      // the chunk
-      assert(i_resampled < resampled_chunk_.data.size());
-
-      resampled_chunk_.data[i_resampled] = resamp_output[i_buf];
-      i_resampled++;
-    }
-  }
-  resampled_chunk_.used_size = i_resampled;
+  resampled_chunk_.used_size =
+      resampler_.executeBlock(input_chunk.data.data(),
+                              static_cast<std::uint32_t>(input_chunk.used_size),
+                              resampled_chunk_.data.data());
   assert(resampled_chunk_.used_size <= resampled_chunk_.data.size());
 
   return resampled_chunk_;
@@ -6,6 +6,12 @@
 #include <cstring>
 #include <iostream>
 
+namespace {
+// Upper bound on a single read or lease; also the contiguous slack reserved
+// past the end of the IQ ring so a lease never has to be split at the wrap.
+constexpr size_t kMaxReadBytes = 1U << 20;
+} // namespace
+
 #if defined(FM_TUNER_HAS_RTLSDR)
 #include <rtl-sdr.h>
 
@@ -34,8 +40,9 @@ const char *tunerTypeName(enum rtlsdr_tuner tuner) {
 RTLSDRDevice::RTLSDRDevice(uint32_t deviceIndex)
     : m_deviceIndex(deviceIndex), m_connected(false), m_deviceHandle(nullptr),
       m_asyncRunning(false), m_asyncFailed(false),
-      m_iqRing(4U * 1024U * 1024U, 0), m_ringReadPos(0), m_ringWritePos(0),
-      m_ringFull(false), m_lowLatencyMode(false), m_lowLatencyDropEvents(0),
+      m_iqRing(4U * 1024U * 1024U, kMaxReadBytes), m_readerWaiting(false),
+      m_overflowEvents(0), m_overflowBytes(0), m_overflowEventsReported(0),
+      m_lowLatencyMode(false), m_lowLatencyDropEvents(0),
       m_lowLatencyDeadlineEvents(0), m_lowLatencyShortReads(0) {}
 
 RTLSDRDevice::~RTLSDRDevice() { disconnect(); }
@@ -79,12 +86,7 @@ bool RTLSDRDevice::connect() {
   m_deviceHandle = dev;
   m_connected = true;
   m_asyncFailed = false;
-  {
-    std::lock_guard<std::mutex> lock(m_bufferMutex);
-    m_ringReadPos = 0;
-    m_ringWritePos = 0;
-    m_ringFull = false;
-  }
+  m_iqRing.clear();
   m_asyncRunning = true;
   m_asyncThread = std::thread(&RTLSDRDevice::asyncReadLoop, this);
   return true;
@@ -109,12 +111,8 @@ void RTLSDRDevice::disconnect() {
     m_deviceHandle = nullptr;
   }
 #endif
-  {
-    std::lock_guard<std::mutex> lock(m_bufferMutex);
-    m_ringReadPos = 0;
-    m_ringWritePos = 0;
-    m_ringFull = false;
-  }
+  // The async thread has been joined, so nothing is producing any more.
+  m_iqRing.clear();
   m_supportedGains.clear();
   m_connected = false;
 }
@@ -221,27 +219,80 @@ size_t RTLSDRDevice::readIQ(uint8_t *buffer, size_t maxSamples) {
   if (!m_connected || !m_deviceHandle || !buffer || maxSamples == 0) {
     return 0;
   }
-  const size_t requestedBytes = std::min<size_t>(maxSamples * 2, 1U << 20);
+  const size_t requestedBytes = std::min<size_t>(maxSamples * 2, kMaxReadBytes);
+  const size_t bytesToRead = waitForIq(requestedBytes);
+  if (bytesToRead == 0) {
+    return 0;
+  }
+  const size_t bytesRead = m_iqRing.read(buffer, bytesToRead);
+  noteShortRead(bytesRead, requestedBytes);
+  return bytesRead / 2;
+#else
+  (void)buffer;
+  (void)maxSamples;
+  return 0;
+#endif
+}
+
+size_t RTLSDRDevice::leaseIQ(size_t maxSamples, const uint8_t *&data) {
+  data = nullptr;
+#if defined(FM_TUNER_HAS_RTLSDR)
+  if (!m_connected || !m_deviceHandle || maxSamples == 0) {
+    return 0;
+  }
+  const size_t requestedBytes = std::min<size_t>(maxSamples * 2, kMaxReadBytes);
+  const size_t bytesToRead = waitForIq(requestedBytes);
+  if (bytesToRead == 0) {
+    return 0;
+  }
+  size_t leasedBytes = 0;
+  data = m_iqRing.peekContiguous(bytesToRead, leasedBytes);
+  leasedBytes &= ~static_cast<size_t>(1);
+  noteShortRead(leasedBytes, requestedBytes);
+  return leasedBytes / 2;
+#else
+  (void)maxSamples;
+  return 0;
+#endif
+}
+
+void RTLSDRDevice::releaseIQ(size_t samples) {
+#if defined(FM_TUNER_HAS_RTLSDR)
+  m_iqRing.discard(samples * 2);
+#else
+  (void)samples;
+#endif
+}
+
+size_t RTLSDRDevice::waitForIq(size_t requestedBytes) {
   const bool lowLatencyMode = m_lowLatencyMode.load(std::memory_order_relaxed);
-  std::unique_lock<std::mutex> lock(m_bufferMutex);
-  const auto deadline = std::chrono::steady_clock::now() +
-                        std::chrono::milliseconds(lowLatencyMode ? 8 : 35);
   bool hitDeadline = false;
-  while (m_connected && !m_asyncFailed.load()) {
-    const size_t availableNow = availableBytesLocked();
-    if (availableNow >= requestedBytes) {
-      break;
-    }
-    if (availableNow > 0 && std::chrono::steady_clock::now() >= deadline) {
-      hitDeadline = true;
-      break;
-    }
-    if (m_bufferCv.wait_until(lock, deadline) == std::cv_status::timeout) {
-      hitDeadline = true;
-      break;
+  if (m_iqRing.readAvailable() < requestedBytes) {
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(lowLatencyMode ? 8 : 35);
+    std::unique_lock<std::mutex> lock(m_bufferMutex);
+    m_readerWaiting.store(true);
+    // Pairs with the fence in asyncCallback: either the callback sees the
+    // waiting flag and notifies, or this check sees its data.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (m_connected && !m_asyncFailed.load()) {
+      const size_t availableNow = m_iqRing.readAvailable();
+      if (availableNow >= requestedBytes) {
+        break;
+      }
+      if (availableNow > 0 && std::chrono::steady_clock::now() >= deadline) {
+        hitDeadline = true;
+        break;
+      }
+      if (m_bufferCv.wait_until(lock, deadline) == std::cv_status::timeout) {
+        hitDeadline = true;
+        break;
+      }
     }
+    m_readerWaiting.store(false, std::memory_order_relaxed);
   }
-  size_t available = availableBytesLocked();
+  reportOverflows();
+  size_t available = m_iqRing.readAvailable();
   if (available == 0) {
     if (lowLatencyMode && hitDeadline) {
       const uint32_t count =
@@ -257,9 +308,8 @@ size_t RTLSDRDevice::readIQ(uint8_t *buffer, size_t maxSamples) {
     size_t drop = available - requestedBytes;
     drop &= ~static_cast<size_t>(1);
     if (drop > 0) {
-      m_ringReadPos = (m_ringReadPos + drop) % m_iqRing.size();
-      m_ringFull = false;
-      available = availableBytesLocked();
+      m_iqRing.discard(drop);
+      available = m_iqRing.readAvailable();
       const uint32_t count =
           m_lowLatencyDropEvents.fetch_add(1, std::memory_order_relaxed) + 1;
       if (count <= 5 || (count % 100) == 0) {
@@ -270,75 +320,47 @@ size_t RTLSDRDevice::readIQ(uint8_t *buffer, size_t maxSamples) {
   }
   size_t bytesToRead = std::min(available, requestedBytes);
   bytesToRead &= ~static_cast<size_t>(1);
-  if (bytesToRead == 0) {
-    return 0;
-  }
-  size_t outByte = 0;
-  size_t remaining = bytesToRead;
-  while (remaining > 0) {
-    const size_t head = m_iqRing.size() - m_ringReadPos;
-    const size_t chunk = std::min(remaining, head);
-    std::memcpy(buffer + outByte, m_iqRing.data() + m_ringReadPos, chunk);
-    outByte += chunk;
-    remaining -= chunk;
-    m_ringReadPos += chunk;
-    if (m_ringReadPos >= m_iqRing.size()) {
-      m_ringReadPos = 0;
-    }
+  return bytesToRead;
+}
+
+void RTLSDRDevice::noteShortRead(size_t bytesRead, size_t requestedBytes) {
+  if (!m_lowLatencyMode.load(std::memory_order_relaxed) ||
+      bytesRead >= requestedBytes) {
+    return;
   }
-  m_ringFull = false;
-  if (lowLatencyMode && bytesToRead < requestedBytes) {
-    const uint32_t count =
-        m_lowLatencyShortReads.fetch_add(1, std::memory_order_relaxed) + 1;
-    if (count <= 5 || (count % 100) == 0) {
-      std::cerr << "[SDR] low-latency short IQ read: " << bytesToRead / 2 << "/"
-                << requestedBytes / 2 << " samples (" << count << ")\n";
-    }
+  const uint32_t count =
+      m_lowLatencyShortReads.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (count <= 5 || (count % 100) == 0) {
+    std::cerr << "[SDR] low-latency short IQ read: " << bytesRead / 2 << "/"
+              << requestedBytes / 2 << " samples (" << count << ")\n";
   }
-  return outByte / 2;
-#else
-  (void)buffer;
-  (void)maxSamples;
-  return 0;
-#endif
 }
 
 void RTLSDRDevice::flushBuffers() {
 #if defined(FM_TUNER_HAS_RTLSDR)
-  std::lock_guard<std::mutex> lock(m_bufferMutex);
-  m_ringReadPos = m_ringWritePos;
-  m_ringFull = false;
+  m_iqRing.discardAll();
 #endif
 }
 
 void RTLSDRDevice::asyncCallback(unsigned char *buf, uint32_t len, void *ctx) {
 #if defined(FM_TUNER_HAS_RTLSDR)
   auto *self = reinterpret_cast<RTLSDRDevice *>(ctx);
-  if (!self || !buf || len == 0 || self->m_iqRing.empty()) {
+  if (!self || !buf || len == 0 || self->m_iqRing.capacity() == 0) {
     return;
   }
-  std::lock_guard<std::mutex> lock(self->m_bufferMutex);
-  static std::atomic<uint32_t> overflowCount{0};
-  const size_t ringSize = self->m_iqRing.size();
-  for (uint32_t i = 0; i < len; i++) {
-    self->m_iqRing[self->m_ringWritePos] = buf[i];
-    self->m_ringWritePos++;
-    if (self->m_ringWritePos >= ringSize) {
-      self->m_ringWritePos = 0;
-    }
-    if (self->m_ringFull) {
-      self->m_ringReadPos++;
-      if (self->m_ringReadPos >= ringSize) {
-        self->m_ringReadPos = 0;
-      }
-      const uint32_t count = ++overflowCount;
-      if (count <= 5 || (count % 1000) == 0) {
-        std::cerr << "[SDR] IQ ring overflow (" << count << ")\n";
-      }
-    }
-    self->m_ringFull = (self->m_ringWritePos == self->m_ringReadPos);
+  // Transfers are whole IQ pairs and the reader only consumes whole pairs, so
+  // a partial write stays pair-aligned. When the reader has fallen behind the
+  // tail of this transfer is dropped rather than overwriting unread data.
+  const size_t written = self->m_iqRing.write(buf, len);
+  if (written < len) {
+    self->m_overflowEvents.fetch_add(1, std::memory_order_relaxed);
+    self->m_overflowBytes.fetch_add(len - written, std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (self->m_readerWaiting.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(self->m_bufferMutex);
+    self->m_bufferCv.notify_one();
   }
-  self->m_bufferCv.notify_one();
 #else
   (void)buf;
   (void)len;
@@ -355,8 +377,13 @@ void RTLSDRDevice::asyncReadLoop() {
     m_bufferCv.notify_all();
     return;
   }
-  const int rc =
-      rtlsdr_read_async(dev, &RTLSDRDevice::asyncCallback, this, 12, 16384);
+  // A USB transfer only reaches the ring once it is complete, and a 16 KiB
+  // one is 32 ms of IQ at 256 kS/s. Low-latency mode uses quarter-size
+  // transfers, four times as many, so the total buffering stays the same.
+  const bool lowLatency = m_lowLatencyMode.load(std::memory_order_relaxed);
+  const int rc = rtlsdr_read_async(dev, &RTLSDRDevice::asyncCallback, this,
+                                   lowLatency ? 48 : 12,
+                                   lowLatency ? 4096 : 16384);
   if (m_asyncRunning.load() && rc != 0) {
     std::cerr << "[SDR] read_async stopped with error rc=" << rc << "\n";
     m_asyncFailed = true;
@@ -366,12 +393,16 @@ void RTLSDRDevice::asyncReadLoop() {
 #endif
 }
 
-size_t RTLSDRDevice::availableBytesLocked() const {
-  if (m_ringFull) {
-    return m_iqRing.size();
+void RTLSDRDevice::reportOverflows() {
+  // Logged from the reader side so the USB callback never blocks on stderr.
+  const uint32_t events = m_overflowEvents.load(std::memory_order_relaxed);
+  if (events == m_overflowEventsReported) {
+    return;
   }
-  if (m_ringWritePos >= m_ringReadPos) {
-    return m_ringWritePos - m_ringReadPos;
+  if (events <= 5 || (events / 1000) != (m_overflowEventsReported / 1000)) {
+    std::cerr << "[SDR] IQ ring overflow (" << events << " events, "
+              << m_overflowBytes.load(std::memory_order_relaxed) / 2
+              << " samples dropped)\n";
   }
-  return (m_iqRing.size() - m_ringReadPos) + m_ringWritePos;
+  m_overflowEventsReported = events;
 }
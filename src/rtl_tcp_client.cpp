@@ -13,15 +13,32 @@
 #include <sys/types.h>
 #include <unistd.h>
 #endif
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
+#include <cmath>
 #include <cstring>
+#include <iomanip>
 #include <iostream>
 #include <mutex>
+#include <sstream>
 #include <thread>
 
 namespace {
 constexpr uint32_t kRtlTcpMaxTunerType = 6;
 constexpr uint32_t kRtlTcpMaxGainCount = 512;
+// ~2 s of IQ at 1.024 MS/s, or 1 s at 2.048 MS/s: enough to ride out the
+// 20-80 ms jitter of remote links without ever forcing a drop.
+constexpr size_t kIqRingBytes = 4U * 1024U * 1024U;
+// Upper bound on a single read or lease (and the ring's contiguous slack).
+constexpr size_t kMaxReadBytes = 1U << 20;
+// Kernel socket buffer requested for the IQ stream, and the size of each
+// recv() the receive thread issues.
+constexpr int kSocketRecvBufferBytes = 4 * 1024 * 1024;
+constexpr size_t kRecvChunkBytes = 64 * 1024;
+// Receive timeout once streaming, so the thread notices a stop request even
+// when the server has gone quiet.
+constexpr int kStreamRecvTimeoutMs = 200;
 
 void closeSocket(int sock) {
 #if defined(_WIN32)
@@ -55,6 +72,23 @@ bool socketWouldBlock(int err) {
 #endif
 }
 
+void setRecvBufferBytes(int sock, int bytes) {
+#if defined(_WIN32)
+  setsockopt(static_cast<SOCKET>(sock), SOL_SOCKET, SO_RCVBUF,
+             reinterpret_cast<const char *>(&bytes), sizeof(bytes));
+#else
+  setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes));
+#endif
+}
+
+void shutdownSocket(int sock) {
+#if defined(_WIN32)
+  shutdown(static_cast<SOCKET>(sock), SD_BOTH);
+#else
+  shutdown(sock, SHUT_RDWR);
+#endif
+}
+
 void setRecvTimeoutMs(int sock, int timeoutMs) {
 #if defined(_WIN32)
   const DWORD timeout = timeoutMs > 0 ? static_cast<DWORD>(timeoutMs) : 0;
@@ -110,12 +144,19 @@ bool validateRtlTcpHeader(const uint8_t *header) {
 
 RTLTCPClient::RTLTCPClient(const std::string &host, uint16_t port)
     : m_host(host), m_port(port), m_socket(-1), m_connected(false),
-      m_frequency(0), m_sampleRate(1024000), m_havePendingIqByte(false),
-      m_pendingIqByte(0) {}
+      m_frequency(0), m_sampleRate(1024000),
+      m_iqRing(kIqRingBytes, kMaxReadBytes), m_rxRunning(false),
+      m_rxFailed(false), m_readerWaiting(false), m_bytesReceived(0),
+      m_overflowEvents(0), m_overflowBytes(0), m_underrunReads(0),
+      m_jitterUs(0), m_maxGapUs(0), m_peakOccupancy(0),
+      m_overflowEventsReported(0), m_verboseLogging(false) {}
 
 RTLTCPClient::~RTLTCPClient() { disconnect(); }
 
 bool RTLTCPClient::connect() {
+  // Reconnect path: stop the previous receive thread before reusing members.
+  disconnect();
+
   if (!ensureSocketSubsystem()) {
     std::cerr << "Failed to initialize socket subsystem" << "\n";
     return false;
@@ -178,19 +219,42 @@ bool RTLTCPClient::connect() {
     return false;
   }
 
-  setRecvTimeoutMs(m_socket, 2000);
-  m_havePendingIqByte = false;
+  // Deep kernel buffer so TCP keeps its window open through our own
+  // scheduling hiccups; the receive thread drains it into the IQ ring.
+  setRecvBufferBytes(m_socket, kSocketRecvBufferBytes);
+  setRecvTimeoutMs(m_socket, kStreamRecvTimeoutMs);
+  m_iqRing.clear();
+  m_bytesReceived = 0;
+  m_overflowEvents = 0;
+  m_overflowBytes = 0;
+  m_underrunReads = 0;
+  m_jitterUs = 0;
+  m_maxGapUs = 0;
+  m_peakOccupancy = 0;
+  m_overflowEventsReported = 0;
+  m_lastStatsLog = std::chrono::steady_clock::now();
+  m_rxFailed = false;
   m_connected = true;
+  m_rxRunning = true;
+  m_rxThread = std::thread(&RTLTCPClient::receiveLoop, this);
   return true;
 }
 
 void RTLTCPClient::disconnect() {
+  m_rxRunning = false;
+  if (m_socket >= 0) {
+    // Wakes a recv() blocked in the receive thread.
+    shutdownSocket(m_socket);
+  }
+  if (m_rxThread.joinable()) {
+    m_rxThread.join();
+  }
   if (m_socket >= 0) {
     closeSocket(m_socket);
     m_socket = -1;
   }
   m_connected = false;
-  m_havePendingIqByte = false;
+  m_iqRing.clear();
 }
 
 bool RTLTCPClient::sendAll(const uint8_t *data, size_t len) {
@@ -239,50 +303,183 @@ bool RTLTCPClient::readResponse(uint8_t *buffer, size_t len) {
   return true;
 }
 
-size_t RTLTCPClient::readIQ(uint8_t *buffer, size_t maxSamples) {
-  if (!m_connected || m_socket < 0) {
-    return 0;
-  }
-
-  size_t bytesToRead = maxSamples * 2;
-  if (bytesToRead == 0) {
-    return 0;
-  }
-  size_t totalRead = 0;
-  if (m_havePendingIqByte) {
-    buffer[0] = m_pendingIqByte;
-    m_havePendingIqByte = false;
-    totalRead = 1;
-  }
-
-  while (totalRead < bytesToRead) {
-    const auto n = recv(m_socket, reinterpret_cast<char *>(buffer + totalRead),
-                        static_cast<int>(bytesToRead - totalRead), 0);
+void RTLTCPClient::receiveLoop() {
+  std::vector<uint8_t> chunk(kRecvChunkBytes);
+  // rtl_tcp is a byte stream, so a recv() can end mid IQ pair. Only whole
+  // pairs go into the ring; an odd trailing byte is carried to the next read.
+  size_t carry = 0;
+  auto lastArrival = std::chrono::steady_clock::now();
+  double jitterUs = 0.0;
+  while (m_rxRunning.load(std::memory_order_relaxed)) {
+    const auto n = recv(m_socket, reinterpret_cast<char *>(chunk.data() + carry),
+                        static_cast<int>(chunk.size() - carry), 0);
     if (n > 0) {
-      totalRead += static_cast<size_t>(n);
+      const auto now = std::chrono::steady_clock::now();
+      const double gapUs =
+          std::chrono::duration<double, std::micro>(now - lastArrival).count();
+      lastArrival = now;
+      const double rate = static_cast<double>(std::max<uint32_t>(1, m_sampleRate));
+      const double expectedUs = static_cast<double>(n) / (2.0 * rate) * 1e6;
+      jitterUs += (std::fabs(gapUs - expectedUs) - jitterUs) / 16.0;
+      m_jitterUs.store(static_cast<uint32_t>(jitterUs), std::memory_order_relaxed);
+      if (gapUs > static_cast<double>(m_maxGapUs.load(std::memory_order_relaxed))) {
+        m_maxGapUs.store(static_cast<uint32_t>(gapUs), std::memory_order_relaxed);
+      }
+      m_bytesReceived.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+
+      const size_t total = carry + static_cast<size_t>(n);
+      const size_t whole = total & ~static_cast<size_t>(1);
+      const size_t written = m_iqRing.write(chunk.data(), whole);
+      if (written < whole) {
+        m_overflowEvents.fetch_add(1, std::memory_order_relaxed);
+        m_overflowBytes.fetch_add(whole - written, std::memory_order_relaxed);
+      }
+      carry = total - whole;
+      if (carry > 0) {
+        chunk[0] = chunk[total - 1];
+      }
+      const size_t occupancy = m_iqRing.readAvailable();
+      if (occupancy > m_peakOccupancy.load(std::memory_order_relaxed)) {
+        m_peakOccupancy.store(occupancy, std::memory_order_relaxed);
+      }
+      // Pairs with the fence in waitForIq (see RTLSDRDevice::asyncCallback).
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (m_readerWaiting.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(m_bufferMutex);
+        m_bufferCv.notify_one();
+      }
       continue;
     }
     if (n == 0) {
-      m_connected = false;
+      if (m_rxRunning.load(std::memory_order_relaxed)) {
+        std::cerr << "[RTL_TCP] server closed the IQ stream\n";
+        m_rxFailed = true;
+      }
       break;
     }
     const int err = lastSocketError();
-    if (socketInterrupted(err)) {
+    if (socketInterrupted(err) || socketWouldBlock(err)) {
       continue;
     }
-    if (socketWouldBlock(err)) {
-      break;
+    if (m_rxRunning.load(std::memory_order_relaxed)) {
+      std::cerr << "[RTL_TCP] IQ receive failed (error " << err << ")\n";
+      m_rxFailed = true;
     }
     break;
   }
+  m_connected = false;
+  std::lock_guard<std::mutex> lock(m_bufferMutex);
+  m_bufferCv.notify_all();
+}
+
+size_t RTLTCPClient::waitForIq(size_t requestedBytes) {
+  if (m_iqRing.readAvailable() < requestedBytes) {
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(35);
+    std::unique_lock<std::mutex> lock(m_bufferMutex);
+    m_readerWaiting.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (m_rxRunning && !m_rxFailed.load() && m_connected) {
+      const size_t availableNow = m_iqRing.readAvailable();
+      if (availableNow >= requestedBytes) {
+        break;
+      }
+      if (m_bufferCv.wait_until(lock, deadline) == std::cv_status::timeout) {
+        break;
+      }
+    }
+    m_readerWaiting.store(false, std::memory_order_relaxed);
+  }
+  reportReceiveEvents();
+  const size_t available = m_iqRing.readAvailable();
+  if (available == 0 && m_connected) {
+    const uint32_t count =
+        m_underrunReads.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (count <= 5 || (count % 100) == 0) {
+      std::cerr << "[RTL_TCP] IQ ring underrun (" << count << ", jitter "
+                << m_jitterUs.load(std::memory_order_relaxed) / 1000.0
+                << " ms, max gap "
+                << m_maxGapUs.load(std::memory_order_relaxed) / 1000.0
+                << " ms)\n";
+    }
+  }
+  return std::min(available, requestedBytes) & ~static_cast<size_t>(1);
+}
+
+void RTLTCPClient::reportReceiveEvents() {
+  if (m_verboseLogging) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastStatsLog >= kStatsLogInterval) {
+      m_lastStatsLog = now;
+      std::cout << formatReceiveStats(receiveStats()) << "\n";
+    }
+  }
+  const uint32_t events = m_overflowEvents.load(std::memory_order_relaxed);
+  if (events == m_overflowEventsReported) {
+    return;
+  }
+  if (events <= 5 || (events / 1000) != (m_overflowEventsReported / 1000)) {
+    std::cerr << "[RTL_TCP] IQ ring overflow (" << events << " events, "
+              << m_overflowBytes.load(std::memory_order_relaxed) / 2
+              << " samples dropped)\n";
+  }
+  m_overflowEventsReported = events;
+}
+
+size_t RTLTCPClient::readIQ(uint8_t *buffer, size_t maxSamples) {
+  if (!buffer || maxSamples == 0 || !m_rxThread.joinable()) {
+    return 0;
+  }
+  const size_t requestedBytes = std::min<size_t>(maxSamples * 2, kMaxReadBytes);
+  const size_t bytesToRead = waitForIq(requestedBytes);
+  if (bytesToRead == 0) {
+    return 0;
+  }
+  return m_iqRing.read(buffer, bytesToRead) / 2;
+}
 
-  if ((totalRead & 1u) != 0u) {
-    m_pendingIqByte = buffer[totalRead - 1];
-    m_havePendingIqByte = true;
-    totalRead--;
+size_t RTLTCPClient::leaseIQ(size_t maxSamples, const uint8_t *&data) {
+  data = nullptr;
+  if (maxSamples == 0 || !m_rxThread.joinable()) {
+    return 0;
+  }
+  const size_t requestedBytes = std::min<size_t>(maxSamples * 2, kMaxReadBytes);
+  const size_t bytesToRead = waitForIq(requestedBytes);
+  if (bytesToRead == 0) {
+    return 0;
   }
+  size_t leasedBytes = 0;
+  data = m_iqRing.peekContiguous(bytesToRead, leasedBytes);
+  return (leasedBytes & ~static_cast<size_t>(1)) / 2;
+}
+
+void RTLTCPClient::releaseIQ(size_t samples) { m_iqRing.discard(samples * 2); }
+
+void RTLTCPClient::flushBuffers() { m_iqRing.discardAll(); }
+
+RTLTCPClient::ReceiveStats RTLTCPClient::receiveStats() const {
+  ReceiveStats stats;
+  stats.bytesReceived = m_bytesReceived.load(std::memory_order_relaxed);
+  stats.overflowEvents = m_overflowEvents.load(std::memory_order_relaxed);
+  stats.overflowBytes = m_overflowBytes.load(std::memory_order_relaxed);
+  stats.underrunReads = m_underrunReads.load(std::memory_order_relaxed);
+  stats.jitterMs = m_jitterUs.load(std::memory_order_relaxed) / 1000.0;
+  stats.maxGapMs = m_maxGapUs.load(std::memory_order_relaxed) / 1000.0;
+  stats.occupancyBytes = m_iqRing.readAvailable();
+  stats.peakOccupancyBytes = m_peakOccupancy.load(std::memory_order_relaxed);
+  stats.capacityBytes = m_iqRing.capacity();
+  return stats;
+}
 
-  return totalRead / 2;
+std::string RTLTCPClient::formatReceiveStats(const ReceiveStats &stats) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(1) << "[RTL_TCP] ring "
+      << stats.occupancyBytes / 1024 << "/" << stats.capacityBytes / 1024
+      << " KB (peak " << stats.peakOccupancyBytes / 1024 << " KB), jitter "
+      << stats.jitterMs << " ms, max gap " << stats.maxGapMs << " ms, "
+      << stats.underrunReads << " underruns, " << stats.overflowEvents
+      << " overflows";
+  return out.str();
 }
 
 bool RTLTCPClient::setFrequency(uint32_t freqHz) {
@@ -101,7 +101,7 @@ sdrplay_api_Bw_MHzT bwForHz(int hz) {
 
 } // namespace
 
-SDRplayDevice::SDRplayDevice(uint32_t) { m_ring.resize(1 << 18); }
+SDRplayDevice::SDRplayDevice(uint32_t) { m_ring.reset(1 << 18, 1 << 16); }
 SDRplayDevice::~SDRplayDevice() { disconnect(); }
 
 bool SDRplayDevice::apiAvailable() {
@@ -188,11 +188,7 @@ bool SDRplayDevice::connect() {
                modelName(), g_device.SerNo, apiVer, kFsHz / 1e6, kDecim,
                m_inputRate, antennaCount(), rx->tunerParams.gain.LNAstate);
   m_handle = g_device.dev;
-  {
-    std::lock_guard<std::mutex> lk(m_mutex);
-    m_readPos = m_writePos = 0;
-    m_full = false;
-  }
+  m_ring.discardAll();
   m_connected.store(true, std::memory_order_relaxed);
   m_failed.store(false, std::memory_order_relaxed);
   return true;
@@ -300,11 +296,7 @@ bool SDRplayDevice::setScanWideMode(bool wide) {
                sdrplay_api_Update_Ext1_None) == sdrplay_api_Success;
   m_inputRate =
       wide ? static_cast<int>(kFsHz) : static_cast<int>(kFsHz / kDecim);
-  {
-    std::lock_guard<std::mutex> lk(m_mutex);
-    m_readPos = m_writePos = 0;
-    m_full = false;
-  }
+  m_ring.discardAll();
   return okDecim && okBw;
 }
 
@@ -344,48 +336,37 @@ bool SDRplayDevice::setBiasTee(bool enable) {
 void SDRplayDevice::ingest(const short *xi, const short *xq, unsigned int n,
                            bool reset) {
   if (!xi || !xq || n == 0) return;
-  std::lock_guard<std::mutex> lk(m_mutex);
-  const size_t cap = m_ring.size();
   // On a retune the API raises `reset`; drop the buffered old-frequency IQ so
   // the new station is heard immediately instead of after the ring drains.
-  if (reset) {
-    m_readPos = m_writePos = 0;
-    m_full = false;
+  if (reset) m_flushMark.store(m_ring.totalWritten(), std::memory_order_release);
+  constexpr unsigned int kChunk = 512;
+  std::complex<float> chunk[kChunk];
+  for (unsigned int done = 0; done < n;) {
+    const unsigned int len = std::min(n - done, kChunk);
+    for (unsigned int i = 0; i < len; i++) {
+      chunk[i] = std::complex<float>(xi[done + i] / 32768.0f, xq[done + i] / 32768.0f);
+    }
+    // Ring full (reader stalled for ~1 s): drop the rest of this callback
+    // rather than overwrite samples the reader may have leased.
+    if (m_ring.write(chunk, len) < len) break;
+    done += len;
   }
-  for (unsigned int i = 0; i < n; i++) {
-    m_ring[m_writePos] = std::complex<float>(xi[i] / 32768.0f, xq[i] / 32768.0f);
-    m_writePos = (m_writePos + 1) % cap;
-    if (m_full) m_readPos = (m_readPos + 1) % cap; // overwrite oldest
-    if (m_writePos == m_readPos) m_full = true;
+  // Pairs with the fence in waitForSamples (see RTLSDRDevice::asyncCallback).
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_readerWaiting.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_cv.notify_one();
   }
-  m_cv.notify_one();
 }
 
-size_t SDRplayDevice::drainLocked(std::complex<float> *out, size_t maxSamples) {
-  const size_t cap = m_ring.size();
-  auto avail = [&]() -> size_t {
-    if (m_full) return cap;
-    return (m_writePos + cap - m_readPos) % cap;
-  };
-  if (avail() == 0) {
-    return 0;
-  }
-  size_t got = std::min(maxSamples, avail());
-  for (size_t i = 0; i < got; i++) {
-    out[i] = m_ring[m_readPos];
-    m_readPos = (m_readPos + 1) % cap;
-  }
-  if (got > 0) m_full = false;
-  return got;
+void SDRplayDevice::applyPendingFlush() {
+  const size_t mark = m_flushMark.load(std::memory_order_acquire);
+  const size_t read = m_ring.totalRead();
+  if (mark > read) m_ring.discard(mark - read);
 }
 
-size_t SDRplayDevice::readIQ(std::complex<float> *out, size_t maxSamples) {
-  if (!out || maxSamples == 0) return 0;
-  std::unique_lock<std::mutex> lk(m_mutex);
-  const size_t cap = m_ring.size();
-  auto avail = [&]() -> size_t {
-    return m_full ? cap : (m_writePos + cap - m_readPos) % cap;
-  };
+size_t SDRplayDevice::waitForSamples(size_t wanted) {
+  applyPendingFlush();
   // Wait until a full block has accumulated (bounded by a ceiling). A tiny
   // partial read is harmless for the steady-state audio path, but it starves
   // the spectral scan: each scan retune raises the SDRplay `reset` flag and
@@ -396,13 +377,37 @@ size_t SDRplayDevice::readIQ(std::complex<float> *out, size_t maxSamples) {
   // ~32 ms for an 8192-sample block at 256 kHz) keeps captures whole and the
   // scan prompt; the predicate returns early in steady state so this adds no
   // latency once the stream is flowing.
-  if (avail() < maxSamples) {
-    m_cv.wait_for(lk, std::chrono::milliseconds(250),
-                  [&] { return avail() >= maxSamples; });
+  if (m_ring.readAvailable() < wanted) {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_readerWaiting.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_cv.wait_for(lk, std::chrono::milliseconds(250), [&] {
+      applyPendingFlush();
+      return m_ring.readAvailable() >= wanted;
+    });
+    m_readerWaiting.store(false, std::memory_order_relaxed);
   }
-  return drainLocked(out, maxSamples);
+  return std::min(wanted, m_ring.readAvailable());
+}
+
+size_t SDRplayDevice::readIQ(std::complex<float> *out, size_t maxSamples) {
+  if (!out || maxSamples == 0) return 0;
+  const size_t got = waitForSamples(maxSamples);
+  return got > 0 ? m_ring.read(out, got) : 0;
+}
+
+size_t SDRplayDevice::leaseIQ(size_t maxSamples, const std::complex<float> *&data) {
+  data = nullptr;
+  if (maxSamples == 0) return 0;
+  const size_t got = waitForSamples(maxSamples);
+  if (got == 0) return 0;
+  size_t leased = 0;
+  data = m_ring.peekContiguous(got, leased);
+  return leased;
 }
 
+void SDRplayDevice::releaseIQ(size_t samples) { m_ring.discard(samples); }
+
 size_t SDRplayDevice::readIQ(uint8_t *out, size_t maxSamples) {
   if (!out || maxSamples == 0) return 0;
   static thread_local std::vector<std::complex<float>> tmp;
@@ -441,8 +446,12 @@ bool SDRplayDevice::setBiasTee(bool) { return false; }
 int SDRplayDevice::antennaCount() const { return 1; }
 const char *SDRplayDevice::modelName() const { return "RSP"; }
 void SDRplayDevice::ingest(const short *, const short *, unsigned int, bool) {}
-size_t SDRplayDevice::drainLocked(std::complex<float> *, size_t) { return 0; }
 size_t SDRplayDevice::readIQ(std::complex<float> *, size_t) { return 0; }
 size_t SDRplayDevice::readIQ(uint8_t *, size_t) { return 0; }
+size_t SDRplayDevice::leaseIQ(size_t, const std::complex<float> *&data) {
+  data = nullptr;
+  return 0;
+}
+void SDRplayDevice::releaseIQ(size_t) {}
 
 #endif
@@ -1,23 +1,15 @@
 #include "signal_level.h"
 
-#include "cpu_features.h"
 #include "dsp/iq_saturation.h"
+#include "dsp/kernel_registry.h"
 #include "dsp/liquid_primitives.h"
+#include "dsp/simd_target.h"
 #include <algorithm>
 #include <array>
 #include <cmath>
 #include <complex>
 #include <vector>
 
-#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||             \
-    defined(_M_IX86)
-#include <immintrin.h>
-#endif
-
-#if defined(__aarch64__) || defined(__arm__) || defined(_M_ARM64)
-#include <arm_neon.h>
-#endif
-
 namespace {
 
 constexpr float kPi = 3.14159265358979323846f;
@@ -26,134 +18,6 @@ constexpr double kPowerFloor = 1e-20;
 constexpr double kSignalLevelSnrGateDb = 3.0;
 constexpr double kSignalLevelSnrCeilDb = 30.0;
 
-#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||             \
-    defined(_M_IX86)
-#if defined(__has_attribute)
-#if __has_attribute(target)
-#define SIGLEV_HAS_AVX2 1
-#define SIGLEV_AVX2_TARGET __attribute__((target("avx2,fma")))
-#endif
-#elif defined(__GNUC__)
-#define SIGLEV_HAS_AVX2 1
-#define SIGLEV_AVX2_TARGET __attribute__((target("avx2,fma")))
-#endif
-#if !defined(SIGLEV_HAS_AVX2) && defined(_MSC_VER) && defined(__AVX2__)
-#define SIGLEV_HAS_AVX2 1
-#define SIGLEV_AVX2_TARGET
-#endif
-#endif
-
-#ifndef SIGLEV_HAS_AVX2
-#define SIGLEV_HAS_AVX2 0
-#define SIGLEV_AVX2_TARGET
-#endif
-
-double computeNormalizedIqPowerSumScalar(const uint8_t *iq, size_t count,
-                                         const float *lut) {
-  double powerSum = 0.0;
-  size_t i = 0;
-  for (; i + 4 <= count; i += 4) {
-    powerSum += lut[iq[i]];
-    powerSum += lut[iq[i + 1]];
-    powerSum += lut[iq[i + 2]];
-    powerSum += lut[iq[i + 3]];
-  }
-  for (; i < count; i++) {
-    powerSum += lut[iq[i]];
-  }
-  return powerSum;
-}
-
-#if SIGLEV_HAS_AVX2
-SIGLEV_AVX2_TARGET double computeNormalizedIqPowerSumAvx2(const uint8_t *iq,
-                                                          size_t count,
-                                                          const float *lut) {
-  __m256 acc = _mm256_setzero_ps();
-  size_t i = 0;
-  for (; i + 8 <= count; i += 8) {
-    const __m128i b8 =
-        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(iq + i));
-    const __m256i idx = _mm256_cvtepu8_epi32(b8);
-    const __m256 vals = _mm256_i32gather_ps(lut, idx, 4);
-    acc = _mm256_add_ps(acc, vals);
-  }
-  alignas(32) float lanes[8];
-  _mm256_store_ps(lanes, acc);
-  double powerSum = lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] +
-                    lanes[5] + lanes[6] + lanes[7];
-  for (; i < count; i++) {
-    powerSum += lut[iq[i]];
-  }
-  return powerSum;
-}
-#endif
-
-#if defined(__aarch64__) || defined(__arm__) || defined(_M_ARM64)
-double computeNormalizedIqPowerSumNeon(const uint8_t *iq, size_t count) {
-  const float32x4_t vMid = vdupq_n_f32(127.0f);
-  const float32x4_t vInv = vdupq_n_f32(1.0f / 127.5f);
-  float32x4_t acc = vdupq_n_f32(0.0f);
-  size_t i = 0;
-  for (; i + 16 <= count; i += 16) {
-    const uint8x16_t v = vld1q_u8(iq + i);
-    const uint16x8_t lo16 = vmovl_u8(vget_low_u8(v));
-    const uint16x8_t hi16 = vmovl_u8(vget_high_u8(v));
-    const uint32x4_t lo32a = vmovl_u16(vget_low_u16(lo16));
-    const uint32x4_t lo32b = vmovl_u16(vget_high_u16(lo16));
-    const uint32x4_t hi32a = vmovl_u16(vget_low_u16(hi16));
-    const uint32x4_t hi32b = vmovl_u16(vget_high_u16(hi16));
-    float32x4_t f0 = vcvtq_f32_u32(lo32a);
-    float32x4_t f1 = vcvtq_f32_u32(lo32b);
-    float32x4_t f2 = vcvtq_f32_u32(hi32a);
-    float32x4_t f3 = vcvtq_f32_u32(hi32b);
-    f0 = vmulq_f32(vsubq_f32(f0, vMid), vInv);
-    f1 = vmulq_f32(vsubq_f32(f1, vMid), vInv);
-    f2 = vmulq_f32(vsubq_f32(f2, vMid), vInv);
-    f3 = vmulq_f32(vsubq_f32(f3, vMid), vInv);
-    acc = vaddq_f32(acc, vmulq_f32(f0, f0));
-    acc = vaddq_f32(acc, vmulq_f32(f1, f1));
-    acc = vaddq_f32(acc, vmulq_f32(f2, f2));
-    acc = vaddq_f32(acc, vmulq_f32(f3, f3));
-  }
-#if defined(__aarch64__)
-  double powerSum = static_cast<double>(vaddvq_f32(acc));
-#else
-  float tmp[4];
-  vst1q_f32(tmp, acc);
-  double powerSum = tmp[0] + tmp[1] + tmp[2] + tmp[3];
-#endif
-  for (; i < count; i++) {
-    const float norm = (static_cast<float>(iq[i]) - 127.0f) * (1.0f / 127.5f);
-    powerSum += static_cast<double>(norm * norm);
-  }
-  return powerSum;
-}
-#endif
-
-double computeNormalizedIqPowerSum(const uint8_t *iq, size_t samples) {
-  static const std::array<float, 256> kNormSqLut = []() {
-    std::array<float, 256> lut{};
-    for (int v = 0; v < 256; v++) {
-      const float norm = (static_cast<float>(v) - 127.0f) / 127.5f;
-      lut[static_cast<size_t>(v)] = norm * norm;
-    }
-    return lut;
-  }();
-  const size_t count = samples * 2;
-  static const CPUFeatures cpu = detectCPUFeatures();
-#if SIGLEV_HAS_AVX2
-  if (cpu.avx2 && cpu.fma) {
-    return computeNormalizedIqPowerSumAvx2(iq, count, kNormSqLut.data());
-  }
-#endif
-#if defined(__aarch64__) || defined(__arm__) || defined(_M_ARM64)
-  if (cpu.neon) {
-    return computeNormalizedIqPowerSumNeon(iq, count);
-  }
-#endif
-  return computeNormalizedIqPowerSumScalar(iq, count, kNormSqLut.data());
-}
-
 size_t nearestPow2(size_t n) {
   size_t p = 1;
   while ((p << 1U) <= n) {
@@ -197,12 +61,14 @@ struct SignalMeterFftCache {
   fftplan plan = nullptr;
 };
 
-ChannelPowerEstimate estimateCenteredChannelPower(const uint8_t *iq,
-                                                  size_t samples,
+// load(i) returns sample i normalized to [-1, 1].
+template <typename LoadSample>
+ChannelPowerEstimate estimateCenteredChannelPower(size_t samples,
                                                   uint32_t sampleRateHz,
-                                                  int channelBandwidthHz) {
+                                                  int channelBandwidthHz,
+                                                  LoadSample load) {
   ChannelPowerEstimate out{};
-  if (!iq || samples == 0 || sampleRateHz == 0 || channelBandwidthHz <= 0) {
+  if (samples == 0 || sampleRateHz == 0 || channelBandwidthHz <= 0) {
     return out;
   }
 
@@ -237,17 +103,17 @@ ChannelPowerEstimate estimateCenteredChannelPower(const uint8_t *iq,
   double meanI = 0.0;
   double meanQ = 0.0;
   for (size_t i = 0; i < nfft; i++) {
-    meanI += (static_cast<int>(iq[i * 2]) - 127.5) * (1.0 / 127.5);
-    meanQ += (static_cast<int>(iq[i * 2 + 1]) - 127.5) * (1.0 / 127.5);
+    const std::complex<double> v = load(i);
+    meanI += v.real();
+    meanQ += v.imag();
   }
   meanI /= static_cast<double>(nfft);
   meanQ /= static_cast<double>(nfft);
 
   for (size_t i = 0; i < nfft; i++) {
-    const float iRaw = static_cast<float>(
-        (static_cast<int>(iq[i * 2]) - 127.5) * (1.0 / 127.5) - meanI);
-    const float qRaw = static_cast<float>(
-        (static_cast<int>(iq[i * 2 + 1]) - 127.5) * (1.0 / 127.5) - meanQ);
+    const std::complex<double> v = load(i);
+    const float iRaw = static_cast<float>(v.real() - meanI);
+    const float qRaw = static_cast<float>(v.imag() - meanQ);
     const float w = 0.5f - 0.5f * std::cos((2.0f * kPi * static_cast<float>(i)) /
                                            static_cast<float>(nfft - 1));
     cache.fftIn[i] = {iRaw * w, qRaw * w};
@@ -310,44 +176,192 @@ ChannelPowerEstimate estimateCenteredChannelPower(const uint8_t *iq,
   return out;
 }
 
-SignalLevelResult computeWidebandSignalLevel(const uint8_t *iq, size_t samples) {
-  SignalLevelResult out{};
-  if (!iq || samples == 0) {
-    return out;
-  }
-
+// Raw first/second moments and clip counts of one block; counts are in IQ
+// values (a clipped sample counts for both of its components).
+struct IqMoments {
   double sumI = 0.0;
   double sumQ = 0.0;
   double sumII = 0.0;
   double sumQQ = 0.0;
   size_t hardClipCount = 0;
   size_t nearClipCount = 0;
+};
 
+IqMoments accumulateIqMoments(const uint8_t *iq, size_t samples) {
+  using namespace fm_tuner::dsp;
+  IqMoments m{};
   for (size_t s = 0; s < samples; s++) {
     const uint8_t iByte = iq[2 * s];
     const uint8_t qByte = iq[2 * s + 1];
     const double iNorm = (static_cast<double>(iByte) - 127.5) * (1.0 / 127.5);
     const double qNorm = (static_cast<double>(qByte) - 127.5) * (1.0 / 127.5);
 
-    sumI += iNorm;
-    sumQ += qNorm;
-    sumII += iNorm * iNorm;
-    sumQQ += qNorm * qNorm;
+    m.sumI += iNorm;
+    m.sumQ += qNorm;
+    m.sumII += iNorm * iNorm;
+    m.sumQQ += qNorm * qNorm;
+
+    if (isRtlSdrIqByteSaturated(iByte) || isRtlSdrIqByteSaturated(qByte)) {
+      m.hardClipCount += 2;
+    }
+    if (iByte <= kRtlSdrIqLowNearClip || iByte >= kRtlSdrIqHighNearClip ||
+        qByte <= kRtlSdrIqLowNearClip || qByte >= kRtlSdrIqHighNearClip) {
+      m.nearClipCount += 2;
+    }
+  }
+  return m;
+}
 
-    if (fm_tuner::dsp::isRtlSdrIqByteSaturated(iByte) ||
-        fm_tuner::dsp::isRtlSdrIqByteSaturated(qByte)) {
-      hardClipCount += 2;
+void accumulateIqMomentsScalar(const std::complex<float> *iq, size_t samples,
+                               IqMoments &m) {
+  using namespace fm_tuner::dsp;
+  for (size_t s = 0; s < samples; s++) {
+    const double iNorm = iq[s].real();
+    const double qNorm = iq[s].imag();
+    m.sumI += iNorm;
+    m.sumQ += qNorm;
+    m.sumII += iNorm * iNorm;
+    m.sumQQ += qNorm * qNorm;
+    const float peak = std::max(std::fabs(iq[s].real()), std::fabs(iq[s].imag()));
+    if (peak >= kCf32IqSaturated) {
+      m.hardClipCount += 2;
     }
-    if (iByte <= 8 || iByte >= 247 || qByte <= 8 || qByte >= 247) {
-      nearClipCount += 2;
+    if (peak >= kCf32IqNearClip) {
+      m.nearClipCount += 2;
     }
   }
+}
 
+// The SIMD kernels sum in float lanes and fold into the double totals every
+// kMomentFlushSamples, keeping the rounding error of a full block at the
+// level of the scalar double loop.
+constexpr size_t kMomentFlushSamples = 1024;
+
+#if FM_TUNER_SIMD_AVX2
+// movemask of 8 interleaved I,Q lanes -> number of samples with I or Q set.
+inline size_t countFlaggedPairs(int mask) {
+  const int pairs = (mask | (mask >> 1)) & 0x55;
+  return static_cast<size_t>((pairs & 1) + ((pairs >> 2) & 1) +
+                             ((pairs >> 4) & 1) + ((pairs >> 6) & 1));
+}
+
+FM_TUNER_AVX2_TARGET void
+accumulateIqMomentsAvx2(const std::complex<float> *iq, size_t samples,
+                        IqMoments &m) {
+  using namespace fm_tuner::dsp;
+  const float *p = reinterpret_cast<const float *>(iq);
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  const __m256 hardLevel = _mm256_set1_ps(kCf32IqSaturated);
+  const __m256 nearLevel = _mm256_set1_ps(kCf32IqNearClip);
+  size_t s = 0;
+  while (s + 4 <= samples) {
+    const size_t blockEnd = std::min(samples, s + kMomentFlushSamples);
+    __m256 sum = _mm256_setzero_ps();
+    __m256 sumSq = _mm256_setzero_ps();
+    size_t hard = 0;
+    size_t nearClip = 0;
+    for (; s + 4 <= blockEnd; s += 4) {
+      // Lanes alternate I, Q.
+      const __m256 v = _mm256_loadu_ps(p + 2 * s);
+      sum = _mm256_add_ps(sum, v);
+      sumSq = _mm256_fmadd_ps(v, v, sumSq);
+      const __m256 a = _mm256_and_ps(v, absMask);
+      hard += countFlaggedPairs(
+          _mm256_movemask_ps(_mm256_cmp_ps(a, hardLevel, _CMP_GE_OQ)));
+      nearClip += countFlaggedPairs(
+          _mm256_movemask_ps(_mm256_cmp_ps(a, nearLevel, _CMP_GE_OQ)));
+    }
+    alignas(32) float lanes[8];
+    alignas(32) float lanesSq[8];
+    _mm256_store_ps(lanes, sum);
+    _mm256_store_ps(lanesSq, sumSq);
+    m.sumI += static_cast<double>(lanes[0] + lanes[2] + lanes[4] + lanes[6]);
+    m.sumQ += static_cast<double>(lanes[1] + lanes[3] + lanes[5] + lanes[7]);
+    m.sumII +=
+        static_cast<double>(lanesSq[0] + lanesSq[2] + lanesSq[4] + lanesSq[6]);
+    m.sumQQ +=
+        static_cast<double>(lanesSq[1] + lanesSq[3] + lanesSq[5] + lanesSq[7]);
+    m.hardClipCount += hard * 2;
+    m.nearClipCount += nearClip * 2;
+  }
+  accumulateIqMomentsScalar(iq + s, samples - s, m);
+}
+#endif
+
+#if FM_TUNER_SIMD_NEON
+void accumulateIqMomentsNeon(const std::complex<float> *iq, size_t samples,
+                             IqMoments &m) {
+  using namespace fm_tuner::dsp;
+  const float *p = reinterpret_cast<const float *>(iq);
+  const float32x4_t hardLevel = vdupq_n_f32(kCf32IqSaturated);
+  const float32x4_t nearLevel = vdupq_n_f32(kCf32IqNearClip);
+  size_t s = 0;
+  while (s + 4 <= samples) {
+    const size_t blockEnd = std::min(samples, s + kMomentFlushSamples);
+    float32x4_t sumI = vdupq_n_f32(0.0f);
+    float32x4_t sumQ = vdupq_n_f32(0.0f);
+    float32x4_t sumII = vdupq_n_f32(0.0f);
+    float32x4_t sumQQ = vdupq_n_f32(0.0f);
+    uint32x4_t hard = vdupq_n_u32(0);
+    uint32x4_t nearClip = vdupq_n_u32(0);
+    for (; s + 4 <= blockEnd; s += 4) {
+      const float32x4x2_t v = vld2q_f32(p + 2 * s); // deinterleaves I / Q
+      sumI = vaddq_f32(sumI, v.val[0]);
+      sumQ = vaddq_f32(sumQ, v.val[1]);
+      sumII = vmlaq_f32(sumII, v.val[0], v.val[0]);
+      sumQQ = vmlaq_f32(sumQQ, v.val[1], v.val[1]);
+      const float32x4_t peak = vmaxq_f32(vabsq_f32(v.val[0]), vabsq_f32(v.val[1]));
+      hard = vsubq_u32(hard, vcgeq_f32(peak, hardLevel));
+      nearClip = vsubq_u32(nearClip, vcgeq_f32(peak, nearLevel));
+    }
+    float lanes[4][4];
+    uint32_t counts[2][4];
+    vst1q_f32(lanes[0], sumI);
+    vst1q_f32(lanes[1], sumQ);
+    vst1q_f32(lanes[2], sumII);
+    vst1q_f32(lanes[3], sumQQ);
+    vst1q_u32(counts[0], hard);
+    vst1q_u32(counts[1], nearClip);
+    m.sumI += lanes[0][0] + lanes[0][1] + lanes[0][2] + lanes[0][3];
+    m.sumQ += lanes[1][0] + lanes[1][1] + lanes[1][2] + lanes[1][3];
+    m.sumII += lanes[2][0] + lanes[2][1] + lanes[2][2] + lanes[2][3];
+    m.sumQQ += lanes[3][0] + lanes[3][1] + lanes[3][2] + lanes[3][3];
+    m.hardClipCount +=
+        2 * static_cast<size_t>(counts[0][0] + counts[0][1] + counts[0][2] +
+                                counts[0][3]);
+    m.nearClipCount +=
+        2 * static_cast<size_t>(counts[1][0] + counts[1][1] + counts[1][2] +
+                                counts[1][3]);
+  }
+  accumulateIqMomentsScalar(iq + s, samples - s, m);
+}
+#endif
+
+IqMoments accumulateIqMoments(const std::complex<float> *iq, size_t samples) {
+  using MomentsFn = void (*)(const std::complex<float> *, size_t, IqMoments &);
+  static const fm_tuner::dsp::KernelTable<MomentsFn> kernels = []() {
+    using fm_tuner::dsp::KernelIsa;
+    fm_tuner::dsp::KernelTable<MomentsFn> table(accumulateIqMomentsScalar);
+#if FM_TUNER_SIMD_AVX2
+    table.set(KernelIsa::Avx2, accumulateIqMomentsAvx2);
+#endif
+#if FM_TUNER_SIMD_NEON
+    table.set(KernelIsa::Neon, accumulateIqMomentsNeon);
+#endif
+    return table;
+  }();
+  IqMoments m{};
+  kernels.select(fm_tuner::dsp::KernelId::PowerSum)(iq, samples, m);
+  return m;
+}
+
+SignalLevelResult widebandSignalLevel(const IqMoments &m, size_t samples) {
+  SignalLevelResult out{};
   const double n = static_cast<double>(samples);
-  const double meanI = sumI / n;
-  const double meanQ = sumQ / n;
-  const double varI = std::max(0.0, (sumII / n) - (meanI * meanI));
-  const double varQ = std::max(0.0, (sumQQ / n) - (meanQ * meanQ));
+  const double meanI = m.sumI / n;
+  const double meanQ = m.sumQ / n;
+  const double varI = std::max(0.0, (m.sumII / n) - (meanI * meanI));
+  const double varQ = std::max(0.0, (m.sumQQ / n) - (meanQ * meanQ));
   const double rms = std::sqrt(std::max(1e-15, 0.5 * (varI + varQ)));
 
   out.dbfs = 20.0 * std::log10(rms + 1e-12);
@@ -360,26 +374,18 @@ SignalLevelResult computeWidebandSignalLevel(const uint8_t *iq, size_t samples)
 
   const double iqValues = static_cast<double>(samples * 2);
   out.hardClipRatio =
-      (iqValues > 0.0) ? (static_cast<double>(hardClipCount) / iqValues) : 0.0;
+      (iqValues > 0.0) ? (static_cast<double>(m.hardClipCount) / iqValues) : 0.0;
   out.nearClipRatio =
-      (iqValues > 0.0) ? (static_cast<double>(nearClipCount) / iqValues) : 0.0;
+      (iqValues > 0.0) ? (static_cast<double>(m.nearClipCount) / iqValues) : 0.0;
   return out;
 }
 
-} // namespace
-
-SignalLevelResult computeSignalLevel(const uint8_t *iq, size_t samples,
-                                     int appliedGainDb, double gainCompFactor,
-                                     double signalBiasDb, double floorDbfs,
-                                     double ceilDbfs, uint32_t sampleRateHz,
-                                     int channelBandwidthHz) {
-  SignalLevelResult out = computeWidebandSignalLevel(iq, samples);
-  if (!iq || samples == 0) {
-    return out;
-  }
-
-  const ChannelPowerEstimate channel = estimateCenteredChannelPower(
-      iq, samples, sampleRateHz, channelBandwidthHz);
+// Shared tail of both computeSignalLevel() overloads.
+SignalLevelResult finishSignalLevel(SignalLevelResult out,
+                                    const ChannelPowerEstimate &channel,
+                                    int appliedGainDb, double gainCompFactor,
+                                    double signalBiasDb, double floorDbfs,
+                                    double ceilDbfs) {
   if (channel.valid) {
     out.dbfs = channel.channelDbfs;
     out.noiseFloorDbfs = channel.noiseFloorDbfs;
@@ -399,6 +405,47 @@ SignalLevelResult computeSignalLevel(const uint8_t *iq, size_t samples,
   return out;
 }
 
+} // namespace
+
+SignalLevelResult computeSignalLevel(const uint8_t *iq, size_t samples,
+                                     int appliedGainDb, double gainCompFactor,
+                                     double signalBiasDb, double floorDbfs,
+                                     double ceilDbfs, uint32_t sampleRateHz,
+                                     int channelBandwidthHz) {
+  if (!iq || samples == 0) {
+    return SignalLevelResult{};
+  }
+  const SignalLevelResult wideband =
+      widebandSignalLevel(accumulateIqMoments(iq, samples), samples);
+  const ChannelPowerEstimate channel = estimateCenteredChannelPower(
+      samples, sampleRateHz, channelBandwidthHz, [iq](size_t i) {
+        return std::complex<double>(
+            (static_cast<int>(iq[i * 2]) - 127.5) * (1.0 / 127.5),
+            (static_cast<int>(iq[i * 2 + 1]) - 127.5) * (1.0 / 127.5));
+      });
+  return finishSignalLevel(wideband, channel, appliedGainDb, gainCompFactor,
+                           signalBiasDb, floorDbfs, ceilDbfs);
+}
+
+SignalLevelResult computeSignalLevel(const std::complex<float> *iq,
+                                     size_t samples, int appliedGainDb,
+                                     double gainCompFactor, double signalBiasDb,
+                                     double floorDbfs, double ceilDbfs,
+                                     uint32_t sampleRateHz,
+                                     int channelBandwidthHz) {
+  if (!iq || samples == 0) {
+    return SignalLevelResult{};
+  }
+  const SignalLevelResult wideband =
+      widebandSignalLevel(accumulateIqMoments(iq, samples), samples);
+  const ChannelPowerEstimate channel = estimateCenteredChannelPower(
+      samples, sampleRateHz, channelBandwidthHz, [iq](size_t i) {
+        return std::complex<double>(iq[i].real(), iq[i].imag());
+      });
+  return finishSignalLevel(wideband, channel, appliedGainDb, gainCompFactor,
+                           signalBiasDb, floorDbfs, ceilDbfs);
+}
+
 float snrLevel120FromSnrDb(double snrDb) {
   if (!std::isfinite(snrDb)) {
     return 120.0f;
@@ -1,6 +1,6 @@
 #include "stereo_decoder.h"
 #include <algorithm>
-#include <complex>
+#include <cmath>
 
 namespace {
 constexpr float kPi = 3.14159265358979323846f;
@@ -31,17 +31,20 @@ constexpr float kPilotCoherenceQualityFloor = 0.55f;
 constexpr float kPilotCoherenceQualityCeil = 0.70f;
 constexpr float kPllQualityBestHz = 40.0f;
 constexpr float kPllQualityWorstHz = 700.0f;
+// Per-sample smoothing / adaptation constants are tuned at this MPX rate and
+// rescaled in the constructor so time constants (and the PLL loop bandwidth
+// in Hz) hold at other rates, e.g. the 128 kHz half-rate MPX.
+constexpr float kReferenceRate = 256000.0f;
 constexpr float kPilotEnvSmooth = 0.9995f;
-constexpr float kPilotEnvInject = 1.0f - kPilotEnvSmooth;
 constexpr float kPilotIqSmooth = 0.9995f;
-constexpr float kPilotIqInject = 1.0f - kPilotIqSmooth;
+constexpr float kPilotCancelMu = 1.0e-4f;
 // Gear-shifted pilot PLL bandwidth. The acquire value matches the historical
 // pre-gear-shift fixed loop bandwidth (0.01) — it preserves weak-signal lock
 // sensitivity that wider acquire bandwidths sacrifice for slightly faster
 // retune lock. The hold value (0.003) is the actual improvement: once we're
 // locked, narrowing the loop reduces pilot jitter and improves stereo
 // separation on strong signals. Both values are in liquid_dsp's normalized
-// loop-bandwidth units.
+// loop-bandwidth units (see dsp::PilotPll).
 constexpr float kPilotPllBwAcquire = 0.01f;
 constexpr float kPilotPllBwHold = 0.003f;
 
@@ -55,71 +58,15 @@ constexpr float kPilotPllBwHold = 0.003f;
 // call show up immediately.
 constexpr uint32_t kHiBlendCoeffRefreshMask = 63;
 
-constexpr float kHalfPi = 1.5707963267948966f;
-constexpr float kTwoPi = 6.28318530717959f;
-
-// 1024-entry sin/cos LUT with linear interpolation (N+1 entries so the
-// upper-bound interpolation lookup doesn't need a separate wrap). Max
-// error ~1.9e-5 (~13.7 bits) — well under the PLL's phase jitter and far
-// below the FM noise floor. The two per-sample sincos pairs in
-// processAudio (one for phaseNow, one for m_pllPhase) were ~95 leaf
-// samples / ~4% of active CPU in the post-Tier-2A profile; this swaps
-// the libm __sincosf_stret call for an L1-cache hit plus two multiplies.
-struct PhaseLUT {
-  static constexpr unsigned N = 1024;
-  float sinTbl[N + 1];
-  float cosTbl[N + 1];
-  PhaseLUT() {
-    for (unsigned i = 0; i <= N; ++i) {
-      const float p = static_cast<float>(i) * kTwoPi / static_cast<float>(N);
-      sinTbl[i] = std::sin(p);
-      cosTbl[i] = std::cos(p);
-    }
-  }
-};
-
-inline const PhaseLUT &phaseLUT() {
-  static const PhaseLUT lut;
-  return lut;
-}
-
-inline void fast_sincosf(float phase, float &s, float &c) {
-  // liquid NCO output is wrapped to [-π, π]; bring negative values into
-  // [0, 2π) so the integer-cast + mask gives a valid LUT index.
-  if (phase < 0.0f) phase += kTwoPi;
-  if (phase >= kTwoPi) phase -= kTwoPi;
-  constexpr float kInvTwoPi = 1.0f / kTwoPi;
-  const float scaled = phase * (static_cast<float>(PhaseLUT::N) * kInvTwoPi);
-  const unsigned idx = static_cast<unsigned>(scaled);
-  const unsigned i = idx & (PhaseLUT::N - 1U);
-  const float f = scaled - static_cast<float>(idx);
-  const auto &lut = phaseLUT();
-  s = lut.sinTbl[i] + f * (lut.sinTbl[i + 1] - lut.sinTbl[i]);
-  c = lut.cosTbl[i] + f * (lut.cosTbl[i + 1] - lut.cosTbl[i]);
-}
+// Mono fast path. Entered only once the output already is mono: forced, or
+// no pilot for kMonoEnterSec with the blend decayed to nothing. The 19 kHz
+// watch is judged over kPilotWatchSec (~33 Hz resolution), narrow enough that
+// noise around 19 kHz cannot pass for a pilot on any block size.
+constexpr float kMonoEnterSec = 2.0f;
+constexpr float kMonoBlendFloor = 1e-3f;
+constexpr float kPilotWatchSec = 0.03f;
+constexpr float kQuarterPi = 0.78539816339744831f;
 
-// Polynomial approximation of atan2 — max error ~0.0015 rad (~0.09°), more
-// than tight enough for the pilot-PLL phase detector at 19 kHz. Replaces
-// libm's atan2f in the inner loop where the profile showed ~150 samples /
-// ~1.25% of one core spent in atan2f. Branch-light to keep the hot path
-// predictable.
-inline float fast_atan2f(float y, float x) {
-  if (x == 0.0f) {
-    return (y > 0.0f) ? kHalfPi : (y < 0.0f) ? -kHalfPi : 0.0f;
-  }
-  constexpr float kPiOver4 = 0.7853981633974483f;
-  const float ax = std::fabs(x);
-  const float ay = std::fabs(y);
-  const bool xDom = (ax >= ay);
-  const float a = xDom ? (ay / ax) : (ax / ay);
-  // Rajan / Volder polynomial: angle ≈ a·(π/4 - (a-1)(0.2447 + 0.0663·a))
-  const float base = a * (kPiOver4 - (a - 1.0f) * (0.2447f + 0.0663f * a));
-  float result = xDom ? base : (kHalfPi - base);
-  if (x < 0.0f) {
-    result = kPi - result;
-  }
-  return (y < 0.0f) ? -result : result;
-}
 } // namespace
 
 StereoDecoder::StereoDecoder(int inputRate, int /*outputRate*/)
@@ -129,7 +76,7 @@ StereoDecoder::StereoDecoder(int inputRate, int /*outputRate*/)
       m_pilotResidualMagnitude(0.0f), m_mpxMagnitude(0.0f),
       m_stereoBlend(0.0f), m_stereoQuality(0.0f), m_pilotLevelTenthsKHz(0),
       m_pilotI(0.0f), m_pilotQ(0.0f), m_lrRawMagnitude(0.0f),
-      m_lrAudioMagnitude(0.0f), m_pllPhase(0.0f),
+      m_lrAudioMagnitude(0.0f),
       m_pllFreq(2.0f * kPi * 19000.0f / static_cast<float>(inputRate)),
       m_pllMinFreq(2.0f * kPi * 18750.0f / static_cast<float>(inputRate)),
       m_pllMaxFreq(2.0f * kPi * 19250.0f / static_cast<float>(inputRate)),
@@ -138,6 +85,29 @@ StereoDecoder::StereoDecoder(int inputRate, int /*outputRate*/)
       m_hiBlendA1(0.0f), m_hiBlendA2(0.0f),
       m_pilotCancelGainI(0.0f), m_pilotCancelGainQ(0.0f),
       m_pilotCancellerEnabled(true), m_delayPos(0), m_delaySamples(0) {
+  const float rateScale = kReferenceRate / static_cast<float>(m_inputRate);
+  m_envSmooth = std::pow(kPilotEnvSmooth, rateScale);
+  m_envInject = 1.0f - m_envSmooth;
+  m_iqSmooth = std::pow(kPilotIqSmooth, rateScale);
+  m_iqInject = 1.0f - m_iqSmooth;
+  m_pilotCancelMu = kPilotCancelMu * rateScale;
+  // Loop natural frequency is sqrt(bandwidth) rad/sample.
+  m_pllBwAcquire = std::min(0.25f, kPilotPllBwAcquire * rateScale * rateScale);
+  m_pllBwHold = std::min(0.25f, kPilotPllBwHold * rateScale * rateScale);
+  // The L-R product detector pairs the post-step PLL phase with an MPX sample
+  // one past the pilot FIR delay: two samples of skew, which at the tuned
+  // 256 kHz rate sets the 38 kHz demodulation phase the decoder depends on.
+  // Hold that skew constant in time at other rates by rotating the reference.
+  const float skewRad = 2.0f * kPi * 38000.0f * 2.0f *
+                        (1.0f / kReferenceRate -
+                         1.0f / static_cast<float>(m_inputRate));
+  m_subcarrierRotCos = std::cos(skewRad);
+  m_subcarrierRotSin = std::sin(skewRad);
+  const double watchOmega = 2.0 * 3.14159265358979323846 * 19000.0 /
+                            static_cast<double>(m_inputRate);
+  m_watchStep = std::complex<double>(std::cos(watchOmega),
+                                     -std::sin(watchOmega));
+
   constexpr float pilotCenterHz = 19000.0f;
   constexpr float pilotHalfBandwidthHz = 250.0f;
   // Wider transition than spec-tight (was 3 kHz → 325 taps @ 256 kHz). The
@@ -160,8 +130,11 @@ StereoDecoder::StereoDecoder(int inputRate, int /*outputRate*/)
       pilotCenterHz / static_cast<float>(m_inputRate), 0.001f, 0.49f);
   const float pilotCutoffNorm = std::clamp(
       pilotHalfBandwidthHz / static_cast<float>(m_inputRate), 0.0005f, 0.45f);
-  m_liquidPilotBandFilter.init(static_cast<std::uint32_t>(pilotTapCount),
-                               pilotCutoffNorm, 60.0f, pilotCenterNorm);
+  std::vector<float> bandTaps;
+  fm_tuner::dsp::liquid::designBandpassTaps(
+      static_cast<std::uint32_t>(pilotTapCount), pilotCutoffNorm, 60.0f,
+      pilotCenterNorm, bandTaps);
+  m_pilotBandFilter.setTaps(bandTaps);
   // Calibrate the band-pass gain at 19 kHz: feed a unit-amplitude 19 kHz
   // cosine and measure the steady-state output magnitude. The centered FIR is
   // L1-normalized (sub-unity gain), so this factor converts the smoothed pilot
@@ -171,23 +144,24 @@ StereoDecoder::StereoDecoder(int inputRate, int /*outputRate*/)
                      static_cast<double>(pilotCenterHz) /
                      static_cast<double>(m_inputRate);
     const int warm = pilotTapCount * 3;
+    std::vector<float> probe(static_cast<size_t>(warm));
+    for (int k = 0; k < warm; k++) {
+      probe[static_cast<size_t>(k)] =
+          static_cast<float>(std::cos(w * static_cast<double>(k)));
+    }
+    m_pilotBandFilter.executeBlock(probe.data(), probe.size(), probe.data());
     double accum = 0.0;
     int counted = 0;
-    for (int k = 0; k < warm; k++) {
-      const float s = static_cast<float>(std::cos(w * static_cast<double>(k)));
-      m_liquidPilotBandFilter.push(std::complex<float>(s, 0.0f));
-      const std::complex<float> o = m_liquidPilotBandFilter.execute();
-      if (k >= pilotTapCount * 2) {
-        accum += static_cast<double>(std::abs(o));
-        counted++;
-      }
+    for (int k = pilotTapCount * 2; k < warm; k++) {
+      accum += static_cast<double>(std::abs(probe[static_cast<size_t>(k)]));
+      counted++;
     }
     m_pilotFilterGain =
         (counted > 0) ? static_cast<float>(accum / counted) : 0.5f;
     if (m_pilotFilterGain < 1e-4f) {
       m_pilotFilterGain = 0.5f;
     }
-    m_liquidPilotBandFilter.reset();
+    m_pilotBandFilter.reset();
   }
 
   // 57 kHz RDS subcarrier band-pass + gain calibration, for the RDS deviation
@@ -215,28 +189,31 @@ StereoDecoder::StereoDecoder(int inputRate, int /*outputRate*/)
         rdsCenterHz / static_cast<float>(m_inputRate), 0.001f, 0.49f);
     const float rdsCutoffNorm = std::clamp(
         rdsHalfBandwidthHz / static_cast<float>(m_inputRate), 0.0005f, 0.45f);
-    m_liquidRdsBandFilter.init(static_cast<std::uint32_t>(rdsTapCount),
-                               rdsCutoffNorm, 60.0f, rdsCenterNorm);
+    fm_tuner::dsp::liquid::designBandpassTaps(
+        static_cast<std::uint32_t>(rdsTapCount), rdsCutoffNorm, 60.0f,
+        rdsCenterNorm, bandTaps);
+    m_rdsBandFilter.setTaps(bandTaps);
     const double w = 2.0 * static_cast<double>(kPi) *
                      static_cast<double>(rdsCenterHz) /
                      static_cast<double>(m_inputRate);
     const int warm = rdsTapCount * 3;
+    std::vector<float> probe(static_cast<size_t>(warm));
+    for (int k = 0; k < warm; k++) {
+      probe[static_cast<size_t>(k)] =
+          static_cast<float>(std::cos(w * static_cast<double>(k)));
+    }
+    m_rdsBandFilter.executeBlock(probe.data(), probe.size(), probe.data());
     double accum = 0.0;
     int counted = 0;
-    for (int k = 0; k < warm; k++) {
-      const float s = static_cast<float>(std::cos(w * static_cast<double>(k)));
-      m_liquidRdsBandFilter.push(std::complex<float>(s, 0.0f));
-      const std::complex<float> o = m_liquidRdsBandFilter.execute();
-      if (k >= rdsTapCount * 2) {
-        accum += static_cast<double>(std::abs(o));
-        counted++;
-      }
+    for (int k = rdsTapCount * 2; k < warm; k++) {
+      accum += static_cast<double>(std::abs(probe[static_cast<size_t>(k)]));
+      counted++;
     }
     m_rdsFilterGain = (counted > 0) ? static_cast<float>(accum / counted) : 0.5f;
     if (m_rdsFilterGain < 1e-4f) {
       m_rdsFilterGain = 0.5f;
     }
-    m_liquidRdsBandFilter.reset();
+    m_rdsBandFilter.reset();
   }
 
   // Noise-triangle hiss estimate for the demod-domain SNR/quality figure. A
@@ -247,8 +224,13 @@ StereoDecoder::StereoDecoder(int inputRate, int /*outputRate*/)
   // sharp skirt (a few biquads — far cheaper than another FIR). On channels
   // narrower than ~150 kHz the upper band is rolled off by the channel filter,
   // so the metric reads optimistically — but those are mono/weak cases anyway.
-  m_liquidHissBandFilter.initHighpass(
-      6, 65000.0f / static_cast<float>(m_inputRate), 60.0f);
+  // At rates that cannot hold the 65 kHz corner the caller passes the band in
+  // (see processAudio()).
+  constexpr float kHissCornerHz = 65000.0f;
+  if (kHissCornerHz < 0.45f * static_cast<float>(m_inputRate)) {
+    m_liquidHissBandFilter.initHighpass(
+        6, kHissCornerHz / static_cast<float>(m_inputRate), 60.0f);
+  }
   // No dedicated audio LPF at the input rate. The 19 kHz pilot / 38 kHz
   // L-R subcarrier / 57 kHz RDS subcarrier are all rejected by the
   // anti-aliasing filter in AFPostProcessor's resampler; the residual
@@ -256,11 +238,11 @@ StereoDecoder::StereoDecoder(int inputRate, int /*outputRate*/)
 
   m_delaySamples = std::max(0, (pilotTapCount - 1) / 2);
   m_delayLine.assign(static_cast<size_t>(std::max(1, m_delaySamples + 1)),
-                     std::complex<float>(0.0f, 0.0f));
+                     0.0f);
   const float nominalPllFreq =
       2.0f * kPi * 19000.0f / static_cast<float>(m_inputRate);
-  m_liquidPilotPll.init(LIQUID_VCO, nominalPllFreq);
-  m_liquidPilotPll.setPLLBandwidth(kPilotPllBwAcquire);
+  m_pilotPll.init(nominalPllFreq);
+  m_pilotPll.setBandwidth(m_pllBwAcquire);
 }
 
 StereoDecoder::~StereoDecoder() = default;
@@ -278,7 +260,6 @@ void StereoDecoder::reset() {
   m_pilotQ = 0.0f;
   m_lrRawMagnitude = 0.0f;
   m_lrAudioMagnitude = 0.0f;
-  m_pllPhase = 0.0f;
   m_pllFreq = 2.0f * kPi * 19000.0f / static_cast<float>(m_inputRate);
   m_pilotConfidence = 0.0f;
   m_hiBlendZ1 = 0.0f;
@@ -286,15 +267,39 @@ void StereoDecoder::reset() {
   m_pilotCancelGainI = 0.0f;
   m_pilotCancelGainQ = 0.0f;
   m_delayPos = 0;
-  std::fill(m_delayLine.begin(), m_delayLine.end(),
-            std::complex<float>(0.0f, 0.0f));
+  std::fill(m_delayLine.begin(), m_delayLine.end(), 0.0f);
   m_rdsBandMs = 0.0f;
   m_hissNoiseMs = 0.0f;
-  m_liquidPilotBandFilter.reset();
-  m_liquidRdsBandFilter.reset();
+  m_pilotBandFilter.reset();
+  m_rdsBandFilter.reset();
   m_liquidHissBandFilter.reset();
-  m_liquidPilotPll.reset();
-  m_liquidPilotPll.setPLLBandwidth(kPilotPllBwAcquire);
+  m_rdsMeter.reset();
+  m_hissMeter.reset();
+  m_pilotPll.reset();
+  m_pilotPll.setBandwidth(m_pllBwAcquire);
+  m_monoFastPath = false;
+  m_pilotAbsentSec = 0.0f;
+  m_watchPhasor = std::complex<double>(1.0, 0.0);
+  m_watchSum = std::complex<double>(0.0, 0.0);
+  m_watchSamples = 0;
+}
+
+void StereoDecoder::setMetering(
+    fm_tuner::dsp::MeteringScheduler::Mode rdsDeviation,
+    fm_tuner::dsp::MeteringScheduler::Mode demodSnr) {
+  using Mode = fm_tuner::dsp::MeteringScheduler::Mode;
+  const size_t interval = static_cast<size_t>(
+      kMeterIntervalSec * static_cast<float>(m_inputRate));
+  // A meter coming back from Off has filter history from whenever it last
+  // ran; start it from silence instead.
+  if (m_rdsMeter.mode() == Mode::Off && rdsDeviation != Mode::Off) {
+    m_rdsBandFilter.reset();
+  }
+  if (m_hissMeter.mode() == Mode::Off && demodSnr != Mode::Off) {
+    m_liquidHissBandFilter.reset();
+  }
+  m_rdsMeter.configure(rdsDeviation, interval);
+  m_hissMeter.configure(demodSnr, interval);
 }
 
 void StereoDecoder::setForceStereo(bool force) { m_forceStereo = force; }
@@ -302,7 +307,7 @@ void StereoDecoder::setForceStereo(bool force) { m_forceStereo = force; }
 void StereoDecoder::setForceMono(bool force) { m_forceMono = force; }
 
 size_t StereoDecoder::processAudio(const float *mono, float *left, float *right,
-                                   size_t numSamples) {
+                                   size_t numSamples, const float *hissBand) {
   if (!mono || !left || !right || numSamples == 0) {
     return 0;
   }
@@ -411,111 +416,177 @@ size_t StereoDecoder::processAudio(const float *mono, float *left, float *right,
   const float fs = static_cast<float>(m_inputRate);
   const float kPiOverFs = kPi / fs;
 
+  // The pilot / RDS / hiss band filters only see the MPX, never the loop
+  // state, so run them over the block up front.
+  if (m_pilotBand.size() < numSamples) {
+    m_pilotBand.resize(numSamples);
+    m_rdsBand.resize(numSamples);
+    m_hissBand.resize(numSamples);
+    m_pllMixedI.resize(numSamples);
+    m_pllMixedQ.resize(numSamples);
+    m_pllAdvance.resize(numSamples);
+    m_pilotRefCos.resize(numSamples);
+    m_pilotRefSin.resize(numSamples);
+    m_subcarrierRef.resize(numSamples);
+    m_subcarrierRefQ.resize(numSamples);
+  }
+
+  // The RDS deviation and hiss SNR meters run on the blocks their scheduler
+  // picks. A duty-cycled meter still pushes the tail of each skipped block
+  // through its filter, so the next metered block starts from the true
+  // filter state rather than a stale one.
+  using MeterMode = fm_tuner::dsp::MeteringScheduler::Mode;
+  constexpr size_t kHissWarmupSamples = 256; // order-6 high-pass settles
+  const bool meterRds = m_rdsMeter.beginBlock(numSamples);
+  const bool meterHiss = m_hissMeter.beginBlock(numSamples);
+  if (meterRds) {
+    m_rdsBandFilter.executeBlock(mono, numSamples, m_rdsBand.data());
+  } else if (m_rdsMeter.mode() == MeterMode::DutyCycled) {
+    const size_t tail =
+        std::min(numSamples, std::max<size_t>(1, m_rdsBandFilter.length()) - 1);
+    m_rdsBandFilter.executeBlock(mono + numSamples - tail, tail,
+                                 m_rdsBand.data());
+  }
+  // An external hiss band is the complement of a band-limited MPX; the
+  // detection thresholds were tuned on the wideband level, so add it back.
+  const bool wideFromHiss = (hissBand != nullptr);
+  if (hissBand == nullptr) {
+    if (meterHiss) {
+      if (m_liquidHissBandFilter.ready()) {
+        m_liquidHissBandFilter.executeBlock(mono, numSamples,
+                                            m_hissBand.data());
+      } else {
+        std::fill(m_hissBand.begin(), m_hissBand.begin() + numSamples, 0.0f);
+      }
+    } else if (m_hissMeter.mode() == MeterMode::DutyCycled &&
+               m_liquidHissBandFilter.ready()) {
+      const size_t tail = std::min(numSamples, kHissWarmupSamples);
+      m_liquidHissBandFilter.executeBlock(mono + numSamples - tail, tail,
+                                          m_hissBand.data());
+    }
+    hissBand = m_hissBand.data();
+  }
+  if (meterRds) {
+    // 57 kHz RDS subcarrier envelope, decaying peak hold (~0.1 s) for the RDS
+    // deviation meter. DSB-SC, so the envelope tracks the data; the peak is
+    // the reported deviation.
+    for (size_t i = 0; i < numSamples; i++) {
+      const float rdsEnv = std::abs(m_rdsBand[i]);
+      m_rdsBandMs =
+          (m_rdsBandMs * m_envSmooth) + (rdsEnv * rdsEnv * m_envInject);
+    }
+  }
+  if (meterHiss) {
+    // Noise-triangle hiss band (real IIR band-pass) for the demod SNR/quality
+    // estimate. EMA of the squared band output mirrors the RDS path.
+    for (size_t i = 0; i < numSamples; i++) {
+      const float hiss = hissBand[i];
+      m_hissNoiseMs =
+          (m_hissNoiseMs * m_envSmooth) + (hiss * hiss * m_envInject);
+    }
+  }
+
+  // In the mono fast path the watch keeps m_stereoDetected current; a pilot
+  // (unless mono is forced) or force-stereo hands the block back to the full
+  // decoder, which then acquires from scratch.
+  if (m_monoFastPath) {
+    if (m_forceStereo || (!m_forceMono && m_stereoDetected)) {
+      leaveMonoFastPath();
+    } else {
+      return processMonoBlock(mono, left, right, numSamples,
+                              wideFromHiss ? hissBand : nullptr);
+    }
+  }
+
+  m_pilotBandFilter.executeBlock(mono, numSamples, m_pilotBand.data());
+  // Likewise the PLL: it is driven by the pilot band alone, and its bandwidth
+  // only gear-shifts between blocks.
+  fm_tuner::dsp::PilotPll::Block pll;
+  pll.mixedI = m_pllMixedI.data();
+  pll.mixedQ = m_pllMixedQ.data();
+  pll.freq = m_pllAdvance.data();
+  pll.cos19 = m_pilotRefCos.data();
+  pll.sin19 = m_pilotRefSin.data();
+  pll.cos38 = m_subcarrierRef.data();
+  if (m_subcarrierRotSin != 0.0f) {
+    pll.sin38 = m_subcarrierRefQ.data();
+  }
+  m_pilotPll.process(m_pilotBand.data(), numSamples, pll);
+  if (m_subcarrierRotSin != 0.0f) {
+    // cos(2 * phase + skew)
+    for (size_t i = 0; i < numSamples; i++) {
+      m_subcarrierRef[i] = m_subcarrierRef[i] * m_subcarrierRotCos -
+                           m_subcarrierRefQ[i] * m_subcarrierRotSin;
+    }
+  }
+
   size_t outCount = 0;
   for (size_t i = 0; i < numSamples; i++) {
     const float mpx = mono[i];
 
-    m_liquidPilotBandFilter.push(std::complex<float>(mpx, 0.0f));
-    const std::complex<float> pilot = m_liquidPilotBandFilter.execute();
-    m_pilotBandMagnitude = (m_pilotBandMagnitude * kPilotEnvSmooth) +
-                           (std::abs(pilot) * kPilotEnvInject);
+    m_pilotBandMagnitude = (m_pilotBandMagnitude * m_envSmooth) +
+                           (std::abs(m_pilotBand[i]) * m_envInject);
 
-    // 57 kHz RDS subcarrier envelope, decaying peak hold (~0.1 s) for the RDS
-    // deviation meter. DSB-SC, so the envelope tracks the data; the peak is the
-    // reported deviation.
-    m_liquidRdsBandFilter.push(std::complex<float>(mpx, 0.0f));
-    const float rdsEnv = std::abs(m_liquidRdsBandFilter.execute());
-    m_rdsBandMs =
-        (m_rdsBandMs * kPilotEnvSmooth) + (rdsEnv * rdsEnv * kPilotEnvInject);
+    const float mpxWide = wideFromHiss ? (mpx + hissBand[i]) : mpx;
     m_mpxMagnitude =
-        (m_mpxMagnitude * kPilotEnvSmooth) + (std::abs(mpx) * kPilotEnvInject);
+        (m_mpxMagnitude * m_envSmooth) + (std::abs(mpxWide) * m_envInject);
 
-    // Noise-triangle hiss band (real IIR band-pass) for the demod SNR/quality
-    // estimate. EMA of the squared band output mirrors the RDS path.
-    const float hiss = m_liquidHissBandFilter.execute(mpx);
-    m_hissNoiseMs =
-        (m_hissNoiseMs * kPilotEnvSmooth) + (hiss * hiss * kPilotEnvInject);
-
-    const float phaseNow = m_liquidPilotPll.phase();
-    float vcoSin;
-    float vcoCos;
-    fast_sincosf(phaseNow, vcoSin, vcoCos);
-    const std::complex<float> vco(vcoCos, vcoSin);
-    const std::complex<float> mixedPilot = pilot * std::conj(vco);
-    const float error = fast_atan2f(mixedPilot.imag(), mixedPilot.real());
-    m_liquidPilotPll.stepPLL(error);
-    m_liquidPilotPll.step();
-    const float phaseNext = m_liquidPilotPll.phase();
-    float dphi = phaseNext - phaseNow;
-    if (dphi > kPi) {
-      dphi -= 2.0f * kPi;
-    } else if (dphi < -kPi) {
-      dphi += 2.0f * kPi;
-    }
-    m_pllPhase = phaseNext;
-    m_pllFreq = std::clamp(dphi, m_pllMinFreq, m_pllMaxFreq);
+    const float mixedI = m_pllMixedI[i];
+    const float mixedQ = m_pllMixedQ[i];
+    m_pllFreq = std::clamp(m_pllAdvance[i], m_pllMinFreq, m_pllMaxFreq);
 
-    m_pilotI =
-        (m_pilotI * kPilotIqSmooth) + (mixedPilot.real() * kPilotIqInject);
-    m_pilotQ =
-        (m_pilotQ * kPilotIqSmooth) + (mixedPilot.imag() * kPilotIqInject);
+    m_pilotI = (m_pilotI * m_iqSmooth) + (mixedI * m_iqInject);
+    m_pilotQ = (m_pilotQ * m_iqSmooth) + (mixedQ * m_iqInject);
     const float pilotMagNow =
         std::sqrt((m_pilotI * m_pilotI) + (m_pilotQ * m_pilotQ));
     const float pilotRatioNow =
         m_pilotBandMagnitude / std::max(m_mpxMagnitude, 1e-3f);
     const float pilotCoherenceNow =
         pilotMagNow / std::max(m_pilotBandMagnitude, 1e-4f);
-    const float pilotResidual = mixedPilot.imag();
+    const float pilotResidual = mixedQ;
     m_pilotResidualMagnitude =
-        (m_pilotResidualMagnitude * kPilotEnvSmooth) +
-        (std::abs(pilotResidual) * kPilotEnvInject);
+        (m_pilotResidualMagnitude * m_envSmooth) +
+        (std::abs(pilotResidual) * m_envInject);
     const float pilotResidualRatioNow =
         m_pilotResidualMagnitude / std::max(pilotMagNow, 1e-4f);
     const float pllErrHzNow = std::abs(m_pllFreq - nominalPllFreq) *
                               static_cast<float>(m_inputRate) / (2.0f * kPi);
 
-    const std::complex<float> delayedMpx = m_delayLine[m_delayPos];
-    m_delayLine[m_delayPos] = std::complex<float>(mpx, 0.0f);
+    const float delayedMpx = m_delayLine[m_delayPos];
+    m_delayLine[m_delayPos] = mpx;
     m_delayPos++;
     if (m_delayPos >= m_delayLine.size()) {
       m_delayPos = 0;
     }
 
-    // SDR++-style L-R recovery:
-    // 1) take delayed MPX as complex (real, imag=0),
-    // 2) multiply by conjugated PLL output twice (38 kHz downconversion),
-    // 3) take real part and apply 2x gain.
-    float pllSin;
-    float pllCos;
-    fast_sincosf(m_pllPhase, pllSin, pllCos);
-    const std::complex<float> pll(pllCos, pllSin);
-    const std::complex<float> lrMixed =
-        delayedMpx * std::conj(pll) * std::conj(pll);
-    float monoRaw = delayedMpx.real();
-    const float lrRaw = 2.0f * lrMixed.real();
+    // SDR++-style L-R recovery: Re(MPX * conj(pll)^2) with 2x gain. The
+    // delayed MPX is real, so that is MPX * cos(2 * pllPhase), the 38 kHz
+    // reference the PLL already produced.
+    float monoRaw = delayedMpx;
+    const float lrRaw = 2.0f * delayedMpx * m_subcarrierRef[i];
 
     // 19 kHz pilot canceller. Two-tap LMS: subtracts gI·cos(pllPhase) +
     // gQ·sin(pllPhase) from the mono path. Using both in-phase and quadrature
     // references lets the canceller kill the pilot regardless of the
-    // single-sample PLL timing offset between phaseNow (used inside the loop
-    // filter) and phaseNext (used here for the L-R recovery). Convergence time
-    // constant is ~2/μ samples ≈ 80 ms at 256 kHz; steady-state residual is
-    // gradient-noise-limited by the cross-correlation of mono program content
-    // with the pilot reference (smaller μ = less noise, slower lock).
+    // single-sample PLL timing offset between the pre-step phase (used inside
+    // the loop filter) and the post-step phase (used here for the L-R
+    // recovery). Convergence time constant is ~2/μ samples ≈ 80 ms at
+    // 256 kHz; steady-state residual is gradient-noise-limited by the
+    // cross-correlation of mono program content with the pilot reference
+    // (smaller μ = less noise, slower lock).
     if (m_pilotCancellerEnabled) {
-      const float refI = pll.real();
-      const float refQ = pll.imag();
+      const float refI = m_pilotRefCos[i];
+      const float refQ = m_pilotRefSin[i];
       const float monoAfter =
           monoRaw - (m_pilotCancelGainI * refI + m_pilotCancelGainQ * refQ);
       if (m_stereoDetected || m_forceStereo) {
-        constexpr float kPilotCancelMu = 1.0e-4f;
-        m_pilotCancelGainI += kPilotCancelMu * monoAfter * refI;
-        m_pilotCancelGainQ += kPilotCancelMu * monoAfter * refQ;
+        m_pilotCancelGainI += m_pilotCancelMu * monoAfter * refI;
+        m_pilotCancelGainQ += m_pilotCancelMu * monoAfter * refQ;
       }
       monoRaw = monoAfter;
     }
     m_lrRawMagnitude =
-        (m_lrRawMagnitude * kPilotEnvSmooth) + (std::abs(lrRaw) * kPilotEnvInject);
+        (m_lrRawMagnitude * m_envSmooth) + (std::abs(lrRaw) * m_envInject);
     const float targetStereoBlend = computeBlendTarget(
         pilotMagNow, pilotRatioNow, pilotCoherenceNow, pilotResidualRatioNow,
         pllErrHzNow);
@@ -560,8 +631,8 @@ size_t StereoDecoder::processAudio(const float *mono, float *left, float *right,
     const float leftRaw = 0.5f * (monoRaw + lrAdapted);
     const float rightRaw = 0.5f * (monoRaw - lrAdapted);
     m_lrAudioMagnitude =
-        (m_lrAudioMagnitude * kPilotEnvSmooth) +
-        (0.5f * std::abs(leftRaw - rightRaw) * kPilotEnvInject);
+        (m_lrAudioMagnitude * m_envSmooth) +
+        (0.5f * std::abs(leftRaw - rightRaw) * m_envInject);
 
     left[outCount] = leftRaw;
     right[outCount] = rightRaw;
@@ -590,9 +661,9 @@ size_t StereoDecoder::processAudio(const float *mono, float *left, float *right,
       (pilotRatio > ratioThreshold) &&
       (pilotCoherence > coherenceThreshold) &&
       (pilotResidualRatio < residualThreshold);
+  const float blockSec = static_cast<float>(numSamples) /
+                         std::max(1.0f, static_cast<float>(m_inputRate));
   if (!m_forceStereo) {
-    const float blockSec = static_cast<float>(numSamples) /
-                           std::max(1.0f, static_cast<float>(m_inputRate));
     const float alphaAcquire =
         1.0f - std::exp(-blockSec / kPilotAcquireTauSec);
     const float alphaRelease =
@@ -607,16 +678,119 @@ size_t StereoDecoder::processAudio(const float *mono, float *left, float *right,
     if (!m_stereoDetected &&
         m_pilotConfidence >= kPilotAcquireConfidence) {
       m_stereoDetected = true;
-      m_liquidPilotPll.setPLLBandwidth(kPilotPllBwHold);
+      m_pilotPll.setBandwidth(m_pllBwHold);
     } else if (m_stereoDetected &&
                m_pilotConfidence <= kPilotHoldConfidence) {
       m_stereoDetected = false;
-      m_liquidPilotPll.setPLLBandwidth(kPilotPllBwAcquire);
+      m_pilotPll.setBandwidth(m_pllBwAcquire);
     }
   }
 
   const float calibrated = m_pilotMagnitude * 8.0f;
   m_pilotLevelTenthsKHz =
       std::clamp(static_cast<int>(std::round(calibrated * 750.0f)), 0, 750);
+
+  // Switch to the mono fast path only once the output is already mono, so
+  // the change of path is inaudible.
+  m_pilotAbsentSec = pilotPresent ? 0.0f : (m_pilotAbsentSec + blockSec);
+  if (!m_forceStereo && m_stereoBlend < kMonoBlendFloor &&
+      (m_forceMono ||
+       (!m_stereoDetected && m_pilotAbsentSec >= kMonoEnterSec))) {
+    m_monoFastPath = true;
+    m_stereoBlend = 0.0f;
+    m_watchSum = std::complex<double>(0.0, 0.0);
+    m_watchSamples = 0;
+  }
   return outCount;
 }
+
+std::complex<double> StereoDecoder::accumulatePilotWatch(const float *mono,
+                                                         size_t numSamples) {
+  std::complex<double> phasor = m_watchPhasor;
+  std::complex<double> blockSum(0.0, 0.0);
+  for (size_t i = 0; i < numSamples; i++) {
+    blockSum += static_cast<double>(mono[i]) * phasor;
+    phasor *= m_watchStep;
+  }
+  m_watchPhasor = phasor / std::abs(phasor);
+  m_watchSum += blockSum;
+  m_watchSamples += numSamples;
+
+  const size_t window = static_cast<size_t>(
+      kPilotWatchSec * static_cast<float>(m_inputRate));
+  if (m_watchSamples >= window) {
+    // A tone A*cos(w n + phi) sums to (N A / 2) e^{j phi}. Express it as the
+    // stereo path's meters would read it. m_pilotFilterGain is the mean
+    // |output| for a unit cosine, i.e. (2/pi) * H for a band-pass gain H, so
+    // the band-pass magnitude is g*A and the coherent (PLL-mixed, H*A/2)
+    // level is g*A*pi/4.
+    const float amplitude = static_cast<float>(
+        2.0 * std::abs(m_watchSum) / static_cast<double>(m_watchSamples));
+    m_pilotBandMagnitude = m_pilotFilterGain * amplitude;
+    m_pilotMagnitude = m_pilotFilterGain * amplitude * kQuarterPi;
+    const float mpxThreshold = m_stereoDetected ? kMpxMinHold : kMpxMinAcquire;
+    const float ratioThreshold =
+        m_stereoDetected ? kPilotRatioHold : kPilotRatioAcquire;
+    const float pilotRatio =
+        m_pilotBandMagnitude / std::max(m_mpxMagnitude, 1e-3f);
+    m_stereoDetected =
+        (m_mpxMagnitude > mpxThreshold) && (pilotRatio > ratioThreshold);
+    m_watchSum = std::complex<double>(0.0, 0.0);
+    m_watchSamples = 0;
+  }
+  return blockSum * (2.0 / static_cast<double>(numSamples));
+}
+
+size_t StereoDecoder::processMonoBlock(const float *mono, float *left,
+                                       float *right, size_t numSamples,
+                                       const float *wideHiss) {
+  const std::complex<double> phasorStart = m_watchPhasor;
+  const std::complex<double> tone = accumulatePilotWatch(mono, numSamples);
+  // Forced mono on a stereo station: the LMS canceller has no PLL reference
+  // here, so take the pilot out with this block's 19 kHz fit instead.
+  const bool cancelPilot = m_pilotCancellerEnabled && m_stereoDetected;
+  std::complex<double> phasor = phasorStart;
+  for (size_t i = 0; i < numSamples; i++) {
+    float mpx = mono[i];
+    const float mpxWide = (wideHiss != nullptr) ? (mpx + wideHiss[i]) : mpx;
+    m_mpxMagnitude =
+        (m_mpxMagnitude * m_envSmooth) + (std::abs(mpxWide) * m_envInject);
+    if (cancelPilot) {
+      mpx -= static_cast<float>((tone * std::conj(phasor)).real());
+      phasor *= m_watchStep;
+    }
+    // Same delay as the stereo path, so switching paths keeps the timeline.
+    const float delayedMpx = m_delayLine[m_delayPos];
+    m_delayLine[m_delayPos] = mpx;
+    m_delayPos++;
+    if (m_delayPos >= m_delayLine.size()) {
+      m_delayPos = 0;
+    }
+    // L = R = (M + 0) / 2, as the matrix with the L-R path muted.
+    left[i] = 0.5f * delayedMpx;
+    right[i] = 0.5f * delayedMpx;
+  }
+
+  m_stereoBlend = 0.0f;
+  m_stereoQuality = 0.0f;
+  const float calibrated = m_pilotMagnitude * 8.0f;
+  m_pilotLevelTenthsKHz =
+      std::clamp(static_cast<int>(std::round(calibrated * 750.0f)), 0, 750);
+  return numSamples;
+}
+
+void StereoDecoder::leaveMonoFastPath() {
+  // The pilot band-pass and PLL sat idle: restart them cold, in acquire mode.
+  m_monoFastPath = false;
+  m_stereoDetected = false;
+  m_pilotConfidence = 0.0f;
+  m_pilotAbsentSec = 0.0f;
+  m_pilotI = 0.0f;
+  m_pilotQ = 0.0f;
+  m_pilotResidualMagnitude = 0.0f;
+  m_hiBlendZ1 = 0.0f;
+  m_hiBlendZ2 = 0.0f;
+  m_pilotBandFilter.reset();
+  m_pilotPll.reset();
+  m_pilotPll.setBandwidth(m_pllBwAcquire);
+}
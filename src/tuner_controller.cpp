@@ -8,6 +8,9 @@ TunerController::SourceKind kindFromSource(const std::string &source) {
   if (source == "rtl_tcp") {
     return TunerController::SourceKind::RtlTcp;
   }
+  if (source == "file") {
+    return TunerController::SourceKind::File;
+  }
   return TunerController::SourceKind::RtlSdr;
 }
 } // namespace
@@ -24,6 +27,8 @@ const char *TunerController::name() const {
     return "sdrplay";
   case SourceKind::RtlTcp:
     return "rtl_tcp";
+  case SourceKind::File:
+    return "file";
   case SourceKind::RtlSdr:
   default:
     return "rtl_sdr";
@@ -36,12 +41,24 @@ void TunerController::configureSdrplay(int lnaState, int antenna, bool biasTee)
   m_sdrplayBiasTee = biasTee;
 }
 
+void TunerController::configureReplay(const std::string &path,
+                                      const std::string &format, bool paced,
+                                      bool loop) {
+  m_fileSource.configure(path, format, paced, loop);
+}
+
 void TunerController::setLowLatencyMode(bool enable) {
   if (m_kind == SourceKind::RtlSdr) {
     m_rtlSdrDevice.setLowLatencyMode(enable);
   }
 }
 
+void TunerController::setVerboseLogging(bool enable) {
+  if (m_kind == SourceKind::RtlTcp) {
+    m_rtlTcpClient.setVerboseLogging(enable);
+  }
+}
+
 bool TunerController::connect() {
   switch (m_kind) {
   case SourceKind::SdrPlay: {
@@ -59,6 +76,8 @@ bool TunerController::connect() {
   }
   case SourceKind::RtlTcp:
     return m_rtlTcpClient.connect();
+  case SourceKind::File:
+    return m_fileSource.connect();
   case SourceKind::RtlSdr:
   default:
     return m_rtlSdrDevice.connect();
@@ -73,6 +92,9 @@ void TunerController::disconnect() {
   case SourceKind::RtlTcp:
     m_rtlTcpClient.disconnect();
     break;
+  case SourceKind::File:
+    m_fileSource.disconnect();
+    break;
   case SourceKind::RtlSdr:
   default:
     m_rtlSdrDevice.disconnect();
@@ -81,15 +103,26 @@ void TunerController::disconnect() {
 }
 
 bool TunerController::setFrequency(uint32_t freqHz) {
+  bool ok = false;
   switch (m_kind) {
   case SourceKind::SdrPlay:
-    return m_sdrplayDevice.setFrequency(freqHz);
+    ok = m_sdrplayDevice.setFrequency(freqHz);
+    break;
   case SourceKind::RtlTcp:
-    return m_rtlTcpClient.setFrequency(freqHz);
+    ok = m_rtlTcpClient.setFrequency(freqHz);
+    break;
+  case SourceKind::File:
+    ok = m_fileSource.setFrequency(freqHz);
+    break;
   case SourceKind::RtlSdr:
   default:
-    return m_rtlSdrDevice.setFrequency(freqHz);
+    ok = m_rtlSdrDevice.setFrequency(freqHz);
+    break;
   }
+  if (ok) {
+    m_frequencyHz.store(freqHz, std::memory_order_relaxed);
+  }
+  return ok;
 }
 
 bool TunerController::setSampleRate(uint32_t sampleRate) {
@@ -98,6 +131,8 @@ bool TunerController::setSampleRate(uint32_t sampleRate) {
     return m_sdrplayDevice.setSampleRate(sampleRate);
   case SourceKind::RtlTcp:
     return m_rtlTcpClient.setSampleRate(sampleRate);
+  case SourceKind::File:
+    return m_fileSource.setSampleRate(sampleRate);
   case SourceKind::RtlSdr:
   default:
     return m_rtlSdrDevice.setSampleRate(sampleRate);
@@ -110,6 +145,8 @@ bool TunerController::setFrequencyCorrection(int ppm) {
     return m_sdrplayDevice.setFrequencyCorrection(ppm);
   case SourceKind::RtlTcp:
     return m_rtlTcpClient.setFrequencyCorrection(ppm);
+  case SourceKind::File:
+    return true; // recorded IQ: gain and correction are baked in
   case SourceKind::RtlSdr:
   default:
     return m_rtlSdrDevice.setFrequencyCorrection(ppm);
@@ -122,6 +159,8 @@ bool TunerController::setGainMode(bool manual) {
     return m_sdrplayDevice.setGainMode(manual);
   case SourceKind::RtlTcp:
     return m_rtlTcpClient.setGainMode(manual);
+  case SourceKind::File:
+    return true; // recorded IQ: gain and correction are baked in
   case SourceKind::RtlSdr:
   default:
     return m_rtlSdrDevice.setGainMode(manual);
@@ -134,6 +173,8 @@ bool TunerController::setGain(uint32_t gainTenthsDb) {
     return m_sdrplayDevice.setGain(gainTenthsDb);
   case SourceKind::RtlTcp:
     return m_rtlTcpClient.setGain(gainTenthsDb);
+  case SourceKind::File:
+    return true; // recorded IQ: gain and correction are baked in
   case SourceKind::RtlSdr:
   default:
     return m_rtlSdrDevice.setGain(gainTenthsDb);
@@ -146,6 +187,8 @@ bool TunerController::setAGC(bool enable) {
     return m_sdrplayDevice.setAGC(enable);
   case SourceKind::RtlTcp:
     return m_rtlTcpClient.setAGC(enable);
+  case SourceKind::File:
+    return true; // recorded IQ: gain and correction are baked in
   case SourceKind::RtlSdr:
   default:
     return m_rtlSdrDevice.setAGC(enable);
@@ -185,6 +228,8 @@ uint32_t TunerController::setScanWideMode(bool wide) {
 void TunerController::flushBuffers() {
   if (m_kind == SourceKind::RtlSdr) {
     m_rtlSdrDevice.flushBuffers();
+  } else if (m_kind == SourceKind::RtlTcp) {
+    m_rtlTcpClient.flushBuffers();
   }
 }
 
@@ -194,6 +239,8 @@ size_t TunerController::readIQ(uint8_t *buffer, size_t maxSamples) {
     return m_sdrplayDevice.readIQ(buffer, maxSamples);
   case SourceKind::RtlTcp:
     return m_rtlTcpClient.readIQ(buffer, maxSamples);
+  case SourceKind::File:
+    return m_fileSource.readIQ(buffer, maxSamples);
   case SourceKind::RtlSdr:
   default:
     return m_rtlSdrDevice.readIQ(buffer, maxSamples);
@@ -204,9 +251,71 @@ size_t TunerController::readIQ(std::complex<float> *buffer, size_t maxSamples) {
   if (m_kind == SourceKind::SdrPlay) {
     return m_sdrplayDevice.readIQ(buffer, maxSamples);
   }
+  if (m_kind == SourceKind::File) {
+    return m_fileSource.readIQ(buffer, maxSamples);
+  }
   return 0;
 }
 
+TunerController::IqLease TunerController::leaseIQ(size_t maxSamples) {
+  IqLease lease;
+  switch (m_kind) {
+  case SourceKind::SdrPlay:
+    lease.samples = m_sdrplayDevice.leaseIQ(maxSamples, lease.cf32);
+    break;
+  case SourceKind::RtlTcp:
+    lease.samples = m_rtlTcpClient.leaseIQ(maxSamples, lease.u8);
+    break;
+  case SourceKind::File:
+    if (m_fileSource.format() != FileSource::Format::U8) {
+      lease.samples = m_fileSource.leaseIQ(maxSamples, lease.cf32);
+    } else {
+      lease.samples = m_fileSource.leaseIQ(maxSamples, lease.u8);
+    }
+    break;
+  case SourceKind::RtlSdr:
+  default:
+    lease.samples = m_rtlSdrDevice.leaseIQ(maxSamples, lease.u8);
+    break;
+  }
+  return lease;
+}
+
+size_t TunerController::queuedSamples() const {
+  switch (m_kind) {
+  case SourceKind::SdrPlay:
+    return m_sdrplayDevice.queuedSamples();
+  case SourceKind::RtlTcp:
+    return m_rtlTcpClient.queuedSamples();
+  case SourceKind::File:
+    return 0;
+  case SourceKind::RtlSdr:
+  default:
+    return m_rtlSdrDevice.queuedSamples();
+  }
+}
+
+void TunerController::releaseIQ(const IqLease &lease) {
+  if (lease.samples == 0) {
+    return;
+  }
+  switch (m_kind) {
+  case SourceKind::SdrPlay:
+    m_sdrplayDevice.releaseIQ(lease.samples);
+    break;
+  case SourceKind::RtlTcp:
+    m_rtlTcpClient.releaseIQ(lease.samples);
+    break;
+  case SourceKind::File:
+    m_fileSource.releaseIQ(lease.samples);
+    break;
+  case SourceKind::RtlSdr:
+  default:
+    m_rtlSdrDevice.releaseIQ(lease.samples);
+    break;
+  }
+}
+
 int TunerController::antennaCount() const {
   return m_kind == SourceKind::SdrPlay ? m_sdrplayDevice.antennaCount() : 1;
 }
@@ -216,7 +325,20 @@ const char *TunerController::modelName() const {
 }
 
 bool TunerController::deviceFailed() const {
-  return m_kind == SourceKind::SdrPlay && m_sdrplayDevice.failed();
+  switch (m_kind) {
+  case SourceKind::SdrPlay:
+    return m_sdrplayDevice.failed();
+  case SourceKind::RtlTcp:
+    return m_rtlTcpClient.failed();
+  case SourceKind::File:
+  case SourceKind::RtlSdr:
+  default:
+    return false;
+  }
+}
+
+bool TunerController::endOfStream() const {
+  return m_kind == SourceKind::File && m_fileSource.endOfStream();
 }
 
 int TunerController::deliveredSampleRate() const {
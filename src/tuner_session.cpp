@@ -22,6 +22,8 @@ void TunerSession::connect() {
   }
   if (m_tuner.isSdrPlay()) {
     std::cout << "[SDR] connecting to sdrplay device...\n";
+  } else if (m_tuner.isFile()) {
+    std::cout << "[SDR] opening IQ recording...\n";
   } else if (m_params.useDirectRtlSdr) {
     std::cout << "[SDR] connecting to rtl_sdr device " << m_params.rtlDeviceIndex
               << "...\n";
@@ -57,15 +57,14 @@ bool WavWriter::init(const std::string &filename, uint32_t sampleRate,
   m_resampleAccum.clear();
 
   if (resampleFromHz != 0 && resampleFromHz != sampleRate && channels == 1) {
-    const float ratio =
-        static_cast<float>(sampleRate) / static_cast<float>(resampleFromHz);
     try {
-      m_resampler.init(ratio);
+      m_resampler.init(resampleFromHz, sampleRate);
       m_resampleEnabled = true;
       if (m_verboseLogging) {
         std::cout << "[AUDIO] " << m_label << " resample "
                   << resampleFromHz << " Hz -> " << sampleRate << " Hz (ratio "
-                  << ratio << ")\n";
+                  << m_resampler.interpolation() << "/"
+                  << m_resampler.decimation() << ")\n";
       }
     } catch (const std::exception &ex) {
       std::cerr << "[AUDIO] " << m_label
@@ -235,24 +234,15 @@ bool WavWriter::enqueueMonoFloat(const float *samples, size_t sampleCount) {
   if (!m_resampleEnabled) {
     return enqueueInterleavedFloat(samples, sampleCount);
   }
-  // Push each input sample through the resampler and collect outputs into the
-  // accumulator. Once the accumulator has data we flush it through the
+  // Resample the block into the accumulator, then flush it through the
   // existing path so the rest of the pipeline is unchanged.
-  if (m_resampleAccum.capacity() == 0) {
-    m_resampleAccum.reserve(sampleCount); // typical 1 in -> ~1 out
-  }
-  m_resampleAccum.clear();
-  for (size_t i = 0; i < sampleCount; i++) {
-    const std::uint32_t produced =
-        m_resampler.execute(samples[i], m_resampleTmp);
-    for (std::uint32_t p = 0; p < produced; p++) {
-      m_resampleAccum.push_back(m_resampleTmp[p]);
-    }
-  }
-  if (m_resampleAccum.empty()) {
+  m_resampleAccum.resize(m_resampler.maxOutput(sampleCount));
+  const size_t produced =
+      m_resampler.execute(samples, sampleCount, m_resampleAccum.data());
+  if (produced == 0) {
     return true; // nothing to write yet — common when downsampling
   }
-  return enqueueInterleavedFloat(m_resampleAccum.data(), m_resampleAccum.size());
+  return enqueueInterleavedFloat(m_resampleAccum.data(), produced);
 }
 
 void WavWriter::runWriterThread() {
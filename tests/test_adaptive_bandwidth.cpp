@@ -53,12 +53,12 @@ TEST_CASE("Hysteresis blocks rapid bandwidth changes", "[adaptive_bandwidth]") {
   REQUIRE(state.lastTargetHz == 194000);
 
   // Immediate second proposal must be suppressed by the min-interval gate.
-  const auto t1 = t0 + std::chrono::milliseconds(500);
+  const auto t1 = t0 + std::chrono::milliseconds(200);
   const int second = applyAdaptiveBandwidthHysteresis(state, 95000, 194000, t1);
   REQUIRE(second == 0);
 
   // After the interval elapses, a meaningfully-different proposal commits.
-  const auto t2 = t0 + std::chrono::milliseconds(2500);
+  const auto t2 = t0 + std::chrono::milliseconds(600);
   const int third = applyAdaptiveBandwidthHysteresis(state, 95000, 194000, t2);
   REQUIRE(third == 95000);
 }
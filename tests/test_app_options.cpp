@@ -36,6 +36,38 @@ TEST_CASE("App options parser normalizes tuner source aliases", "[app_options]")
   REQUIRE(result.options.tunerSource == "rtl_tcp");
 }
 
+TEST_CASE("App options parser --replay selects the file source",
+          "[app_options]") {
+  std::vector<std::string> args = {"fm-sdr-tuner", "--replay",   "band.cf32",
+                                   "--replay-fast", "--replay-loop", "-s"};
+  std::vector<char *> argv = makeArgv(args);
+  const AppParseResult result =
+      parseAppOptions(static_cast<int>(argv.size()), argv.data(), 256000);
+  REQUIRE(result.outcome == AppParseOutcome::Run);
+  REQUIRE(result.options.tunerSource == "file");
+  REQUIRE(result.options.replayFile == "band.cf32");
+  REQUIRE(result.options.replayFormat == "auto");
+  REQUIRE_FALSE(result.options.replayRealtime);
+  REQUIRE(result.options.replayLoop);
+}
+
+TEST_CASE("App options parser accepts --iq-format", "[app_options]") {
+  std::vector<std::string> args = {"fm-sdr-tuner", "-i", "band.iq",
+                                   "--iq-format", "cs16"};
+  std::vector<char *> argv = makeArgv(args);
+  const AppParseResult result =
+      parseAppOptions(static_cast<int>(argv.size()), argv.data(), 256000);
+  REQUIRE(result.outcome == AppParseOutcome::Run);
+  REQUIRE(result.options.iqFile == "band.iq");
+  REQUIRE(result.options.iqFormat == "cs16");
+
+  std::vector<std::string> bad = {"fm-sdr-tuner", "--iq-format=s8"};
+  std::vector<char *> badArgv = makeArgv(bad);
+  REQUIRE(parseAppOptions(static_cast<int>(badArgv.size()), badArgv.data(),
+                          256000)
+              .outcome == AppParseOutcome::ExitFailure);
+}
+
 TEST_CASE("App options parser rejects invalid IQ rate", "[app_options]") {
   std::vector<std::string> args = {"fm-sdr-tuner", "--iq-rate", "123456"};
   std::vector<char *> argv = makeArgv(args);
@@ -44,6 +76,22 @@ TEST_CASE("App options parser rejects invalid IQ rate", "[app_options]") {
   REQUIRE(result.outcome == AppParseOutcome::ExitFailure);
 }
 
+TEST_CASE("App options parser accepts fractional IQ rates", "[app_options]") {
+  for (const char *rate : {"2400000", "1920000", "300000"}) {
+    std::vector<std::string> args = {"fm-sdr-tuner", "--iq-rate", rate, "-s"};
+    std::vector<char *> argv = makeArgv(args);
+    const AppParseResult result =
+        parseAppOptions(static_cast<int>(argv.size()), argv.data(), 256000);
+    REQUIRE(result.outcome == AppParseOutcome::Run);
+    REQUIRE(result.options.iqSampleRate == std::stoul(rate));
+  }
+  std::vector<std::string> tooFast = {"fm-sdr-tuner", "--iq-rate", "20000000",
+                                      "-s"};
+  std::vector<char *> argv = makeArgv(tooFast);
+  REQUIRE(parseAppOptions(static_cast<int>(argv.size()), argv.data(), 256000)
+              .outcome == AppParseOutcome::ExitFailure);
+}
+
 TEST_CASE("App options parser toggles low-latency IQ flag", "[app_options]") {
   std::vector<std::string> args = {"fm-sdr-tuner", "--low-latency-iq",
                                    "--no-low-latency-iq", "-s"};
@@ -54,6 +102,25 @@ TEST_CASE("App options parser toggles low-latency IQ flag", "[app_options]") {
   REQUIRE_FALSE(result.options.lowLatencyIq);
 }
 
+TEST_CASE("App options parser reads and bounds the latency target",
+          "[app_options]") {
+  std::vector<std::string> args = {"fm-sdr-tuner", "--latency=60", "-s"};
+  std::vector<char *> argv = makeArgv(args);
+  AppParseResult result =
+      parseAppOptions(static_cast<int>(argv.size()), argv.data(), 256000);
+  REQUIRE(result.outcome == AppParseOutcome::Run);
+  REQUIRE(result.options.targetLatencyMs == 60);
+
+  for (const char *bad : {"10", "900", "soon"}) {
+    std::vector<std::string> badArgs = {"fm-sdr-tuner", "--latency", bad,
+                                        "-s"};
+    std::vector<char *> badArgv = makeArgv(badArgs);
+    REQUIRE(parseAppOptions(static_cast<int>(badArgv.size()), badArgv.data(),
+                            256000)
+                .outcome == AppParseOutcome::ExitFailure);
+  }
+}
+
 TEST_CASE("App options parser reads tcp host and port", "[app_options]") {
   std::vector<std::string> args = {"fm-sdr-tuner", "--tcp", "192.168.1.2:4321",
                                    "-s"};
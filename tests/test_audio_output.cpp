@@ -89,14 +89,12 @@ TEST_CASE("AudioOutput speaker ring keeps newest samples and clears cleanly",
   AudioOutput out;
   out.m_speakerRing.assign(8, 0.0f);
 
-  const float leftA[3] = {1.0f, 2.0f, 3.0f};
-  const float rightA[3] = {10.0f, 20.0f, 30.0f};
-  out.pushSpeakerSamples(leftA, rightA, 3, "test");
+  const float framesA[6] = {1.0f, 10.0f, 2.0f, 20.0f, 3.0f, 30.0f};
+  out.pushSpeakerSamples(framesA, 3, "test");
   REQUIRE(out.m_speakerSize == 6);
 
-  const float leftB[3] = {4.0f, 5.0f, 6.0f};
-  const float rightB[3] = {40.0f, 50.0f, 60.0f};
-  out.pushSpeakerSamples(leftB, rightB, 3, "test");
+  const float framesB[6] = {4.0f, 40.0f, 5.0f, 50.0f, 6.0f, 60.0f};
+  out.pushSpeakerSamples(framesB, 3, "test");
   REQUIRE(out.m_speakerSize == out.m_speakerRing.size());
 
   std::vector<float> popped(out.m_speakerRing.size(), 0.0f);
@@ -117,3 +115,88 @@ TEST_CASE("AudioOutput speaker ring keeps newest samples and clears cleanly",
     REQUIRE(out.m_speakerWritePos == 0);
   }
 }
+
+TEST_CASE("AudioOutput trims a standing speaker backlog under a latency target",
+          "[audio_output]") {
+  static constexpr size_t kPopSamples = 400;
+  auto run = [](AudioOutput &out, size_t backlogFrames, size_t windows) {
+    std::vector<float> frames(backlogFrames * AudioOutput::CHANNELS, 0.5f);
+    out.pushSpeakerSamples(frames.data(), backlogFrames, "test");
+    std::vector<float> block(kPopSamples, 0.5f);
+    std::vector<float> popped(kPopSamples, 0.0f);
+    const size_t pops = windows * AudioOutput::kRingWindowSamples / kPopSamples;
+    for (size_t i = 0; i < pops; i++) {
+      out.pushSpeakerSamples(block.data(), kPopSamples / AudioOutput::CHANNELS,
+                             "test");
+      std::lock_guard<std::mutex> lock(out.m_speakerMutex);
+      REQUIRE(out.popSpeakerSamplesLocked(popped.data(), kPopSamples) ==
+              kPopSamples);
+      for (const float v : popped) {
+        REQUIRE(v == Approx(0.5f));
+      }
+    }
+  };
+
+  AudioOutput untargeted;
+  untargeted.m_verboseLogging = false;
+  run(untargeted, 9600, 2);
+  REQUIRE(untargeted.m_speakerSize == 9600 * AudioOutput::CHANNELS);
+
+  AudioOutput out;
+  out.m_verboseLogging = false;
+  out.setTargetLatencyMs(60);
+  run(out, 9600, 2);
+  // 200 ms of backlog is cut to the initial two-pop allowance.
+  REQUIRE(out.m_ringAllowance == 2 * kPopSamples);
+  REQUIRE(out.m_speakerSize <= out.m_ringAllowance);
+
+  // Running the ring dry raises the allowance by a pop.
+  std::vector<float> popped(kPopSamples, 0.0f);
+  {
+    std::lock_guard<std::mutex> lock(out.m_speakerMutex);
+    for (size_t i = 0; i < AudioOutput::kRingWindowSamples / kPopSamples; i++) {
+      (void)out.popSpeakerSamplesLocked(popped.data(), kPopSamples);
+    }
+  }
+  REQUIRE(out.m_ringAllowance == 3 * kPopSamples);
+
+  // A device period that outgrows the allowance lifts it to the new floor
+  // when the allowance steps down, instead of wrapping below zero.
+  constexpr size_t kLargePop = 4096;
+  std::vector<float> backlog(kLargePop, 0.5f);
+  out.pushSpeakerSamples(backlog.data(), kLargePop / AudioOutput::CHANNELS,
+                         "test");
+  std::lock_guard<std::mutex> lock(out.m_speakerMutex);
+  out.m_ringAllowance = kPopSamples;
+  out.m_ringCalmWindows = AudioOutput::kRingCalmWindows - 1;
+  out.m_ringWindowPopped = AudioOutput::kRingWindowSamples;
+  out.m_ringWindowStarved = false;
+  out.trackSpeakerDepthLocked(kLargePop);
+  REQUIRE(out.m_ringAllowance == kLargePop);
+}
+
+TEST_CASE("AudioOutput backlog trim crossfades across the skipped audio",
+          "[audio_output]") {
+  AudioOutput out;
+  out.m_speakerRing.assign(1024, 0.0f);
+  std::vector<float> frames(256 * AudioOutput::CHANNELS);
+  for (size_t i = 0; i < frames.size(); i++) {
+    frames[i] = (i / AudioOutput::CHANNELS) < 128 ? 1.0f : -1.0f;
+  }
+  out.pushSpeakerSamples(frames.data(), 256, "test");
+
+  std::lock_guard<std::mutex> lock(out.m_speakerMutex);
+  out.trimSpeakerRingLocked(128 * AudioOutput::CHANNELS);
+  REQUIRE(out.m_speakerSize == 128 * AudioOutput::CHANNELS);
+  std::vector<float> popped(out.m_speakerSize);
+  REQUIRE(out.popSpeakerSamplesLocked(popped.data(), popped.size()) ==
+          popped.size());
+  // Starts next to the skipped 1.0s, eases to the kept -1.0s, then is them.
+  REQUIRE(popped[0] > 0.9f);
+  for (size_t i = AudioOutput::CHANNELS; i < popped.size(); i++) {
+    REQUIRE(popped[i] <= popped[i - AudioOutput::CHANNELS]);
+    REQUIRE(popped[i - AudioOutput::CHANNELS] - popped[i] < 0.05f);
+  }
+  REQUIRE(popped[AudioOutput::kRingTrimFadeFrames * AudioOutput::CHANNELS] ==
+          -1.0f);
+}
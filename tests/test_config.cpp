@@ -39,12 +39,14 @@ TEST_CASE("Config parses audio section", "[config]") {
     file << "[audio]\n";
     file << "enable_audio = true\n";
     file << "startup_volume = 50\n";
+    file << "target_latency_ms = 5\n";
     file.close();
     
     bool result = config.loadFromFile("test_config.ini");
     REQUIRE(result == true);
     REQUIRE(config.audio.enable_audio == true);
     REQUIRE(config.audio.startup_volume == 50);
+    REQUIRE(config.audio.target_latency_ms == 20);
     
     std::remove("test_config.ini");
 }
@@ -103,6 +105,32 @@ TEST_CASE("Config parses sdrplay section", "[config]") {
     std::remove("test_config.ini");
 }
 
+TEST_CASE("Config parses replay section and file source", "[config]") {
+    Config config;
+    config.loadDefaults();
+
+    REQUIRE(config.replay.realtime == true);
+    REQUIRE(config.replay.format == "auto");
+
+    std::ofstream file("test_config.ini");
+    file << "[tuner]\n";
+    file << "source = file\n";
+    file << "[replay]\n";
+    file << "file = capture.iq\n";
+    file << "format = CF32\n";
+    file << "realtime = false\n";
+    file << "loop = true\n";
+    file.close();
+
+    REQUIRE(config.loadFromFile("test_config.ini"));
+    REQUIRE(config.tuner.source == "file");
+    REQUIRE(config.replay.file == "capture.iq");
+    REQUIRE(config.replay.format == "cf32");
+    REQUIRE(config.replay.realtime == false);
+    REQUIRE(config.replay.loop == true);
+    std::remove("test_config.ini");
+}
+
 TEST_CASE("Config clamps sdrplay out-of-range values to defaults", "[config]") {
     Config config;
     config.loadDefaults();
@@ -220,6 +248,8 @@ TEST_CASE("Config parses and clamps processing fields", "[config]") {
     file << "dsp_agc = slow\n";
     file << "stereo_blend = aggressive\n";
     file << "stereo = no\n";
+    file << "squelch_idle = yes\n";
+    file << "dsp_pipeline_stages = 5\n";
     file.close();
 
     const bool result = config.loadFromFile("test_config.ini");
@@ -229,6 +259,8 @@ TEST_CASE("Config parses and clamps processing fields", "[config]") {
     REQUIRE(config.processing.dsp_agc == "slow");
     REQUIRE(config.processing.stereo_blend == "aggressive");
     REQUIRE(config.processing.stereo == false);
+    REQUIRE(config.processing.squelch_idle == true);
+    REQUIRE(config.processing.dsp_pipeline_stages == 3);
 
     std::remove("test_config.ini");
 }
@@ -13,8 +13,17 @@
 
 #include "af_post_processor.h"
 #include "config.h"
+#include "dsp/fm_front_end.h"
+#include "dsp/half_band_decimator.h"
+#include "dsp/iq_decimator.h"
+#include "dsp/iq_rate_converter.h"
+#include "dsp/kernel_registry.h"
 #include "dsp/liquid_primitives.h"
 #include "dsp/multipath_eq.h"
+#include "dsp/phase_discriminator.h"
+#include "dsp/pilot_pll.h"
+#include "dsp/polyphase_resampler.h"
+#include "dsp/real_fir_filter.h"
 #include "dsp/squelch.h"
 #include "dsp_pipeline.h"
 #include "fm_demod.h"
@@ -276,6 +285,68 @@ TEST_CASE("FMDemod reset restores deterministic output for same IQ input",
   REQUIRE(meanAbsDiff(monoA.data(), monoB.data(), outA) < 1e-6f);
 }
 
+TEST_CASE("FMDemod bandwidth switch crossfades without restarting the demod",
+          "[dsp][fm_demod]") {
+  constexpr int kInputRate = 256000;
+  constexpr int kOutputRate = 32000;
+  constexpr size_t kBlock = 8192;
+  constexpr size_t kCrossfade = 512; // 2 ms at 256 kHz
+  constexpr float kTwoPi = 6.2831853071795864769f;
+
+  // 1 kHz tone at 10 kHz deviation, inside every filter below, and a weak
+  // carrier 90 kHz off that only the wide one lets through.
+  std::vector<std::complex<float>> iq(2 * kBlock);
+  float phase = 0.0f;
+  for (size_t i = 0; i < iq.size(); i++) {
+    const float t = static_cast<float>(i) / static_cast<float>(kInputRate);
+    phase += kTwoPi * 10000.0f * std::sin(kTwoPi * 1000.0f * t) /
+             static_cast<float>(kInputRate);
+    iq[i] = 0.5f * std::polar(1.0f, phase) +
+            0.05f * std::polar(1.0f, kTwoPi * 90000.0f * t);
+  }
+  auto run = [&](FMDemod &demod, size_t block) {
+    std::vector<float> mpx(kBlock, 0.0f);
+    std::vector<float> mono(kBlock, 0.0f);
+    (void)demod.processSplitComplex(iq.data() + block * kBlock, mpx.data(),
+                                    mono.data(), kBlock);
+    return mpx;
+  };
+
+  FMDemod narrow(kInputRate, kOutputRate);
+  narrow.setBandwidthHz(56000);
+  (void)run(narrow, 0);
+  const std::vector<float> expected = run(narrow, 1);
+  FMDemod wide(kInputRate, kOutputRate);
+  wide.setBandwidthHz(300000);
+  (void)run(wide, 0);
+  const std::vector<float> wideOut = run(wide, 1);
+
+  // Wide for the first block, then narrow (81 -> 121 taps), with a swap
+  // to a third filter in between that the second one cuts short.
+  FMDemod switched(kInputRate, kOutputRate);
+  switched.setBandwidthHz(300000);
+  (void)run(switched, 0);
+  switched.setBandwidthHz(150000);
+  switched.setBandwidthHz(56000);
+  const std::vector<float> out = run(switched, 1);
+
+  float filterStep = 0.0f;
+  float fadeError = 0.0f;
+  float settledError = 0.0f;
+  for (size_t i = 0; i < kBlock; i++) {
+    filterStep = std::max(filterStep, std::abs(wideOut[i] - expected[i]));
+    const float error = std::abs(out[i] - expected[i]);
+    (i <= kCrossfade ? fadeError : settledError) =
+        std::max(i <= kCrossfade ? fadeError : settledError, error);
+  }
+  REQUIRE(filterStep > 1e-2f);
+  // During the fade the output stays between the two filters' (a reset
+  // would restart the discriminator and the FIR from zeros instead) ...
+  REQUIRE(fadeError < filterStep + 0.01f);
+  // ... and afterwards it is exactly the narrow filter on the same history.
+  REQUIRE(settledError < 1e-5f);
+}
+
 TEST_CASE("AF deemphasis attenuates high frequencies more than low frequencies",
           "[dsp][af_post]") {
   constexpr int kInputRate = 256000;
@@ -519,6 +590,230 @@ TEST_CASE("Stereo decoder demod SNR is higher for a clean MPX than a noisy one",
   REQUIRE(cleanSnr > noisySnr + 6.0f);
 }
 
+TEST_CASE("Stereo decoder duty-cycled meters track the always-on readings",
+          "[dsp][stereo][metering]") {
+  using Mode = fm_tuner::dsp::MeteringScheduler::Mode;
+  constexpr int kInputRate = 256000;
+  constexpr size_t kSamples = 256000;
+  constexpr size_t kBlock = 4096;
+  constexpr float kTwoPi = 6.2831853071795864769f;
+
+  // Program + pilot + a biphase-keyed 57 kHz carrier at the RDS bit rate +
+  // broadband noise for the hiss band.
+  std::vector<float> mpx(kSamples, 0.0f);
+  uint32_t state = 0x2468ace1u;
+  auto nextNoise = [&]() -> float {
+    state = state * 1664525u + 1013904223u;
+    const uint32_t bits = (state >> 8) & 0x00ffffffu;
+    return (static_cast<float>(bits) / 8388607.5f) - 1.0f;
+  };
+  const size_t samplesPerBit = static_cast<size_t>(kInputRate / 1187.5f);
+  float bit = 1.0f;
+  for (size_t i = 0; i < kSamples; i++) {
+    const float t = static_cast<float>(i) / static_cast<float>(kInputRate);
+    if ((i % samplesPerBit) == 0) {
+      bit = (nextNoise() >= 0.0f) ? 1.0f : -1.0f;
+    }
+    mpx[i] = 0.6f * std::sin(kTwoPi * 1000.0f * t) +
+             0.08f * std::sin(kTwoPi * 19000.0f * t) +
+             0.04f * bit * std::sin(kTwoPi * 57000.0f * t) +
+             0.05f * nextNoise();
+  }
+
+  StereoDecoder always(kInputRate, 48000);
+  StereoDecoder duty(kInputRate, 48000);
+  StereoDecoder off(kInputRate, 48000);
+  duty.setMetering(Mode::DutyCycled, Mode::DutyCycled);
+  off.setMetering(Mode::Off, Mode::Off);
+
+  std::vector<float> l(kBlock, 0.0f);
+  std::vector<float> r(kBlock, 0.0f);
+  for (size_t pos = 0; pos + kBlock <= kSamples; pos += kBlock) {
+    always.processAudio(mpx.data() + pos, l.data(), r.data(), kBlock);
+    duty.processAudio(mpx.data() + pos, l.data(), r.data(), kBlock);
+    off.processAudio(mpx.data() + pos, l.data(), r.data(), kBlock);
+  }
+
+  const float refRds = always.getRdsDeviationKHz();
+  const float refSnr = always.getDemodSnrDb();
+  REQUIRE(refRds > 0.5f);
+  REQUIRE(refSnr > 5.0f);
+  REQUIRE(refSnr < 59.0f);
+  // The duty-cycled reading is a snapshot up to kMeterIntervalSec old, so it
+  // differs by the meter's own ripple on the keyed carrier, not by a bias.
+  CHECK(std::abs(duty.getRdsDeviationKHz() - refRds) < 0.10f * refRds);
+  CHECK(std::abs(duty.getDemodSnrDb() - refSnr) < 0.5f);
+
+  // Off never ran; switching it on meters the very next block.
+  REQUIRE(off.getRdsDeviationKHz() == 0.0f);
+  off.setMetering(Mode::DutyCycled, Mode::DutyCycled);
+  off.processAudio(mpx.data(), l.data(), r.data(), kBlock);
+  CHECK(off.getRdsDeviationKHz() > 0.5f * refRds);
+}
+
+TEST_CASE("Stereo decoder mono fast path enters on pilot loss and leaves on pilot return",
+          "[dsp][stereo][mono]") {
+  constexpr int kInputRate = 256000;
+  constexpr size_t kBlock = 8192;
+  constexpr float kTwoPi = 6.2831853071795864769f;
+
+  size_t clock = 0;
+  auto makeBlock = [&](bool withPilot) {
+    std::vector<float> mpx(kBlock, 0.0f);
+    for (size_t i = 0; i < kBlock; i++, clock++) {
+      const float t = static_cast<float>(clock) / static_cast<float>(kInputRate);
+      const float l = 0.45f * std::sin(kTwoPi * 1000.0f * t);
+      const float r = 0.30f * std::sin(kTwoPi * 1700.0f * t);
+      mpx[i] = (l + r);
+      if (withPilot) {
+        mpx[i] += 0.08f * std::sin(kTwoPi * 19000.0f * t) +
+                  (l - r) * std::sin(kTwoPi * 38000.0f * t);
+      }
+    }
+    return mpx;
+  };
+
+  StereoDecoder decoder(kInputRate, 48000);
+  std::vector<float> l(kBlock, 0.0f);
+  std::vector<float> r(kBlock, 0.0f);
+  const size_t blocksPerSec = static_cast<size_t>(kInputRate) / kBlock;
+
+  // Pilot-free program: the full path runs until the pilot has been gone for
+  // a couple of seconds, then the output is produced by the fast path.
+  std::vector<float> mpx;
+  float fullPathLevel = 0.0f;
+  for (size_t b = 0; b < 3 * blocksPerSec; b++) {
+    mpx = makeBlock(false);
+    decoder.processAudio(mpx.data(), l.data(), r.data(), kBlock);
+    if (b == blocksPerSec) {
+      REQUIRE_FALSE(decoder.isMonoOutput());
+      fullPathLevel = rms(l.data(), kBlock);
+    }
+  }
+  REQUIRE(decoder.isMonoOutput());
+  REQUIRE_FALSE(decoder.isStereo());
+  for (size_t i = 0; i < kBlock; i++) {
+    REQUIRE(l[i] == r[i]);
+  }
+  // Same L = R = M / 2 level as the matrix produced.
+  CHECK(std::abs(rms(l.data(), kBlock) - fullPathLevel) < 0.01f * fullPathLevel);
+
+  // Pilot back: the watch hands over to the full decoder, which locks.
+  for (size_t b = 0; b < blocksPerSec / 2; b++) {
+    mpx = makeBlock(true);
+    decoder.processAudio(mpx.data(), l.data(), r.data(), kBlock);
+  }
+  REQUIRE_FALSE(decoder.isMonoOutput());
+  REQUIRE(decoder.isStereo());
+  const int pilotTenths = decoder.getPilotLevelTenthsKHz();
+  REQUIRE(pilotTenths > 0);
+
+  // Forced mono on the stereo signal: fast path once the blend has decayed,
+  // with the watch still reporting the pilot.
+  decoder.setForceMono(true);
+  for (size_t b = 0; b < blocksPerSec / 2; b++) {
+    mpx = makeBlock(true);
+    decoder.processAudio(mpx.data(), l.data(), r.data(), kBlock);
+  }
+  REQUIRE(decoder.isMonoOutput());
+  CHECK(decoder.isStereo());
+  CHECK(std::abs(decoder.getPilotLevelTenthsKHz() - pilotTenths) <=
+        pilotTenths / 10 + 1);
+  for (size_t i = 0; i < kBlock; i++) {
+    REQUIRE(l[i] == r[i]);
+  }
+
+  decoder.setForceMono(false);
+  for (size_t b = 0; b < blocksPerSec / 2; b++) {
+    mpx = makeBlock(true);
+    decoder.processAudio(mpx.data(), l.data(), r.data(), kBlock);
+  }
+  REQUIRE_FALSE(decoder.isMonoOutput());
+  REQUIRE(decoder.isStereo());
+  CHECK(rms(l.data(), kBlock) > 1.2f * rms(r.data(), kBlock));
+}
+
+TEST_CASE("AF post mono path matches the two-channel path on identical input",
+          "[dsp][af_post][mono]") {
+  constexpr int kInputRate = 256000;
+  constexpr size_t kBlock = 4096;
+  constexpr float kTwoPi = 6.2831853071795864769f;
+
+  AFPostProcessor twoChannel(kInputRate, 48000);
+  AFPostProcessor monoPath(kInputRate, 48000);
+  std::vector<float> in(kBlock, 0.0f);
+  std::vector<float> other(kBlock, 0.0f);
+  std::vector<float> al(kBlock), ar(kBlock), bl(kBlock), br(kBlock);
+  size_t clock = 0;
+  // Mono for a while, then different channels: after the switch back the
+  // mono-path instance must still match sample for sample.
+  for (size_t b = 0; b < 12; b++) {
+    const bool stereo = (b >= 8);
+    for (size_t i = 0; i < kBlock; i++, clock++) {
+      const float t = static_cast<float>(clock) / static_cast<float>(kInputRate);
+      in[i] = 0.4f * std::sin(kTwoPi * 440.0f * t) + 0.1f;
+      other[i] = stereo ? 0.3f * std::sin(kTwoPi * 3000.0f * t) : in[i];
+    }
+    const size_t na = twoChannel.process(in.data(), other.data(), kBlock,
+                                         al.data(), ar.data(), kBlock);
+    const size_t nb =
+        stereo ? monoPath.process(in.data(), other.data(), kBlock, bl.data(),
+                                  br.data(), kBlock)
+               : monoPath.processMono(in.data(), kBlock, bl.data(), br.data(),
+                                      kBlock);
+    REQUIRE(na == nb);
+    for (size_t i = 0; i < na; i++) {
+      REQUIRE(al[i] == bl[i]);
+      REQUIRE(ar[i] == br[i]);
+    }
+  }
+}
+
+TEST_CASE("AF post interleaved lanes match independent single-channel runs",
+          "[dsp][af_post]") {
+  constexpr int kInputRate = 256000;
+  constexpr size_t kBlock = 4096;
+  constexpr float kTwoPi = 6.2831853071795864769f;
+
+  auto configure = [](AFPostProcessor &af) {
+    af.setDeemphasis(75);
+    af.setHicutMode(AFPostProcessor::HicutMode::Strong);
+    af.setSignalQuality(0.3f);
+  };
+  AFPostProcessor stereo(kInputRate, 48000);
+  AFPostProcessor leftOnly(kInputRate, 48000);
+  AFPostProcessor rightOnly(kInputRate, 48000);
+  configure(stereo);
+  configure(leftOnly);
+  configure(rightOnly);
+
+  std::vector<float> l(kBlock), r(kBlock);
+  std::vector<float> frames(2 * kBlock), lFrames(2 * kBlock),
+      rFrames(2 * kBlock);
+  size_t clock = 0;
+  for (size_t b = 0; b < 6; b++) {
+    for (size_t i = 0; i < kBlock; i++, clock++) {
+      const float t = static_cast<float>(clock) / static_cast<float>(kInputRate);
+      l[i] = 0.4f * std::sin(kTwoPi * 1000.0f * t) + 0.05f;
+      r[i] = 0.3f * std::sin(kTwoPi * 9000.0f * t) - 0.02f;
+    }
+    const size_t n =
+        stereo.processInterleaved(l.data(), r.data(), kBlock, frames.data(),
+                                  kBlock);
+    REQUIRE(n > 0);
+    REQUIRE(leftOnly.processMonoInterleaved(l.data(), kBlock, lFrames.data(),
+                                            kBlock) == n);
+    REQUIRE(rightOnly.processMonoInterleaved(r.data(), kBlock, rFrames.data(),
+                                             kBlock) == n);
+    // Shared phase walk and lane-parallel filters: each lane is exactly what
+    // that channel alone produces.
+    for (size_t i = 0; i < n; i++) {
+      REQUIRE(frames[2 * i] == lFrames[2 * i]);
+      REQUIRE(frames[2 * i + 1] == rFrames[2 * i + 1]);
+    }
+  }
+}
+
 TEST_CASE("Stereo decoder reduces blend when stereo difference path gets noisy",
           "[dsp][stereo]") {
   constexpr int kInputRate = 256000;
@@ -875,7 +1170,7 @@ TEST_CASE("DspPipeline decimation staging handles fragmented high-rate IQ withou
   constexpr size_t kIqDecimation = 4;
 
   DspPipeline pipeline(kInputRate, kOutputRate, processing, false,
-                       kBlockSamples, kIqDecimation);
+                       kBlockSamples, kInputRate * kIqDecimation);
   REQUIRE(pipeline.sdrBlockSamples() == kBlockSamples * kIqDecimation);
 
   const size_t totalIqSamples = pipeline.sdrBlockSamples() * 2;
@@ -900,7 +1195,7 @@ TEST_CASE("DspPipeline decimation staging handles fragmented high-rate IQ withou
     if (have) {
       REQUIRE(out.demodSamples == kBlockSamples);
       REQUIRE(out.outSamples > 900);
-      REQUIRE(std::isfinite(out.left[std::min<size_t>(10, out.outSamples - 1)]));
+      REQUIRE(std::isfinite(out.audio[2 * std::min<size_t>(10, out.outSamples - 1)]));
       producedBlocks++;
     }
     offset += chunk;
@@ -911,6 +1206,62 @@ TEST_CASE("DspPipeline decimation staging handles fragmented high-rate IQ withou
   REQUIRE(producedBlocks == 2);
 }
 
+TEST_CASE("DspPipeline whole-block input bypasses staging with identical output",
+          "[dsp][pipeline]") {
+  Config::ProcessingSection processing;
+  processing.stereo = false;
+  processing.w0_bandwidth_hz = 194000;
+
+  constexpr int kInputRate = 256000;
+  constexpr int kOutputRate = 48000;
+  constexpr size_t kBlockSamples = 4096;
+  constexpr size_t kIqDecimation = 4;
+
+  // Leased source memory normally hands the pipeline exactly one block per
+  // call (decimated in place); a slow source delivers fragments that go
+  // through the staging ring. Both must produce the same audio.
+  DspPipeline leased(kInputRate, kOutputRate, processing, false, kBlockSamples,
+                     kInputRate * kIqDecimation);
+  DspPipeline staged(kInputRate, kOutputRate, processing, false, kBlockSamples,
+                     kInputRate * kIqDecimation);
+  const size_t block = leased.sdrBlockSamples();
+  const size_t total = block * 3;
+  std::vector<uint8_t> iq(total * 2);
+  for (size_t i = 0; i < total; i++) {
+    const double ph = 2.0 * M_PI * 0.01 * static_cast<double>(i);
+    iq[i * 2] = static_cast<uint8_t>(std::lround(std::cos(ph) * 100.0 + 127.5));
+    iq[i * 2 + 1] =
+        static_cast<uint8_t>(std::lround(std::sin(ph) * 100.0 + 127.5));
+  }
+
+  std::vector<float> leasedAudio;
+  for (size_t b = 0; b < 3; b++) {
+    DspPipeline::Result out;
+    REQUIRE(leased.process(iq.data() + b * block * 2, block,
+                           [](const float *, size_t) {}, out));
+    leasedAudio.insert(leasedAudio.end(), out.audio,
+                       out.audio + 2 * out.outSamples);
+  }
+
+  std::vector<float> stagedAudio;
+  const size_t fragment = block / 3 + 7;
+  for (size_t offset = 0; offset < total;) {
+    const size_t chunk = std::min(fragment, total - offset);
+    DspPipeline::Result out;
+    if (staged.process(iq.data() + offset * 2, chunk,
+                       [](const float *, size_t) {}, out)) {
+      stagedAudio.insert(stagedAudio.end(), out.audio,
+                         out.audio + 2 * out.outSamples);
+    }
+    offset += chunk;
+  }
+
+  REQUIRE(leasedAudio.size() == stagedAudio.size());
+  for (size_t i = 0; i < leasedAudio.size(); i++) {
+    REQUIRE(leasedAudio[i] == stagedAudio[i]);
+  }
+}
+
 TEST_CASE("ComplexDecimator CF32 input matches uint8 input bit-for-bit",
           "[dsp][decimator][cf32]") {
   using fm_tuner::dsp::liquid::ComplexDecimator;
@@ -949,6 +1300,557 @@ TEST_CASE("ComplexDecimator CF32 input matches uint8 input bit-for-bit",
   }
 }
 
+namespace {
+
+// Steady-state gain (dB) of a decimator for a complex tone at freqHz.
+template <typename Decimate>
+double toneGainDb(double freqHz, double inputRate, size_t factor,
+                  Decimate &&decimate) {
+  constexpr size_t kOutSamples = 2048;
+  constexpr size_t kSettle = 512;
+  const size_t inSamples = kOutSamples * factor;
+  std::vector<std::complex<float>> in(inSamples);
+  for (size_t i = 0; i < inSamples; i++) {
+    const double ph = 2.0 * M_PI * freqHz * static_cast<double>(i) / inputRate;
+    in[i] = std::complex<float>(static_cast<float>(0.5 * std::cos(ph)),
+                                static_cast<float>(0.5 * std::sin(ph)));
+  }
+  std::vector<std::complex<float>> out(kOutSamples);
+  const size_t produced = decimate(in.data(), inSamples, out.data(), kOutSamples);
+  REQUIRE(produced == kOutSamples);
+  double power = 0.0;
+  for (size_t i = kSettle; i < kOutSamples; i++) {
+    power += std::norm(out[i]);
+  }
+  power /= static_cast<double>(kOutSamples - kSettle);
+  return 10.0 * std::log10(std::max(power, 1e-30) / 0.25);
+}
+
+} // namespace
+
+TEST_CASE("IqDecimator cascade keeps the firdecim passband and rejects aliases",
+          "[dsp][decimator]") {
+  using fm_tuner::dsp::IqDecimator;
+  using fm_tuner::dsp::liquid::ComplexDecimator;
+  constexpr double kOutputRate = 256000.0;
+
+  for (const uint32_t factor : {4u, 8u}) {
+    const double inputRate = kOutputRate * factor;
+    // The single-stage design the pipeline used before the cascade.
+    const auto oldResponse = [&](double freqHz) {
+      ComplexDecimator old;
+      old.init(factor, factor >= 8 ? 28 : 20, 80.0f);
+      return toneGainDb(freqHz, inputRate, factor,
+                        [&](const std::complex<float> *in, size_t n,
+                            std::complex<float> *out, size_t cap) {
+                          return old.executeComplexFromComplex(in, n, out, cap);
+                        });
+    };
+    const auto newResponse = [&](double freqHz) {
+      IqDecimator cascade;
+      cascade.init(factor, 100000.0f / 256000.0f, 80.0f);
+      return toneGainDb(freqHz, inputRate, factor,
+                        [&](const std::complex<float> *in, size_t n,
+                            std::complex<float> *out, size_t cap) {
+                          return cascade.execute(in, n, out, cap);
+                        });
+    };
+
+    IqDecimator probe;
+    probe.init(factor, 100000.0f / 256000.0f, 80.0f);
+    REQUIRE(probe.stageCount() == (factor == 8 ? 3u : 2u));
+    // The first (highest-rate) stage is the shortest.
+    REQUIRE(probe.stageLength(0) < probe.stageLength(probe.stageCount() - 1));
+
+    // Passband: where the old filter is flat, the cascade matches it; out to
+    // 100 kHz the cascade stays flat.
+    for (const double f : {0.0, 20000.0, -45000.0, 70000.0, -80000.0}) {
+      INFO("factor " << factor << " passband tone " << f);
+      REQUIRE(std::abs(newResponse(f) - oldResponse(f)) < 0.05);
+    }
+    for (const double f : {95000.0, -100000.0}) {
+      INFO("factor " << factor << " passband edge tone " << f);
+      REQUIRE(std::abs(newResponse(f)) < 0.05);
+    }
+
+    // Tones that alias into the +/-100 kHz channel after decimation are
+    // rejected by at least 75 dB (80 dB design, minus settling), and next to
+    // the channel, where the old filter's transition band sat, at least as
+    // well as before.
+    for (const double f : {160000.0, -200000.0, 300000.0, -420000.0, 500000.0,
+                           700000.0, -950000.0}) {
+      if (std::abs(f) >= inputRate / 2.0) {
+        continue;
+      }
+      const double gainNew = newResponse(f);
+      INFO("factor " << factor << " alias tone " << f << ": " << gainNew
+                     << " dB");
+      REQUIRE(gainNew < -75.0);
+      if (std::abs(f) <= 300000.0) {
+        REQUIRE(gainNew < oldResponse(f) + 0.5);
+      }
+    }
+  }
+}
+
+TEST_CASE("IqDecimator uint8 input matches normalized CF32 input",
+          "[dsp][decimator][cf32]") {
+  using fm_tuner::dsp::IqDecimator;
+  constexpr uint32_t kFactor = 8;
+  constexpr size_t kInSamples = 8192;
+
+  std::vector<uint8_t> iq(kInSamples * 2);
+  std::vector<std::complex<float>> cf(kInSamples);
+  uint32_t lcg = 12345u;
+  for (size_t i = 0; i < kInSamples; i++) {
+    lcg = lcg * 1664525u + 1013904223u;
+    const uint8_t iv = static_cast<uint8_t>(lcg >> 24);
+    const uint8_t qv = static_cast<uint8_t>(lcg >> 16);
+    iq[i * 2] = iv;
+    iq[i * 2 + 1] = qv;
+    cf[i] = std::complex<float>((static_cast<float>(iv) - 127.5f) / 127.5f,
+                                (static_cast<float>(qv) - 127.5f) / 127.5f);
+  }
+
+  IqDecimator decU8;
+  IqDecimator decCF;
+  decU8.init(kFactor, 100000.0f / 256000.0f, 80.0f);
+  decCF.init(kFactor, 100000.0f / 256000.0f, 80.0f);
+
+  const size_t outCap = kInSamples / kFactor;
+  std::vector<std::complex<float>> outU8(outCap);
+  std::vector<std::complex<float>> outCF(outCap);
+  REQUIRE(decU8.execute(iq.data(), kInSamples, outU8.data(), outCap) == outCap);
+  REQUIRE(decCF.execute(cf.data(), kInSamples, outCF.data(), outCap) == outCap);
+  for (size_t i = 0; i < outCap; i++) {
+    REQUIRE(std::abs(outU8[i].real() - outCF[i].real()) < 1e-4f);
+    REQUIRE(std::abs(outU8[i].imag() - outCF[i].imag()) < 1e-4f);
+  }
+}
+
+TEST_CASE("IqDecimator is phase continuous across uneven blocks",
+          "[dsp][decimator]") {
+  using fm_tuner::dsp::IqDecimator;
+  constexpr uint32_t kFactor = 8;
+  constexpr size_t kInSamples = 16384;
+
+  std::vector<uint8_t> iq(kInSamples * 2);
+  for (size_t i = 0; i < kInSamples; i++) {
+    const double ph = 0.37 * static_cast<double>(i);
+    iq[2 * i] = static_cast<uint8_t>(std::lround(127.5 + 100.0 * std::cos(ph)));
+    iq[2 * i + 1] =
+        static_cast<uint8_t>(std::lround(127.5 + 100.0 * std::sin(ph)));
+  }
+
+  IqDecimator whole;
+  whole.init(kFactor, 100000.0f / 256000.0f, 80.0f);
+  std::vector<std::complex<float>> expected(kInSamples / kFactor);
+  REQUIRE(whole.execute(iq.data(), kInSamples, expected.data(),
+                        expected.size()) == expected.size());
+
+  IqDecimator chunked;
+  chunked.init(kFactor, 100000.0f / 256000.0f, 80.0f);
+  std::vector<std::complex<float>> actual;
+  std::vector<std::complex<float>> out(kInSamples);
+  size_t offset = 0;
+  size_t step = 0;
+  while (offset < kInSamples) {
+    const size_t chunk =
+        std::min<size_t>(kInSamples - offset, 1 + (step++ * 977) % 1531);
+    const size_t produced =
+        chunked.execute(iq.data() + 2 * offset, chunk, out.data(), out.size());
+    actual.insert(actual.end(), out.begin(), out.begin() + produced);
+    offset += chunk;
+  }
+
+  REQUIRE(actual.size() == expected.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    REQUIRE(std::abs(actual[i] - expected[i]) < 1e-5f);
+  }
+}
+
+TEST_CASE("IqRateConverter lands fractional source rates on 256 kHz",
+          "[dsp][decimator]") {
+  using fm_tuner::dsp::IqRateConverter;
+  constexpr size_t kBlock = 4096;
+  constexpr size_t kBlocks = 6;
+  struct Case {
+    uint32_t rate;
+    uint32_t halfBandFactor;
+  };
+  for (const Case c : {Case{2400000, 8}, Case{1920000, 4}, Case{300000, 1}}) {
+    IqRateConverter converter;
+    converter.init(c.rate, 256000, 100000.0f);
+    INFO(converter.summary());
+    REQUIRE(converter.halfBandFactor() == c.halfBandFactor);
+    REQUIRE(converter.fractional());
+    REQUIRE(converter.actualOutputRate() == 256000.0);
+    REQUIRE(converter.multipliesPerInputSample() > 0.0);
+
+    // Runs kBlocks blocks of a complex tone; returns the output (dB gain and
+    // frequency from the average phase step) past the settling block.
+    const auto measure = [&](double freqHz, double &gainDb, double &outHz) {
+      converter.reset();
+      const size_t inBlock = converter.inputBlockFor(kBlock);
+      std::vector<std::complex<float>> in(inBlock);
+      std::vector<std::complex<float>> out(kBlock);
+      std::vector<std::complex<float>> all;
+      size_t t = 0;
+      for (size_t b = 0; b < kBlocks; b++) {
+        for (size_t i = 0; i < inBlock; i++, t++) {
+          const double ph = 2.0 * M_PI * freqHz * static_cast<double>(t) /
+                            static_cast<double>(c.rate);
+          in[i] = std::complex<float>(static_cast<float>(0.5 * std::cos(ph)),
+                                      static_cast<float>(0.5 * std::sin(ph)));
+        }
+        const size_t produced =
+            converter.execute(in.data(), inBlock, out.data(), kBlock);
+        // Never more than a block, and never far below one.
+        REQUIRE(produced <= kBlock);
+        REQUIRE(produced + 2 >= kBlock * 99 / 100);
+        all.insert(all.end(), out.begin(), out.begin() + produced);
+      }
+      double power = 0.0;
+      std::complex<double> step = 0.0;
+      for (size_t i = kBlock; i < all.size(); i++) {
+        power += std::norm(all[i]);
+        step += std::complex<double>(all[i]) *
+                std::conj(std::complex<double>(all[i - 1]));
+      }
+      power /= static_cast<double>(all.size() - kBlock);
+      gainDb = 10.0 * std::log10(std::max(power, 1e-30) / 0.25);
+      outHz = std::arg(step) / (2.0 * M_PI) * 256000.0;
+    };
+
+    double gainDb = 0.0;
+    double outHz = 0.0;
+    for (const double f : {0.0, 40000.0, -75000.0, 95000.0}) {
+      INFO("passband tone " << f);
+      measure(f, gainDb, outHz);
+      REQUIRE(std::abs(gainDb) < 0.05);
+      REQUIRE(std::abs(outHz - f) < 1.0);
+    }
+    // Out-of-band tones: the ones that end up inside the +/-100 kHz channel
+    // after folding at each stage's output rate must be gone.
+    const auto fold = [](double f, double rate) {
+      return f - rate * std::round(f / rate);
+    };
+    size_t checked = 0;
+    for (const double f : {170000.0, -190000.0, 230000.0, 410000.0, -530000.0,
+                           700000.0, -900000.0}) {
+      if (std::abs(f) >= c.rate / 2.0) {
+        continue;
+      }
+      double landing = f;
+      double rate = c.rate;
+      for (uint32_t factor = c.halfBandFactor; factor > 1; factor /= 2) {
+        rate /= 2.0;
+        landing = fold(landing, rate);
+      }
+      landing = fold(landing, 256000.0);
+      if (std::abs(landing) > 100000.0) {
+        continue;
+      }
+      INFO("alias tone " << f << " -> " << landing);
+      measure(f, gainDb, outHz);
+      REQUIRE(gainDb < -75.0);
+      checked++;
+    }
+    // At 300 kHz nothing can fold into the channel; the others must test some.
+    REQUIRE((checked > 0 || c.halfBandFactor == 1));
+  }
+}
+
+TEST_CASE("IqRateConverter approximates ratios with too many branches",
+          "[dsp][decimator]") {
+  fm_tuner::dsp::IqRateConverter converter;
+  // 2048000 / 2400123 does not reduce below 1024 branches.
+  converter.init(2400123, 256000, 100000.0f);
+  INFO(converter.summary());
+  REQUIRE(converter.fractional());
+  REQUIRE(std::abs(converter.actualOutputRate() / 256000.0 - 1.0) < 1e-6);
+  REQUIRE(converter.summary().find("ppm") != std::string::npos);
+
+  // Exact powers of two skip the resampler and match the bare cascade.
+  fm_tuner::dsp::IqRateConverter exact;
+  exact.init(2048000, 256000, 100000.0f);
+  REQUIRE_FALSE(exact.fractional());
+  REQUIRE(exact.halfBandFactor() == 8);
+  REQUIRE(exact.inputBlockFor(8192) == 8192 * 8);
+}
+
+TEST_CASE("DspPipeline demodulates a 2.4 MS/s source like a 2.048 MS/s one",
+          "[dsp][pipeline][decimator]") {
+  Config::ProcessingSection processing;
+  processing.stereo = false;
+  processing.w0_bandwidth_hz = 194000;
+  constexpr int kInputRate = 256000;
+  constexpr int kOutputRate = 48000;
+  constexpr size_t kBlockSamples = 8192;
+
+  // 1 kHz tone at 50 kHz deviation, RTL-style uint8 IQ.
+  const auto audioRms = [&](uint32_t iqRate) {
+    DspPipeline pipeline(kInputRate, kOutputRate, processing, false,
+                         kBlockSamples, iqRate);
+    const size_t block = pipeline.sdrBlockSamples();
+    std::vector<uint8_t> iq(block * 2);
+    double phase = 0.0;
+    size_t t = 0;
+    std::vector<float> audio;
+    for (int b = 0; b < 12; b++) {
+      for (size_t i = 0; i < block; i++, t++) {
+        const double mod = std::sin(2.0 * M_PI * 1000.0 *
+                                    static_cast<double>(t) / iqRate);
+        phase += 2.0 * M_PI * 50000.0 * mod / iqRate;
+        iq[2 * i] = static_cast<uint8_t>(std::lround(127.5 + 100.0 * std::cos(phase)));
+        iq[2 * i + 1] =
+            static_cast<uint8_t>(std::lround(127.5 + 100.0 * std::sin(phase)));
+      }
+      DspPipeline::Result out;
+      if (pipeline.process(iq.data(), block, nullptr, out) && b >= 4) {
+        REQUIRE(out.demodSamples <= kBlockSamples);
+        audio.insert(audio.end(), out.audio, out.audio + 2 * out.outSamples);
+      }
+    }
+    REQUIRE_FALSE(audio.empty());
+    return rms(audio.data(), audio.size());
+  };
+
+  const float reference = audioRms(2048000);
+  const float fractional = audioRms(2400000);
+  REQUIRE(reference > 0.01f);
+  REQUIRE(std::abs(20.0f * std::log10(fractional / reference)) < 0.2f);
+}
+
+TEST_CASE("DspPipeline squelch idle keeps stream timing and reopens",
+          "[dsp][pipeline][squelch]") {
+  constexpr int kInputRate = 256000;
+  constexpr int kOutputRate = 48000;
+  constexpr size_t kBlockSamples = 8192;
+
+  // A station (-6 dBFS), 40 blocks of near-empty channel (about -60 dBFS),
+  // then the station again. squelch_dbfs = -40 closes on the gap.
+  constexpr int kStrongBlocks = 6;
+  constexpr int kGapBlocks = 40;
+  constexpr int kBlocks = 2 * kStrongBlocks + kGapBlocks;
+  std::vector<std::complex<float>> iq(kBlockSamples * kBlocks);
+  uint32_t rng = 12345u;
+  double phase = 0.0;
+  for (size_t i = 0; i < iq.size(); i++) {
+    const int block = static_cast<int>(i / kBlockSamples);
+    if (block >= kStrongBlocks && block < kStrongBlocks + kGapBlocks) {
+      rng = rng * 1664525u + 1013904223u;
+      const float a = static_cast<float>(rng >> 8) / 16777216.0f - 0.5f;
+      rng = rng * 1664525u + 1013904223u;
+      const float b = static_cast<float>(rng >> 8) / 16777216.0f - 0.5f;
+      iq[i] = {2e-3f * a, 2e-3f * b};
+    } else {
+      phase += 2.0 * M_PI * 40000.0 *
+               std::sin(2.0 * M_PI * 1000.0 * static_cast<double>(i) /
+                        kInputRate) /
+               kInputRate;
+      iq[i] = 0.5f * std::polar(1.0f, static_cast<float>(phase));
+    }
+  }
+
+  struct Run {
+    size_t frames = 0;
+    int idleBlocks = 0;
+    int firstIdle = -1;
+    int lastIdle = -1;
+    bool idleSilent = true;
+    float tailRms = 0.0f;
+  };
+  const auto run = [&](bool idle) {
+    Config::ProcessingSection processing;
+    processing.stereo = true;
+    processing.squelch_dbfs = -40.0;
+    processing.squelch_idle = idle;
+    DspPipeline pipeline(kInputRate, kOutputRate, processing, false,
+                         kBlockSamples, kInputRate);
+    Run r;
+    for (int b = 0; b < kBlocks; b++) {
+      DspPipeline::Result out;
+      REQUIRE(pipeline.process(iq.data() + b * kBlockSamples, kBlockSamples,
+                               nullptr, out));
+      r.frames += out.outSamples;
+      if (out.idle) {
+        r.idleBlocks++;
+        r.lastIdle = b;
+        if (r.firstIdle < 0) {
+          r.firstIdle = b;
+        }
+        for (size_t i = 0; i < 2 * out.outSamples; i++) {
+          r.idleSilent = r.idleSilent && out.audio[i] == 0.0f;
+        }
+      }
+      if (b == kBlocks - 1) {
+        r.tailRms = rms(out.audio, 2 * out.outSamples);
+      }
+    }
+    return r;
+  };
+
+  const Run full = run(false);
+  const Run idle = run(true);
+  REQUIRE(full.idleBlocks == 0);
+  // Idles once the 30 ms release has faded out, for the rest of the gap.
+  REQUIRE(idle.firstIdle > kStrongBlocks);
+  REQUIRE(idle.firstIdle < kStrongBlocks + 15);
+  REQUIRE(idle.lastIdle == kStrongBlocks + kGapBlocks);
+  REQUIRE(idle.idleSilent);
+  // The same number of frames as the full chain, give or take the AF
+  // resampler's phase at the switches.
+  REQUIRE(std::abs(static_cast<long>(idle.frames) -
+                   static_cast<long>(full.frames)) <= 4);
+  // And the station comes back at full level.
+  REQUIRE(full.tailRms > 0.05f);
+  REQUIRE(std::abs(20.0f * std::log10(idle.tailRms / full.tailRms)) < 1.0f);
+}
+
+TEST_CASE("DspPipeline pipelined stages match the serial chain a block later per stage",
+          "[dsp][pipeline][threads]") {
+  constexpr int kInputRate = 256000;
+  constexpr int kOutputRate = 48000;
+  constexpr size_t kBlockSamples = 4096;
+  constexpr uint32_t kIqRate = 1024000;
+  constexpr int kBlocks = 28;
+  constexpr int kBandwidthBlock = 9;
+  constexpr int kDeemphasisBlock = 14;
+  constexpr int kResetBlock = 20;
+
+  // Stereo MPX (1 kHz left, 3 kHz right, pilot) as RTL-style uint8 IQ, so
+  // the IQ front end runs in the first stage too.
+  Config::ProcessingSection processing;
+  processing.stereo = true;
+  processing.stereo_blend = "normal";
+  const size_t block = [&]() {
+    DspPipeline probe(kInputRate, kOutputRate, processing, false,
+                      kBlockSamples, kIqRate);
+    return probe.sdrBlockSamples();
+  }();
+  std::vector<uint8_t> iq(block * 2 * kBlocks);
+  double phase = 0.0;
+  for (size_t i = 0; i < block * kBlocks; i++) {
+    const double t = static_cast<double>(i) / kIqRate;
+    const double left = 0.4 * std::sin(2.0 * M_PI * 1000.0 * t);
+    const double right = 0.4 * std::sin(2.0 * M_PI * 3000.0 * t);
+    const double mpx = 0.45 * (left + right) +
+                       0.45 * (left - right) * std::cos(2.0 * M_PI * 38000.0 * t) +
+                       0.1 * std::cos(2.0 * M_PI * 19000.0 * t);
+    phase += 2.0 * M_PI * 75000.0 * mpx / kIqRate;
+    iq[2 * i] = static_cast<uint8_t>(std::lround(127.5 + 100.0 * std::cos(phase)));
+    iq[2 * i + 1] =
+        static_cast<uint8_t>(std::lround(127.5 + 100.0 * std::sin(phase)));
+  }
+
+  struct Output {
+    bool ok = false;
+    bool stereo = false;
+    double signalDbfs = 0.0;
+    std::vector<float> audio;
+    std::vector<float> mpx;
+  };
+  const auto run = [&](int stages) {
+    processing.dsp_pipeline_stages = stages;
+    DspPipeline pipeline(kInputRate, kOutputRate, processing, false,
+                         kBlockSamples, kIqRate);
+    REQUIRE(pipeline.pipelineStages() == static_cast<size_t>(stages));
+    // kBlocks results from process(), then whatever flush() still emits.
+    std::vector<Output> outputs(kBlocks);
+    for (int b = 0; b < kBlocks; b++) {
+      if (b == kBandwidthBlock) {
+        pipeline.setBandwidthHz(110000);
+      }
+      if (b == kDeemphasisBlock) {
+        pipeline.setDeemphasisMode(1);
+      }
+      if (b == kResetBlock) {
+        pipeline.reset();
+      }
+      Output &o = outputs[b];
+      DspPipeline::Result out;
+      // Tags the block, to check it comes back with its own audio.
+      SignalLevelResult signal;
+      signal.dbfs = -static_cast<double>(b);
+      o.ok = pipeline.process(
+          iq.data() + b * block * 2, block,
+          [&](const float *mpx, size_t count) {
+            o.mpx.assign(mpx, mpx + count);
+          },
+          out, {}, signal);
+      if (o.ok) {
+        o.stereo = out.stereoDetected;
+        o.signalDbfs = out.signal.dbfs;
+        o.audio.assign(out.audio, out.audio + 2 * out.outSamples);
+      }
+    }
+    for (;;) {
+      Output o;
+      DspPipeline::Result out;
+      o.ok = pipeline.flush(
+          [&](const float *mpx, size_t count) {
+            o.mpx.assign(mpx, mpx + count);
+          },
+          out);
+      if (!o.ok) {
+        break;
+      }
+      o.stereo = out.stereoDetected;
+      o.signalDbfs = out.signal.dbfs;
+      o.audio.assign(out.audio, out.audio + 2 * out.outSamples);
+      outputs.push_back(std::move(o));
+    }
+    if (stages > 1) {
+      const DspPipeline::PipelineStats stats = pipeline.takePipelineStats();
+      REQUIRE(stats.stages.size() == static_cast<size_t>(stages - 1));
+      for (const DspPipeline::StageStats &stage : stats.stages) {
+        REQUIRE(stage.blocks >= static_cast<uint64_t>(kBlocks - stages + 1));
+        REQUIRE(stage.busyRatio > 0.0);
+        REQUIRE(stage.maxQueueDepth < static_cast<size_t>(stages + 2));
+      }
+    }
+    return outputs;
+  };
+
+  const std::vector<Output> serial = run(1);
+  REQUIRE(serial.size() == static_cast<size_t>(kBlocks));
+  REQUIRE(serial.back().ok);
+  REQUIRE(serial.back().stereo);
+  REQUIRE(serial.back().signalDbfs == -(kBlocks - 1));
+  for (int stages = 2; stages <= 3; stages++) {
+    const int delay = stages - 1;
+    const std::vector<Output> pipelined = run(stages);
+    int results = 0;
+    for (int b = 0; b < kBlocks; b++) {
+      // Each result arrives one block per worker stage late; the blocks in
+      // flight at the reset are dropped with it.
+      const bool filling =
+          b < delay || (b >= kResetBlock && b < kResetBlock + delay);
+      REQUIRE(pipelined[b].ok == !filling);
+      if (filling) {
+        continue;
+      }
+      results++;
+      const Output &expected = serial[b - delay];
+      REQUIRE(pipelined[b].stereo == expected.stereo);
+      REQUIRE(pipelined[b].signalDbfs == expected.signalDbfs);
+      REQUIRE(pipelined[b].audio == expected.audio);
+      REQUIRE(pipelined[b].mpx == expected.mpx);
+    }
+    REQUIRE(results == kBlocks - 2 * delay);
+    // End of stream: flush() emits the blocks still in flight, so the run
+    // ends on the same audio as the serial chain.
+    REQUIRE(pipelined.size() == static_cast<size_t>(kBlocks + delay));
+    for (int b = kBlocks; b < kBlocks + delay; b++) {
+      const Output &expected = serial[b - delay];
+      REQUIRE(pipelined[b].signalDbfs == expected.signalDbfs);
+      REQUIRE(pipelined[b].audio == expected.audio);
+      REQUIRE(pipelined[b].mpx == expected.mpx);
+    }
+  }
+}
+
 TEST_CASE("DspPipeline CF32 path matches uint8 path for equivalent IQ",
           "[dsp][pipeline][cf32]") {
   Config::ProcessingSection processing;
@@ -979,8 +1881,10 @@ TEST_CASE("DspPipeline CF32 path matches uint8 path for equivalent IQ",
                                 (static_cast<float>(qv) - 127.5f) / 127.5f);
   }
 
-  DspPipeline pa(kInputRate, kOutputRate, processing, false, kBlockSamples, kDecim);
-  DspPipeline pb(kInputRate, kOutputRate, processing, false, kBlockSamples, kDecim);
+  DspPipeline pa(kInputRate, kOutputRate, processing, false, kBlockSamples,
+                 kInputRate * kDecim);
+  DspPipeline pb(kInputRate, kOutputRate, processing, false, kBlockSamples,
+                 kInputRate * kDecim);
 
   DspPipeline::Result ra;
   DspPipeline::Result rb;
@@ -996,9 +1900,8 @@ TEST_CASE("DspPipeline CF32 path matches uint8 path for equivalent IQ",
   // centering internally, so allow a small (~ -54 dB) tolerance — far below any
   // audible/meaningful level. This guards against gross plumbing errors in the
   // CF32 path while tolerating last-bit float divergence.
-  for (size_t i = 0; i < ra.outSamples; i++) {
-    REQUIRE(std::abs(ra.left[i] - rb.left[i]) < 2e-3f);
-    REQUIRE(std::abs(ra.right[i] - rb.right[i]) < 2e-3f);
+  for (size_t i = 0; i < 2 * ra.outSamples; i++) {
+    REQUIRE(std::abs(ra.audio[i] - rb.audio[i]) < 2e-3f);
   }
 }
 
@@ -1142,7 +2045,7 @@ TEST_CASE("DspPipeline surfaces audioClipRatio and keeps audio in range",
   processing.stereo_blend = "normal";
   processing.dsp_agc = "off";
   DspPipeline pipeline(kInputRate, kOutputRate, processing, false,
-                       kBlockSamples, kIqDecimation);
+                       kBlockSamples, kInputRate * kIqDecimation);
 
   std::vector<uint8_t> iq(kBlockSamples * 2, 0);
   for (size_t i = 0; i < kBlockSamples; i++) {
@@ -1157,11 +2060,9 @@ TEST_CASE("DspPipeline surfaces audioClipRatio and keeps audio in range",
   REQUIRE(out.outSamples > 0);
   REQUIRE(out.audioClipRatio >= 0.0f);
   REQUIRE(out.audioClipRatio <= 1.0f);
-  for (size_t i = 0; i < out.outSamples; i++) {
-    REQUIRE(out.left[i] >= -1.0f);
-    REQUIRE(out.left[i] <= 1.0f);
-    REQUIRE(out.right[i] >= -1.0f);
-    REQUIRE(out.right[i] <= 1.0f);
+  for (size_t i = 0; i < 2 * out.outSamples; i++) {
+    REQUIRE(out.audio[i] >= -1.0f);
+    REQUIRE(out.audio[i] <= 1.0f);
   }
 }
 
@@ -1386,6 +2287,78 @@ TEST_CASE("Multipath equalizer reduces envelope variance on a 2-ray channel",
   REQUIRE(postStdDev < preStdDev * 0.7);
 }
 
+TEST_CASE("Multipath equalizer block path tracks the per-sample CMA recursion",
+          "[dsp][multipath_eq]") {
+  constexpr int kInputRate = 256000;
+  constexpr size_t kSamples = 200000;
+  constexpr uint32_t kTaps = 33;
+  constexpr float kTwoPi = 6.2831853071795864769f;
+  // Aggressive-mode constants of the equalizer.
+  constexpr float kMu = 2.0e-4f;
+  constexpr float kLeak = 1.0e-5f;
+  constexpr float kInputMeanAlpha = 1.0f / 65536.0f;
+
+  // Same constant-envelope FM signal and 2-ray channel as above.
+  std::vector<std::complex<float>> input(kSamples);
+  float phase = 0.0f;
+  for (size_t i = 0; i < kSamples; i++) {
+    const float t = static_cast<float>(i) / static_cast<float>(kInputRate);
+    phase += (2.0f * kTwoPi * 50000.0f / kInputRate) * 0.5f *
+             std::sin(kTwoPi * 1000.0f * t);
+    input[i] = std::complex<float>(std::cos(phase), std::sin(phase));
+  }
+  const std::complex<float> echoCoeff =
+      0.5f * std::complex<float>(std::cos(kTwoPi / 8.0f),
+                                  std::sin(kTwoPi / 8.0f));
+  for (size_t i = kSamples; i-- > 15;) {
+    input[i] += echoCoeff * input[i - 15];
+  }
+
+  // Reference: the ring-buffer form of the dispersion-CMA + leak update.
+  std::vector<std::complex<float>> taps(kTaps);
+  std::vector<std::complex<float>> ring(kTaps);
+  taps[kTaps / 2] = 1.0f;
+  uint32_t writePos = 0;
+  float meanSq = std::norm(input[0]);
+  std::vector<std::complex<float>> expected(kSamples);
+  for (size_t i = 0; i < kSamples; i++) {
+    meanSq += kInputMeanAlpha * (std::norm(input[i]) - meanSq);
+    ring[writePos] = input[i];
+    std::complex<float> y(0.0f, 0.0f);
+    for (uint32_t k = 0; k < kTaps; k++) {
+      y += taps[k] * ring[(writePos + kTaps - k) % kTaps];
+    }
+    const std::complex<float> errTimesY = y * (std::norm(y) - meanSq);
+    for (uint32_t k = 0; k < kTaps; k++) {
+      taps[k] = taps[k] * (1.0f - kLeak) -
+                kMu * errTimesY *
+                    std::conj(ring[(writePos + kTaps - k) % kTaps]);
+    }
+    taps[kTaps / 2] += kLeak;
+    writePos = (writePos + 1) % kTaps;
+    expected[i] = y;
+  }
+
+  fm_tuner::dsp::MultipathEqualizer eq;
+  eq.init(fm_tuner::dsp::MultipathEqMode::Aggressive, kTaps, kInputRate);
+  eq.setAdaptEnabled(true);
+  std::vector<std::complex<float>> equalized(input);
+  // Uneven block sizes, in place, with a few single-sample calls mixed in.
+  size_t pos = 0;
+  for (size_t block = 0; pos < kSamples; block++) {
+    const size_t len = std::min(kSamples - pos, (block % 5 == 0) ? size_t{1}
+                                                                 : size_t{4093});
+    eq.executeBlock(equalized.data() + pos, equalized.data() + pos, len);
+    pos += len;
+  }
+
+  float maxDiff = 0.0f;
+  for (size_t i = 0; i < kSamples; i++) {
+    maxDiff = std::max(maxDiff, std::abs(equalized[i] - expected[i]));
+  }
+  REQUIRE(maxDiff < 1e-3f);
+}
+
 TEST_CASE("AF post HiCut off keeps the configured de-emphasis intact",
           "[dsp][af][hicut]") {
   constexpr int kInputRate = 48000;
@@ -1721,3 +2694,653 @@ TEST_CASE("FIRFilter L1 normalized lowpass keeps a unit-magnitude carrier "
   }
   REQUIRE(peak <= 1.0f + 1e-4f);
 }
+
+TEST_CASE("FmFrontEnd block path matches the per-sample liquid chain",
+          "[dsp][fm_front_end]") {
+  // Reference: the chain FMDemod used to build per sample from the liquid
+  // wrappers (two DC blockers, the lowpass channel FIR, freqdem).
+  const std::uint32_t length = 81;
+  const float cutoff = 0.45f;
+  const float kf = 75000.0f / 256000.0f;
+
+  fm_tuner::dsp::liquid::IIRFilterReal dcI;
+  fm_tuner::dsp::liquid::IIRFilterReal dcQ;
+  dcI.initDCBlocker(0.0005f);
+  dcQ.initDCBlocker(0.0005f);
+  fm_tuner::dsp::liquid::FIRFilter fir;
+  fir.init(length, cutoff, 60.0f, 0.0f, /*l1Normalize=*/true);
+  fm_tuner::dsp::liquid::FreqDemod demod;
+  demod.init(kf);
+
+  fm_tuner::dsp::FmFrontEnd frontEnd;
+  frontEnd.setDcBlocker(0.0005f);
+  frontEnd.setChannelFilter(length, cutoff, 60.0f, /*l1Normalize=*/true);
+  frontEnd.setModulationFactor(kf);
+
+  // FM tone plus a DC offset and a few rail hits, in uneven block sizes so
+  // the FIR history crosses block boundaries.
+  uint32_t lcg = 12345u;
+  float phase = 0.0f;
+  size_t expectedClips = 0;
+  float maxDiff = 0.0f;
+  double powerRef = 0.0;
+  double powerBlock = 0.0;
+  for (size_t blockSize : {1000u, 37u, 4096u, 5u, 2048u}) {
+    std::vector<uint8_t> iq(blockSize * 2);
+    for (size_t i = 0; i < blockSize; i++) {
+      phase += 0.3f * std::sin(0.01f * static_cast<float>(i)) + 0.05f;
+      lcg = lcg * 1664525u + 1013904223u;
+      const float noise = static_cast<float>((lcg >> 24) & 0x7) - 3.5f;
+      iq[2 * i] = static_cast<uint8_t>(
+          std::clamp(140.0f + 100.0f * std::cos(phase) + noise, 0.0f, 255.0f));
+      iq[2 * i + 1] = static_cast<uint8_t>(
+          std::clamp(120.0f + 100.0f * std::sin(phase) - noise, 0.0f, 255.0f));
+      if ((lcg >> 8) % 97 == 0) {
+        iq[2 * i] = 255;
+      }
+      if (iq[2 * i] == 0 || iq[2 * i] == 255 || iq[2 * i + 1] == 0 ||
+          iq[2 * i + 1] == 255) {
+        expectedClips++;
+      }
+    }
+
+    std::vector<std::complex<float>> filtered(blockSize);
+    std::vector<float> audio(blockSize);
+    const auto stats = frontEnd.filter(iq.data(), blockSize, filtered.data());
+    frontEnd.discriminate(filtered.data(), blockSize, audio.data());
+    expectedClips -= stats.clipCount;
+    powerBlock += stats.powerSum;
+
+    for (size_t i = 0; i < blockSize; i++) {
+      const float inI = (static_cast<float>(iq[2 * i]) - 127.0f) / 127.5f;
+      const float inQ = (static_cast<float>(iq[2 * i + 1]) - 127.0f) / 127.5f;
+      fir.push({dcI.execute(inI), dcQ.execute(inQ)});
+      const std::complex<float> y = fir.execute();
+      powerRef += std::norm(y);
+      maxDiff = std::max(maxDiff, std::abs(y - filtered[i]));
+      maxDiff = std::max(maxDiff, std::abs(demod.execute(y) - audio[i]));
+    }
+  }
+
+  REQUIRE(expectedClips == 0);
+  REQUIRE(maxDiff < 1e-3f);
+  REQUIRE(std::abs(powerBlock - powerRef) <= 1e-4 * powerRef);
+}
+
+TEST_CASE("fastAtan2 stays within its documented error bound",
+          "[dsp][discriminator]") {
+  constexpr double kTwoPi = 6.28318530717958647692;
+  double maxErr = 0.0;
+  for (int k = 0; k < 100000; k++) {
+    const double theta = -kTwoPi / 2.0 + kTwoPi * (k + 0.5) / 100000.0;
+    for (float radius : {1e-6f, 0.3f, 1.0f, 5000.0f}) {
+      const float y = radius * static_cast<float>(std::sin(theta));
+      const float x = radius * static_cast<float>(std::cos(theta));
+      maxErr = std::max(
+          maxErr, std::abs(fm_tuner::dsp::fastAtan2(y, x) -
+                           std::atan2(static_cast<double>(y),
+                                      static_cast<double>(x))));
+    }
+  }
+  REQUIRE(maxErr <= fm_tuner::dsp::kFastAtan2MaxErrorRad);
+  REQUIRE(fm_tuner::dsp::fastAtan2(0.0f, 0.0f) == 0.0f);
+  REQUIRE(fm_tuner::dsp::fastAtan2(1.0f, 0.0f) ==
+          Approx(1.5707963f).margin(1e-6f));
+  REQUIRE(fm_tuner::dsp::fastAtan2(0.0f, -1.0f) ==
+          Approx(3.1415927f).margin(1e-6f));
+}
+
+TEST_CASE("discriminateBlock matches liquid freqdem across blocks",
+          "[dsp][discriminator]") {
+  constexpr float kPi = 3.14159265358979323846f;
+  const float kf = 75000.0f / 256000.0f;
+  const float gain = 1.0f / (2.0f * kPi * kf);
+  fm_tuner::dsp::liquid::FreqDemod demod;
+  demod.init(kf);
+
+  // Random phase steps (short of ±pi, where either sign is correct) and
+  // magnitudes, with a few exact zeros.
+  uint32_t lcg = 2024u;
+  auto next = [&lcg]() {
+    lcg = lcg * 1664525u + 1013904223u;
+    return static_cast<float>(lcg >> 8) / 16777216.0f;
+  };
+  std::complex<float> prev(0.0f, 0.0f);
+  float phase = 0.0f;
+  float maxErr = 0.0f;
+  for (size_t blockSize : {1u, 3u, 8u, 9u, 1000u, 17u, 4096u}) {
+    std::vector<std::complex<float>> in(blockSize);
+    for (auto &x : in) {
+      phase += (next() - 0.5f) * 1.9f * kPi;
+      const float mag = (next() < 0.01f) ? 0.0f : 0.01f + 2.0f * next();
+      x = std::polar(mag, phase);
+    }
+    std::vector<float> out(blockSize);
+    std::complex<float> last = prev;
+    fm_tuner::dsp::discriminateBlock(in.data(), blockSize, prev, gain,
+                                     out.data());
+    REQUIRE(prev == in.back());
+    for (size_t i = 0; i < blockSize; i++) {
+      const float ref = demod.execute(in[i]);
+      const bool zero = (in[i] == std::complex<float>(0.0f, 0.0f) ||
+                         last == std::complex<float>(0.0f, 0.0f));
+      last = in[i];
+      if (zero) {
+        // libm's atan2 of signed zeros can be ±pi; the block path gives 0.
+        REQUIRE(out[i] == 0.0f);
+        continue;
+      }
+      maxErr = std::max(maxErr, std::abs(out[i] - ref));
+    }
+  }
+  // Polynomial bound plus float rounding of the conj(prev)·x product.
+  REQUIRE(maxErr <= (fm_tuner::dsp::kFastAtan2MaxErrorRad + 2e-6f) * gain);
+}
+
+TEST_CASE("PolyphaseResampler delivers unity gain at its reported delay",
+          "[dsp][resampler]") {
+  constexpr double kTwoPi = 6.28318530717958647692;
+  struct Case {
+    std::uint32_t in;
+    std::uint32_t out;
+    std::uint32_t l;
+    std::uint32_t m;
+  };
+  for (const Case c : {Case{256000, 48000, 3, 16}, Case{256000, 192000, 3, 4},
+                       Case{48000, 44100, 147, 160}}) {
+    fm_tuner::dsp::PolyphaseResampler resampler;
+    resampler.init(c.in, c.out, 24);
+    REQUIRE(resampler.interpolation() == c.l);
+    REQUIRE(resampler.decimation() == c.m);
+
+    // 1 kHz tone in uneven blocks; the output must be the same tone shifted
+    // by exactly groupDelayOutputSamples().
+    const double f = 1000.0;
+    const size_t total = c.in / 4;
+    std::vector<float> in(total);
+    for (size_t i = 0; i < total; i++) {
+      in[i] = static_cast<float>(std::sin(kTwoPi * f * i / c.in));
+    }
+    std::vector<float> out;
+    size_t pos = 0;
+    size_t block = 1;
+    while (pos < total) {
+      const size_t n = std::min(block, total - pos);
+      std::vector<float> chunk(resampler.maxOutput(n));
+      const size_t produced = resampler.execute(in.data() + pos, n, chunk.data());
+      REQUIRE(produced <= chunk.size());
+      out.insert(out.end(), chunk.begin(), chunk.begin() + produced);
+      pos += n;
+      block = (block * 7 + 3) % 997 + 1;
+    }
+    // Output count is exact: ceil(total * L / M).
+    REQUIRE(out.size() ==
+            (static_cast<size_t>(total) * c.l + c.m - 1) / c.m);
+
+    const double delay = resampler.groupDelayOutputSamples();
+    float maxErr = 0.0f;
+    for (size_t n = out.size() / 4; n < out.size(); n++) {
+      const double expected =
+          std::sin(kTwoPi * f * (static_cast<double>(n) - delay) / c.out);
+      maxErr = std::max(maxErr, static_cast<float>(std::abs(out[n] - expected)));
+    }
+    REQUIRE(maxErr < 2e-3f);
+  }
+}
+
+TEST_CASE("PolyphaseResampler 1/1 is a zero-delay copy", "[dsp][resampler]") {
+  fm_tuner::dsp::PolyphaseResampler resampler;
+  resampler.init(192000, 192000);
+  REQUIRE(resampler.groupDelayOutputSamples() == 0.0);
+  const std::vector<float> in = {0.5f, -1.0f, 0.25f};
+  std::vector<float> out(resampler.maxOutput(in.size()));
+  REQUIRE(resampler.execute(in.data(), in.size(), out.data()) == in.size());
+  REQUIRE(out == in);
+}
+
+TEST_CASE("PolyphaseResampler band-limits decimation by default",
+          "[dsp][resampler]") {
+  // The 57 kHz RDS subcarrier has no place in a 48k output; it must not fold
+  // to 9 kHz.
+  constexpr double kTwoPi = 6.28318530717958647692;
+  fm_tuner::dsp::PolyphaseResampler resampler;
+  resampler.init(256000, 48000);
+  std::vector<float> in(64000);
+  for (size_t i = 0; i < in.size(); i++) {
+    in[i] = static_cast<float>(std::sin(kTwoPi * 57000.0 * i / 256000.0));
+  }
+  std::vector<float> out(resampler.maxOutput(in.size()));
+  const size_t produced = resampler.execute(in.data(), in.size(), out.data());
+  REQUIRE(rms(out.data() + produced / 2, produced / 2) < 0.01f);
+}
+
+TEST_CASE("liquid wrapper executeBlock matches per-sample execute",
+          "[dsp][liquid]") {
+  namespace lq = fm_tuner::dsp::liquid;
+  std::vector<std::complex<float>> x(700);
+  std::vector<float> xr(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    const float t = static_cast<float>(i);
+    x[i] = {0.6f * std::cos(0.07f * t) + 0.1f, 0.4f * std::sin(0.11f * t)};
+    xr[i] = x[i].real();
+  }
+
+  lq::FIRFilter firA;
+  lq::FIRFilter firB;
+  firA.init(41, 0.12f);
+  firB.init(41, 0.12f);
+  lq::IIRFilterReal iirA;
+  lq::IIRFilterReal iirB;
+  iirA.initHighpass(4, 0.1f);
+  iirB.initHighpass(4, 0.1f);
+  lq::AGC agcA;
+  lq::AGC agcB;
+  agcA.init(0.01f, 1.0f);
+  agcB.init(0.01f, 1.0f);
+  lq::FreqDemod demA;
+  lq::FreqDemod demB;
+  demA.init(0.2f);
+  demB.init(0.2f);
+  lq::NCO ncoA;
+  lq::NCO ncoB;
+  ncoA.init(LIQUID_VCO, 0.3f);
+  ncoB.init(LIQUID_VCO, 0.3f);
+
+  // Blocks of uneven size, in place where the API allows it.
+  std::vector<std::complex<float>> firOut = x;
+  std::vector<float> iirOut = xr;
+  std::vector<std::complex<float>> agcOut = x;
+  std::vector<float> demOut(x.size());
+  std::vector<std::complex<float>> ncoOut(x.size());
+  for (size_t pos = 0, n = 1; pos < x.size(); pos += n, n = n * 3 % 211 + 1) {
+    n = std::min(n, x.size() - pos);
+    firB.executeBlock(firOut.data() + pos, n, firOut.data() + pos);
+    iirB.executeBlock(iirOut.data() + pos, n, iirOut.data() + pos);
+    agcB.executeBlock(agcOut.data() + pos, n, agcOut.data() + pos);
+    demB.executeBlock(x.data() + pos, n, demOut.data() + pos);
+    ncoB.mixBlockDown(x.data() + pos, n, ncoOut.data() + pos);
+  }
+
+  float maxDiff = 0.0f;
+  for (size_t i = 0; i < x.size(); i++) {
+    firA.push(x[i]);
+    maxDiff = std::max(maxDiff, std::abs(firA.execute() - firOut[i]));
+    maxDiff = std::max(maxDiff, std::abs(iirA.execute(xr[i]) - iirOut[i]));
+    maxDiff = std::max(maxDiff, std::abs(agcA.execute(x[i]) - agcOut[i]));
+    maxDiff = std::max(maxDiff, std::abs(demA.execute(x[i]) - demOut[i]));
+    const float phase = ncoA.phase();
+    const std::complex<float> mixed =
+        x[i] * std::complex<float>(std::cos(phase), -std::sin(phase));
+    ncoA.step();
+    maxDiff = std::max(maxDiff, std::abs(mixed - ncoOut[i]));
+  }
+  REQUIRE(maxDiff < 1e-4f);
+}
+
+TEST_CASE("RealFirFilter band-pass matches the complex liquid FIR",
+          "[dsp][liquid]") {
+  namespace lq = fm_tuner::dsp::liquid;
+  // The pilot band-pass as StereoDecoder designs it at 256 kHz.
+  constexpr std::uint32_t kTaps = 243;
+  const float cutoff = 1000.0f / 256000.0f;
+  const float center = 19000.0f / 256000.0f;
+  lq::FIRFilter reference;
+  reference.init(kTaps, cutoff, 60.0f, center);
+  std::vector<float> taps;
+  lq::designBandpassTaps(kTaps, cutoff, 60.0f, center, taps);
+  fm_tuner::dsp::RealFirFilter fir;
+  fir.setTaps(taps);
+  REQUIRE(fir.length() == kTaps);
+  REQUIRE(fir.groupDelay() == (kTaps - 1) / 2);
+
+  std::vector<float> x(1500);
+  for (size_t i = 0; i < x.size(); i++) {
+    const float t = static_cast<float>(i);
+    x[i] = 0.5f * std::cos(0.466f * t) + 0.3f * std::sin(0.09f * t) +
+           0.1f * std::cos(1.4f * t);
+  }
+  std::vector<float> y = x;
+  for (size_t pos = 0, n = 1; pos < y.size(); pos += n, n = n * 5 % 307 + 1) {
+    n = std::min(n, y.size() - pos);
+    fir.executeBlock(y.data() + pos, n, y.data() + pos);
+  }
+
+  float maxDiff = 0.0f;
+  for (size_t i = 0; i < x.size(); i++) {
+    reference.push(std::complex<float>(x[i], 0.0f));
+    const std::complex<float> expected = reference.execute();
+    maxDiff = std::max(maxDiff, std::abs(expected.imag()));
+    maxDiff = std::max(maxDiff, std::abs(expected.real() - y[i]));
+  }
+  REQUIRE(maxDiff < 1e-5f);
+}
+
+TEST_CASE("PilotPll locks to an off-nominal pilot across uneven blocks",
+          "[dsp][stereo]") {
+  constexpr double kPi = 3.14159265358979323846;
+  constexpr double kRate = 256000.0;
+  const double w = 2.0 * kPi * 19040.0 / kRate;
+  constexpr double kOffset = 1.1;
+  fm_tuner::dsp::PilotPll pll;
+  pll.init(static_cast<float>(2.0 * kPi * 19000.0 / kRate));
+  pll.setBandwidth(0.01f);
+
+  constexpr size_t kSamples = 128000;
+  std::vector<float> pilot(kSamples);
+  for (size_t i = 0; i < kSamples; i++) {
+    pilot[i] = 0.1f * static_cast<float>(
+                          std::cos(w * static_cast<double>(i) + kOffset));
+  }
+  std::vector<float> mixedI(kSamples);
+  std::vector<float> mixedQ(kSamples);
+  std::vector<float> freq(kSamples);
+  std::vector<float> cos19(kSamples);
+  std::vector<float> cos38(kSamples);
+  std::vector<float> sin38(kSamples);
+  for (size_t pos = 0, n = 1; pos < kSamples; pos += n, n = n * 7 % 4099 + 1) {
+    n = std::min(n, kSamples - pos);
+    fm_tuner::dsp::PilotPll::Block out;
+    out.mixedI = mixedI.data() + pos;
+    out.mixedQ = mixedQ.data() + pos;
+    out.freq = freq.data() + pos;
+    out.cos19 = cos19.data() + pos;
+    out.cos38 = cos38.data() + pos;
+    out.sin38 = sin38.data() + pos;
+    pll.process(pilot.data() + pos, n, out);
+  }
+
+  // Last quarter: the loop frequency sits on the pilot, the 19 kHz reference
+  // is in phase with it, and the 38 kHz reference is its exact second
+  // harmonic.
+  double freqSum = 0.0;
+  double corr19 = 0.0;
+  double corr38 = 0.0;
+  float harmonicErr = 0.0f;
+  const size_t start = kSamples * 3 / 4;
+  for (size_t i = start; i < kSamples; i++) {
+    // The reference is one step ahead of the sample it was mixed against.
+    const double phase = w * static_cast<double>(i + 1) + kOffset;
+    freqSum += freq[i];
+    corr19 += cos19[i] * std::cos(phase);
+    corr38 += cos38[i] * std::cos(2.0 * phase);
+    harmonicErr = std::max(
+        harmonicErr, std::abs(cos38[i] - (2.0f * cos19[i] * cos19[i] - 1.0f)));
+    REQUIRE(std::abs(cos38[i] * cos38[i] + sin38[i] * sin38[i] - 1.0f) <
+            1e-4f);
+  }
+  const double count = static_cast<double>(kSamples - start);
+  REQUIRE(std::abs(freqSum / count - w) < 1e-5);
+  // 0.5 is a perfect match; the real-input phase detector leaves a 38 kHz
+  // ripple on the VCO phase at the acquire bandwidth.
+  REQUIRE(corr19 / count > 0.46);
+  REQUIRE(corr38 / count > 0.46);
+  REQUIRE(harmonicErr < 1e-4f);
+}
+
+TEST_CASE("HalfBandDecimator keeps the MPX band and splits off the hiss band",
+          "[dsp][halfband]") {
+  constexpr int kInputRate = 256000;
+  constexpr int kHalfRate = kInputRate / 2;
+  constexpr size_t kSamples = 32768;
+  constexpr double kTwoPi = 6.28318530717958647692;
+  auto tone = [&](double hz) {
+    std::vector<float> x(kSamples);
+    for (size_t i = 0; i < kSamples; i++) {
+      x[i] = 0.5f * static_cast<float>(std::sin(
+                        kTwoPi * hz * static_cast<double>(i) / kInputRate));
+    }
+    return x;
+  };
+  auto run = [&](const std::vector<float> &x, std::vector<float> &low,
+                 std::vector<float> &high) {
+    fm_tuner::dsp::HalfBandDecimator hb;
+    hb.init(59500.0f / kInputRate);
+    low.assign(fm_tuner::dsp::HalfBandDecimator::maxOutput(kSamples), 0.0f);
+    high.assign(low.size(), 0.0f);
+    size_t produced = 0;
+    for (size_t pos = 0, n = 1; pos < kSamples; pos += n, n = n * 5 % 1021 + 1) {
+      n = std::min(n, kSamples - pos);
+      produced += hb.execute(x.data() + pos, n, low.data() + produced,
+                             high.data() + produced);
+    }
+    REQUIRE(produced == kSamples / 2);
+    low.resize(produced);
+    high.resize(produced);
+  };
+
+  const size_t settle = 512;
+  const size_t span = kSamples / 2 - settle;
+  for (const double hz : {1000.0, 19000.0, 38000.0, 57000.0}) {
+    std::vector<float> low;
+    std::vector<float> high;
+    run(tone(hz), low, high);
+    const float passed = toneMagnitude(low.data() + settle, span, kHalfRate,
+                                       static_cast<float>(hz));
+    INFO(hz << " Hz");
+    REQUIRE(std::abs(passed - 0.25f) < 0.003f);
+    REQUIRE(rms(high.data() + settle, span) < 0.5f * 1e-3f);
+  }
+  // 80 kHz folds to 48 kHz at 128k: gone from the low band, all in the high.
+  std::vector<float> low;
+  std::vector<float> high;
+  run(tone(80000.0), low, high);
+  REQUIRE(rms(low.data() + settle, span) < 0.5f * 1e-3f);
+  REQUIRE(std::abs(rms(high.data() + settle, span) - 0.5f / std::sqrt(2.0f)) <
+          0.01f);
+
+  // Block boundaries do not matter.
+  fm_tuner::dsp::HalfBandDecimator whole;
+  whole.init(59500.0f / kInputRate);
+  const std::vector<float> x = tone(19000.0);
+  std::vector<float> ref(kSamples / 2 + 1);
+  REQUIRE(whole.execute(x.data(), kSamples, ref.data(), nullptr) ==
+          kSamples / 2);
+  run(x, low, high);
+  for (size_t i = 0; i < low.size(); i++) {
+    REQUIRE(low[i] == ref[i]);
+  }
+}
+
+TEST_CASE("Stereo decoder separates channels on a half-rate MPX",
+          "[dsp][stereo][halfband]") {
+  constexpr int kInputRate = 256000;
+  constexpr int kHalfRate = kInputRate / 2;
+  constexpr size_t kSamples = 131072;
+  constexpr size_t kBlock = 8192;
+  constexpr float kTwoPi = 6.2831853071795864769f;
+  constexpr float kPilotHz = 19000.0f;
+  constexpr float kLeftHz = 1000.0f;
+  constexpr float kRightHz = 2800.0f;
+
+  std::vector<float> mpx(kSamples, 0.0f);
+  for (size_t i = 0; i < kSamples; i++) {
+    const float t = static_cast<float>(i) / static_cast<float>(kInputRate);
+    const float l = 0.45f * std::sin(kTwoPi * kLeftHz * t);
+    const float r = 0.45f * std::sin(kTwoPi * kRightHz * t);
+    const float pilot = 0.08f * std::sin(kTwoPi * kPilotHz * t);
+    const float dsb = 0.25f * (l - r) * std::sin(kTwoPi * 2.0f * kPilotHz * t);
+    mpx[i] = (l + r) + pilot + dsb;
+  }
+
+  StereoDecoder full(kInputRate, 48000);
+  StereoDecoder half(kHalfRate, 48000);
+  fm_tuner::dsp::HalfBandDecimator hb;
+  hb.init(59500.0f / kInputRate);
+  std::vector<float> scratchL(kBlock);
+  std::vector<float> scratchR(kBlock);
+  std::vector<float> halfMpx(kBlock);
+  std::vector<float> halfHiss(kBlock);
+  std::vector<float> left(kSamples / 2, 0.0f);
+  std::vector<float> right(kSamples / 2, 0.0f);
+  size_t out = 0;
+  for (size_t offset = 0; offset < kSamples; offset += kBlock) {
+    full.processAudio(mpx.data() + offset, scratchL.data(), scratchR.data(),
+                      kBlock);
+    const size_t n = hb.execute(mpx.data() + offset, kBlock, halfMpx.data(),
+                                halfHiss.data());
+    out += half.processAudio(halfMpx.data(), left.data() + out,
+                             right.data() + out, n, halfHiss.data());
+  }
+
+  REQUIRE(out == kSamples / 2);
+  REQUIRE(half.isStereo());
+  REQUIRE(half.getStereoBlend() > 0.75f);
+  // Meters agree with the full-rate decoder.
+  REQUIRE(std::abs(half.getPilotDeviationKHz() - full.getPilotDeviationKHz()) <
+          0.3f);
+  REQUIRE(std::abs(half.getMpxMagnitude() - full.getMpxMagnitude()) <
+          0.02f * full.getMpxMagnitude());
+
+  const size_t settle = out / 4;
+  const size_t span = out - settle;
+  const float leftAtLeftHz =
+      toneMagnitude(left.data() + settle, span, kHalfRate, kLeftHz);
+  const float leftAtRightHz =
+      toneMagnitude(left.data() + settle, span, kHalfRate, kRightHz);
+  const float rightAtRightHz =
+      toneMagnitude(right.data() + settle, span, kHalfRate, kRightHz);
+  const float rightAtLeftHz =
+      toneMagnitude(right.data() + settle, span, kHalfRate, kLeftHz);
+  // The synthetic MPX carries L-R at a quarter of L+R, so the best case is
+  // 0.625 / 0.375 between the wanted and the unwanted tone.
+  REQUIRE(leftAtLeftHz > 1.3f * leftAtRightHz);
+  REQUIRE(rightAtRightHz > 1.3f * rightAtLeftHz);
+}
+
+TEST_CASE("Kernel registry parses overrides as per-kernel ISA ceilings",
+          "[dsp][kernels]") {
+  using fm_tuner::dsp::KernelId;
+  using fm_tuner::dsp::KernelIsa;
+  using fm_tuner::dsp::kernelIsa;
+  std::string error;
+
+  REQUIRE(fm_tuner::dsp::setKernelOverrides("scalar", error));
+  for (size_t k = 0; k < fm_tuner::dsp::kKernelCount; k++) {
+    REQUIRE(kernelIsa(static_cast<KernelId>(k)) == KernelIsa::Scalar);
+  }
+
+  REQUIRE(fm_tuner::dsp::setKernelOverrides("auto", error));
+  const KernelIsa bestFir = kernelIsa(KernelId::ChannelFir);
+  REQUIRE(fm_tuner::dsp::setKernelOverrides(
+      " Channel_FIR:scalar , resampler : avx2", error));
+  REQUIRE(kernelIsa(KernelId::ChannelFir) == KernelIsa::Scalar);
+  REQUIRE(kernelIsa(KernelId::Resampler) <= KernelIsa::Avx2);
+  REQUIRE(kernelIsa(KernelId::RealFir) == bestFir);
+
+  // A bad entry leaves the current selection alone.
+  REQUIRE_FALSE(fm_tuner::dsp::setKernelOverrides("avx2,fir:scalar", error));
+  REQUIRE(error.find("fir") != std::string::npos);
+  REQUIRE_FALSE(fm_tuner::dsp::setKernelOverrides("sse9", error));
+  REQUIRE(kernelIsa(KernelId::ChannelFir) == KernelIsa::Scalar);
+
+  REQUIRE(fm_tuner::dsp::setKernelOverrides("auto", error));
+  REQUIRE(fm_tuner::dsp::kernelSelectionSummary().find("channel_fir=") !=
+          std::string::npos);
+}
+
+TEST_CASE("Every kernel variant the CPU runs agrees with the scalar kernels",
+          "[dsp][kernels]") {
+  // One pass through each dispatched kernel, with lengths that leave SIMD
+  // tails: 81 channel taps (an odd number of tap blocks), the 243-tap pilot
+  // band-pass, 256k -> 48k resampling in mono and stereo, the CMA, and the
+  // 2.048 MS/s half-band cascade on an odd sample count.
+  constexpr size_t kSamples = 3001;
+  std::vector<uint8_t> iqU8(2 * kSamples);
+  std::vector<std::complex<float>> iqCf32(kSamples);
+  std::vector<float> mpx(kSamples);
+  uint32_t lcg = 777u;
+  for (size_t i = 0; i < kSamples; i++) {
+    const float t = static_cast<float>(i);
+    lcg = lcg * 1664525u + 1013904223u;
+    const float noise = static_cast<float>((lcg >> 24) & 0x7) - 3.5f;
+    const float phase = 0.2f * t + 2.0f * std::sin(0.013f * t);
+    iqU8[2 * i] = static_cast<uint8_t>(
+        std::clamp(130.0f + 120.0f * std::cos(phase) + noise, 0.0f, 255.0f));
+    iqU8[2 * i + 1] = static_cast<uint8_t>(
+        std::clamp(125.0f + 120.0f * std::sin(phase) - noise, 0.0f, 255.0f));
+    iqCf32[i] = {0.9f * std::cos(phase) + 0.05f * std::cos(3.1f * t),
+                 0.9f * std::sin(phase) + 0.05f * std::sin(2.3f * t)};
+    mpx[i] = 0.5f * std::cos(0.466f * t) + 0.3f * std::sin(0.09f * t);
+  }
+
+  struct Outputs {
+    std::vector<float> values;
+    size_t clips = 0;
+  };
+  const auto runAll = [&]() {
+    Outputs out;
+    auto append = [&out](const float *data, size_t count) {
+      out.values.insert(out.values.end(), data, data + count);
+    };
+
+    fm_tuner::dsp::FmFrontEnd frontEnd;
+    frontEnd.setChannelFilter(81, 0.45f, 60.0f, /*l1Normalize=*/true);
+    frontEnd.setModulationFactor(75000.0f / 256000.0f);
+    std::vector<std::complex<float>> filtered(kSamples);
+    std::vector<float> audio(kSamples);
+    out.clips +=
+        frontEnd.filter(iqU8.data(), kSamples, filtered.data()).clipCount;
+    frontEnd.discriminate(filtered.data(), kSamples, audio.data());
+    append(reinterpret_cast<const float *>(filtered.data()), 2 * kSamples);
+    append(audio.data(), kSamples);
+    out.clips +=
+        frontEnd.filter(iqCf32.data(), kSamples, filtered.data()).clipCount;
+    append(reinterpret_cast<const float *>(filtered.data()), 2 * kSamples);
+
+    std::vector<float> taps;
+    fm_tuner::dsp::liquid::designBandpassTaps(243, 1000.0f / 256000.0f, 60.0f,
+                                              19000.0f / 256000.0f, taps);
+    fm_tuner::dsp::RealFirFilter pilot;
+    pilot.setTaps(taps);
+    std::vector<float> band(kSamples);
+    pilot.executeBlock(mpx.data(), kSamples, band.data());
+    append(band.data(), kSamples);
+
+    fm_tuner::dsp::PolyphaseResampler resampler;
+    resampler.init(256000, 48000, 24);
+    std::vector<float> resampled(2 * resampler.maxOutput(kSamples));
+    append(resampled.data(),
+           resampler.execute(mpx.data(), kSamples, resampled.data()));
+    fm_tuner::dsp::PolyphaseResampler stereo;
+    stereo.init(256000, 48000, 24);
+    append(resampled.data(), 2 * stereo.executeStereo(mpx.data(), band.data(),
+                                                      kSamples,
+                                                      resampled.data()));
+
+    fm_tuner::dsp::MultipathEqualizer eq;
+    eq.init(fm_tuner::dsp::MultipathEqMode::Aggressive, 17, 256000.0f);
+    std::vector<std::complex<float>> equalized(kSamples);
+    eq.executeBlock(iqCf32.data(), equalized.data(), kSamples);
+    append(reinterpret_cast<const float *>(equalized.data()), 2 * kSamples);
+
+    fm_tuner::dsp::IqDecimator decimator;
+    decimator.init(8, 100000.0f / 256000.0f, 80.0f);
+    std::vector<std::complex<float>> decimated(kSamples);
+    append(reinterpret_cast<const float *>(decimated.data()),
+           2 * decimator.execute(iqU8.data(), kSamples, decimated.data(),
+                                 kSamples));
+    decimator.reset();
+    append(reinterpret_cast<const float *>(decimated.data()),
+           2 * decimator.execute(iqCf32.data(), kSamples, decimated.data(),
+                                 kSamples));
+    return out;
+  };
+
+  std::string error;
+  REQUIRE(fm_tuner::dsp::setKernelOverrides("scalar", error));
+  const Outputs reference = runAll();
+  for (const char *isa : {"neon", "avx2", "avx512"}) {
+    REQUIRE(fm_tuner::dsp::setKernelOverrides(isa, error));
+    const Outputs variant = runAll();
+    REQUIRE(variant.clips == reference.clips);
+    REQUIRE(variant.values.size() == reference.values.size());
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < reference.values.size(); i++) {
+      maxDiff = std::max(maxDiff,
+                         std::abs(variant.values[i] - reference.values[i]));
+    }
+    INFO("isa " << isa << " -> " << fm_tuner::dsp::kernelSelectionSummary());
+    REQUIRE(maxDiff < 1e-4f);
+  }
+  REQUIRE(fm_tuner::dsp::setKernelOverrides("auto", error));
+}
@@ -0,0 +1,237 @@
+#include "catch_compat.h"
+
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define private public
+#include "file_source.h"
+#undef private
+
+namespace {
+
+void writeBytes(const std::string &path, const std::vector<uint8_t> &bytes) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+}
+
+std::vector<uint8_t> rampIq(size_t samples) {
+  std::vector<uint8_t> bytes(samples * 2);
+  for (size_t i = 0; i < bytes.size(); i++) {
+    bytes[i] = static_cast<uint8_t>(i & 0xff);
+  }
+  return bytes;
+}
+
+} // namespace
+
+TEST_CASE("FileSource replays u8 IQ unthrottled and stops at the end",
+          "[file_source]") {
+  const std::string path = "test_replay.u8";
+  const std::vector<uint8_t> iq = rampIq(1000);
+  writeBytes(path, iq);
+
+  FileSource source;
+  source.configure(path, "auto", false, false);
+  REQUIRE(source.connect());
+  REQUIRE(source.format() == FileSource::Format::U8);
+  REQUIRE(source.totalSamples() == 1000);
+
+  const uint8_t *data = nullptr;
+  REQUIRE(source.leaseIQ(600, data) == 600);
+  REQUIRE(data != nullptr);
+  REQUIRE(data[0] == 0);
+  REQUIRE(data[1199] == iq[1199]);
+  source.releaseIQ(600);
+
+  std::vector<uint8_t> rest(1000 * 2, 0);
+  REQUIRE(source.readIQ(rest.data(), 1000) == 400);
+  REQUIRE(rest[0] == iq[1200]);
+  REQUIRE_FALSE(source.endOfStream());
+  REQUIRE(source.readIQ(rest.data(), 1000) == 0);
+  REQUIRE(source.endOfStream());
+
+  source.disconnect();
+  std::remove(path.c_str());
+}
+
+TEST_CASE("FileSource loops and paces at the sample rate", "[file_source]") {
+  const std::string path = "test_replay_loop.u8";
+  writeBytes(path, rampIq(100));
+
+  FileSource source;
+  source.configure(path, "u8", true, true);
+  REQUIRE(source.connect());
+  REQUIRE(source.setSampleRate(10000));
+
+  std::vector<uint8_t> buf(100 * 2, 0);
+  const auto start = std::chrono::steady_clock::now();
+  size_t total = 0;
+  for (int i = 0; i < 4; i++) {
+    total += source.readIQ(buf.data(), 100);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  REQUIRE(total == 400);
+  REQUIRE_FALSE(source.endOfStream());
+  // 400 samples at 10 kS/s are due after 40 ms.
+  REQUIRE(elapsed >= std::chrono::milliseconds(35));
+  REQUIRE(buf[0] == 0);
+
+  source.disconnect();
+  std::remove(path.c_str());
+}
+
+TEST_CASE("FileSource seeks to tune index segments on retune",
+          "[file_source]") {
+  const std::string path = "test_replay_tunes.u8";
+  writeBytes(path, rampIq(300));
+  {
+    std::ofstream index(path + ".tunes");
+    index << "# offset freq\n0 87600000\n100 95000000\n200 101700000\n";
+  }
+
+  FileSource source;
+  source.configure(path, "auto", false, false);
+  REQUIRE(source.connect());
+  REQUIRE(source.setFrequency(95000000));
+  REQUIRE(source.positionSamples() == 100);
+
+  std::vector<uint8_t> buf(300 * 2, 0);
+  // Playback stays inside the 95.0 MHz segment.
+  REQUIRE(source.readIQ(buf.data(), 300) == 100);
+  REQUIRE(buf[0] == static_cast<uint8_t>(200 & 0xff));
+  REQUIRE(source.readIQ(buf.data(), 300) == 0);
+  REQUIRE(source.endOfStream());
+
+  REQUIRE(source.setFrequency(87600000));
+  REQUIRE_FALSE(source.endOfStream());
+  REQUIRE(source.positionSamples() == 0);
+
+  // Frequencies missing from the index keep playing linearly.
+  REQUIRE(source.setFrequency(99900000));
+  REQUIRE(source.readIQ(buf.data(), 300) == 300);
+
+  source.disconnect();
+  std::remove((path + ".tunes").c_str());
+  std::remove(path.c_str());
+}
+
+TEST_CASE("FileSource leases CF32 recordings in place", "[file_source]") {
+  const std::string path = "test_replay.cf32";
+  std::vector<std::complex<float>> iq(64);
+  for (size_t i = 0; i < iq.size(); i++) {
+    iq[i] = {0.01f * static_cast<float>(i), -0.5f};
+  }
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(iq.data()),
+              static_cast<std::streamsize>(iq.size() * sizeof(iq[0])));
+  }
+
+  FileSource source;
+  source.configure(path, "auto", false, false);
+  REQUIRE(source.connect());
+  REQUIRE(source.format() == FileSource::Format::CF32);
+  REQUIRE(source.totalSamples() == 64);
+
+  const std::complex<float> *data = nullptr;
+  REQUIRE(source.leaseIQ(16, data) == 16);
+  REQUIRE(data[5] == iq[5]);
+  source.releaseIQ(16);
+
+  // u8 readers (scan engine) get the requantized samples.
+  std::vector<uint8_t> u8(2 * 4, 0);
+  REQUIRE(source.readIQ(u8.data(), 4) == 4);
+  REQUIRE(u8[1] == 64); // -0.5 -> 127.5 - 63.75 rounds to 64
+
+  source.disconnect();
+  std::remove(path.c_str());
+}
+
+TEST_CASE("FileSource fails cleanly on a missing recording", "[file_source]") {
+  FileSource source;
+  source.configure("does_not_exist.u8", "auto", true, false);
+  REQUIRE_FALSE(source.connect());
+  REQUIRE_FALSE(source.isConnected());
+  const uint8_t *data = nullptr;
+  REQUIRE(source.leaseIQ(16, data) == 0);
+  REQUIRE_FALSE(source.setFrequency(87600000));
+}
+
+TEST_CASE("FileSource converts CS16 recordings to CF32 leases",
+          "[file_source]") {
+  const std::string path = "test_replay.cs16";
+  std::vector<int16_t> iq(2 * 32);
+  for (size_t i = 0; i < 32; i++) {
+    iq[2 * i] = static_cast<int16_t>(i * 1000);
+    iq[2 * i + 1] = -16384;
+  }
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(iq.data()),
+              static_cast<std::streamsize>(iq.size() * sizeof(iq[0])));
+  }
+
+  FileSource source;
+  source.configure(path, "auto", false, false);
+  REQUIRE(source.format() == FileSource::Format::CS16);
+  REQUIRE(source.connect());
+  REQUIRE(source.totalSamples() == 32);
+
+  const std::complex<float> *data = nullptr;
+  REQUIRE(source.leaseIQ(8, data) == 8);
+  REQUIRE(data[5] == std::complex<float>(5000.0f / 32768.0f, -0.5f));
+  source.releaseIQ(8);
+
+  std::vector<uint8_t> u8(2 * 4, 0);
+  REQUIRE(source.readIQ(u8.data(), 4) == 4);
+  REQUIRE(u8[1] == 64);
+
+  source.disconnect();
+  std::remove(path.c_str());
+}
+
+TEST_CASE("FileSource slides a window over recordings too large to map",
+          "[file_source]") {
+  const std::string path = "test_replay_window.cf32";
+  // Three and a bit pages, so leases straddle window edges.
+  std::vector<std::complex<float>> iq(1700);
+  for (size_t i = 0; i < iq.size(); i++) {
+    iq[i] = {static_cast<float>(i), -static_cast<float>(i)};
+  }
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(iq.data()),
+              static_cast<std::streamsize>(iq.size() * sizeof(iq[0])));
+  }
+
+  FileSource source;
+  source.configure(path, "auto", false, true);
+  source.m_wholeMapLimit = 0;
+  source.m_windowBytes = 4096;
+  REQUIRE(source.connect());
+  REQUIRE(source.m_windowed);
+  REQUIRE(source.totalSamples() == iq.size());
+
+  // Two passes through the loop: every lease matches the file and the view
+  // never grows past the window (plus one lease).
+  size_t expected = 0;
+  for (int lease = 0; lease < 12; lease++) {
+    const std::complex<float> *data = nullptr;
+    const size_t got = source.leaseIQ(300, data);
+    REQUIRE(got > 0);
+    REQUIRE(data != nullptr);
+    REQUIRE(data[0] == iq[expected]);
+    REQUIRE(data[got - 1] == iq[expected + got - 1]);
+    REQUIRE(source.m_viewBytes <= 4096 + 300 * sizeof(iq[0]));
+    source.releaseIQ(got);
+    expected = (expected + got) % iq.size();
+  }
+
+  source.disconnect();
+  std::remove(path.c_str());
+}
@@ -0,0 +1,168 @@
+#include "catch_compat.h"
+
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "iq_capture_writer.h"
+
+namespace {
+
+std::vector<uint8_t> readFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(in),
+                              std::istreambuf_iterator<char>());
+}
+
+std::string readText(const std::string &path) {
+  std::ifstream in(path);
+  return std::string(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+}
+
+std::vector<uint8_t> rampIq(size_t samples, size_t start) {
+  std::vector<uint8_t> bytes(samples * 2);
+  for (size_t i = 0; i < bytes.size(); i++) {
+    bytes[i] = static_cast<uint8_t>((start * 2 + i) & 0xff);
+  }
+  return bytes;
+}
+
+} // namespace
+
+TEST_CASE("IqCaptureWriter writes IQ and a tune index off-thread",
+          "[iq_capture]") {
+  const std::string path = "test_capture.iq";
+  IqCaptureWriter writer;
+  IqCaptureWriter::Options options;
+  options.sampleRate = 256000;
+  options.verboseLogging = false;
+  REQUIRE(writer.init(path, options));
+  REQUIRE(writer.isOpen());
+
+  const std::vector<uint8_t> a = rampIq(1000, 0);
+  const std::vector<uint8_t> b = rampIq(500, 1000);
+  REQUIRE(writer.enqueue(a.data(), 1000, 87600000));
+  REQUIRE(writer.enqueue(b.data(), 500, 95000000));
+  writer.shutdown();
+  REQUIRE_FALSE(writer.isOpen());
+
+  const std::vector<uint8_t> data = readFile(path);
+  REQUIRE(data.size() == 3000);
+  bool ramp = true;
+  for (size_t i = 0; i < data.size(); i++) {
+    ramp = ramp && (data[i] == static_cast<uint8_t>(i & 0xff));
+  }
+  REQUIRE(ramp);
+  REQUIRE(readText(path + ".tunes") == "0 87600000\n1000 95000000\n");
+  REQUIRE(writer.bytesWritten() == 3000);
+  REQUIRE(writer.dropEvents() == 0);
+
+  std::remove((path + ".tunes").c_str());
+  std::remove(path.c_str());
+}
+
+TEST_CASE("IqCaptureWriter rotates by size at sample boundaries",
+          "[iq_capture]") {
+  IqCaptureWriter writer;
+  IqCaptureWriter::Options options;
+  options.sampleRate = 256000;
+  options.rotateBytes = 1000;
+  options.verboseLogging = false;
+  REQUIRE(writer.init("test_rotate.iq", options));
+
+  const std::vector<uint8_t> a = rampIq(700, 0);
+  REQUIRE(writer.enqueue(a.data(), 700, 87600000));
+  const std::vector<uint8_t> b = rampIq(600, 700);
+  REQUIRE(writer.enqueue(b.data(), 600, 101700000));
+  writer.shutdown();
+  REQUIRE(writer.filesOpened() == 3);
+
+  const std::vector<uint8_t> f0 = readFile("test_rotate_0000.iq");
+  const std::vector<uint8_t> f1 = readFile("test_rotate_0001.iq");
+  const std::vector<uint8_t> f2 = readFile("test_rotate_0002.iq");
+  REQUIRE(f0.size() == 1000);
+  REQUIRE(f1.size() == 1000);
+  REQUIRE(f2.size() == 600);
+  REQUIRE(f1[0] == static_cast<uint8_t>(1000 & 0xff));
+
+  // Each file's index starts at 0; the retune at stream sample 700 falls in
+  // the second file at offset 200.
+  REQUIRE(readText("test_rotate_0000.iq.tunes") == "0 87600000\n");
+  REQUIRE(readText("test_rotate_0001.iq.tunes") ==
+          "0 87600000\n200 101700000\n");
+  REQUIRE(readText("test_rotate_0002.iq.tunes") == "0 101700000\n");
+
+  for (const char *name : {"test_rotate_0000.iq", "test_rotate_0001.iq",
+                           "test_rotate_0002.iq"}) {
+    std::remove((std::string(name) + ".tunes").c_str());
+    std::remove(name);
+  }
+}
+
+TEST_CASE("IqCaptureWriter fails cleanly on an unwritable path",
+          "[iq_capture]") {
+  IqCaptureWriter writer;
+  IqCaptureWriter::Options options;
+  options.verboseLogging = false;
+  REQUIRE_FALSE(writer.init("no_such_dir/capture.iq", options));
+  REQUIRE_FALSE(writer.isOpen());
+  const uint8_t iq[4] = {1, 2, 3, 4};
+  REQUIRE_FALSE(writer.enqueue(iq, 2, 87600000));
+  writer.shutdown();
+}
+
+TEST_CASE("IqCaptureWriter stores CF32 input as CS16 and CF32 files",
+          "[iq_capture]") {
+  std::vector<std::complex<float>> iq(300);
+  for (size_t i = 0; i < iq.size(); i++) {
+    iq[i] = {static_cast<float>(i) / 32768.0f, -0.5f};
+  }
+
+  IqCaptureWriter::Format format = IqCaptureWriter::Format::U8;
+  REQUIRE(IqCaptureWriter::parseFormat("auto", "test_capture.cs16", format));
+  REQUIRE(format == IqCaptureWriter::Format::CS16);
+  REQUIRE_FALSE(IqCaptureWriter::parseFormat("s8", "x.iq", format));
+
+  IqCaptureWriter writer;
+  IqCaptureWriter::Options options;
+  options.inputFormat = IqCaptureWriter::Format::CF32;
+  options.fileFormat = IqCaptureWriter::Format::CS16;
+  options.rotateBytes = 1001; // rounded down to whole 4-byte samples
+  options.verboseLogging = false;
+  REQUIRE(writer.init("test_capture.cs16", options));
+  REQUIRE(writer.enqueue(iq.data(), 200, 87600000));
+  // u8 blocks (scan engine) are converted to the input format.
+  const std::vector<uint8_t> u8 = rampIq(50, 0);
+  REQUIRE(writer.enqueue(u8.data(), 50, 87600000));
+  writer.shutdown();
+  REQUIRE(writer.filesOpened() == 1);
+  REQUIRE(writer.bytesWritten() == 250 * 4);
+
+  const std::vector<uint8_t> data = readFile("test_capture_0000.cs16");
+  REQUIRE(data.size() == 250 * 4);
+  std::vector<int16_t> s16(data.size() / 2);
+  std::memcpy(s16.data(), data.data(), data.size());
+  REQUIRE(s16[2 * 123] == 123); // lossless for 16-bit sources
+  REQUIRE(s16[2 * 123 + 1] == -16384);
+  REQUIRE(s16[2 * 200] == -32768); // u8 0 -> -1.0
+
+  std::remove("test_capture_0000.cs16.tunes");
+  std::remove("test_capture_0000.cs16");
+
+  IqCaptureWriter cf32Writer;
+  options.fileFormat = IqCaptureWriter::Format::CF32;
+  options.rotateBytes = 0;
+  REQUIRE(cf32Writer.init("test_capture.cf32", options));
+  REQUIRE(cf32Writer.enqueue(iq.data(), iq.size(), 87600000));
+  cf32Writer.shutdown();
+  const std::vector<uint8_t> raw = readFile("test_capture.cf32");
+  REQUIRE(raw.size() == iq.size() * sizeof(iq[0]));
+  REQUIRE(std::memcmp(raw.data(), iq.data(), raw.size()) == 0);
+  std::remove("test_capture.cf32.tunes");
+  std::remove("test_capture.cf32");
+}
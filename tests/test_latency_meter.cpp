@@ -0,0 +1,72 @@
+#include "catch_compat.h"
+
+#include <chrono>
+#include <string>
+
+#include "latency_meter.h"
+
+using Clock = std::chrono::steady_clock;
+
+TEST_CASE("LatencyMeter averages blocks and tracks the max",
+          "[latency_meter]") {
+  LatencyMeter meter(0);
+  const Clock::time_point t0 = Clock::now();
+  // 20 ms + 30 ms ring + 10 ms device = 60 ms.
+  meter.addBlock(t0, t0 + std::chrono::milliseconds(20), 0.030, 0.010);
+  // 40 ms + 50 ms ring + 10 ms device = 100 ms.
+  meter.addBlock(t0, t0 + std::chrono::milliseconds(40), 0.050, 0.010);
+
+  const LatencyMeter::Report report = meter.take();
+  REQUIRE(report.blocks == 2);
+  REQUIRE(report.avgMs == Approx(80.0));
+  REQUIRE(report.maxMs == Approx(100.0));
+  REQUIRE(report.iqToOutputMs == Approx(30.0));
+  REQUIRE(report.speakerRingMs == Approx(40.0));
+  REQUIRE(report.deviceMs == Approx(10.0));
+}
+
+TEST_CASE("LatencyMeter take() starts a new window", "[latency_meter]") {
+  LatencyMeter meter(0);
+  const Clock::time_point t0 = Clock::now();
+  meter.addBlock(t0, t0 + std::chrono::milliseconds(200), 0.0, 0.0);
+  REQUIRE(meter.take().blocks == 1);
+
+  const LatencyMeter::Report empty = meter.take();
+  REQUIRE(empty.blocks == 0);
+  REQUIRE(empty.avgMs == 0.0);
+  REQUIRE(empty.maxMs == 0.0);
+
+  // The old 200 ms max does not leak into the next window.
+  meter.addBlock(t0, t0 + std::chrono::milliseconds(10), 0.0, 0.0);
+  const LatencyMeter::Report next = meter.take();
+  REQUIRE(next.blocks == 1);
+  REQUIRE(next.maxMs == Approx(10.0));
+}
+
+TEST_CASE("LatencyMeter clamps a write stamped before the IQ arrival",
+          "[latency_meter]") {
+  LatencyMeter meter(0);
+  const Clock::time_point t0 = Clock::now();
+  meter.addBlock(t0, t0 - std::chrono::milliseconds(5), 0.020, 0.0);
+
+  const LatencyMeter::Report report = meter.take();
+  REQUIRE(report.iqToOutputMs == 0.0);
+  REQUIRE(report.avgMs == Approx(20.0));
+}
+
+TEST_CASE("LatencyMeter format() echoes the target only when set",
+          "[latency_meter]") {
+  LatencyMeter::Report report;
+  report.blocks = 4;
+  report.avgMs = 82.5;
+  report.maxMs = 101.0;
+  report.iqToOutputMs = 30.0;
+  report.speakerRingMs = 42.5;
+  report.deviceMs = 10.0;
+
+  const std::string expected = "[LATENCY] iq->dac avg 82.5 ms, max 101.0 ms "
+                               "(iq->output 30.0, speaker ring 42.5, "
+                               "device 10.0)";
+  REQUIRE(LatencyMeter(0).format(report) == expected);
+  REQUIRE(LatencyMeter(40).format(report) == expected + " target 40 ms");
+}
@@ -359,17 +359,51 @@ TEST_CASE("RTLTCPClient command and IQ handling with mock rtl_tcp server",
   REQUIRE(iq1[2] == 3);
   REQUIRE(iq1[3] == 4);
 
+  // Reads now give up after a short deadline instead of blocking in recv(),
+  // and the lone trailing byte can sit in Nagle/delayed-ACK for ~40 ms.
   uint8_t iq2[4] = {};
-  const size_t s2 = client.readIQ(iq2, 1);
+  size_t s2 = 0;
+  for (int i = 0; i < 20 && s2 == 0; i++) {
+    s2 = client.readIQ(iq2, 1);
+  }
   REQUIRE(s2 == 1);
   REQUIRE(iq2[0] == 5);
   REQUIRE(iq2[1] == 6);
 
+  // The server hangs up 50 ms after the IQ; the receive thread reports it.
+  for (int i = 0; i < 200 && !client.failed(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  REQUIRE(client.failed());
+  const RTLTCPClient::ReceiveStats stats = client.receiveStats();
+  REQUIRE(stats.bytesReceived == 6);
+  REQUIRE(stats.overflowEvents == 0);
+  REQUIRE(stats.occupancyBytes == 0);
+  REQUIRE(stats.capacityBytes >= 1024U * 1024U);
+  const std::string line = RTLTCPClient::formatReceiveStats(stats);
+  REQUIRE(line.find("ring 0/" + std::to_string(stats.capacityBytes / 1024) +
+                    " KB") != std::string::npos);
+
   client.disconnect();
   server.join();
   REQUIRE(serverOk.load());
 }
 
+TEST_CASE("RTLTCPClient receive stats line shows ring fill and jitter",
+          "[protocol][rtl_tcp]") {
+  RTLTCPClient::ReceiveStats stats;
+  stats.occupancyBytes = 512 * 1024;
+  stats.peakOccupancyBytes = 1536 * 1024;
+  stats.capacityBytes = 4096 * 1024;
+  stats.jitterMs = 1.3;
+  stats.maxGapMs = 42.0;
+  stats.underrunReads = 3;
+  stats.overflowEvents = 1;
+  REQUIRE(RTLTCPClient::formatReceiveStats(stats) ==
+          "[RTL_TCP] ring 512/4096 KB (peak 1536 KB), jitter 1.3 ms, "
+          "max gap 42.0 ms, 3 underruns, 1 overflows");
+}
+
 TEST_CASE("RTLTCPClient rejects malformed rtl_tcp header",
           "[protocol][rtl_tcp]") {
 #if defined(_WIN32)
@@ -141,14 +141,13 @@ struct LiveDspAnalysis {
   double averageQuality = 0.0;
 };
 
-double stereoAudioRms(const float* left, const float* right, size_t count) {
-  if (!left || !right || count == 0) {
+double stereoAudioRms(const float* frames, size_t count) {
+  if (!frames || count == 0) {
     return 0.0;
   }
   double sum = 0.0;
-  for (size_t i = 0; i < count; ++i) {
-    sum += static_cast<double>(left[i]) * left[i];
-    sum += static_cast<double>(right[i]) * right[i];
+  for (size_t i = 0; i < count * 2; ++i) {
+    sum += static_cast<double>(frames[i]) * frames[i];
   }
   return std::sqrt(sum / static_cast<double>(count * 2));
 }
@@ -164,11 +163,9 @@ LiveDspAnalysis analyzeBandwidth(RTLSDRDevice& dev, uint32_t sampleRateHz,
   cfg.processing.stereo = true;
 
   REQUIRE(sampleRateHz >= static_cast<uint32_t>(kInputRate));
-  REQUIRE((sampleRateHz % static_cast<uint32_t>(kInputRate)) == 0);
-  const size_t iqDecimation = sampleRateHz / static_cast<uint32_t>(kInputRate);
   DspPipeline pipeline(kInputRate, kOutputRate, cfg.processing, false,
                        static_cast<size_t>(cfg.processing.dsp_block_samples),
-                       iqDecimation);
+                       sampleRateHz);
   pipeline.setBandwidthHz(bandwidthHz);
   pipeline.setDeemphasisMode(deemphasisMode);
   pipeline.setForceMono(false);
@@ -214,7 +211,7 @@ LiveDspAnalysis analyzeBandwidth(RTLSDRDevice& dev, uint32_t sampleRateHz,
     pilotSum += static_cast<double>(dspOut.pilotTenthsKHz);
     blendSum += static_cast<double>(dspOut.stereoBlend);
     qualitySum += static_cast<double>(dspOut.stereoQuality);
-    audioRmsSum += stereoAudioRms(dspOut.left, dspOut.right, dspOut.outSamples);
+    audioRmsSum += stereoAudioRms(dspOut.audio, dspOut.outSamples);
     validBlocks++;
   }
 
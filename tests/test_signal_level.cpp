@@ -1,4 +1,5 @@
 #include "catch_compat.h"
+#include "dsp/kernel_registry.h"
 #include "signal_level.h"
 
 #include <algorithm>
@@ -6,6 +7,7 @@
 #include <complex>
 #include <cstring>
 #include <limits>
+#include <string>
 #include <vector>
 
 namespace {
@@ -51,7 +53,7 @@ std::vector<uint8_t> makeNoiseIqBuffer(size_t samples, float amplitude) {
 } // namespace
 
 TEST_CASE("computeSignalLevel handles null input", "[signal_level]") {
-    SignalLevelResult result = computeSignalLevel(nullptr, 100, 0, 0.5, 0.0, -80.0, -12.0);
+    SignalLevelResult result = computeSignalLevel(static_cast<const uint8_t *>(nullptr), 100, 0, 0.5, 0.0, -80.0, -12.0);
     REQUIRE(result.dbfs == -120.0);
     REQUIRE(result.level120 == 0.0f);
 }
@@ -323,3 +325,91 @@ TEST_CASE("computeSignalLevel remains selective at higher sample rates",
     REQUIRE(inChannelLevel.dbfs > blockerLevel.dbfs + 8.0);
     REQUIRE(std::abs(mixedLevel.dbfs - inChannelLevel.dbfs) < 2.5);
 }
+
+TEST_CASE("computeSignalLevel CF32 overload matches the u8 meter",
+          "[signal_level]") {
+    constexpr size_t kSamples = 4096;
+    constexpr uint32_t kSampleRateHz = 256000;
+    constexpr int kChannelBandwidthHz = 56000;
+
+    const std::vector<uint8_t> iq =
+        makeIqBuffer(kSamples, kSampleRateHz,
+                     {{15000.0f, 0.18f}, {90000.0f, 0.30f}},
+                     {0.02f, -0.01f});
+    std::vector<std::complex<float>> cf32(kSamples);
+    for (size_t n = 0; n < kSamples; ++n) {
+        cf32[n] = {(static_cast<float>(iq[n * 2]) - 127.5f) / 127.5f,
+                   (static_cast<float>(iq[n * 2 + 1]) - 127.5f) / 127.5f};
+    }
+
+    for (const uint32_t rate : {0u, kSampleRateHz}) {
+        const SignalLevelResult u8Level =
+            computeSignalLevel(iq.data(), kSamples, 10, 0.5, 1.0, -80.0,
+                               -12.0, rate, kChannelBandwidthHz);
+        const SignalLevelResult cf32Level =
+            computeSignalLevel(cf32.data(), kSamples, 10, 0.5, 1.0, -80.0,
+                               -12.0, rate, kChannelBandwidthHz);
+        REQUIRE(std::abs(cf32Level.dbfs - u8Level.dbfs) < 0.01);
+        REQUIRE(std::abs(cf32Level.noiseFloorDbfs - u8Level.noiseFloorDbfs) <
+                0.01);
+        REQUIRE(std::abs(cf32Level.compensatedDbfs - u8Level.compensatedDbfs) <
+                0.01);
+        REQUIRE(std::abs(cf32Level.level120 - u8Level.level120) < 0.05f);
+    }
+}
+
+TEST_CASE("computeSignalLevel CF32 clip ratios count saturated samples",
+          "[signal_level]") {
+    // Odd length so the SIMD kernels' scalar tail is exercised too.
+    constexpr size_t kSamples = 1003;
+    std::vector<std::complex<float>> iq(kSamples, {0.1f, -0.1f});
+    size_t hard = 0;
+    size_t near = 0;
+    for (size_t n = 0; n < kSamples; n += 7) {
+        iq[n] = {0.1f, -1.0f}; // full-scale Q
+        hard++;
+        near++;
+    }
+    for (size_t n = 3; n < kSamples; n += 11) {
+        if (n % 7 != 0) {
+            iq[n] = {0.95f, 0.0f}; // near clip only
+            near++;
+        }
+    }
+
+    const SignalLevelResult result =
+        computeSignalLevel(iq.data(), kSamples, 0, 0.5, 0.0, -80.0, -12.0);
+    REQUIRE(std::abs(result.hardClipRatio -
+                     static_cast<double>(hard) / kSamples) < 1e-9);
+    REQUIRE(std::abs(result.nearClipRatio -
+                     static_cast<double>(near) / kSamples) < 1e-9);
+    REQUIRE(computeSignalLevel(static_cast<const std::complex<float> *>(nullptr),
+                               16, 0, 0.5, 0.0, -80.0, -12.0)
+                .dbfs == -120.0);
+}
+
+TEST_CASE("computeSignalLevel CF32 moments agree across kernel variants",
+          "[signal_level][kernels]") {
+    constexpr size_t kSamples = 4099; // odd tail past the SIMD blocks
+    std::vector<std::complex<float>> iq(kSamples);
+    for (size_t n = 0; n < kSamples; ++n) {
+        const float t = static_cast<float>(n);
+        iq[n] = {0.05f + 0.4f * std::cos(0.37f * t),
+                 -0.02f + 0.4f * std::sin(0.37f * t)};
+        if (n % 61 == 0) {
+            iq[n] = {0.999f, 0.95f};
+        }
+    }
+
+    std::string error;
+    REQUIRE(fm_tuner::dsp::setKernelOverrides("power_sum:scalar", error));
+    const SignalLevelResult scalar =
+        computeSignalLevel(iq.data(), kSamples, 0, 0.5, 0.0, -80.0, -12.0);
+    REQUIRE(fm_tuner::dsp::setKernelOverrides("auto", error));
+    const SignalLevelResult best =
+        computeSignalLevel(iq.data(), kSamples, 0, 0.5, 0.0, -80.0, -12.0);
+
+    REQUIRE(std::abs(best.dbfs - scalar.dbfs) < 1e-4);
+    REQUIRE(best.hardClipRatio == scalar.hardClipRatio);
+    REQUIRE(best.nearClipRatio == scalar.nearClipRatio);
+}
@@ -0,0 +1,129 @@
+#include "catch_compat.h"
+
+#include "spsc_ring.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using fm_tuner::SpscRing;
+
+TEST_CASE("SPSC ring rounds capacity up to a power of two", "[spsc_ring]") {
+  SpscRing<uint8_t> ring(1000);
+  REQUIRE(ring.capacity() == 1024);
+  REQUIRE(ring.readAvailable() == 0);
+  REQUIRE(ring.writeAvailable() == 1024);
+}
+
+TEST_CASE("SPSC ring wraps with at most two contiguous spans", "[spsc_ring]") {
+  SpscRing<uint8_t> ring(16);
+  std::vector<uint8_t> in(12);
+  for (size_t i = 0; i < in.size(); i++) {
+    in[i] = static_cast<uint8_t>(i + 1);
+  }
+  REQUIRE(ring.write(in.data(), in.size()) == 12);
+  REQUIRE(ring.discard(10) == 10);
+  // 2 left at positions 10..11; the next 12 wrap past the end of storage.
+  REQUIRE(ring.write(in.data(), in.size()) == 12);
+  REQUIRE(ring.readAvailable() == 14);
+
+  const auto spans = ring.peek(14);
+  REQUIRE(spans.firstCount == 6);
+  REQUIRE(spans.secondCount == 8);
+  REQUIRE(spans.first[0] == 11);
+  REQUIRE(spans.first[2] == 1);
+  REQUIRE(spans.second[0] == 5);
+
+  std::vector<uint8_t> out(14, 0);
+  REQUIRE(ring.read(out.data(), out.size()) == 14);
+  REQUIRE(out[0] == 11);
+  REQUIRE(out[1] == 12);
+  for (size_t i = 0; i < 12; i++) {
+    REQUIRE(out[i + 2] == in[i]);
+  }
+  REQUIRE(ring.readAvailable() == 0);
+}
+
+TEST_CASE("SPSC ring write reports how much fit when full", "[spsc_ring]") {
+  SpscRing<uint8_t> ring(8);
+  std::vector<uint8_t> in(12, 0x5a);
+  REQUIRE(ring.write(in.data(), in.size()) == 8);
+  REQUIRE(ring.writeAvailable() == 0);
+  REQUIRE(ring.write(in.data(), 2) == 0);
+  REQUIRE(ring.discardAll() == 8);
+  REQUIRE(ring.writeAvailable() == 8);
+}
+
+TEST_CASE("SPSC ring preserves order across threads", "[spsc_ring]") {
+  SpscRing<uint32_t> ring(4096);
+  constexpr uint32_t kTotal = 1U << 20;
+
+  std::thread producer([&]() {
+    std::vector<uint32_t> chunk(777);
+    uint32_t next = 0;
+    while (next < kTotal) {
+      const size_t want =
+          std::min<size_t>(chunk.size(), static_cast<size_t>(kTotal - next));
+      for (size_t i = 0; i < want; i++) {
+        chunk[i] = next + static_cast<uint32_t>(i);
+      }
+      size_t done = 0;
+      while (done < want) {
+        done += ring.write(chunk.data() + done, want - done);
+        if (done < want) {
+          std::this_thread::yield();
+        }
+      }
+      next += static_cast<uint32_t>(want);
+    }
+  });
+
+  std::vector<uint32_t> out(1024);
+  uint32_t expected = 0;
+  bool ordered = true;
+  while (expected < kTotal) {
+    const size_t n = ring.read(out.data(), out.size());
+    if (n == 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (size_t i = 0; i < n; i++) {
+      ordered = ordered && (out[i] == expected);
+      expected++;
+    }
+  }
+  producer.join();
+  REQUIRE(ordered);
+  REQUIRE(ring.readAvailable() == 0);
+}
+
+TEST_CASE("SPSC ring contiguous peek stitches wrapped data through slack",
+          "[spsc_ring]") {
+  SpscRing<uint8_t> ring(16, 8);
+  REQUIRE(ring.contiguousSlack() == 8);
+  std::vector<uint8_t> in(12);
+  for (size_t i = 0; i < in.size(); i++) {
+    in[i] = static_cast<uint8_t>(i + 1);
+  }
+  REQUIRE(ring.write(in.data(), in.size()) == 12);
+  REQUIRE(ring.discard(12) == 12);
+  REQUIRE(ring.write(in.data(), in.size()) == 12);
+
+  // Readable data starts at 12 and wraps after 4 elements.
+  size_t available = 0;
+  const uint8_t *span = ring.peekContiguous(12, available);
+  REQUIRE(span != nullptr);
+  REQUIRE(available == 12);
+  for (size_t i = 0; i < 12; i++) {
+    REQUIRE(span[i] == in[i]);
+  }
+  REQUIRE(ring.discard(available) == 12);
+
+  // More wrapped data than slack: the span is cut short instead.
+  REQUIRE(ring.write(in.data(), in.size()) == 12);
+  REQUIRE(ring.discard(2) == 2);
+  REQUIRE(ring.write(in.data(), 6) == 6);
+  span = ring.peekContiguous(16, available);
+  REQUIRE(span[0] == in[2]);
+  REQUIRE(available == 14);
+}